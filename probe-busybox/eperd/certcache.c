@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2026 RIPE NCC <atlas@ripe.net>
+ * Licensed under GPLv2 or later, see file LICENSE in this tarball for details.
+ * certcache.c
+ */
+
+#include "libbb.h"
+
+#include "certcache.h"
+
+static unsigned cc_hashfp(const unsigned char *fp)
+{
+	/* The fingerprint is already a good hash */
+	return (fp[0] | (fp[1] << 8)) % CERTCACHE_HASH;
+}
+
+void certcache_fp(const void *der, size_t len, unsigned char *fp)
+{
+	sha256_ctx_t ctx;
+
+	sha256_begin(&ctx);
+	sha256_hash(&ctx, der, len);
+	sha256_end(&ctx, fp);
+}
+
+/* Drop the oldest entry of the first chain from h on that has one */
+static void cc_evict(struct certcache *cc, unsigned h)
+{
+	int i;
+	struct certcache_ent **pp;
+
+	for (i= 0; i<CERTCACHE_HASH; i++)
+	{
+		pp= &cc->hash[(h+i) % CERTCACHE_HASH];
+		if (*pp == NULL)
+			continue;
+		while ((*pp)->next)
+			pp= &(*pp)->next;
+		free(*pp);
+		*pp= NULL;
+		cc->count--;
+		return;
+	}
+}
+
+struct certcache_ent *certcache_lookup(struct certcache *cc,
+	const unsigned char *fp, int create)
+{
+	unsigned h;
+	struct certcache_ent *ent;
+
+	h= cc_hashfp(fp);
+	for (ent= cc->hash[h]; ent; ent= ent->next)
+	{
+		if (memcmp(ent->fp, fp, CERTCACHE_FP_LEN) == 0)
+			return ent;
+	}
+	if (!create)
+		return NULL;
+
+	if (cc->count >= CERTCACHE_MAX)
+		cc_evict(cc, h);
+	ent= xzalloc(sizeof(*ent));
+	memcpy(ent->fp, fp, CERTCACHE_FP_LEN);
+	ent->next= cc->hash[h];
+	cc->hash[h]= ent;
+	cc->count++;
+	return ent;
+}
+
+void certcache_expire(struct certcache *cc, unsigned tag)
+{
+	int i;
+	struct certcache_ent *ent, **pp;
+
+	for (i= 0; i<CERTCACHE_HASH; i++)
+	{
+		pp= &cc->hash[i];
+		while ((ent= *pp) != NULL)
+		{
+			if (ent->tag == tag)
+			{
+				pp= &ent->next;
+				continue;
+			}
+			*pp= ent->next;
+			free(ent);
+			cc->count--;
+		}
+	}
+}
+
+void certcache_clear(struct certcache *cc)
+{
+	int i;
+	struct certcache_ent *ent;
+
+	for (i= 0; i<CERTCACHE_HASH; i++)
+	{
+		while ((ent= cc->hash[i]) != NULL)
+		{
+			cc->hash[i]= ent->next;
+			free(ent);
+		}
+	}
+	cc->count= 0;
+}
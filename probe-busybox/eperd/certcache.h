@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2026 RIPE NCC <atlas@ripe.net>
+ * Licensed under GPLv2 or later, see file LICENSE in this tarball for details.
+ * certcache.h
+ */
+
+/* Set of certificates, keyed by the SHA-256 fingerprint of the DER
+ * encoding. Each measurement instance keeps its own, so what one instance
+ * reported says nothing about another. A full set drops an entry to make
+ * room, that certificate is then reported in full again.
+ */
+#define CERTCACHE_HASH		64
+#define CERTCACHE_MAX		256	/* Entries per set */
+#define CERTCACHE_FP_LEN	32	/* SHA-256 */
+
+struct certcache_ent
+{
+	unsigned char fp[CERTCACHE_FP_LEN];
+	unsigned tag;		/* Last run that saw it, see certcache_expire */
+	int id;			/* Index in the chain output of that run */
+	char uploaded;		/* Reported in full by this instance */
+
+	/* Private */
+	struct certcache_ent *next;	/* Hash chain */
+};
+
+struct certcache
+{
+	struct certcache_ent *hash[CERTCACHE_HASH];
+	int count;
+};
+
+/* Fingerprint of a DER encoded certificate */
+void certcache_fp(const void *der, size_t len, unsigned char *fp);
+
+/* Find fp. With create set, a missing entry is added (zeroed), after
+ * dropping the oldest entry of a hash chain if the set is full.
+ */
+struct certcache_ent *certcache_lookup(struct certcache *cc,
+	const unsigned char *fp, int create);
+
+/* Forget the entries not seen by the run with tag */
+void certcache_expire(struct certcache *cc, unsigned tag);
+
+/* Forget all entries */
+void certcache_clear(struct certcache *cc);
@@ -0,0 +1,527 @@
+/*
+ * Copyright (c) 2026 RIPE NCC <atlas@ripe.net>
+ * Licensed under GPLv2 or later, see file LICENSE in this tarball for details.
+ * dnscache.c
+ */
+
+#include "libbb.h"
+#include <event2/dns.h>
+#include <event2/event.h>
+#include <event2/event_struct.h>
+#include <event2/util.h>
+
+#include "eperd.h"
+#include "dnscache.h"
+
+#define DNSCACHE_HASH	64
+#define DNSCACHE_HOSTS	"/etc/hosts"
+
+/* From libevent's util-internal.h. Callers free results with
+ * evutil_freeaddrinfo, so they have to be allocated the way libevent
+ * does it.
+ */
+struct evutil_addrinfo *evutil_new_addrinfo_(struct sockaddr *sa,
+	ev_socklen_t socklen, const struct evutil_addrinfo *hints);
+struct evutil_addrinfo *evutil_addrinfo_append_(struct evutil_addrinfo *first,
+	struct evutil_addrinfo *append);
+
+struct dc_lookup;
+
+struct dc_link
+{
+	struct dc_lookup *lookup;
+	struct dc_link *next;
+};
+
+/* The A or AAAA records of a name */
+struct dc_rec
+{
+	struct dc_rec *next;		/* Hash chain */
+	char *name;
+	char type;			/* DNS_IPv4_A or DNS_IPv6_AAAA */
+	char flushed;			/* No longer in the hash table */
+	char busy;			/* Answering its waiters */
+	unsigned hash;
+	struct evdns_request *req;	/* Query in progress */
+	struct dc_link *waiters;	/* Lookups waiting for req */
+	time_t expires;
+	int error;			/* getaddrinfo error, 0 if ok */
+	int count;
+	u_char *addrs;
+};
+
+/* A call to dnscache_getaddrinfo. Index 0 is A, 1 is AAAA */
+struct dc_lookup
+{
+	evdns_getaddrinfo_cb cb;
+	void *arg;
+	struct evutil_addrinfo hints;
+	int port;
+	int pending;
+	struct dc_rec *rec[2];		/* Records still being resolved */
+	struct dc_link link[2];
+	int error[2];
+	struct evutil_addrinfo *res[2];
+	struct event skew_timer;
+};
+
+static struct dc_rec *dc_hash[DNSCACHE_HASH];
+static int dc_nrec;
+
+/* The hosts file, in a base without nameservers. evdns_getaddrinfo answers
+ * from the hosts file before it sends queries, and here the queries wait
+ * for a nameserver until they are cancelled.
+ */
+static struct evdns_base *dc_hosts_base;
+static struct dc_hosts_ans
+{
+	int found;
+	int error;
+	struct evutil_addrinfo *res;
+} dc_hosts_ans;
+
+static time_t dc_now(void)
+{
+	struct timespec now;
+
+	gettime_mono(&now);
+	return now.tv_sec;
+}
+
+static unsigned dc_hashname(const char *name, int type)
+{
+	unsigned h;
+
+	/* FNV-1a, names are case insensitive */
+	h= 2166136261u ^ type;
+	for (; *name; name++)
+	{
+		h ^= tolower((unsigned char)*name);
+		h *= 16777619u;
+	}
+	return h % DNSCACHE_HASH;
+}
+
+static struct dc_rec *dc_find(const char *name, int type)
+{
+	struct dc_rec *rec;
+
+	for (rec= dc_hash[dc_hashname(name, type)]; rec; rec= rec->next)
+	{
+		if (rec->type == type && strcasecmp(rec->name, name) == 0)
+			return rec;
+	}
+	return NULL;
+}
+
+static void dc_drop(struct dc_rec *rec)
+{
+	free(rec->name);
+	free(rec->addrs);
+	free(rec);
+}
+
+/* Take a record out of the hash table. Whoever is using it frees it */
+static void dc_unlink(struct dc_rec *rec)
+{
+	struct dc_rec **pp;
+
+	if (rec->flushed)
+		return;
+	for (pp= &dc_hash[rec->hash]; *pp != rec; pp= &(*pp)->next)
+		;
+	*pp= rec->next;
+	dc_nrec--;
+	rec->flushed= 1;
+}
+
+static void dc_free_rec(struct dc_rec *rec)
+{
+	dc_unlink(rec);
+	dc_drop(rec);
+}
+
+/* Make room for a new record. Expired records go first, then the one
+ * that expires soonest. If every record is still in use, one of them
+ * leaves the table and is freed when its query is done.
+ */
+static void dc_evict(time_t now)
+{
+	int i;
+	struct dc_rec *rec, *oldest, *inuse, **pp;
+
+	oldest= NULL;
+	inuse= NULL;
+	for (i= 0; i<DNSCACHE_HASH; i++)
+	{
+		pp= &dc_hash[i];
+		while ((rec= *pp) != NULL)
+		{
+			if (rec->req || rec->busy)
+			{
+				if (!inuse)
+					inuse= rec;
+				pp= &rec->next;
+				continue;
+			}
+			if (rec->expires <= now)
+			{
+				*pp= rec->next;
+				dc_nrec--;
+				dc_drop(rec);
+				continue;
+			}
+			if (!oldest || rec->expires < oldest->expires)
+				oldest= rec;
+			pp= &rec->next;
+		}
+	}
+	if (dc_nrec < DNSCACHE_MAX)
+		return;
+	if (oldest)
+		dc_free_rec(oldest);
+	else if (inuse)
+		dc_unlink(inuse);
+}
+
+static struct evutil_addrinfo *dc_addrinfo(const struct dc_rec *rec,
+	const struct evutil_addrinfo *hints, int port)
+{
+	int i;
+	struct sockaddr_in sin;
+	struct sockaddr_in6 sin6;
+	struct evutil_addrinfo *res, *ai;
+
+	res= NULL;
+	for (i= 0; i<rec->count; i++)
+	{
+		if (rec->type == DNS_IPv4_A)
+		{
+			memset(&sin, '\0', sizeof(sin));
+			sin.sin_family= AF_INET;
+			sin.sin_port= htons(port);
+			memcpy(&sin.sin_addr, rec->addrs + i*4, 4);
+			ai= evutil_new_addrinfo_((struct sockaddr *)&sin,
+				sizeof(sin), hints);
+		}
+		else
+		{
+			memset(&sin6, '\0', sizeof(sin6));
+			sin6.sin6_family= AF_INET6;
+			sin6.sin6_port= htons(port);
+			memcpy(&sin6.sin6_addr, rec->addrs + i*16, 16);
+			ai= evutil_new_addrinfo_((struct sockaddr *)&sin6,
+				sizeof(sin6), hints);
+		}
+		if (!ai)
+		{
+			if (res)
+				evutil_freeaddrinfo(res);
+			return NULL;
+		}
+		res= evutil_addrinfo_append_(res, ai);
+	}
+	return res;
+}
+
+static void dc_deliver(struct dc_lookup *lookup)
+{
+	int error;
+	struct evutil_addrinfo *res;
+
+	/* IPv4 first, like evdns_getaddrinfo */
+	res= evutil_addrinfo_append_(lookup->res[0], lookup->res[1]);
+	error= 0;
+	if (!res)
+	{
+		error= lookup->error[0] ? lookup->error[0] : lookup->error[1];
+		if (!error)
+			error= EVUTIL_EAI_AGAIN;
+	}
+	event_del(&lookup->skew_timer);
+	lookup->cb(error, res, lookup->arg);
+	free(lookup);
+}
+
+static void dc_set_result(struct dc_lookup *lookup, int ind,
+	const struct dc_rec *rec)
+{
+	lookup->error[ind]= rec->error;
+	if (rec->error)
+		return;
+	lookup->res[ind]= dc_addrinfo(rec, &lookup->hints, lookup->port);
+	if (!lookup->res[ind])
+		lookup->error[ind]= EVUTIL_EAI_MEMORY;
+}
+
+static void dc_skew_cb(int __attribute((unused)) unused,
+	const short __attribute((unused)) event, void *s)
+{
+	int i;
+	struct dc_lookup *lookup;
+	struct dc_link **lp;
+
+	/* Give up on the other family. Its query continues for the cache */
+	lookup= s;
+	for (i= 0; i<2; i++)
+	{
+		if (!lookup->rec[i])
+			continue;
+		for (lp= &lookup->rec[i]->waiters; *lp != &lookup->link[i];
+			lp= &(*lp)->next)
+		{
+			;
+		}
+		*lp= lookup->link[i].next;
+		lookup->rec[i]= NULL;
+	}
+	dc_deliver(lookup);
+}
+
+static void dc_resolved(int result, char type, int count, int ttl,
+	void *addresses, void *arg)
+{
+	int ind;
+	struct dc_rec *rec;
+	struct dc_link *link, *next, *waiters;
+	struct dc_lookup *lookup;
+	struct timeval skew;
+
+	rec= arg;
+	rec->req= NULL;
+
+	if (result == DNS_ERR_NONE && count > 0)
+	{
+		rec->error= 0;
+		rec->count= count;
+		rec->addrs= xmemdup(addresses,
+			count * (type == DNS_IPv4_A ? 4 : 16));
+		if (ttl > DNSCACHE_MAX_TTL)
+			ttl= DNSCACHE_MAX_TTL;
+	}
+	else if (result == DNS_ERR_NONE || result == DNS_ERR_NOTEXIST)
+	{
+		/* Negative answer, ttl is the SOA minimum if there was one */
+		rec->error= (result == DNS_ERR_NONE) ? EVUTIL_EAI_NODATA :
+			EVUTIL_EAI_NONAME;
+		if (ttl > DNSCACHE_NEG_MAX_TTL)
+			ttl= DNSCACHE_NEG_MAX_TTL;
+	}
+	else
+	{
+		/* Timeouts and server failures are not cached */
+		rec->error= EVUTIL_EAI_FAIL;
+		ttl= 0;
+	}
+	rec->expires= dc_now() + ttl;
+
+	/* The callbacks may look up the same name, evict or flush. The
+	 * record stays until they are all done.
+	 */
+	waiters= rec->waiters;
+	rec->waiters= NULL;
+	rec->busy= 1;
+	for (link= waiters; link; link= next)
+	{
+		next= link->next;
+		lookup= link->lookup;
+		ind= link - lookup->link;
+		lookup->rec[ind]= NULL;
+		dc_set_result(lookup, ind, rec);
+		lookup->pending--;
+		if (lookup->pending == 0)
+			dc_deliver(lookup);
+		else
+		{
+			skew.tv_sec= DNSCACHE_SKEW;
+			skew.tv_usec= 0;
+			evtimer_add(&lookup->skew_timer, &skew);
+		}
+	}
+	rec->busy= 0;
+
+	if (rec->flushed || ttl <= 0)
+		dc_free_rec(rec);
+}
+
+static void dc_hosts_cb(int result, struct evutil_addrinfo *res,
+	void *arg)
+{
+	struct dc_hosts_ans *ans;
+
+	if (result == EVUTIL_EAI_CANCEL)
+		return;
+	ans= arg;
+	ans->found= 1;
+	ans->error= result;
+	ans->res= res;
+}
+
+/* Answer from the hosts file. Returns 0 if the name is not in it */
+static int dc_fromhosts(const char *name, const char *port,
+	const struct evutil_addrinfo *hints, evdns_getaddrinfo_cb cb,
+	void *arg)
+{
+	struct evdns_getaddrinfo_request *req;
+
+	if (!dc_hosts_base)
+	{
+		dc_hosts_base= evdns_base_new(EventBase, 0 /*!initialize*/);
+		if (!dc_hosts_base)
+			return 0;
+		evdns_base_load_hosts(dc_hosts_base, DNSCACHE_HOSTS);
+	}
+
+	memset(&dc_hosts_ans, '\0', sizeof(dc_hosts_ans));
+	req= evdns_getaddrinfo(dc_hosts_base, name, port, hints,
+		dc_hosts_cb, &dc_hosts_ans);
+	if (req)
+		evdns_getaddrinfo_cancel(req);
+	if (!dc_hosts_ans.found)
+		return 0;
+	cb(dc_hosts_ans.error, dc_hosts_ans.res, arg);
+	return 1;
+}
+
+void dnscache_getaddrinfo(struct evdns_base *base, const char *name,
+	const char *port, const struct evutil_addrinfo *hints, int nocache,
+	evdns_getaddrinfo_cb cb, void *arg)
+{
+	int i, type, family, nwant;
+	unsigned long portnum;
+	char *check;
+	time_t now;
+	struct dc_rec *rec;
+	struct dc_lookup *lookup;
+	struct in6_addr addr;
+	struct timeval skew;
+
+	family= hints ? hints->ai_family : AF_UNSPEC;
+	portnum= 0;
+	if (port)
+	{
+		portnum= strtoul(port, &check, 10);
+		if (port[0] == '\0' || check[0] != '\0' || portnum > 65535)
+			nocache= 1;	/* Service names */
+	}
+	if (!name || !strchr(name, '.') || (hints && hints->ai_flags) ||
+		(family != AF_UNSPEC && family != AF_INET &&
+		family != AF_INET6) ||
+		inet_pton(AF_INET, name, &addr) == 1 ||
+		inet_pton(AF_INET6, name, &addr) == 1)
+	{
+		/* Leave literals and the hosts file to evdns */
+		nocache= 1;
+	}
+	if (nocache)
+	{
+		(void) evdns_getaddrinfo(base, name, port, hints, cb, arg);
+		return;
+	}
+
+	/* Names from the hosts file are never cached */
+	if (!dc_find(name, DNS_IPv4_A) && !dc_find(name, DNS_IPv6_AAAA) &&
+		dc_fromhosts(name, port, hints, cb, arg))
+	{
+		return;
+	}
+
+	lookup= xzalloc(sizeof(*lookup));
+	lookup->cb= cb;
+	lookup->arg= arg;
+	if (hints)
+		lookup->hints= *hints;
+	lookup->hints.ai_family= family;
+	lookup->port= portnum;
+	evtimer_assign(&lookup->skew_timer, EventBase, dc_skew_cb, lookup);
+
+	now= dc_now();
+	nwant= 0;
+	for (i= 0; i<2; i++)
+	{
+		type= (i == 0) ? DNS_IPv4_A : DNS_IPv6_AAAA;
+		if (family == (i == 0 ? AF_INET6 : AF_INET))
+			continue;
+		nwant++;
+
+		rec= dc_find(name, type);
+		if (rec && !rec->req && !rec->busy && rec->expires <= now)
+		{
+			dc_free_rec(rec);
+			rec= NULL;
+		}
+		if (!rec)
+		{
+			if (dc_nrec >= DNSCACHE_MAX)
+				dc_evict(now);
+			rec= xzalloc(sizeof(*rec));
+			rec->name= xstrdup(name);
+			rec->type= type;
+			rec->hash= dc_hashname(name, type);
+			rec->next= dc_hash[rec->hash];
+			dc_hash[rec->hash]= rec;
+			dc_nrec++;
+			if (type == DNS_IPv4_A)
+			{
+				rec->req= evdns_base_resolve_ipv4(base, name, 0,
+					dc_resolved, rec);
+			}
+			else
+			{
+				rec->req= evdns_base_resolve_ipv6(base, name, 0,
+					dc_resolved, rec);
+			}
+			if (!rec->req)
+			{
+				dc_free_rec(rec);
+				lookup->error[i]= EVUTIL_EAI_FAIL;
+				continue;
+			}
+		}
+		if (rec->req)
+		{
+			/* Join the query in progress */
+			lookup->rec[i]= rec;
+			lookup->link[i].lookup= lookup;
+			lookup->link[i].next= rec->waiters;
+			rec->waiters= &lookup->link[i];
+			lookup->pending++;
+			continue;
+		}
+		dc_set_result(lookup, i, rec);
+	}
+
+	if (lookup->pending == 0)
+		dc_deliver(lookup);
+	else if (lookup->pending < nwant)
+	{
+		skew.tv_sec= DNSCACHE_SKEW;
+		skew.tv_usec= 0;
+		evtimer_add(&lookup->skew_timer, &skew);
+	}
+}
+
+void dnscache_flush(void)
+{
+	int i;
+	struct dc_rec *rec;
+
+	for (i= 0; i<DNSCACHE_HASH; i++)
+	{
+		while ((rec= dc_hash[i]) != NULL)
+		{
+			dc_hash[i]= rec->next;
+			dc_nrec--;
+
+			/* Queries in progress still answer their lookups */
+			if (rec->req || rec->busy)
+				rec->flushed= 1;
+			else
+				dc_drop(rec);
+		}
+	}
+
+	/* It may have changed too */
+	if (dc_hosts_base)
+		evdns_base_load_hosts(dc_hosts_base, DNSCACHE_HOSTS);
+}
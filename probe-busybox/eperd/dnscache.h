@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2026 RIPE NCC <atlas@ripe.net>
+ * Licensed under GPLv2 or later, see file LICENSE in this tarball for details.
+ * dnscache.h
+ */
+
+#include <event2/dns.h>
+
+/* Process-wide cache of A and AAAA answers in front of evdns. Answers are
+ * kept for their TTL, negative answers for the SOA minimum. Concurrent
+ * lookups of the same name share one query.
+ */
+#define DNSCACHE_MAX		256	/* Records */
+#define DNSCACHE_MAX_TTL	3600	/* Seconds */
+#define DNSCACHE_NEG_MAX_TTL	300
+#define DNSCACHE_SKEW		3	/* Wait for the other family (s) */
+
+/* Drop-in replacement for evdns_getaddrinfo. The callback may be called
+ * before this function returns. With nocache set, or for address
+ * literals, single-label names and hints with flags, the lookup is
+ * passed to evdns_getaddrinfo unchanged. Names in /etc/hosts are answered
+ * from there and not cached.
+ */
+void dnscache_getaddrinfo(struct evdns_base *base, const char *name,
+	const char *port, const struct evutil_addrinfo *hints, int nocache,
+	evdns_getaddrinfo_cb cb, void *arg);
+
+/* Forget all answers and reread /etc/hosts, for example after resolv.conf
+ * changed
+ */
+void dnscache_flush(void);
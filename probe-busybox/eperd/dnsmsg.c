@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2026 RIPE NCC <atlas@ripe.net>
+ * Licensed under GPLv2 or later, see file LICENSE in this tarball for details.
+ * dnsmsg.c
+ */
+
+#include "libbb.h"
+
+#include "dnsmsg.h"
+
+#define DNS_HEADER_LEN	12
+#define MAX_JUMPS	256
+
+static unsigned get16(const u_char *p)
+{
+	return (p[0] << 8) | p[1];
+}
+
+/* Return the offset just after the (possibly compressed) name at
+ * 'offset', or 0 if the name runs past the end of the message.
+ */
+static size_t skip_name(const struct dnsmsg *msg, size_t offset)
+{
+	unsigned len;
+
+	while (offset < msg->len)
+	{
+		len= msg->buf[offset];
+		if ((len & 0xc0) == 0xc0)
+		{
+			if (offset+2 > msg->len)
+				return 0;
+			return offset+2;
+		}
+		if (len & 0xc0)
+			return 0;	/* Bad format */
+		offset += len+1;
+		if (len == 0)
+			return offset;
+	}
+	return 0;
+}
+
+/* Returns -1 if the message is too short for a header */
+int dnsmsg_init(struct dnsmsg *msg, const u_char *buf, size_t len)
+{
+	if (len < DNS_HEADER_LEN)
+		return -1;
+	msg->buf= buf;
+	msg->len= len;
+	msg->offset= DNS_HEADER_LEN;
+	msg->id= get16(buf);
+	msg->flags= get16(buf+2);
+	msg->qdcount= get16(buf+4);
+	msg->ancount= get16(buf+6);
+	msg->nscount= get16(buf+8);
+	msg->arcount= get16(buf+10);
+	return 0;
+}
+
+/* Read the question at the cursor. Returns -1 if it is truncated. */
+int dnsmsg_question(struct dnsmsg *msg, struct dnsrr *rr)
+{
+	size_t o;
+
+	o= skip_name(msg, msg->offset);
+	if (o == 0 || o+4 > msg->len)
+		return -1;
+	rr->name_off= msg->offset;
+	rr->type= get16(msg->buf+o);
+	rr->class= get16(msg->buf+o+2);
+	rr->ttl= 0;
+	rr->rdata_off= 0;
+	rr->rdlen= 0;
+	msg->offset= o+4;
+	return 0;
+}
+
+/* Read the resource record at the cursor. Returns -1 if it is truncated. */
+int dnsmsg_rr(struct dnsmsg *msg, struct dnsrr *rr)
+{
+	size_t o;
+	const u_char *p;
+
+	o= skip_name(msg, msg->offset);
+	if (o == 0 || o+10 > msg->len)
+		return -1;
+	p= msg->buf+o;
+	rr->name_off= msg->offset;
+	rr->type= get16(p);
+	rr->class= get16(p+2);
+	rr->ttl= ((uint32_t)get16(p+4) << 16) | get16(p+6);
+	rr->rdlen= get16(p+8);
+	rr->rdata_off= o+10;
+	if (rr->rdata_off + rr->rdlen > msg->len)
+		return -1;
+	msg->offset= rr->rdata_off + rr->rdlen;
+	return 0;
+}
+
+/* Decompress the name at 'offset' into 'name' as dot separated labels,
+ * without a trailing dot. The root is the empty string. If 'endp' is not
+ * NULL, it is set to the offset just after the name in the message.
+ * Returns the length of the name or -1 for bad or truncated names and
+ * names that do not fit.
+ */
+int dnsmsg_name(const struct dnsmsg *msg, size_t offset, char *name,
+	size_t size, size_t *endp)
+{
+	unsigned len, jumps;
+	size_t p, end;
+
+	p= 0;
+	end= 0;
+	jumps= 0;
+	for (;;)
+	{
+		if (offset >= msg->len)
+			return -1;
+		len= msg->buf[offset];
+		if ((len & 0xc0) == 0xc0)
+		{
+			if (offset+2 > msg->len || ++jumps > MAX_JUMPS)
+				return -1;
+			if (end == 0)
+				end= offset+2;
+			offset= ((len & 0x3f) << 8) | msg->buf[offset+1];
+			continue;
+		}
+		if (len & 0xc0)
+			return -1;	/* Bad format */
+		if (len == 0)
+			break;
+		if (p > 0)
+			p++;		/* Dot */
+		if (offset+len+1 > msg->len || p+len+1 > size ||
+			p+len+1 > DNSMSG_NAMELEN-1)
+		{
+			return -1;
+		}
+		if (p > 0)
+			name[p-1]= '.';
+		memcpy(name+p, msg->buf+offset+1, len);
+		p += len;
+		offset += len+1;
+	}
+	if (end == 0)
+		end= offset+1;
+
+	name[p]= '\0';
+	if (endp)
+		*endp= end;
+	return p;
+}
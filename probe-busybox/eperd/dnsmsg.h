@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2026 RIPE NCC <atlas@ripe.net>
+ * Licensed under GPLv2 or later, see file LICENSE in this tarball for details.
+ * dnsmsg.h
+ */
+
+/* Longest name in presentation format, including the terminating zero */
+#define DNSMSG_NAMELEN	256
+
+/* A cursor over a DNS message. Nothing is copied, records refer to the
+ * message by offset.
+ */
+struct dnsmsg
+{
+	const u_char *buf;
+	size_t len;
+	size_t offset;			/* Next record */
+	unsigned id;
+	unsigned flags;
+	unsigned qdcount, ancount, nscount, arcount;
+};
+
+struct dnsrr
+{
+	size_t name_off;		/* Owner name, maybe compressed */
+	unsigned type;
+	unsigned class;
+	uint32_t ttl;			/* Zero for questions */
+	size_t rdata_off;		/* Zero for questions */
+	size_t rdlen;
+};
+
+int dnsmsg_init(struct dnsmsg *msg, const u_char *buf, size_t len);
+int dnsmsg_question(struct dnsmsg *msg, struct dnsrr *rr);
+int dnsmsg_rr(struct dnsmsg *msg, struct dnsrr *rr);
+int dnsmsg_name(const struct dnsmsg *msg, size_t offset, char *name,
+	size_t size, size_t *endp);
@@ -31,6 +31,7 @@
 #include <event2/dns.h>
 
 #include "eperd.h"
+#include "dnscache.h"
 #include "atlas_path.h"
 
 #define SUFFIX 		".curr"
@@ -688,6 +689,7 @@ static void check_resolv_conf2(const char *out_file, const char *atlasid)
 	r= evdns_base_resolv_conf_parse(DnsBase, DNS_OPTIONS_ALL,
 		resolv_conf);
 	evdns_base_resume(DnsBase);
+	dnscache_flush();
 
 	if ((r != 0 || last_time != -1) && out_file != NULL)
 	{
@@ -22,7 +22,7 @@
 
 //applet:IF_EPERD(APPLET(eperd, BB_DIR_ROOT, BB_SUID_DROP))
 
-//kbuild:lib-$(CONFIG_EPERD) += eooqd.o eperd.o condmv.o http2.o httpget.o ping.o sslgetcert.o traceroute.o evhttpget.o evping.o evsslgetcert.o evtdig.o evtraceroute.o tcputil.o readresolv.o evntp.o ntp.o
+//kbuild:lib-$(CONFIG_EPERD) += eooqd.o eperd.o condmv.o http2.o httpget.o ping.o sslgetcert.o traceroute.o evhttpget.o evping.o evsslgetcert.o evtdig.o evtraceroute.o tcputil.o readresolv.o evntp.o ntp.o icmperr.o dnsmsg.o dnscache.o certcache.o
 
 //usage:#define eperd_trivial_usage
 //usage:       "-fbSAD -P pidfile -l N -d N -L LOGFILE -c DIR"
@@ -48,6 +48,7 @@
 #include <event2/dns.h>
 
 #include "eperd.h"
+#include "dnscache.h"
 
 #define SAFE_PREFIX_REL ATLAS_DATA_NEW_REL
 
@@ -666,6 +667,7 @@ static void check_resolv_conf(void)
 	r= evdns_base_resolv_conf_parse(DnsBase, DNS_OPTIONS_ALL,
 		resolv_conf);
 	evdns_base_resume(DnsBase);
+	dnscache_flush();
 
 	if ((r != 0 || last_time != -1) && out_filename)
 	{
@@ -24,12 +24,13 @@
 //usage:       "[-ac0146] [--all [--combine]] [--get|--head|--post]"
 //usage:	"\n\t[--host <host>] [--post-file <file>] "
 //usage:	"[--post-header <file>]\n\t[--post-footer <file>] "
-//usage:	"[-read-limit <limit] [--store-body <bytes>]"
+//usage:	"[-read-limit <limit] [--store-body <bytes>] [--body-digest]"
 //usage:	"\n\t[--store-headers <bytes>] [--sni <sni>] "
-//usage:	"[--timeout <value>] "
-//usage:	"[--user-agent <string>]\n\t[--etim] [--etim] [-I interface] "
+//usage:	"[--timeout <value>] [--tls-resume] [--happy-eyeballs] "
+//usage:	"\n\t[--no-dns-cache] [--tcp-fastopen] [--user-agent <string>]"
+//usage:	"\n\t[--requests <n>] [--pipeline]\n\t[--etim] [--etim] [-I interface] "
 //usage:	"[-A <atlas id>] [-b <bundle id>]\n\t[-O <file>] "
-//usage:	"[-R <file>] [-W <file>]"
+//usage:	"[-R <file>] [-W <file>] <url> [<url>...]"
 //usage:#define evhttpget_full_usage "\n\n"
 //usage:     "\nOptions:"
 //usage:     "\n       -a --all                Report on all addresses"
@@ -44,9 +45,17 @@
 //usage:     "\n       --read-limit <limit>    Amount of body to read"
 //usage:     "\n       --store-body <bytes>    Number of bytes of the body to store"
 //usage:     "\n       --store-headers <bytes> Number of bytes of the header to store"
+//usage:     "\n       --body-digest           Report the SHA-256 digest of the body"
 //usage:     "\n       --sni <sni>             Service Name Identification"
 //usage:     "\n       --timeout <value>       Time (in ms) to wait between read calls"
+//usage:     "\n       --tls-resume            Resume TLS sessions of earlier connections"
+//usage:     "\n       --happy-eyeballs        Race connections to all addresses (RFC 8305)"
+//usage:     "\n       --no-dns-cache          Don't use the DNS cache"
+//usage:     "\n       --tcp-fastopen          Send the request in the SYN (TCP Fast Open)"
 //usage:     "\n       --user-agent <string>   User agent header"
+//usage:     "\n       --requests <n>          Requests on one connection, cycling through"
+//usage:     "\n                               the URLs (default one per URL)"
+//usage:     "\n       --pipeline              Send all requests at once"
 //usage:     "\n       --etim                  Extended timings"
 //usage:     "\n       --eetim                 Extended extended timings"
 //usage:     "\n       -0                      HTTP/1.0"
@@ -14,7 +14,7 @@
 //kbuild:lib-$(CONFIG_EVNTP) += evntp.o
 
 //usage:#define evntp_trivial_usage
-//usage:	"-[46] [-c <count>] [-i <interface>] [-w <timeout>]"
+//usage:	"-[46N] [-c <count>] [-i <interface>] [-w <timeout>]"
 //usage:	"\n\t[-A <Atlas ID>] [-B <bundle ID>] [-O <output file>]"
 //usage:	"\n\t[-R <response in>] [-W <response out>] [-s <size>] "
 //usage:	"<target>\n"
@@ -22,6 +22,7 @@
 //usage:       "\nOptions:"
 //usage:       "\n     -4              IPv4"
 //usage:       "\n     -6              IPv6"
+//usage:       "\n     -N              Don't use the DNS cache"
 //usage:       "\n     -c <count>      Number of packets"
 //usage:       "\n     -i <interface>  Outgoing interface"
 //usage:       "\n     -w <timeout>    Time to wait for reply"
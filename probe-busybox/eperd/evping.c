@@ -14,16 +14,19 @@
 //kbuild:lib-$(CONFIG_EVPING) += evping.o
 
 //usage:#define evping_trivial_usage
-//usage:	"-[46ep] [-c <count>] [-s <size>] [-A <Atlas ID>] "
+//usage:	"-[46epqQN] [-c <count>] [-s <size>] [-A <Atlas ID>] "
 //usage:	"[-B <bundle ID>\n\t[-O <output file>] [-i <interval>] "
 //usage:	"[-I <interface>] [-R <response in>]\n\t[-W <response out>] "
-//usage:	"<target>"
+//usage:	"[-H <rate>] <target>\n"
+//usage:	"   or: evping -M[g] [options] [-F <target file>] "
+//usage:	"[-P <pace>] <target>..."
 //usage:#define evping_full_usage "\n\n"
 //usage:       "\nOptions:"
 //usage:       "\n     -4              IPv4"
 //usage:       "\n     -6              IPv6"
 //usage:       "\n     -e              use the libc stub resolver"
 //usage:       "\n     -r              use the libevent resolver (default)"
+//usage:       "\n     -N              Don't use the DNS cache"
 //usage:       "\n     -c <count>      Number of packets"
 //usage:       "\n     -s <size>       Size"
 //usage:       "\n     -A <id>         Atlas measurement ID"
@@ -33,6 +36,13 @@
 //usage:       "\n     -I <interface>  Outgoing interface"
 //usage:       "\n     -R <response in> Read response from a file"
 //usage:       "\n     -W <response out> Write responses to a file"
+//usage:       "\n     -M              Ping multiple targets over one socket"
+//usage:       "\n     -g              One result for all targets (with -M)"
+//usage:       "\n     -F <file>       Read targets from a file (with -M)"
+//usage:       "\n     -P <pace>       Time between packets to different targets"
+//usage:       "\n     -H <rate>       High-rate mode, packets per second"
+//usage:       "\n     -q              Only report an RTT summary (not with -M)"
+//usage:       "\n     -Q              Report an RTT summary as well (not with -M)"
 //usage:       "\n"
 
 #include "libbb.h"
@@ -10,7 +10,7 @@
 //kbuild:lib-$(CONFIG_EVSSLGETCERT) += evsslgetcert.o
 
 //usage:#define evsslgetcert_trivial_usage
-//usage:	"-[46] [-A <Atlas ID>] [-B <bundle ID>] [-h <host name>]"
+//usage:	"-[46CN] [-A <Atlas ID>] [-B <bundle ID>] [-h <host name>]"
 //usage:	"\n\t[-O <output file>] [-R <response in>] [-V <version>] "
 //usage:	"\n\t[-W <response out>] [-i <interface>] [-p <port>] "
 //usage:	"<target>\n"
@@ -18,6 +18,8 @@
 //usage:       "\nOptions:"
 //usage:       "\n     -4              IPv4"
 //usage:       "\n     -6              IPv6"
+//usage:       "\n     -C              Report a known chain by SHA-256 fingerprints"
+//usage:       "\n     -N              Don't use the DNS cache"
 //usage:       "\n     -A <id>         Atlas measurement ID"
 //usage:       "\n     -B <id>         bundle ID"
 //usage:       "\n     -h <host name>  Host name for SNI"
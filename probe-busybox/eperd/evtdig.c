@@ -53,9 +53,12 @@
 //usage:	"[--read-response <name>]"
 //usage:	"\n\t[--resolv]"
 //usage:	"[--retry <count>]"
-//usage:	"[--sni-cert-name <name>]"
-//usage:	"\n\t[--timeout <ms>]"
-//usage:	"[--tls]"
+//usage:	"[--reuse-conn <idle>]"
+//usage:	"\n\t[--sni-cert-name <name>]"
+//usage:	"[--tcp-fastopen]"
+//usage:	"[--timeout <ms>]"
+//usage:	"\n\t[--tls]"
+//usage:	"[--tls-resume]"
 //usage:	"[--ttl]"
 //usage:	"[--write-response <name>]"
 //usage:	"\n\t[--type <type>][--class <class>][--query <name>]"
@@ -95,7 +98,7 @@
 //usage:	"[--id.server]"
 //usage:	"[--version.bind]"
 //usage:	"[--version.server]"
-//usage:	"\n\t[<server>]"
+//usage:	"\n\t[<server>] [-- <options> [<server>]]..."
 //usage:#define evtdig_full_usage "\n\n"
 //usage:	"\nOptions:"
 //usage:	"\n\t-4                  Restrict to IPv4"
@@ -127,9 +130,12 @@
 //usage:	"\n\t--read-response <name>    Read responses"
 //usage:	"\n\t--resolv            Use system resolvers as targets"
 //usage:	"\n\t--retry <count>     Retry query count times"
+//usage:	"\n\t--reuse-conn <idle> Keep TCP/TLS/HTTPS connections open for idle seconds"
 //usage:	"\n\t--sni-cert-name <name> Name to check in cert and SNI"
+//usage:	"\n\t--tcp-fastopen      Send the query in the SYN (TCP Fast Open)"
 //usage:	"\n\t--timeout <ms>      Timeout waiting for reply"
 //usage:	"\n\t--tls               Connect using TLS"
+//usage:	"\n\t--tls-resume        Resume TLS sessions of earlier connections"
 //usage:	"\n\t--ttl               Report TTL of reply"
 //usage:	"\n\t--write-response <name>   Write responses"
 //usage:	"\n\t--type <type>       Query type"
@@ -171,6 +177,9 @@
 //usage:	"\n\t-i|--id.server      CHAOS TXT id.server query"
 //usage:	"\n\t-b|--version.bind   CHAOS TXT version.bind query"
 //usage:	"\n\t-r|--version.server CHAOS TXT version.server query"
+//usage:	"\n"
+//usage:	"\nQueries separated by -- are started a second apart in the same"
+//usage:	"\nprocess, so they can share a connection (--reuse-conn)"
 
 #include "libbb.h"
 #include "atlas_bb64.h"
@@ -190,6 +199,7 @@
 #include "tcputil.h"
 #include "http2.h"
 #include "atlas_path.h"
+#include "dnsmsg.h"
 
 #include <event2/event.h>
 #include <event2/event_struct.h>
@@ -204,6 +214,11 @@
 #define JS(key, val) snprintf(line, DEFAULT_LINE_LENGTH, "\"" #key"\" : \"%s\" , ",  val), ADDRESULT  
 #define JS_NC(key, val) snprintf(line, DEFAULT_LINE_LENGTH,"\"" #key"\" : \"%s\" ",  val), ADDRESULT 
 #define JSDOT(key, val) snprintf(line, DEFAULT_LINE_LENGTH, "\"" #key"\" : \"%s.\" , ",  val), ADDRESULT
+/* Names can be longer than 'line' and labels can hold any byte */
+#define JSNAME(key, val) AS("\"" #key "\" : \""), add_name_quoted(qry, val), \
+	AS("\" , ")
+#define JSNAMEDOT(key, val) AS("\"" #key "\" : \""), \
+	add_name_quoted(qry, val), AS(".\" , ")
 #define JS1(key, fmt, val) snprintf(line, DEFAULT_LINE_LENGTH, "\"" #key"\" : "#fmt" , ",  val), ADDRESULT
 #define JD(key, val) snprintf(line, DEFAULT_LINE_LENGTH, "\"" #key"\" : %d , ",  val), ADDRESULT
 #define JD_NC(key, val) snprintf(line, DEFAULT_LINE_LENGTH, "\"" #key"\" : %d ",  val), ADDRESULT
@@ -238,6 +253,9 @@
 #define O_HTTPS 1014
 #define O_SNI_CERT_NAME 1015
 #define O_HTTPS_PATH 1016
+#define O_REUSE_CONN 1017
+#define O_TLS_RESUME 1018
+#define O_TFO 1019
 
 #define DNS_FLAG_RD 0x0100
 
@@ -257,6 +275,14 @@
 #define CONN_TO            5  /* TCP connection time out in seconds */
 #define DEFAULT_RETRY_MAX 0 
 
+/* UDP sockets are shared between queries to the same server. A socket is
+ * retired after UDP_POOL_MAXUSE queries to get a new random source port and
+ * is closed when it has been idle for UDP_POOL_IDLE seconds.
+ */
+#define UDP_POOL_HASH		64
+#define UDP_POOL_MAXUSE		100
+#define UDP_POOL_IDLE		60	/* in seconds */
+
 /* state of the dns query */
 #define STATUS_DNS_RESOLV 		1001
 #define STATUS_TCP_CONNECTING 		1002
@@ -419,6 +445,9 @@
 #define RESP_TIMEOUT		 9
 #define RESP_ADDRINFO		10
 #define RESP_ADDRINFO_SA	11
+#define RESP_QUERY		12
+
+#define REPLAY_CHUNK		4096	/* Max. RESP_DATA of a shared connection */
 
 
 /* Definition for various types of counters */
@@ -435,6 +464,74 @@ struct dns_cookie_state
 	} server_cookies[MAXNS];
 };
 
+/* A connected UDP socket in the pool */
+struct udp_sock
+{
+	struct udp_sock *next;		/* Hash chain */
+	struct tdig_base *base;
+	int fd;
+	struct event event;
+	int retired;			/* No longer in the hash table */
+	unsigned uses;			/* Number of queries sent */
+	time_t idle_since;
+	struct query_state *waiting;	/* Queries that expect a reply */
+
+	/* Key */
+	struct sockaddr_storage server;
+	socklen_t server_len;
+	char *infname;
+	int ipv6_dest_option;
+	bool do_ttl;
+
+	/* Local address, from getsockname */
+	struct sockaddr_in6 loc_sin6;
+	socklen_t loc_socklen;
+};
+
+/* A TCP, TLS or HTTPS connection that is kept open between queries
+ * (--reuse-conn). Queries are pipelined, replies are matched on query ID
+ * and question. For DoH each query gets its own HTTP/2 stream, connections
+ * are also keyed on the path.
+ */
+struct tcp_conn
+{
+	struct tcp_conn *next;
+	struct tdig_base *base;
+	struct bufferevent *bev;
+	struct event idle_timer;
+	unsigned idle;			/* in seconds */
+	struct query_state *waiting;	/* Queries that expect a reply */
+
+	/* Key */
+	char *server_name;
+	char *port;
+	char *sni_cert_name;
+	char *infname;
+	bool do_tls;
+	bool do_https;
+	char *https_path;
+	int v4_only;
+	int v6_only;
+
+	struct http2_env *http2_env;	/* DoH streams */
+
+	/* Recording or replaying responses. The connection owns the
+	 * response file of the query that opened it. A replayed connection
+	 * gets its input from replay_bev.
+	 */
+	FILE *resp_file;
+	int replay;
+	size_t recorded;		/* Input bytes written to resp_file */
+	struct bufferevent *replay_bev;
+	struct event replay_timer;
+
+	/* Reported with every query */
+	char dst_addr_str[(INET6_ADDRSTRLEN+1)];
+	unsigned short dst_ai_family;
+	struct sockaddr_in6 loc_sin6;
+	socklen_t loc_socklen;
+};
+
 /* How to keep track of a DNS query session */
 struct tdig_base {
 	struct event_base *event_base;
@@ -456,6 +553,14 @@ struct tdig_base {
 	counter_t queries; 	
 	counter_t activeqry;
 
+	/* Pool of UDP sockets, hashed on the server address */
+	struct udp_sock *udp_pool[UDP_POOL_HASH];
+	unsigned udp_pool_count;
+	struct event udp_pool_timer;
+
+	/* TCP, TLS and HTTPS connections that can be reused */
+	struct tcp_conn *tcp_conns;
+
 	u_char packet [MAX_DNS_BUF_SIZE] ;
 	/* used only for the stand alone version */
 	void (*done)(void *state, int error);
@@ -471,7 +576,11 @@ struct query_state {
 	char * infname;		    /* Bind to this interface (or address) */
 	u_int16_t qryid;            /* query id 16 bit */
 	struct event event;         /* Used to detect read events on udp socket   */
-	int udp_fd;		    /* udp_fd */
+	int udp_fd;		    /* Only when replaying responses */
+	struct udp_sock *usock;	    /* Socket from the pool */
+	struct query_state *usock_next, *usock_prev;
+	u_char qsect[NS_MAXCDNAME+4]; /* Question section, to match replies */
+	int qsect_len;
 	int wire_size;
 	struct dns_cookie_state *cookie_state;
 
@@ -502,15 +611,22 @@ struct query_state {
 	int opt_rset;
 	int opt_retry_max;
 	int opt_query_arg;
+	unsigned opt_reuse_conn;	/* Idle timeout, 0 is no reuse */
 	unsigned opt_timeout;
 	int retry;
 	int resolv_i;
 	bool opt_do_tls;
 	bool opt_do_ttl;
 	bool opt_do_https;
+	bool opt_tls_resume;
+	bool opt_tfo;
 	char *sni_cert_name;
 	char *https_path;
 	bool client_cookie_mismatch;
+	bool conn_reused;
+	bool tls_resumed;
+	struct tcp_conn *conn;
+	struct query_state *conn_next, *conn_prev;
 
 	char * str_Atlas; 
 	char * str_bundle; 
@@ -567,6 +683,7 @@ struct query_state {
 
 	/* For DNS over HTTP2 */
 	struct http2_env *http2_env;
+	uint32_t h2_stream;		/* On a shared DoH connection */
 
 	u_char *outbuff;
 
@@ -657,25 +774,6 @@ struct QUESTION
 	u_int16_t qclass;
 };
 
-//Constant sized fields of the resource record structure
-#pragma pack(push, 1)
-struct R_DATA
-{
-	u_int16_t type;
-	u_int16_t _class;
-	u_int32_t ttl;
-	u_int16_t data_len;
-};
-#pragma pack(pop)
-
-//Pointers to resource record contents
-struct RES_RECORD
-{
-	unsigned char *name;
-	struct R_DATA *resource;
-	unsigned char *rdata;
-};
-
 static struct option longopts[]=
 {
 	// class IN
@@ -744,6 +842,9 @@ static struct option longopts[]=
 	{ "sni-cert-name", required_argument, NULL, O_SNI_CERT_NAME },
 	{ "https-path", required_argument, NULL, O_HTTPS_PATH },
 	{ "ttl", no_argument, NULL, O_TTL },
+	{ "reuse-conn", required_argument, NULL, O_REUSE_CONN },
+	{ "tls-resume", no_argument, NULL, O_TLS_RESUME },
+	{ "tcp-fastopen", no_argument, NULL, O_TFO },
 
 	{ "edns0", required_argument, NULL, 'e' },
 	{ "edns-flags", required_argument, NULL, '2' },
@@ -770,6 +871,7 @@ void tdig_start (void *qry);
 void printReply(struct query_state *qry, int wire_size, unsigned char *result);
 void printErrorQuick (struct query_state *qry);
 static void local_exit(void *state, int error);
+static void start_query(int unused, const short event, void *qry);
 static void *tdig_init(int argc, char *argv[],
 	void (*done)(void *state, int error));
 static void process_reply(void * arg, int nrecv, struct timespec now,
@@ -787,24 +889,44 @@ static void udp_dns_cb(int err, struct evutil_addrinfo *ev_res, void *arg);
 static void noreply_callback(int unused  UNUSED_PARAM, const short event UNUSED_PARAM, void *h);
 static void free_qry_inst(struct query_state *qry);
 static void ready_callback (int unused, const short event, void * arg);
+static void save_question(struct query_state *qry, u_char *packet,
+	int len);
+static int udp_pool_attach(struct query_state *qry);
+static void udp_pool_detach(struct query_state *qry);
+static void udp_pool_callback(int fd, const short event, void *arg);
+static void udp_pool_sweep(int unused, const short event, void *arg);
+static void udp_reply(struct query_state *qry, int nrecv,
+	struct timespec rectime, struct msghdr *msgp);
+static int match_reply(struct query_state *qry, u_char *packet, int len);
+static int tcp_reuse(struct query_state *qry);
+static struct tcp_conn *tcp_conn_find(struct query_state *qry);
+static struct tcp_conn *tcp_conn_new(struct query_state *qry,
+	struct bufferevent *bev);
+static void tcp_conn_send(struct tcp_conn *conn, struct query_state *qry);
+static void tcp_conn_close(struct tcp_conn *conn, const char *reason);
+static void tcp_conn_detach(struct query_state *qry);
+static void tcp_conn_timeout(struct query_state *qry);
 
 u_int32_t get32b (unsigned char *p);
 void ldns_write_uint16(void *dst, uint16_t data);
 uint16_t ldns_read_uint16(const void *src);
-unsigned char* ReadName(unsigned char *base, size_t size, size_t offset,
-        int* count);
-int dns_namelen(unsigned char *base, size_t offset, size_t size);
 
 void print_txt_json(unsigned char *rdata, int txt_len,struct query_state *qry);
+static void add_name_quoted(struct query_state *qry, const char *name);
 
 static void http2_reply_cb(void *ref, unsigned status,
 	u_char *data, size_t len);
 static void https_write_response(void *ref, void *buf, size_t len);
 static size_t https_read_response(void *ref, void *buf, size_t len);
 
+static int nqueries, ndone;
+
 int evtdig_main(int argc, char **argv) MAIN_EXTERNALLY_VISIBLE;
 int evtdig_main(int argc, char **argv) 
 { 
+	int i, j;
+	char **qry_argv;
+	struct timeval start;
 	struct query_state *qry;
 
 	EventBase=event_base_new();
@@ -813,13 +935,6 @@ int evtdig_main(int argc, char **argv)
 		crondlog(LVL9 "ERROR: critical event_base_new failed"); /* exits */
 	}
 
-	qry = tdig_init(argc, argv, local_exit);
-	if(!qry) {
-		crondlog(DIE9 "ERROR: critical tdig_init failed"); /* exits */
-		event_base_free	(EventBase);
-		return 1;
-	}
-
 	DnsBase = evdns_base_new(EventBase, 1);
 	if (!DnsBase) {
 		crondlog(DIE9 "ERROR: critical evdns_base_new failed"); /* exits */
@@ -827,7 +942,30 @@ int evtdig_main(int argc, char **argv)
 		return 1;
 	}
 
-	tdig_start(qry);  
+	/* Queries separated by -- start a second apart, each with its own
+	 * argument vector.
+	 */
+	qry_argv= xzalloc((argc+1) * sizeof(*qry_argv));
+	for (i= 1; i <= argc; i++)
+	{
+		qry_argv[0]= argv[0];
+		for (j= 1; i < argc && strcmp(argv[i], "--") != 0; i++, j++)
+			qry_argv[j]= argv[i];
+		qry_argv[j]= NULL;
+
+		qry = tdig_init(j, qry_argv, local_exit);
+		if(!qry) {
+			crondlog(DIE9 "ERROR: critical tdig_init failed"); /* exits */
+			event_base_free	(EventBase);
+			return 1;
+		}
+		start.tv_sec= nqueries;
+		start.tv_usec= 0;
+		event_base_once(EventBase, -1, EV_TIMEOUT, start_query, qry,
+			&start);
+		nqueries++;
+	}
+	free(qry_argv);
 	// printf ("starting query\n");
 
 	event_base_dispatch (EventBase);
@@ -874,6 +1012,43 @@ void print_txt_json(unsigned char *rdata, int txt_len,struct query_state *qry)
         AS("\" ] ");
 }
 
+/* Add a name to the result, escaped as in add_str_quoted in httpget.c.
+ * Plain runs are added in one go.
+ */
+static void add_name_quoted(struct query_state *qry, const char *name)
+{
+	unsigned char c;
+	const char *p, *q;
+	char buf[20];
+
+	for (p= name; *p; p= q+1)
+	{
+		for (q= p; *q; q++)
+		{
+			c= *q;
+			if (c == '"' || c == '\\' || !isprint_asciionly(c))
+				break;
+		}
+		if (q > p)
+			buf_add(&qry->result, p, q-p);
+		if (!*q)
+			break;
+
+		c= *q;
+		if (c == '"' || c == '\\')
+			snprintf(buf, sizeof(buf), "\\%c", c);
+		else
+			snprintf(buf, sizeof(buf), "\\u%04x", c);
+		AS(buf);
+	}
+}
+
+static void start_query(int unused UNUSED_PARAM,
+	const short event UNUSED_PARAM, void *qry)
+{
+	tdig_start(qry);
+}
+
 static void local_exit(void *state UNUSED_PARAM, int error)
 {
 	/*
@@ -894,7 +1069,9 @@ static void local_exit(void *state UNUSED_PARAM, int error)
 	   event_base_free(event_base);
 	   terminator(qry);
 	*/
-	exit(error);
+	ndone++;
+	if (error || ndone >= nqueries)
+		exit(error);
 }
 
 
@@ -1231,8 +1408,7 @@ static int mk_dns_buff(struct query_state *qry,  u_char *packet,
 /* Attempt to transmit a UDP DNS Request to a server. TCP is else where */
 static void tdig_send_query_callback(int unused UNUSED_PARAM, const short event UNUSED_PARAM, void *h)
 {
-	int r, fd, on;
-	sa_family_t af;
+	int r, fd;
 	struct query_state *qry = h;
 	struct tdig_base *base = qry->base;
 	uint32_t nsent = 0;
@@ -1252,12 +1428,8 @@ static void tdig_send_query_callback(int unused UNUSED_PARAM, const short event
 	qry->xmit_time= atlas_time();
 
 	do {
-		if (!qry->response_in && qry->udp_fd != -1)
-		{
-			event_del(&qry->event);
-			close(qry->udp_fd);
-			qry->udp_fd= -1;
-		}
+		if (qry->usock)
+			udp_pool_detach(qry);
 
 		if (qry->response_in)
 		{
@@ -1293,67 +1465,6 @@ static void tdig_send_query_callback(int unused UNUSED_PARAM, const short event
 				qry->res->ai_addrlen, qry->res->ai_addr);
 		}
 
-		af = ((struct sockaddr *)(qry->res->ai_addr))->sa_family;
-
-		if (!qry->response_in)
-		{
-			if ((fd = socket(af, SOCK_DGRAM, 0) ) < 0 )
-			{
-				snprintf(line, DEFAULT_LINE_LENGTH,
-					"%s \"socket\" : \"socket failed %s\"",
-					qry->err.size ? ", " : "",
-					strerror(errno));
-				buf_add(&qry->err, line, strlen(line));
-				printReply (qry, 0, NULL);
-				free (outbuff);
-				outbuff = NULL;
-				return;
-			} 
-		}
-
-		if (af == AF_INET6 && qry->opt_ipv6_dest_option != 0)
-		{
-			do_ipv6_option(fd, 1 /* dest */,
-				qry->opt_ipv6_dest_option);
-		}
-
-		if (qry->opt_do_ttl)
-		{
-			on = 1;
-			if (af == AF_INET6) {
-				setsockopt(fd, IPPROTO_IPV6, IPV6_RECVHOPLIMIT,
-					&on, sizeof(on));
-			}
-			else {
-				setsockopt(fd, IPPROTO_IP, IP_RECVTTL,
-					&on, sizeof(on));
-			}
-		}
-
-		qry->udp_fd= fd;
-
-		evutil_make_socket_nonblocking(fd); 
-
-		event_assign(&qry->event, tdig_base->event_base, fd, 
-			EV_READ | EV_PERSIST, ready_callback, qry);
-		if (!qry->response_in)
-			event_add(&qry->event, NULL);
-
-		if (qry->infname)
-		{
-			if (bind_interface(fd, af, qry->infname) == -1)
-			{
-				snprintf(line, DEFAULT_LINE_LENGTH,
-					"%s \"socket\" : \"bind_interface failed\"",
-					qry->err.size ? ", " : "");
-				buf_add(&qry->err, line, strlen(line));
-				printReply (qry, 0, NULL);
-				free (outbuff);
-				outbuff = NULL;
-				return;
-			}
-		}
-
 		if (!qry->opt_resolv_conf)
 		{
 			r= atlas_check_addr(qry->res->ai_addr,
@@ -1375,6 +1486,20 @@ static void tdig_send_query_callback(int unused UNUSED_PARAM, const short event
 			}
 		}
 
+		if (qry->response_in)
+		{
+			qry->udp_fd= fd;
+			event_assign(&qry->event, tdig_base->event_base, fd, 
+				EV_READ | EV_PERSIST, ready_callback, qry);
+		}
+		else if (udp_pool_attach(qry) == -1)
+		{
+			printReply (qry, 0, NULL);
+			free (outbuff);
+			outbuff = NULL;
+			return;
+		}
+
 		if (qry->opt_resolv_conf && strcmp(qry->macro_lookupname,
 			qry->lookupname) != 0)
 		{
@@ -1389,22 +1514,6 @@ static void tdig_send_query_callback(int unused UNUSED_PARAM, const short event
 			qry->lookupname=
 				atlas_name_macro(qry->macro_lookupname);
 		}
-		qry->loc_socklen = sizeof(qry->loc_sin6);
-		if (qry->response_in)
-			;	/* No need to connect */
-		else if (connect(qry->udp_fd, qry->res->ai_addr, qry->res->ai_addrlen) == -1)
-		{
-				snprintf(line, DEFAULT_LINE_LENGTH,
-					"%s \"socket\" : \"connect failed %s\"",
-					qry->err.size ? ", " : "",
-					strerror(errno));
-				buf_add(&qry->err, line, strlen(line));
-				printReply (qry, 0, NULL);
-				free (outbuff);
-				outbuff = NULL;
-				return;
-		}
-
 		if (qry->response_in)
 		{
 			size_t tmp_len;
@@ -1416,15 +1525,8 @@ static void tdig_send_query_callback(int unused UNUSED_PARAM, const short event
 		}
 		else
 		{
-			if (getsockname(qry->udp_fd,
-				(struct sockaddr *)&qry->loc_sin6,
-				&qry->loc_socklen)  == -1) {
-				snprintf(line, DEFAULT_LINE_LENGTH,
-					"%s \"getsockname\" : \"%s\"",
-					qry->err.size ? ", " : "",
-					strerror(errno));
-				buf_add(&qry->err, line, strlen(line));
-			}
+			qry->loc_sin6= qry->usock->loc_sin6;
+			qry->loc_socklen= qry->usock->loc_socklen;
 			if (qry->response_out)
 			{
 				write_response(qry->resp_file,
@@ -1455,13 +1557,15 @@ static void tdig_send_query_callback(int unused UNUSED_PARAM, const short event
 			return;
 		}
 
+		save_question(qry, outbuff, qry->pktsize);
+
 		gettime_mono(&qry->xmit_time_ts);
 
 		if (qry->response_in)
 			nsent= qry->pktsize;
 		else
 		{
-			nsent = send(qry->udp_fd, outbuff,qry->pktsize,
+			nsent = send(qry->usock->fd, outbuff,qry->pktsize,
 				MSG_DONTWAIT);
 		}
 		qry->ressent = qry->res;
@@ -1525,7 +1629,9 @@ static void noreply_callback(int unused  UNUSED_PARAM, const short event UNUSED_
 	snprintf(line, DEFAULT_LINE_LENGTH, "%s \"timeout\" : %d", qry->err.size ? ", " : "", qry->opt_timeout);
 	buf_add(&qry->err, line, strlen(line));
 
-	if (qry->response_in)
+	if (qry->conn)
+		tcp_conn_timeout(qry);
+	else if (qry->response_in)
 	{
 		size_t tmp_len;
 
@@ -1542,7 +1648,7 @@ static void noreply_callback(int unused  UNUSED_PARAM, const short event UNUSED_
 				&tmp_len, NULL);
 		}
 	}
-	if (qry->response_out)
+	if (qry->response_out && !qry->conn)
 		write_response(qry->resp_file, RESP_TIMEOUT, 0, NULL);
 
 	//BLURT(LVL5 "AAA timeout for %s retry %d/%d ", qry->server_name, qry->retry,  qry->opt_retry_max);
@@ -1665,9 +1771,11 @@ static void tcp_connected(struct tu_env *env, struct bufferevent *bev)
 	uint16_t payload_len ;
 	u_char *outbuff;	
 	u_char *wire;
+	struct tcp_conn *conn;
 	struct query_state * qry; 
 	qry = ENV2QRY(env); 
 
+	qry->tls_resumed= env->tls_resumed;
 	qry->loc_socklen= sizeof(qry->loc_sin6);
 	if (qry->response_in)
 	{
@@ -1689,6 +1797,15 @@ static void tcp_connected(struct tu_env *env, struct bufferevent *bev)
 		}
 	}
 
+	if (tcp_reuse(qry))
+	{
+		/* The connection is no longer owned by tu_env */
+		conn= tcp_conn_new(qry, bev);
+		env->bev= NULL;
+		tcp_conn_send(conn, qry);
+		return;
+	}
+
 	qry->bev_tcp =  bev;
 	outbuff = xzalloc(MAX_DNS_OUT_BUF_SIZE);
 	bzero(outbuff, MAX_DNS_OUT_BUF_SIZE);
@@ -1700,7 +1817,7 @@ static void tcp_connected(struct tu_env *env, struct bufferevent *bev)
 		http2_dns(qry->http2_env, qry->bev_tcp, qry->sni_cert_name,
 			qry->port_as_char,
 			qry->https_path ? qry->https_path : "/dns-query",
-			outbuff, payload_len);
+			outbuff, payload_len, env);
 		wire= NULL;
 	}
 	else
@@ -1916,6 +2033,16 @@ static void http2_reply_cb(void *ref, unsigned status,
 
 	gettime_mono(&rectime);
 
+	if (status == 200 && len < sizeof(struct DNS_HEADER))
+	{
+		bzero(line, DEFAULT_LINE_LENGTH);
+		snprintf(line, DEFAULT_LINE_LENGTH,
+			" %s \"error\" : \"http2 reply too short\"",
+			qry->err.size ? ", " : "");
+		buf_add(&qry->err, line, strlen(line));
+		printReply (qry, 0, NULL);
+		return;
+	}
 	if (status != 200)
 	{
 		bzero(line, DEFAULT_LINE_LENGTH);
@@ -1958,6 +2085,436 @@ static void tcp_writecb(struct bufferevent *bev UNUSED_PARAM, void *ptr UNUSED_P
 	// BLURT(LVL5 "TCP writecb");
 }
 
+static int tcp_reuse(struct query_state *qry)
+{
+	return qry->opt_reuse_conn;
+}
+
+static int same_str(const char *a, const char *b)
+{
+	if (a == NULL || b == NULL)
+		return a == b;
+	return strcmp(a, b) == 0;
+}
+
+static struct tcp_conn *tcp_conn_find(struct query_state *qry)
+{
+	struct tcp_conn *conn;
+
+	for (conn= qry->base->tcp_conns; conn; conn= conn->next)
+	{
+		if (same_str(conn->server_name, qry->server_name) &&
+			same_str(conn->port, qry->port_as_char) &&
+			same_str(conn->sni_cert_name, qry->sni_cert_name) &&
+			same_str(conn->infname, qry->infname) &&
+			conn->do_tls == qry->opt_do_tls &&
+			conn->do_https == qry->opt_do_https &&
+			same_str(conn->https_path, qry->https_path ?
+				qry->https_path : "/dns-query") &&
+			conn->v4_only == qry->opt_v4_only &&
+			conn->v6_only == qry->opt_v6_only &&
+			(!conn->http2_env || http2_dns_avail(conn->http2_env)))
+		{
+			return conn;
+		}
+	}
+	return NULL;
+}
+
+static void tcp_conn_free(struct tcp_conn *conn)
+{
+	struct tcp_conn **connp;
+
+	for (connp= &conn->base->tcp_conns; *connp; connp= &(*connp)->next)
+	{
+		if (*connp == conn)
+		{
+			*connp= conn->next;
+			break;
+		}
+	}
+
+	event_del(&conn->idle_timer);
+	if (conn->http2_env)
+		http2_free(conn->http2_env);
+	bufferevent_free(conn->bev);
+	if (conn->replay_bev)
+	{
+		event_del(&conn->replay_timer);
+		bufferevent_free(conn->replay_bev);
+	}
+	if (conn->resp_file)
+		fclose(conn->resp_file);
+	free(conn->server_name);
+	free(conn->port);
+	free(conn->sni_cert_name);
+	free(conn->infname);
+	free(conn->https_path);
+	free(conn);
+}
+
+static void tcp_conn_idle(int unused UNUSED_PARAM,
+	const short event UNUSED_PARAM, void *arg)
+{
+	tcp_conn_free(arg);
+}
+
+/* Replies can arrive in any order */
+static void tcp_conn_readcb(struct bufferevent *bev, void *ptr)
+{
+	int r;
+	size_t len;
+	u_char b2[2], *data;
+	struct timespec rectime;
+	struct evbuffer *input;
+	struct tcp_conn *conn;
+	struct query_state *qry;
+
+	conn= ptr;
+	input= bufferevent_get_input(bev);
+
+	/* Record what is new since the last call, partial messages stay in
+	 * the input.
+	 */
+	len= evbuffer_get_length(input);
+	if (conn->resp_file && !conn->replay && len > conn->recorded)
+	{
+		data= evbuffer_pullup(input, len);
+		for (; conn->recorded < len; conn->recorded += r)
+		{
+			r= len-conn->recorded;
+			if (r > REPLAY_CHUNK)
+				r= REPLAY_CHUNK;
+			write_response(conn->resp_file, RESP_DATA, r,
+				data+conn->recorded);
+		}
+	}
+
+	if (conn->http2_env)
+	{
+		/* Replies are dispatched by stream */
+		while ((r= http2_dns_input(conn->http2_env, bev,
+			http2_reply_cb, conn, NULL, NULL)) == 0)
+		{
+		}
+		if (r == -1)
+		{
+			tcp_conn_close(conn, "http2_dns_input failed");
+			return;
+		}
+		conn->recorded= evbuffer_get_length(input);
+		return;
+	}
+
+	gettime_mono(&rectime);
+
+	for (;;)
+	{
+		if (evbuffer_copyout(input, b2, sizeof(b2)) != sizeof(b2))
+			break;
+		len= ldns_read_uint16(b2);
+		if (evbuffer_get_length(input) < sizeof(b2) + len)
+			break;
+		data= evbuffer_pullup(input, sizeof(b2) + len) + sizeof(b2);
+
+		qry= NULL;
+		if (len >= sizeof(struct DNS_HEADER))
+		{
+			for (qry= conn->waiting; qry; qry= qry->conn_next)
+			{
+				if (match_reply(qry, data, len))
+					break;
+			}
+		}
+		if (qry)
+		{
+			qry->triptime = (rectime.tv_sec -
+				qry->xmit_time_ts.tv_sec)*1000 +
+				(rectime.tv_nsec -
+				qry->xmit_time_ts.tv_nsec)/1e6;
+			qry->querytime = (rectime.tv_sec -
+				qry->qxmit_time_ts.tv_sec)*1000 +
+				(rectime.tv_nsec -
+				qry->qxmit_time_ts.tv_nsec)/1e6;
+			printReply (qry, len, data);
+		}
+		else
+			conn->base->martian++;
+
+		evbuffer_drain(input, sizeof(b2) + len);
+	}
+	conn->recorded= evbuffer_get_length(input);
+}
+
+/* Queries that were sent on a replayed connection are answered from the
+ * response file, up to the point where the next query was sent.
+ */
+static void tcp_conn_replay(int unused UNUSED_PARAM,
+	const short event UNUSED_PARAM, void *arg)
+{
+	int type;
+	unsigned pos;
+	size_t len;
+	u_char buf[REPLAY_CHUNK];
+	struct timeval asap= { 0, 0 };
+	struct tcp_conn *conn;
+	struct query_state *qry;
+
+	conn= arg;
+	if (!conn->waiting)
+		return;
+
+	peek_response_file(conn->resp_file, &type);
+	if (type == RESP_QUERY)
+		return;		/* Wait for tcp_conn_send */
+
+	/* One record at a time, the connection may be gone after it */
+	evtimer_add(&conn->replay_timer, &asap);
+
+	if (type == RESP_TIMEOUT)
+	{
+		len= sizeof(pos);
+		read_response_file(conn->resp_file, RESP_TIMEOUT, &len, &pos);
+		for (qry= conn->waiting; qry && pos > 0; qry= qry->conn_next)
+			pos--;
+		if (qry)
+			noreply_callback(0, 0, qry);
+		return;
+	}
+
+	/* The pair calls tcp_conn_readcb before bufferevent_write returns */
+	len= sizeof(buf);
+	read_response_file(conn->resp_file, RESP_DATA, &len, buf);
+	bufferevent_write(conn->replay_bev, buf, len);
+}
+
+/* Queries written to a replayed connection are not checked */
+static void tcp_conn_drain(struct bufferevent *bev, void *ptr UNUSED_PARAM)
+{
+	struct evbuffer *input;
+
+	input= bufferevent_get_input(bev);
+	evbuffer_drain(input, evbuffer_get_length(input));
+}
+
+/* Timeouts are recorded with the position of the query in the list of
+ * waiting queries.
+ */
+static void tcp_conn_timeout(struct query_state *qry)
+{
+	unsigned pos;
+	struct tcp_conn *conn;
+	struct query_state *q;
+
+	conn= qry->conn;
+	if (!conn->resp_file || conn->replay)
+		return;
+
+	pos= 0;
+	for (q= conn->waiting; q && q != qry; q= q->conn_next)
+		pos++;
+	write_response(conn->resp_file, RESP_TIMEOUT, sizeof(pos), &pos);
+}
+
+/* Queries that are still waiting fail, or are retried on a new
+ * connection.
+ */
+static void tcp_conn_close(struct tcp_conn *conn, const char *reason)
+{
+	struct query_state *qry;
+
+	while ((qry= conn->waiting) != NULL)
+	{
+		tcp_conn_detach(qry);
+		tcp_reporterr(&qry->tu_env, TU_READ_ERR, reason);
+	}
+	tcp_conn_free(conn);
+}
+
+static void tcp_conn_eventcb(struct bufferevent *bev UNUSED_PARAM,
+	short events, void *ptr)
+{
+	if (!(events & (BEV_EVENT_EOF | BEV_EVENT_ERROR)))
+		return;
+
+	tcp_conn_close(ptr, "connection closed");
+}
+
+/* Take over the connection of 'qry'. When replaying, 'bev' is NULL and
+ * the connection is one end of a pair.
+ */
+static struct tcp_conn *tcp_conn_new(struct query_state *qry,
+	struct bufferevent *bev)
+{
+	struct bufferevent *pair[2];
+	struct tcp_conn *conn;
+
+	conn= xzalloc(sizeof(*conn));
+	conn->resp_file= qry->resp_file;
+	qry->resp_file= NULL;
+	if (qry->response_in)
+	{
+		if (bufferevent_pair_new(qry->base->event_base, 0, pair) != 0)
+		{
+			crondlog(DIE9 "tcp_conn_new: bufferevent_pair_new failed");
+		}
+		bev= pair[0];
+		conn->replay= 1;
+		conn->replay_bev= pair[1];
+		bufferevent_setcb(pair[1], tcp_conn_drain, NULL, NULL, conn);
+		bufferevent_enable(pair[0], EV_READ|EV_WRITE);
+		bufferevent_enable(pair[1], EV_READ|EV_WRITE);
+		evtimer_assign(&conn->replay_timer, qry->base->event_base,
+			tcp_conn_replay, conn);
+	}
+
+	conn->base= qry->base;
+	conn->bev= bev;
+	conn->idle= qry->opt_reuse_conn;
+	conn->server_name= qry->server_name ? strdup(qry->server_name) : NULL;
+	conn->port= qry->port_as_char ? strdup(qry->port_as_char) : NULL;
+	conn->sni_cert_name= qry->sni_cert_name ?
+		strdup(qry->sni_cert_name) : NULL;
+	conn->infname= qry->infname ? strdup(qry->infname) : NULL;
+	conn->do_tls= qry->opt_do_tls;
+	conn->do_https= qry->opt_do_https;
+	conn->https_path= strdup(qry->https_path ? qry->https_path :
+		"/dns-query");
+	if (conn->do_https)
+		conn->http2_env= http2_init();
+	conn->v4_only= qry->opt_v4_only;
+	conn->v6_only= qry->opt_v6_only;
+	memcpy(conn->dst_addr_str, qry->dst_addr_str,
+		sizeof(conn->dst_addr_str));
+	conn->dst_ai_family= qry->dst_ai_family;
+	conn->loc_sin6= qry->loc_sin6;
+	conn->loc_socklen= qry->loc_socklen;
+
+	evtimer_assign(&conn->idle_timer, qry->base->event_base,
+		tcp_conn_idle, conn);
+	bufferevent_setcb(bev, tcp_conn_readcb, NULL, tcp_conn_eventcb, conn);
+
+	conn->next= qry->base->tcp_conns;
+	qry->base->tcp_conns= conn;
+
+	return conn;
+}
+
+/* Send the query of 'qry' on 'conn'. The query ID has to be unique on the
+ * connection.
+ */
+static void tcp_conn_send(struct tcp_conn *conn, struct query_state *qry)
+{
+	size_t len;
+	u_char *outbuff;
+	u_char b2[2];
+	struct timeval asap= { 0, 0 };
+	struct query_state *q;
+
+	evtimer_del(&conn->idle_timer);
+
+	/* Replies to this query follow the marker */
+	if (conn->replay)
+	{
+		len= 0;
+		read_response_file(conn->resp_file, RESP_QUERY, &len, NULL);
+		evtimer_add(&conn->replay_timer, &asap);
+	}
+	else if (conn->resp_file)
+		write_response(conn->resp_file, RESP_QUERY, 0, NULL);
+
+	qry->conn= conn;
+	qry->conn_prev= NULL;
+	qry->conn_next= conn->waiting;
+	if (qry->conn_next)
+		qry->conn_next->conn_prev= qry;
+	conn->waiting= qry;
+
+	memcpy(qry->dst_addr_str, conn->dst_addr_str,
+		sizeof(qry->dst_addr_str));
+	qry->dst_ai_family= conn->dst_ai_family;
+	qry->loc_sin6= conn->loc_sin6;
+	qry->loc_socklen= conn->loc_socklen;
+	if (qry->conn_reused)
+	{
+		qry->xmit_time= atlas_time();
+		gettime_mono(&qry->xmit_time_ts);
+	}
+
+	outbuff = xzalloc(MAX_DNS_OUT_BUF_SIZE);
+	mk_dns_buff(qry, outbuff, MAX_DNS_OUT_BUF_SIZE);
+	if (conn->http2_env)
+	{
+		/* Each query gets its own stream, tcp_conn_find checked
+		 * that there is room for one.
+		 */
+		qry->h2_stream= http2_dns(conn->http2_env, conn->bev,
+			qry->sni_cert_name, qry->port_as_char,
+			conn->https_path, outbuff, qry->pktsize,
+			&qry->tu_env);
+		if(qry->opt_qbuf) {
+			buf_init(&qry->qbuf, -1);
+			buf_add_b64(&qry->qbuf, outbuff, qry->pktsize, 0);
+		}
+		free(outbuff);
+		gettime_mono(&qry->qxmit_time_ts);
+		return;
+	}
+	for (q= conn->waiting; q; q= q->conn_next)
+	{
+		if (q != qry && q->qryid == qry->qryid)
+		{
+			qry->qryid++;
+			((struct DNS_HEADER *)outbuff)->id= htons(qry->qryid);
+			q= conn->waiting;	/* Check again */
+		}
+	}
+	save_question(qry, outbuff, qry->pktsize);
+
+	ldns_write_uint16(b2, qry->pktsize);
+	bufferevent_write(conn->bev, b2, sizeof(b2));
+	bufferevent_write(conn->bev, outbuff, qry->pktsize);
+	qry->base->sentok++;
+	qry->base->sentbytes+= (qry->pktsize +2);
+
+	if(qry->opt_qbuf) {
+		buf_init(&qry->qbuf, -1);
+		buf_add_b64(&qry->qbuf, outbuff, qry->pktsize, 0);
+	}
+	free(outbuff);
+
+	gettime_mono(&qry->qxmit_time_ts);
+}
+
+static void tcp_conn_detach(struct query_state *qry)
+{
+	struct timeval interval;
+	struct tcp_conn *conn;
+
+	conn= qry->conn;
+	if (conn->http2_env && qry->h2_stream)
+	{
+		/* No-op if the reply is already in */
+		http2_dns_cancel(conn->http2_env, conn->bev, qry->h2_stream);
+		qry->h2_stream= 0;
+	}
+	if (qry->conn_next)
+		qry->conn_next->conn_prev= qry->conn_prev;
+	if (qry->conn_prev)
+		qry->conn_prev->conn_next= qry->conn_next;
+	else
+		conn->waiting= qry->conn_next;
+	qry->conn= NULL;
+	qry->conn_next= qry->conn_prev= NULL;
+
+	if (!conn->waiting)
+	{
+		interval.tv_sec= conn->idle;
+		interval.tv_usec= 0;
+		evtimer_add(&conn->idle_timer, &interval);
+	}
+}
+
 
 
 /*
@@ -2156,84 +2713,487 @@ static int get_edns_opt(int *optoffp, int target_code,
 		opt_o += 4 + opt_len;
 	}
 
-	/* Not found */
-	return -1;
+	/* Not found */
+	return -1;
+}
+
+static int get_rr_len(int *namelenp, uint8_t *packet, int offset, int len,
+	int question)
+{
+	int label_len, name_len, rdlength, rr_len;
+
+	/* Handle name */
+	name_len= 0;
+	for(;;)
+	{
+		if (offset+name_len >= len)
+			return -1;
+		label_len= packet[offset+name_len];
+		if (label_len > 63)
+		{
+			if (label_len < 192)
+				return -1;	/* bogus */
+			name_len += 2;
+			break;
+		}
+		else if (label_len == 0)
+		{
+			name_len++;
+			break;
+		}
+		name_len += label_len+1;
+	}
+
+	*namelenp= name_len;
+
+	if (question)
+		return name_len + /*qtype*/ 2 + /*qclass*/ 2;
+
+	rr_len= name_len + /*type*/ 2 + /*class*/ 2 + /*ttl*/ 4;
+	if (offset+rr_len+2 > len)
+		return -1;
+	rdlength= (packet[offset+rr_len] << 8) | packet[offset+rr_len+1];
+
+	rr_len += 2 + rdlength;
+
+	return rr_len;
+}
+
+/* Replies that are read from a file. Replies from the network arrive at
+ * udp_pool_callback.
+ */
+static void ready_callback (int unused UNUSED_PARAM, const short event UNUSED_PARAM, void * arg)
+{
+	struct query_state * qry;
+	int nrecv, type;
+	size_t tmp_len;
+	struct timespec rectime;
+	struct msghdr msg;
+	struct sockaddr_in remote;
+	char cmsgbuf[256];
+
+	qry = arg;
+
+	peek_response(qry->udp_fd, &type);
+	if (type == RESP_TIMEOUT)
+	{
+		noreply_callback(0, 0, qry);
+		return;
+	}
+
+	/* Time the packet has been received */
+	gettime_mono(&rectime);
+
+	memset(&msg, '\0', sizeof(msg));
+	msg.msg_name= &remote;
+	msg.msg_namelen= sizeof(remote);
+	msg.msg_control= cmsgbuf;
+
+	tmp_len= sizeof(qry->base->packet);
+	read_response(qry->udp_fd, RESP_PACKET, &tmp_len,
+		qry->base->packet);
+	nrecv= tmp_len;
+
+	tmp_len= sizeof(remote);
+	read_response(qry->udp_fd, RESP_PEERNAME, &tmp_len,
+		&remote);
+	if (tmp_len != sizeof(remote))
+	{
+		crondlog(
+		DIE9 "ready_callback: error reading from '%s'",
+			qry->response_in);
+	}
+
+	tmp_len= sizeof(cmsgbuf);
+	read_response(qry->udp_fd, RESP_CMSG, &tmp_len, cmsgbuf);
+	msg.msg_controllen= tmp_len;
+
+	udp_reply(qry, nrecv, rectime, &msg);
+} 
+
+static void udp_reply(struct query_state *qry, int nrecv,
+	struct timespec rectime, struct msghdr *msgp)
+{
+	if (qry->response_out)
+	{
+		/* The file format has room for an IPv4 peer address */
+		write_response(qry->resp_file, RESP_PACKET, nrecv,
+			qry->base->packet);
+		write_response(qry->resp_file, RESP_PEERNAME,
+			sizeof(struct sockaddr_in), msgp->msg_name);
+		write_response(qry->resp_file, RESP_CMSG, msgp->msg_controllen,
+			msgp->msg_control);
+	}
+
+	process_reply(qry, nrecv, rectime, msgp);
+}
+
+/* Keep a copy of the question section of a query. The reply has to have
+ * the same question.
+ */
+static void save_question(struct query_state *qry, u_char *packet, int len)
+{
+	int o, label_len;
+
+	qry->qsect_len= 0;
+	o= sizeof(struct DNS_HEADER);
+	for (;;)
+	{
+		if (o >= len)
+			return;
+		label_len= packet[o];
+		if (label_len > 63)
+			return;		/* No compression in queries */
+		o += label_len+1;
+		if (label_len == 0)
+			break;
+	}
+	o += /*qtype*/ 2 + /*qclass*/ 2;
+	if (o > len || o - sizeof(struct DNS_HEADER) > sizeof(qry->qsect))
+		return;
+	qry->qsect_len= o - sizeof(struct DNS_HEADER);
+	memcpy(qry->qsect, packet+sizeof(struct DNS_HEADER), qry->qsect_len);
+}
+
+/* Check that a reply is for query 'qry'. A reply without a question
+ * section (for example FORMERR) is matched on the query ID alone.
+ * Servers should copy the question, but names are compared case
+ * insensitively.
+ */
+static int match_reply(struct query_state *qry, u_char *packet, int len)
+{
+	int i, n;
+	struct DNS_HEADER *dnsR;
+
+	dnsR= (struct DNS_HEADER *)packet;
+	if (ntohs(dnsR->id) != qry->qryid)
+		return 0;
+	if (ntohs(dnsR->q_count) == 0)
+		return 1;
+	if (qry->qsect_len == 0 ||
+		len < sizeof(struct DNS_HEADER) + qry->qsect_len)
+	{
+		return 0;
+	}
+
+	packet += sizeof(struct DNS_HEADER);
+	n= qry->qsect_len - /*qtype*/ 2 - /*qclass*/ 2;
+	for (i= 0; i<n; i++)
+	{
+		if (tolower(packet[i]) != tolower(qry->qsect[i]))
+			return 0;
+	}
+	return memcmp(packet+n, qry->qsect+n, 4) == 0;
+}
+
+static int same_server(struct sockaddr *a, struct sockaddr *b)
+{
+	struct sockaddr_in *a4, *b4;
+	struct sockaddr_in6 *a6, *b6;
+
+	if (a->sa_family != b->sa_family)
+		return 0;
+	if (a->sa_family == AF_INET)
+	{
+		a4= (struct sockaddr_in *)a;
+		b4= (struct sockaddr_in *)b;
+		return a4->sin_port == b4->sin_port &&
+			a4->sin_addr.s_addr == b4->sin_addr.s_addr;
+	}
+	a6= (struct sockaddr_in6 *)a;
+	b6= (struct sockaddr_in6 *)b;
+	return a6->sin6_port == b6->sin6_port &&
+		a6->sin6_scope_id == b6->sin6_scope_id &&
+		memcmp(&a6->sin6_addr, &b6->sin6_addr,
+		sizeof(a6->sin6_addr)) == 0;
+}
+
+static unsigned udp_pool_hash(struct sockaddr *sa)
+{
+	unsigned h;
+	size_t i, len;
+	u_char *p;
+	struct sockaddr_in *sin4;
+	struct sockaddr_in6 *sin6;
+
+	if (sa->sa_family == AF_INET)
+	{
+		sin4= (struct sockaddr_in *)sa;
+		p= (u_char *)&sin4->sin_addr;
+		len= sizeof(sin4->sin_addr);
+		h= sin4->sin_port;
+	}
+	else
+	{
+		sin6= (struct sockaddr_in6 *)sa;
+		p= (u_char *)&sin6->sin6_addr;
+		len= sizeof(sin6->sin6_addr);
+		h= sin6->sin6_port;
+	}
+	for (i= 0; i<len; i++)
+		h= h*31 + p[i];
+	return h % UDP_POOL_HASH;
+}
+
+static void udp_pool_close(struct udp_sock *usock)
+{
+	event_del(&usock->event);
+	close(usock->fd);
+	free(usock->infname);
+	free(usock);
+}
+
+/* Create a socket connected to the server of 'qry'. Errors are added to
+ * qry->err.
+ */
+static struct udp_sock *udp_pool_new(struct query_state *qry)
+{
+	int fd, on;
+	sa_family_t af;
+	struct udp_sock *usock;
+
+	af= qry->res->ai_addr->sa_family;
+	if ((fd = socket(af, SOCK_DGRAM, 0) ) < 0 )
+	{
+		snprintf(line, DEFAULT_LINE_LENGTH,
+			"%s \"socket\" : \"socket failed %s\"",
+			qry->err.size ? ", " : "",
+			strerror(errno));
+		buf_add(&qry->err, line, strlen(line));
+		return NULL;
+	} 
+
+	if (af == AF_INET6 && qry->opt_ipv6_dest_option != 0)
+	{
+		do_ipv6_option(fd, 1 /* dest */,
+			qry->opt_ipv6_dest_option);
+	}
+
+	if (qry->opt_do_ttl)
+	{
+		on = 1;
+		if (af == AF_INET6) {
+			setsockopt(fd, IPPROTO_IPV6, IPV6_RECVHOPLIMIT,
+				&on, sizeof(on));
+		}
+		else {
+			setsockopt(fd, IPPROTO_IP, IP_RECVTTL,
+				&on, sizeof(on));
+		}
+	}
+
+	evutil_make_socket_nonblocking(fd); 
+
+	if (qry->infname)
+	{
+		if (bind_interface(fd, af, qry->infname) == -1)
+		{
+			snprintf(line, DEFAULT_LINE_LENGTH,
+				"%s \"socket\" : \"bind_interface failed\"",
+				qry->err.size ? ", " : "");
+			buf_add(&qry->err, line, strlen(line));
+			close(fd);
+			return NULL;
+		}
+	}
+
+	/* Connecting gives a random source port and makes the kernel drop
+	 * packets from other addresses.
+	 */
+	if (connect(fd, qry->res->ai_addr, qry->res->ai_addrlen) == -1)
+	{
+		snprintf(line, DEFAULT_LINE_LENGTH,
+			"%s \"socket\" : \"connect failed %s\"",
+			qry->err.size ? ", " : "",
+			strerror(errno));
+		buf_add(&qry->err, line, strlen(line));
+		close(fd);
+		return NULL;
+	}
+
+	usock= xzalloc(sizeof(*usock));
+	usock->loc_socklen= sizeof(usock->loc_sin6);
+	if (getsockname(fd, (struct sockaddr *)&usock->loc_sin6,
+		&usock->loc_socklen) == -1)
+	{
+		snprintf(line, DEFAULT_LINE_LENGTH,
+			"%s \"getsockname\" : \"%s\"",
+			qry->err.size ? ", " : "",
+			strerror(errno));
+		buf_add(&qry->err, line, strlen(line));
+		close(fd);
+		free(usock);
+		return NULL;
+	}
+
+	usock->base= qry->base;
+	usock->fd= fd;
+	memcpy(&usock->server, qry->res->ai_addr, qry->res->ai_addrlen);
+	usock->server_len= qry->res->ai_addrlen;
+	usock->infname= qry->infname ? strdup(qry->infname) : NULL;
+	usock->ipv6_dest_option= qry->opt_ipv6_dest_option;
+	usock->do_ttl= qry->opt_do_ttl;
+
+	event_assign(&usock->event, qry->base->event_base, fd, 
+		EV_READ | EV_PERSIST, udp_pool_callback, usock);
+	event_add(&usock->event, NULL);
+
+	return usock;
 }
 
-static int get_rr_len(int *namelenp, uint8_t *packet, int offset, int len,
-	int question)
+/* Find a socket for the current server of 'qry', or create one, and add
+ * 'qry' to the queries that wait for a reply on it.
+ */
+static int udp_pool_attach(struct query_state *qry)
 {
-	int label_len, name_len, rdlength, rr_len;
+	unsigned h;
+	struct timeval interval;
+	struct tdig_base *base;
+	struct udp_sock *usock;
 
-	/* Handle name */
-	name_len= 0;
-	for(;;)
+	base= qry->base;
+	h= udp_pool_hash(qry->res->ai_addr);
+	for (usock= base->udp_pool[h]; usock; usock= usock->next)
 	{
-		if (offset+name_len >= len)
-			return -1;
-		label_len= packet[offset+name_len];
-		if (label_len > 63)
+		if (same_server((struct sockaddr *)&usock->server,
+			qry->res->ai_addr) &&
+			usock->ipv6_dest_option == qry->opt_ipv6_dest_option &&
+			usock->do_ttl == qry->opt_do_ttl &&
+			(usock->infname ? (qry->infname &&
+			strcmp(usock->infname, qry->infname) == 0) :
+			!qry->infname))
 		{
-			if (label_len < 192)
-				return -1;	/* bogus */
-			name_len += 2;
 			break;
 		}
-		else if (label_len == 0)
+	}
+	if (!usock)
+	{
+		usock= udp_pool_new(qry);
+		if (!usock)
+			return -1;
+		usock->next= base->udp_pool[h];
+		base->udp_pool[h]= usock;
+		if (base->udp_pool_count++ == 0)
 		{
-			name_len++;
-			break;
+			interval.tv_sec= UDP_POOL_IDLE;
+			interval.tv_usec= 0;
+			evtimer_add(&base->udp_pool_timer, &interval);
 		}
-		name_len += label_len+1;
 	}
 
-	*namelenp= name_len;
+	usock->uses++;
+	if (usock->uses >= UDP_POOL_MAXUSE)
+	{
+		/* Remove from the hash table. The socket is closed when
+		 * the last query is done.
+		 */
+		struct udp_sock **usockp;
 
-	if (question)
-		return name_len + /*qtype*/ 2 + /*qclass*/ 2;
+		for (usockp= &base->udp_pool[h]; *usockp != usock;
+			usockp= &(*usockp)->next)
+		{
+			; /* Nothing */
+		}
+		*usockp= usock->next;
+		usock->next= NULL;
+		usock->retired= 1;
+		base->udp_pool_count--;
+	}
 
-	rr_len= name_len + /*type*/ 2 + /*class*/ 2 + /*ttl*/ 4;
-	if (offset+rr_len+2 > len)
-		return -1;
-	rdlength= (packet[offset+rr_len] << 8) | packet[offset+rr_len+1];
+	qry->usock= usock;
+	qry->usock_prev= NULL;
+	qry->usock_next= usock->waiting;
+	if (qry->usock_next)
+		qry->usock_next->usock_prev= qry;
+	usock->waiting= qry;
 
-	rr_len += 2 + rdlength;
+	return 0;
+}
 
-	return rr_len;
+static void udp_pool_detach(struct query_state *qry)
+{
+	struct udp_sock *usock;
+
+	usock= qry->usock;
+	if (qry->usock_next)
+		qry->usock_next->usock_prev= qry->usock_prev;
+	if (qry->usock_prev)
+		qry->usock_prev->usock_next= qry->usock_next;
+	else
+		usock->waiting= qry->usock_next;
+	qry->usock= NULL;
+	qry->usock_next= qry->usock_prev= NULL;
+
+	if (usock->waiting)
+		return;
+	if (usock->retired)
+		udp_pool_close(usock);
+	else
+		usock->idle_since= atlas_time();
 }
 
-static void ready_callback (int unused UNUSED_PARAM, const short event UNUSED_PARAM, void * arg)
+/* Close sockets that have not been used for a while */
+static void udp_pool_sweep(int unused UNUSED_PARAM,
+	const short event UNUSED_PARAM, void *arg)
+{
+	int i;
+	time_t now;
+	struct timeval interval;
+	struct tdig_base *base;
+	struct udp_sock *usock, **usockp;
+
+	base= arg;
+	now= atlas_time();
+	for (i= 0; i<UDP_POOL_HASH; i++)
+	{
+		for (usockp= &base->udp_pool[i]; *usockp;)
+		{
+			usock= *usockp;
+			if (usock->waiting ||
+				now - usock->idle_since < UDP_POOL_IDLE)
+			{
+				usockp= &usock->next;
+				continue;
+			}
+			*usockp= usock->next;
+			base->udp_pool_count--;
+			udp_pool_close(usock);
+		}
+	}
+
+	if (base->udp_pool_count)
+	{
+		interval.tv_sec= UDP_POOL_IDLE;
+		interval.tv_usec= 0;
+		evtimer_add(&base->udp_pool_timer, &interval);
+	}
+}
+
+/* A reply on a pooled socket. The kernel only passes packets from the
+ * server, the query ID and question select the query.
+ */
+static void udp_pool_callback(int fd, const short event UNUSED_PARAM,
+	void *arg)
 {
-	struct query_state * qry;
 	int nrecv;
 	struct timespec rectime;
 	struct msghdr msg;
 	struct iovec iov[1];
-	struct sockaddr_in remote;
+	struct sockaddr_in6 remote;
 	char cmsgbuf[256];
+	struct tdig_base *base;
+	struct udp_sock *usock;
+	struct query_state *qry;
 
-	qry = arg;
-
-	if (qry->response_in)
-	{
-		int type;
-
-		peek_response(qry->udp_fd, &type);
-		if (type == RESP_TIMEOUT)
-		{
-			noreply_callback(0, 0, qry);
-			return;
-		}
-	}
+	usock= arg;
+	base= usock->base;
 
-	
 	/* Time the packet has been received */
 	gettime_mono(&rectime);
 
-	bzero(qry->base->packet, MAX_DNS_BUF_SIZE);
-
-	iov[0].iov_base= qry->base->packet;
-	iov[0].iov_len= sizeof(qry->base->packet);
+	iov[0].iov_base= base->packet;
+	iov[0].iov_len= sizeof(base->packet);
+	memset(&remote, '\0', sizeof(remote));
 	msg.msg_name= &remote;
 	msg.msg_namelen= sizeof(remote);
 	msg.msg_iov= iov;
@@ -2242,52 +3202,39 @@ static void ready_callback (int unused UNUSED_PARAM, const short event UNUSED_PA
 	msg.msg_controllen= sizeof(cmsgbuf);
 	msg.msg_flags= 0;			/* Not really needed */
 
-	/* Receive data from the network */
-	if (qry->response_in)
-	{
-		size_t tmp_len;
-
-		tmp_len= sizeof(qry->base->packet);
-		read_response(qry->udp_fd, RESP_PACKET, &tmp_len,
-			qry->base->packet);
-		nrecv= tmp_len;
-
-		tmp_len= sizeof(remote);
-		read_response(qry->udp_fd, RESP_PEERNAME, &tmp_len,
-			&remote);
-		if (tmp_len != sizeof(remote))
-		{
-			crondlog(
-			DIE9 "ready_callback: error reading from '%s'",
-				qry->response_in);
-		}
-
-		tmp_len= sizeof(cmsgbuf);
-		read_response(qry->udp_fd, RESP_CMSG, &tmp_len, cmsgbuf);
-		msg.msg_controllen= tmp_len;
-	}
-	else
-	{
-		nrecv= recvmsg(qry->udp_fd, &msg, MSG_DONTWAIT);
-	}
+	nrecv= recvmsg(fd, &msg, MSG_DONTWAIT);
 	if (nrecv < 0) {
 		/* One more failure */
-		qry->base->recvfail++;
+		base->recvfail++;
 		return ;
 	}
-	if (qry->response_out)
+	if (nrecv < sizeof (struct DNS_HEADER)) {
+		base->shortpkt++;
+		return;
+	}
+	if (!same_server((struct sockaddr *)&remote,
+		(struct sockaddr *)&usock->server))
 	{
-		write_response(qry->resp_file, RESP_PACKET, nrecv,
-			qry->base->packet);
-		write_response(qry->resp_file, RESP_PEERNAME, sizeof(remote),
-			&remote);
-		write_response(qry->resp_file, RESP_CMSG, msg.msg_controllen,
-			cmsgbuf);
+		base->martian++;
+		return;
 	}
 
-	process_reply(arg, nrecv, rectime, &msg);
-	return;
-} 
+	for (qry= usock->waiting; qry; qry= qry->usock_next)
+	{
+		if (match_reply(qry, base->packet, nrecv))
+			break;
+	}
+	if (!qry)
+	{
+		base->martian++;
+		crondlog(LVL7 "DBG: no query for reply with id %d",
+			ntohs(((struct DNS_HEADER *)base->packet)->id));
+		return;
+	}
+
+	/* Careful, 'usock' may be gone after this */
+	udp_reply(qry, nrecv, rectime, &msg);
+}
 
 static bool argProcess (int argc, char *argv[], struct query_state *qry )
 {
@@ -2468,10 +3415,13 @@ static void *tdig_init(int argc, char *argv[],
 	qry->opt_do_tls = 0;
 	qry->opt_do_ttl = 0;
 	qry->opt_do_https = 0;
+	qry->opt_tls_resume = 0;
+	qry->opt_tfo = 0;
 	qry->sni_cert_name = NULL;
 	qry->https_path = NULL;
 	qry->resp_file= NULL;
 	qry->http2_env= NULL;
+	qry->h2_stream= 0;
 
 	/* initialize callbacks : */
 	/* sendpacket  called by UDP send */
@@ -2642,6 +3592,26 @@ static void *tdig_init(int argc, char *argv[],
 				qry->https_path = strdup(optarg);
 				break;
 
+			case O_REUSE_CONN:
+				qry->opt_reuse_conn = strtoul(optarg, &check,
+					10);
+				if (*check != '\0' || qry->opt_reuse_conn == 0)
+				{
+					fprintf(stderr, "ERROR bad value for "
+						"--reuse-conn %s\n", optarg);
+					tdig_delete(qry);
+					return (0);
+				}
+				break;
+
+			case O_TLS_RESUME:
+				qry->opt_tls_resume = 1;
+				break;
+
+			case O_TFO:
+				qry->opt_tfo = 1;
+				break;
+
 			case O_TYPE:
 				qry->qtype = strtoul(optarg, &check, 10);
 				if ((qry->qtype >= 0 ) && 
@@ -3006,6 +3976,8 @@ struct tdig_base * tdig_base_new(struct event_base *event_base)
 	//tdig_base-->loc_socklen= 0;
 
 	evtimer_assign(&tdig_base->statsReportEvent, tdig_base->event_base, tdig_stats, tdig_base);
+	evtimer_assign(&tdig_base->udp_pool_timer, tdig_base->event_base,
+		udp_pool_sweep, tdig_base);
 
 	// Define the callback to handle UDP Reply 
 	// add the raw file descriptor to those monitored for read events 
@@ -3043,12 +4015,14 @@ void tdig_start (void *arg)
 	struct timeval interval;
 
 	int i, err_num;
+	unsigned flags;
 	size_t len;
 	struct query_state *qry;
 	struct addrinfo hints, *res;
 	char port[] = "domain";
 	struct sockaddr_in6 sin6;
 	char strbuf[256];
+	struct tcp_conn *conn;
 
 	qry= arg;
 
@@ -3199,7 +4173,12 @@ void tdig_start (void *arg)
 		hints.ai_family = AF_UNSPEC;
 	}
 
-	if (qry->response_out && !qry->resp_file)
+	/* Queries on a shared connection use its response file */
+	conn= NULL;
+	if (qry->opt_proto == 6 && tcp_reuse(qry))
+		conn= tcp_conn_find(qry);
+
+	if (qry->response_out && !qry->resp_file && !conn)
 	{
 		qry->resp_file= fopen(qry->response_out, "w");
 		if (!qry->resp_file)
@@ -3241,11 +4220,26 @@ void tdig_start (void *arg)
 	else { // TCP Query
 
 		qry->wire_size =  0;
+		qry->conn_reused= 0;
+		qry->tls_resumed= 0;
 		// crondlog(LVL5 "TCP QUERY %s", qry->server_name);
 		interval.tv_sec = CONN_TO;
 		interval.tv_usec= 0;
 
-		if (qry->response_in)
+		if (conn)
+		{
+			/* Same timeout as for a new connection. Replayed
+			 * timeouts come from the response file.
+			 */
+			evtimer_assign(&qry->tu_env.timer, EventBase,
+				tcp_timeout_callback, &qry->tu_env);
+			if (!qry->response_in)
+				evtimer_add(&qry->tu_env.timer, &interval);
+			qry->qst = STATUS_SEND;
+			qry->conn_reused= 1;
+			tcp_conn_send(conn, qry);
+		}
+		else if (qry->response_in)
 		{
 			size_t len;
 
@@ -3269,9 +4263,17 @@ void tdig_start (void *arg)
 		}
 		else
 		{
+			flags= TU_F_DNS_NOCACHE;
+			if (qry->opt_do_tls)
+				flags |= TU_F_TLS;
+			if (qry->opt_do_https)
+				flags |= TU_F_HTTP2;
+			if (qry->opt_tls_resume)
+				flags |= TU_F_TLS_RESUME;
+			if (qry->opt_tfo)
+				flags |= TU_F_TFO;
 			tu_connect_to_name (&qry->tu_env,   qry->server_name,
-					qry->opt_do_tls, qry->opt_do_https,
-					qry->port_as_char,
+					flags, qry->port_as_char,
 					&interval, &hints, qry->infname,
 					qry->sni_cert_name,
 					qry->sni_cert_name,
@@ -3476,10 +4478,15 @@ static void free_qry_inst(struct query_state *qry)
 
 	if(qry->opt_proto == 6)
 	{
+		if (qry->conn)
+			tcp_conn_detach(qry);
 		if (!qry->response_in)
 			tu_cleanup(&qry->tu_env);
 	}
 
+	if (qry->usock)
+		udp_pool_detach(qry);
+
 	if (qry->udp_fd != -1)
 	{
 		if (qry->response_in && qry->resolv_i < qry->resolv_max)
@@ -3645,6 +4652,10 @@ static int tdig_delete(void *state)
 			qry->nslist[i]= NULL;
 		}
 	}
+	if (qry->usock)
+		udp_pool_detach(qry);
+	if (qry->conn)
+		tcp_conn_detach(qry);
 	if (qry->udp_fd != -1)
 	{
 		event_del(&qry->event);
@@ -3705,19 +4716,20 @@ void printErrorQuick (struct query_state *qry)
 
 void printReply(struct query_state *qry, int wire_size, unsigned char *result)
 {
-	int i, stop=0;
+	int i;
 	struct DNS_HEADER *dnsR = NULL;
-	struct RES_RECORD answers[20]; //the replies from the DNS server
+	struct dnsmsg msg;
+	struct dnsrr rr;
+	char name[DNSMSG_NAMELEN], mname[DNSMSG_NAMELEN],
+		rname[DNSMSG_NAMELEN];
 	void *ptr = NULL;
 	FILE *fh; 
 	char addrstr[INET6_ADDRSTRLEN];
 	u_int32_t serial;
 	int iMax ;
 	int flagAnswer = 0;
-	int data_len, len;
 	int write_out = FALSE;
-	unsigned offset;
-	unsigned char *name1= NULL, *name2= NULL;
+	size_t offset;
 
 	int lts = get_timesync();
 
@@ -3811,6 +4823,30 @@ void printReply(struct query_state *qry, int wire_size, unsigned char *result)
 
 	JS_NC(proto, qry->opt_proto == 6 ? "TCP" : "UDP" );
 
+	if (qry->opt_reuse_conn && qry->opt_proto == 6)
+	{
+		AS(qry->conn_reused ? ", \"reused\" : true" :
+			", \"reused\" : false");
+	}
+
+	/* A reused connection did no handshake of its own */
+	if (qry->opt_tls_resume && (qry->opt_do_tls || qry->opt_do_https) &&
+		!qry->conn_reused)
+	{
+		AS(qry->tls_resumed ? ", \"resumed\" : true" :
+			", \"resumed\" : false");
+	}
+
+	/* Fast Open only applies to the connection's first query */
+	if (qry->opt_tfo && qry->opt_proto == 6 && !qry->conn_reused)
+	{
+		snprintf(line, DEFAULT_LINE_LENGTH, ", \"tfo\" : \"%s\"",
+			qry->response_in ? "none" :
+			tu_tfo_result(&qry->tu_env, qry->conn ?
+			qry->conn->bev : qry->tu_env.bev));
+		AS(line);
+	}
+
 	if(qry->opt_qbuf && qry->qbuf.size) {
 		AS(",\"qbuf\" : \"");
 		buf_add(&qry->result,  qry->qbuf.buf,  qry->qbuf.size);
@@ -3862,142 +4898,75 @@ void printReply(struct query_state *qry, int wire_size, unsigned char *result)
 		JU (NSCOUNT, ntohs(dnsR->ns_count));
 		JU_NC (ARCOUNT, ntohs(dnsR->add_count));
 
-		/* Start just after header */
-		offset= sizeof(struct DNS_HEADER);
-
-		len= dns_namelen(result, offset, wire_size);
-		if (len == -1)
-			goto truncated;
-
-		offset += len + sizeof(struct QUESTION);
-
-		if (offset > wire_size)
+		/* Skip the question */
+		dnsmsg_init(&msg, result, wire_size);
+		if (dnsmsg_question(&msg, &rr) == -1)
 			goto truncated;
 
-		stop=0;  
-		iMax = 0;
-		
-		if (dnsR->ans_count > 0)
+		/* Only the first two answers are reported */
+		iMax = MIN(2, msg.ancount);
+		for(i=0;i<iMax;i++)
 		{
-			iMax = MIN(2, ntohs(dnsR->ans_count));
-
-			memset(answers, '\0', sizeof(answers));
+			if (dnsmsg_rr(&msg, &rr) == -1 ||
+				dnsmsg_name(&msg, rr.name_off, name,
+				sizeof(name), NULL) == -1)
+			{
+				goto truncated;
+			}
 
-			for(i=0;i<iMax;i++)
+			if(rr.type == T_TXT)
 			{
-				answers[i].name=ReadName(result,wire_size,
-					offset,&stop);
-				if (stop == -1)
-					goto truncated;
-				offset += stop;
+				if(flagAnswer == 0) {
+					AS(",\"answers\" : [ {");
+					flagAnswer++;
+				}
+				else if (flagAnswer >  0) {
+						AS(", {");
+				}
+				flagAnswer++;
+				JS (TYPE, "TXT");
+				JSNAME(NAME, name);
+				print_txt_json(result+rr.rdata_off,
+					rr.rdlen, qry);
+				AS("}");
 
-				if (offset + sizeof(struct R_DATA) > 
-					wire_size)
+			}
+			else if (rr.type == T_SOA)
+			{
+				if (dnsmsg_name(&msg, rr.rdata_off, mname,
+					sizeof(mname), &offset) == -1 ||
+					dnsmsg_name(&msg, offset, rname,
+					sizeof(rname), &offset) == -1 ||
+					offset+5*4 > rr.rdata_off+rr.rdlen)
 				{
-					/* Report error? */
 					goto truncated;
 				}
 
-				answers[i].resource =
-					(struct R_DATA*)(result+offset);
-				offset += sizeof(struct R_DATA);
-
-				answers[i].rdata  = NULL;
-
-				if(ntohs(answers[i].resource->type)==T_TXT) //txt
-				{
-					data_len = ntohs(answers[i].resource->data_len);
-
-					if (offset+data_len > wire_size)
-						goto truncated;
-
-					if(flagAnswer == 0) {
-						AS(",\"answers\" : [ {");
-						flagAnswer++;
-					}
-					else if (flagAnswer >  0) {
-							AS(", {");
-					}
-					flagAnswer++;
-					JS (TYPE, "TXT");
-					JS (NAME, answers[i].name);
-					print_txt_json(result+offset,
-						data_len, qry);
-					offset += data_len;
-					AS("}");
-
+				if(flagAnswer == 0) {
+					AS(",\"answers\" : [ { ");
 				}
-				else if (ntohs(answers[i].resource->type)== T_SOA)
-				{
-					name1= name2= NULL;
-					name1 = ReadName(
-						result,wire_size,
-						offset,&stop);
-					if (stop == -1)
-						goto truncated;
-					offset += stop;
-					name2 = ReadName(
-						result,wire_size,
-						offset,&stop);
-					if (stop == -1)
-					{
-						free(name1); name1= NULL;
-						goto truncated;
-					}
-					offset += stop;
-					if (offset+5*4 > wire_size)
-					{
-						free(name1); name1= NULL;
-						free(name2); name2= NULL;
-						goto truncated;
-					}
-
-					if(flagAnswer == 0) {
-						AS(",\"answers\" : [ { ");
-					}
-					else if (flagAnswer > 0) {
-						AS(",{ ");
-					}
-					flagAnswer++;
-
-					JS(TYPE, "SOA");
-					JSDOT(NAME, answers[i].name);
-					JU(TTL, ntohl(answers[i].resource->ttl));
-					JSDOT( MNAME, name1);
-					free(name1); name1= NULL;
-					JSDOT( RNAME, name2);
-					free(name2); name2= NULL;
-
-					serial = get32b(result+offset);
-					JU_NC(SERIAL, serial);
-					offset += 4;
-
-					offset += 4*4; // skip REFRESH, RETRY, EXIPIRE, and MINIMUM
-						AS(" } ");
+				else if (flagAnswer > 0) {
+					AS(",{ ");
 				}
-				else  
-				{
-					data_len = ntohs(answers[i].
-						resource->data_len);
+				flagAnswer++;
 
-					if (offset+data_len > wire_size)
-						goto truncated;
+				JS(TYPE, "SOA");
+				JSNAMEDOT(NAME, name);
+				JU(TTL, rr.ttl);
+				JSNAMEDOT(MNAME, mname);
+				JSNAMEDOT(RNAME, rname);
 
-					offset += data_len;
-				}
-	
-				// free mem 
-				if(answers[i].rdata != NULL) 
-					free (answers[i].rdata); 
-			}
-			if(flagAnswer > 0) 
-				AS(" ]");
-		}
+				serial = get32b(result+offset);
+				JU_NC(SERIAL, serial);
 
-		for(i=0;i<iMax;i++)
-		{
-			free(answers[i].name);
+				/* REFRESH, RETRY, EXPIRE, and MINIMUM are
+				 * not reported.
+				 */
+					AS(" } ");
+			}
 		}
+		if(flagAnswer > 0) 
+			AS(" ]");
 
 truncated:
 		AS (" }"); //result {
@@ -4053,147 +5022,6 @@ truncated:
 	free_qry_inst(qry);
 }
 
-unsigned char* ReadName(unsigned char *base, size_t size, size_t offset,
-	int* count)
-{
-	unsigned char *name;
-	unsigned int p=0,jumped=0, jump_count=0, len;
-	size_t noffset;
-
-	*count = 0;
-	name = (unsigned char*)malloc(256);
-
-	name[0]= '\0';
-
-	//read the names in 3www6google3com format
-	while(offset < size && (len= base[offset], len !=0))
-	{
-		if (len & 0xc0)
-		{
-			if ((len & 0xc0) != 0xc0)
-			{
-				/* Bad format */
-				snprintf((char *)name, sizeof(name),
-					"format-error at %lu: value 0x%x",
-					(unsigned long)offset, len);
-				*count= -1;
-				free(name); name= NULL;
-				return name;
-			}
-
-			noffset= ((len & ~0xc0) << 8) | base[offset+1];
-			if (noffset >= size)
-			{
-				snprintf((char *)name, sizeof(name),
-					"offset-error at %lu: offset %lu",
-					(unsigned long)offset, (unsigned long)noffset);
-				*count= -1;
-				free(name); name= NULL;
-				return name;
-			}
-
-			if (jump_count > 256)
-			{
-				/* Too many */
-				snprintf((char *)name, sizeof(name),
-					"too many redirects at %lu",
-						(unsigned long)offset);
-				*count= -1;
-				free(name); name= NULL;
-				return name;
-			}
-
-			offset= noffset;
-			if(jumped==0)
-			{
-				/* if we havent jumped to another location
-				 * then we can count up
-				 */
-				*count += 2;
-			}
-			jumped= 1;
-			jump_count++;
-			continue;
-		}
-		if (offset+len+1 > size)
-		{
-			snprintf((char *)name, sizeof(name),
-				"buf-bounds-error at %lu: len %d",
-					(unsigned long)offset, len);
-			*count= -1;
-			free(name); name= NULL;
-			return name;
-		}
-
-		if (p+len+1 > 255)
-		{
-			snprintf((char *)name, sizeof(name),
-					"name-length-error at %lu: len %d",
-					(unsigned long)offset, p+len+1);
-			*count= -1;
-			free(name); name= NULL;
-			return name;
-		}
-		memcpy(name+p, base+offset+1, len);
-		name[p+len]= '.';
-		p += len+1;
-		offset += len+1;
-		
-		if(jumped==0)
-		{
-			/* if we havent jumped to another location then we
-			 * can count up 
-			 */
-			*count += len+1;
-		}
-	}
-
-	if (!jumped)
-		(*count)++;	/* Terminating zero length */
-
-	name[p]= '\0'; //string complete
-
-	if(p >  0)
-		name[p-1]= '\0'; //remove the last dot
-	return name;
-}
-
-int dns_namelen(unsigned char *base, size_t offset, size_t size)
-{
-	size_t start_offset;
-	unsigned int len;
-
-	start_offset= offset;
-
-	//figure out the length of a name in 3www6google3com format
-	while(offset < size)
-	{
-		len= base[offset];
-		if (len & 0xc0)
-		{
-			if ((len & 0xc0) != 0xc0)
-			{
-				/* Bad format */
-				return -1;
-			}
-
-			offset++;
-			break;
-		}
-		if (offset+len+1 > size)
-		{
-			return -1;
-		}
-
-		offset += len+1;
-
-		if (len == 0)
-			break;
-	}
-
-	return offset-start_offset;
-}
-
 /* get 4 bytes from memory
  * eg.  used to extract serial number from soa packet
  */
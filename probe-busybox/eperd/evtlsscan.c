@@ -20,9 +20,19 @@
 //kbuild:lib-$(CONFIG_EVTLSSCAN) += evtlsscan.o
 
 //usage:#define evtlsscan_trivial_usage
-//usage:       "todo"
+//usage:       "[-46A] [-O <file>] [--timeout <s>] [--max-con <n>] "
+//usage:	"[--cipher-group <n>] [--cert-ref] <host>"
 //usage:#define evtlsscan_full_usage "\n\n"
-//usage:     "todo"
+//usage:     "\nOptions:"
+//usage:     "\n       -4                      Only IPv4 addresses"
+//usage:     "\n       -6                      Only IPv6 addresses"
+//usage:     "\n       -A                      Probe all ciphers"
+//usage:     "\n       -O <filename>           Output file"
+//usage:     "\n       --timeout <s>           Timeout per handshake"
+//usage:     "\n       --max-con <n>           Concurrent handshakes per address (4)"
+//usage:     "\n       --cipher-group <n>      Offer <n> ciphers per handshake (1)"
+//usage:     "\n       --cert-ref              Only the fingerprint of certificates"
+//usage:     "\n                               reported before"
 
 #include "json-macros.h"
 #include "libbb.h"
@@ -51,12 +61,19 @@
 #include <openssl/err.h>
 #include <openssl/rand.h>
 #include "tls_hostname_validation.h"
+#include "certcache.h"
 
 #define SAFE_PREFIX ATLAS_DATA_NEW
 
 #define DEFAULT_LINE_LENGTH 1024
 #define DEFAULT_NOREPLY_TIMEOUT 5000
 #define O_RETRY  200
+#define O_MAX_CON 201
+#define O_CIPHER_GROUP 202
+#define O_CERT_REF 203
+
+#define DEFAULT_MAX_CON 4	/* concurrent handshakes per destination */
+#define MAX_CIPHER_GROUP 16	/* ciphers offered in one handshake */
 
 #define STATUS_FREE 0
 #define STATUS_START 1001
@@ -86,6 +103,9 @@ struct tls_state {
 	int state;
 	int q_serial;  /* on the instance, keep count of queries sent */
 	int q_success;
+	struct certcache certs;	/* Seen by this run and the one before */
+	unsigned cert_tag;	/* Run number, tags certs seen by this run */
+	int cert_n;		/* certificates in the cert_chain */
 
 	/* all children share same result structure with the  parent */
 	struct buf err;
@@ -116,6 +136,8 @@ struct tls_state {
 	struct evutil_addrinfo hints;
 
 	int opt_max_con; /* maximum concurrent queries per destination */
+	int opt_cipher_group; /* ciphers offered per child query */
+	bool opt_cert_ref; /* no PEM for certificates reported before */
 	int opt_max_bytes; /*  max size of output buffer */
 
 	bool opt_all_tests;
@@ -134,11 +156,6 @@ struct tls_state {
 	void (*done)(void *state); /* call back when all queries are done */
 };
 
-struct cert_fp {
-	unsigned char fp[EVP_MAX_MD_SIZE];
-	struct cert_fp *next;
-};
-
 struct tls_qry {
 	/* per instance variables. Unshared after duplicate */
 	int serial;   /* serial number of this query. Start at zero on pqry */
@@ -151,14 +168,17 @@ struct tls_qry {
  	struct buf *certs; /* ciphers that succeded */
 	struct buf err;
 
-	struct cert_fp *cfps;
-
 	SSL_CTX *ssl_ctx;
 	SSL *ssl;
 	int sslv; 			/* version of child query from parent opt_ */
 	const char *sslv_str; 		/* string for sslv */
 	const char *cipher_q; 		/* for this child query, what we are going to query */
 	const char *cipher_r; 		/* for this child query, what the response was */
+	const char **c_pend;		/* parent: ciphers not probed yet */
+	int n_pend;
+	const char *c_grp[MAX_CIPHER_GROUP]; /* child: ciphers offered */
+	int n_grp;
+	char *cipher_grp;		/* child: c_grp as a cipher list */
 	struct bufferevent *bev;
 	struct evutil_addrinfo *addr_curr;
 
@@ -194,6 +214,10 @@ static struct option longopts[]=
 	{ "retry",  required_argument, NULL, O_RETRY },
         { "timeout", required_argument, NULL, 'T' },
 	{ "port", required_argument, NULL, 'p'},
+	{ "max-con", required_argument, NULL, O_MAX_CON },
+	{ "cipher-group", required_argument, NULL, O_CIPHER_GROUP },
+	{ "cert-ref", no_argument, NULL, O_CERT_REF },
+	{ NULL, }
 };
 
 static void done_cb(int unused  UNUSED_PARAM, const short event UNUSED_PARAM, void *h) {
@@ -239,9 +263,17 @@ static void free_child_cb(int unused  UNUSED_PARAM, const short event UNUSED_PAR
 	}
 
 	if(qry->ssl_ctx !=  NULL) {
-		SSL_CTX_free(qry->ssl_ctx);
+		SSL_CTX_free(qry->ssl_ctx); /* children hold a reference */
 		qry->ssl_ctx = NULL;
 	}
+
+	if (qry->p != NULL) {
+		free(qry->cipher_grp);
+		free(qry);
+	} else if (qry->c_pend != NULL) {
+		free(qry->c_pend);
+		qry->c_pend = NULL;
+	}
 }
 
 /* Initialize a struct timeval by converting milliseconds */
@@ -255,37 +287,42 @@ static bool tls_inst_start (struct tls_qry *qry, const char *cipher_q)
 {
 	/* OpenSSL is initialized, SSL_library_init() should be called already */
 
+	const SSL_METHOD *method;
+
 	/* 
-	 ssl_ctx are not shared between quries. It could but not sure how to 
-	 set structures with specific versions and algorithms. Instead using
-	 one ctx per query.
+	 The version is fixed per ssl_ctx and the ciphers are set per
+	 connection. Children already hold a reference to the ssl_ctx
+	 of their parent, only a parent creates one.
 	 */
 
 	switch(qry->sslv)
 	{
 		case SSL3_VERSION:
-			qry->ssl_ctx = SSL_CTX_new(SSLv3_client_method());
+			method = SSLv3_client_method();
 			qry->sslv_str = SSL_TXT_SSLV3;
 			break;
 		case TLS1_VERSION:
-			qry->ssl_ctx = SSL_CTX_new(TLSv1_client_method());
+			method = TLSv1_client_method();
 			qry->sslv_str = SSL_TXT_TLSV1;
 			break;
 		case TLS1_1_VERSION:
-			qry->ssl_ctx = SSL_CTX_new(TLSv1_1_client_method());
+			method = TLSv1_1_client_method();
 			qry->sslv_str = SSL_TXT_TLSV1_1;
 			break;
 		case TLS1_2_VERSION:
-			qry->ssl_ctx = SSL_CTX_new(TLSv1_2_client_method());
+			method = TLSv1_2_client_method();
 			qry->sslv_str = SSL_TXT_TLSV1_2;
 			break;
 		default:
-			qry->ssl_ctx = SSL_CTX_new(SSLv23_client_method());
+			method = SSLv23_client_method();
 			qry->sslv_str = "TLSv1/SSL2/SSL3";
 			break;
 
 	}
 
+	if (qry->ssl_ctx == NULL)
+		qry->ssl_ctx = SSL_CTX_new(method);
+
 	qry->cipher_q =  cipher_q;
 
 	/* Do we want to do any sort of vericiation the probe? */
@@ -307,7 +344,14 @@ static bool tls_inst_start (struct tls_qry *qry, const char *cipher_q)
 		crondlog_aa(LVL9, "SSL_new() %s", __func__);
 		return TRUE;
 	}
-	SSL_set_cipher_list(qry->ssl, cipher_q);
+	if (!SSL_set_cipher_list(qry->ssl, cipher_q)) {
+		/* none of them is usable with this version */
+		crondlog_aa(LVL7, "SSL_set_cipher_list %s %s", __func__,
+				cipher_q);
+		SSL_free(qry->ssl);
+		qry->ssl = NULL;
+		return TRUE;
+	}
 
 	/* Set hostname for SNI extension */
 	SSL_set_tlsext_host_name(qry->ssl, qry->ui->host);
@@ -321,6 +365,7 @@ static bool tls_inst_start (struct tls_qry *qry, const char *cipher_q)
 
 	//bufferevent_openssl_set_allow_dirty_shutdown(qry->bev, 1);
 	bufferevent_setcb(qry->bev, http_read_cb, write_cb, event_cb, qry);
+	bufferevent_enable(qry->bev, EV_READ);
 
 	{
 		void *ptr = NULL;
@@ -346,8 +391,10 @@ static bool tls_inst_start (struct tls_qry *qry, const char *cipher_q)
 				);
 
 		// warnx("could not connect to %s : %s", qry->ui->host, evutil_socket_error_to_string(EVUTIL_SOCKET_ERROR()));
+		evtimer_del(&qry->timeout_ev);
 		bufferevent_free(qry->bev);
 		qry->bev = NULL;
+		qry->ssl = NULL;
 		return TRUE;
 	}
 	else{
@@ -356,39 +403,37 @@ static bool tls_inst_start (struct tls_qry *qry, const char *cipher_q)
 	}
 	return FALSE;
 }
-static void ssl_c_init(struct tls_qry *qry)
+/* Start children for the pending ciphers, at most opt_max_con at a time.
+ * Each child offers up to opt_cipher_group ciphers.
+ */
+static void ssl_c_sched(struct tls_qry *qry)
 {
 	int i;
-	const char *p;
-	SSL *ssl = SSL_new(qry->ssl_ctx); /* this is a local one */
-
-	if (ssl == NULL)
-		return;
+	size_t len;
+	struct tls_qry *cqry = NULL; /* next child query */
 
-	for (i=0; ; i++)
+	while ((qry->n_pend > 0) && (qry->active_c < qry->ui->opt_max_con))
 	{
-		struct tls_qry *cqry = NULL; /* next child query */
+		cqry = xzalloc(sizeof(struct tls_qry));
 
-		p = SSL_get_cipher_list(ssl,i);
-		if (p == NULL) {
-			crondlog_aa(LVL7, "%s dst %s active = %d" " active_c = %d %s %s %s created %d children",  __func__,
-				qry->addrstr, qry->ui->active, qry->active_c, qry->sslv_str, p, qry->ui->host, i);
-			break;
+		len = 0;
+		for (i = 0; (i < qry->ui->opt_cipher_group) &&
+				(qry->n_pend > 0); i++) {
+			cqry->c_grp[i] = qry->c_pend[--qry->n_pend];
+			len += strlen(cqry->c_grp[i]) + 1;
+		}
+		cqry->n_grp = i;
+		cqry->cipher_grp = xzalloc(len);
+		for (i = 0; i < cqry->n_grp; i++) {
+			if (i > 0)
+				strcat(cqry->cipher_grp, ":");
+			strcat(cqry->cipher_grp, cqry->c_grp[i]);
 		}
-		/* skip the one that server picked. We know that is supported */
-		if (strlen(p) && strncmp(p, qry->cipher_r, strlen(p)) == 0)
-			continue;
 
 		qry->ui->active++;
-		cqry = xzalloc(sizeof(struct tls_qry));
-
-		if (cqry == NULL)
-			break;
-
-		qry->tls_incomplete = TRUE;
-		cqry->ui = qry->ui;
 		qry->ui->q_serial++;
 		qry->active_c++;
+		cqry->ui = qry->ui;
 		cqry->serial =  qry->ui->q_serial;
 
 		cqry->addr_curr = qry->addr_curr;
@@ -397,17 +442,82 @@ static void ssl_c_init(struct tls_qry *qry)
 		evtimer_assign(&cqry->free_child_ev, EventBase, free_child_cb, cqry);
 		cqry->sslv  = qry->sslv;
 		crondlog_aa(LVL7, "%s dst %s active = %d" " active_c = %d %s %s %s",  __func__,
-				qry->addrstr, qry->ui->active, qry->active_c, qry->sslv_str, p, qry->ui->host);
+				qry->addrstr, qry->ui->active, qry->active_c, qry->sslv_str, cqry->cipher_grp, qry->ui->host);
 		cqry->is_c = TRUE;
 		cqry->p = qry;
 		cqry->cc = qry->cc;
 		cqry->certs = qry->certs;
-		cqry->cfps = qry->cfps;
 		cqry->ciphers_s_buf = qry->ciphers_s_buf;
-		cqry->cipher_q = p;
-		tls_inst_start(cqry, p);
+		cqry->tls_incomplete = TRUE;
+		cqry->ssl_ctx = qry->ssl_ctx;
+		SSL_CTX_up_ref(cqry->ssl_ctx);
+
+		if (tls_inst_start(cqry, cqry->cipher_grp)) {
+			qry->ui->active--;
+			qry->active_c--;
+			SSL_CTX_free(cqry->ssl_ctx);
+			free(cqry->cipher_grp);
+			free(cqry);
+		}
+	}
+}
+
+/* A child offering several ciphers succeeded. The server picked one of
+ * them, the others are still unknown.
+ */
+static void ssl_c_requeue(struct tls_qry *cqry)
+{
+	int i;
+	const char *picked;
+	struct tls_qry *qry = cqry->p;
+
+	if (cqry->n_grp < 2)
+		return;
+
+	picked = SSL_CIPHER_get_name(SSL_get_current_cipher(cqry->ssl));
+	for (i = 0; i < cqry->n_grp; i++) {
+		if (strcmp(cqry->c_grp[i], picked) == 0)
+			break;
+	}
+	if (i == cqry->n_grp)
+		return; /* not one we offered, don't loop */
+
+	for (i = 0; i < cqry->n_grp; i++) {
+		if (strcmp(cqry->c_grp[i], picked) != 0)
+			qry->c_pend[qry->n_pend++] = cqry->c_grp[i];
+	}
+}
+
+static void ssl_c_init(struct tls_qry *qry)
+{
+	int i, n;
+	const char *p;
+	SSL *ssl = SSL_new(qry->ssl_ctx); /* this is a local one */
+
+	if (ssl == NULL)
+		return;
+
+	for (n=0; SSL_get_cipher_list(ssl, n) != NULL; n++)
+		;
+	qry->c_pend = xzalloc((n + 1) * sizeof(*qry->c_pend));
+	qry->n_pend = 0;
+
+	/* pending ciphers are taken from the end, store them reversed */
+	for (i=n-1; i >= 0; i--)
+	{
+		p = SSL_get_cipher_list(ssl,i);
+		/* skip the one that server picked. We know that is supported */
+		if (strlen(p) && strncmp(p, qry->cipher_r, strlen(p)) == 0)
+			continue;
+		qry->c_pend[qry->n_pend++] = p;
 	}
 	SSL_free(ssl);
+
+	crondlog_aa(LVL7, "%s dst %s active = %d" " %s %s %d ciphers to probe",  __func__,
+		qry->addrstr, qry->ui->active, qry->sslv_str, qry->ui->host, qry->n_pend);
+
+	qry->tls_incomplete = TRUE;
+	ssl_c_sched(qry);
 }
 
 static void atlas_cert_char_encode (struct buf *lbuf, BUF_MEM *bptr)
@@ -431,56 +541,52 @@ static void atlas_cert_char_encode (struct buf *lbuf, BUF_MEM *bptr)
 
 static char * add_cert_and_fp(unsigned char *md, X509* cert, struct tls_qry *qry, int *id) {
 	unsigned int n;
-	struct cert_fp *cfp = qry->cfps;
 	const EVP_MD *fdig = EVP_sha1();
-	int i = 0; 
-
+	unsigned char key[CERTCACHE_FP_LEN];
+	struct certcache_ent *ent;
 
-	if (X509_digest(cert,fdig,md,&n) == 0) 
+	if (X509_digest(cert, EVP_sha256(), key, &n) == 0 ||
+			X509_digest(cert,fdig,md,&n) == 0)
 	{
 		return "error in X509_digest";
 	}
 
-	*id = -1;
-	while ( cfp != NULL) {
-		if (memcmp(md, cfp->fp, EVP_MAX_MD_SIZE) == 0) 
-		{
-			*id = i;
-			break;
-		}
-		i++;
-		cfp = cfp->next;
-	} 
+	/* seen by any child of this run? */
+	ent = certcache_lookup(&qry->ui->certs, key, 1);
+	if (ent->tag == qry->ui->cert_tag) {
+		*id = ent->id;
+		return NULL;
+	}
+	*id = qry->ui->cert_n++;
+	ent->tag = qry->ui->cert_tag;
+	ent->id = *id;
 
 	/* this is a new certificate add to chain */ 
-
-	if (*id == -1) {
+	{
 		struct buf *lbuf = qry->cc;
-		BIO *b64 = BIO_new (BIO_s_mem());
-		BUF_MEM *bptr;
 		int k;
 		char c3[4];
 
-		cfp = xzalloc(sizeof(struct cert_fp));
-		cfp->next = qry->cfps;
-		qry->cfps = cfp;
-		memcpy(cfp->fp, md, EVP_MAX_MD_SIZE);
-
-		*id = i;
-		PEM_write_bio_X509(b64, cert);
-		BIO_get_mem_ptr(b64, &bptr);
-
 		if (lbuf->size == 0) {
-			if (i == 0) {
-				AS(", \"cert_chain\" : [");
-			}
-		}
-		if ( i > 0 )
+			AS(", \"cert_chain\" : [");
+		} else {
 			AS(", ");
+		}
 		AS("{");
-		JD(id , i);
-		atlas_cert_char_encode(lbuf, bptr);
-		BIO_free(b64);
+		if (qry->ui->opt_cert_ref && ent->uploaded) {
+			/* reported in full by an earlier run */
+			JD_NC(id , *id);
+		} else {
+			BIO *b64 = BIO_new (BIO_s_mem());
+			BUF_MEM *bptr;
+
+			PEM_write_bio_X509(b64, cert);
+			BIO_get_mem_ptr(b64, &bptr);
+			JD(id , *id);
+			atlas_cert_char_encode(lbuf, bptr);
+			BIO_free(b64);
+			ent->uploaded = 1;
+		}
 
 		AS(", \"fp\":\"");
 		for (k=0; k<(int)n; k++)
@@ -805,7 +911,6 @@ static void print_tls_resp(struct tls_qry *qry, bool is_err) {
 
 	if ((qry->p != NULL ) && (qry->p->active_c > 0)) {
 		qry->p->active_c--; 
-		active_c = qry->p->active_c;
 	}
 
 	if (qry->ui->opt_out_format & OUTPUT_FMT_CERTS_FULL) {
@@ -814,11 +919,23 @@ static void print_tls_resp(struct tls_qry *qry, bool is_err) {
 		fmt_ssl_summary(qry, is_err);
 	}
 
+	if (qry->p != NULL) {
+		/* a slot is free, start the next child */
+		if (!is_err && !qry->tls_incomplete && (qry->ssl != NULL))
+			ssl_c_requeue(qry);
+		ssl_c_sched(qry->p);
+		active_c = qry->p->active_c;
+		evtimer_add(&qry->free_child_ev, &asap);
+	}
+
 	if (((qry->p == NULL ) && (qry->active_c == 0)) ||
 			((qry->p != NULL ) && (qry->p->active_c == 0)))
 	{
 		struct buf *lbuf = &qry->ui->result;
-		evtimer_add(&qry->free_child_ev, &asap);
+		if (qry->p != NULL)
+			evtimer_add(&qry->p->free_child_ev, &asap);
+		else
+			evtimer_add(&qry->free_child_ev, &asap);
 		if (qry->ui->result.size == 0) { /* initialze the first parts RESULT */
 			fmt_ssl_ui_result(qry);
 		} else {
@@ -838,6 +955,7 @@ static void print_tls_resp(struct tls_qry *qry, bool is_err) {
 			if (qry->cc->size > 0) {
 				buf_add(&qry->ui->result, qry->cc->buf, qry->cc->size);
 				buf_cleanup(qry->cc);
+				AS("]");
 			} 
 
 			if (qry->ciphers_s_buf->size > 0) {
@@ -906,6 +1024,8 @@ int tlsscan_delete (void *st)
 		free(pqry->host);
 		pqry->host = NULL;
 	}
+
+	certcache_clear(&pqry->certs);
 	return 1;
 }
 
@@ -928,6 +1048,8 @@ static void timeout_cb(int unused  UNUSED_PARAM, const short event
 		snprintf(line, DEFAULT_LINE_LENGTH, "%s \"timeout\" : %d", qry->err.size ? ", " : "", DEFAULT_NOREPLY_TIMEOUT);
 		buf_add(&qry->err, line, strlen(line));
 	}
+	if (qry->bev != NULL) /* freed later, no more callbacks */
+		bufferevent_setcb(qry->bev, NULL, NULL, NULL, NULL);
 	print_tls_resp(qry, TRUE);
 }
 
@@ -1225,6 +1347,8 @@ static struct tls_state * tlsscan_init (int argc, char *argv[], void (*done)(voi
 	pqry->done = done;
 	pqry->opt_all_tests = TRUE;
 	pqry->timeout_tv.tv_sec = 5;
+	pqry->opt_max_con = DEFAULT_MAX_CON;
+	pqry->opt_cipher_group = 1;
 	pqry->opt_out_format = OUTPUT_FMT_CERTS_ARRAY;
 //	pqry->opt_out_format = OUTPUT_FMT_CERTS_FULL;
 
@@ -1263,6 +1387,32 @@ static struct tls_state * tlsscan_init (int argc, char *argv[], void (*done)(voi
                                         return (0);
                                 }
 				break;
+
+			case O_MAX_CON:
+				pqry->opt_max_con = strtoul(optarg, NULL, 10);
+				if ((pqry->opt_max_con <= 0) || (pqry->opt_max_con > 64)) {
+					fprintf(stderr, "ERROR invalid --max-con "
+							"%s ??.  1 - 64\n", optarg);
+					tlsscan_delete(pqry);
+					return (0);
+				}
+				break;
+
+			case O_CERT_REF:
+				pqry->opt_cert_ref = TRUE;
+				break;
+
+			case O_CIPHER_GROUP:
+				pqry->opt_cipher_group = strtoul(optarg, NULL, 10);
+				if ((pqry->opt_cipher_group <= 0) ||
+					(pqry->opt_cipher_group > MAX_CIPHER_GROUP)) {
+					fprintf(stderr, "ERROR invalid --cipher-group "
+							"%s ??.  1 - %d\n", optarg,
+							MAX_CIPHER_GROUP);
+					tlsscan_delete(pqry);
+					return (0);
+				}
+				break;
 		}
 	}
 
@@ -1415,6 +1565,11 @@ void tlsscan_start (struct tls_state *pqry)
 	pqry->hints.ai_flags = 0;
 
 	pqry->q_serial = 0;
+	/* Keep what the last run reported for opt_cert_ref */
+	certcache_expire(&pqry->certs, pqry->cert_tag);
+	if (++pqry->cert_tag == 0)
+		pqry->cert_tag++;
+	pqry->cert_n = 0;
 	pqry->q_success = 0;
 	pqry->active = 0;
 	pqry->retry = 0;
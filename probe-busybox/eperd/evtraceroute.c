@@ -14,16 +14,19 @@
 //kbuild:lib-$(CONFIG_EVTRACEROUTE) += evtraceroute.o
 
 //usage:#define evtraceroute_trivial_usage
-//usage:       "-[46FIrTU] [-a <paris mod>] [-b <paris base>] [-c <count>]"
+//usage:       "-[46FINPrTU] [-a <paris mod>] [-b <paris base>] [-c <count>]"
 //usage:       "\n\t[-f <hop>] [-g <gap>] [-i <interface>] [-m <maxhops>] "
 //usage:       "[-p <port>]\n\t[-t <tos>] [-w <ms>] [-z <ms>] [-A <string>] "
 //usage:       "[-B <bundle>] [-O <file>]\n\t[-S <size>] [-H <hbh size>] "
-//usage:       "[-D <dest. opt. size>] [-R <response in>]\n\t[-W <response out]"
+//usage:       "[-D <dest. opt. size>] [-R <response in>]\n\t[-W <response out] [-E <seconds>]"
+//usage:       "\n\t<target> [-- <options> <target>]..."
 //usage:#define evtraceroute_full_usage "\n"
 //usage:     "\n       -4                      Use IPv4 (default)"
 //usage:     "\n       -6                      Use IPv6"
 //usage:     "\n       -F                      Don't fragment"
 //usage:     "\n       -I                      Use ICMP"
+//usage:     "\n       -N                      Don't use the DNS cache"
+//usage:     "\n       -P                      Probe all hops in parallel"
 //usage:     "\n       -r                      Name resolution during each run"
 //usage:     "\n       -T                      Use TCP"
 //usage:     "\n       -U                      Use UDP (default)"
@@ -46,6 +49,10 @@
 //usage:     "\n       -D <size>               Add IPv6 Destination Option this size"
 //usage:     "\n       -R <file>               Response in file"
 //usage:     "\n       -W <file>               Response out file"
+//usage:     "\n       -E <seconds>            Stop set entry lifetime (enables stop set)"
+//usage:     "\n"
+//usage:     "\nRuns separated by -- are done one after the other in the same"
+//usage:     "\nprocess, so they share the stop set"
 
 #include "libbb.h"
 #include <syslog.h>
@@ -55,16 +62,32 @@
 
 #include "eperd.h"
 
+static void **states;
+static int nstates, curr_state;
+
+static void start_next(int unused UNUSED_PARAM, short event UNUSED_PARAM,
+	void *arg UNUSED_PARAM)
+{
+	traceroute_ops.start(states[curr_state]);
+}
+
 static void done(void *state UNUSED_PARAM, int error)
 {
-	exit(error);
+	struct timeval now= { 0, 0 };
+
+	curr_state++;
+	if (error || curr_state >= nstates)
+		exit(error);
+
+	/* Not from inside the previous run's callbacks */
+	event_base_once(EventBase, -1, EV_TIMEOUT, start_next, NULL, &now);
 }
 
 int evtraceroute_main(int argc, char **argv) MAIN_EXTERNALLY_VISIBLE;
-int evtraceroute_main(int argc UNUSED_PARAM, char **argv)
+int evtraceroute_main(int argc, char **argv)
 {
-	int r;
-	void *state;
+	int i, j, r;
+	char **run_argv;
 
 	/* Create libevent event base */
 	EventBase= event_base_new();
@@ -80,13 +103,29 @@ int evtraceroute_main(int argc UNUSED_PARAM, char **argv)
 		exit(1);
 	}
 
-	state= traceroute_ops.init(argc, argv, done);
-	if (!state)
+	/* Each run gets its own argument vector, starting with argv[0] */
+	states= xzalloc(argc * sizeof(*states));
+	run_argv= xzalloc((argc+1) * sizeof(*run_argv));
+	for (i= 1; i <= argc; i++)
 	{
-		fprintf(stderr, "evtraceroute: traceroute_ops.init failed\n");
-		exit(1);
+		run_argv[0]= argv[0];
+		for (j= 1; i < argc && strcmp(argv[i], "--") != 0; i++, j++)
+			run_argv[j]= argv[i];
+		run_argv[j]= NULL;
+
+		states[nstates]= traceroute_ops.init(j, run_argv, done);
+		if (!states[nstates])
+		{
+			fprintf(stderr,
+				"evtraceroute: traceroute_ops.init failed\n");
+			exit(1);
+		}
+		nstates++;
 	}
-	traceroute_ops.start(state);
+	free(run_argv);
+
+	curr_state= 0;
+	traceroute_ops.start(states[curr_state]);
 
 	r= event_base_loop(EventBase, 0);
 	if (r != 0)
@@ -96,4 +135,3 @@ int evtraceroute_main(int argc UNUSED_PARAM, char **argv)
 	}
 	return 0; /* not reached */
 }
-
@@ -7,6 +7,7 @@
 #include "libbb.h"
 #include "eperd.h"
 #include "http2.h"
+#include "http2_huffman.h"
 #include <assert.h>
 #include <stdarg.h>
 #include <event2/buffer.h>
@@ -22,6 +23,8 @@ struct http2_hdr
 	uint8_t stream_id[4];
 };
 
+#define HTTP2_PREFACE	"PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n"
+
 #define HTTP2_HDR_TYPE_DATA		0
 #define HTTP2_HDR_TYPE_HEADERS		1
 #define HTTP2_HDR_TYPE_RST_STREAM	3
@@ -53,11 +56,16 @@ struct http2_hdr
 
 #define HTTP2_DEFAULT_WINDOW	65535
 #define HTTP2_MAX_WINDOW	0x7fffffff
+#define HTTP2_MAX_STREAM_ID	0x7fffffff
+
+/* Return receive credits once half of a window is used up */
+#define HTTP2_UPDATE_THRESHOLD	(HTTP2_DEFAULT_WINDOW/2)
 
 #define HTTP2_PROTOCOL_ERROR		0x1
 #define HTTP2_INTERNAL_ERROR		0x2
 #define HTTP2_FLOW_CONTROL_ERROR	0x3
 #define HTTP2_FRAME_SIZE_ERROR		0x6
+#define HTTP2_CANCEL			0x8
 #define HTTP2_COMPRESSION_ERROR		0x9
 
 #define HTTP2_HEADER_STATUS	":status"
@@ -79,7 +87,20 @@ struct http2_hdr
 #define HPACK_LHFwI_MASK	0xF0
 #define HPACK_LHFwI_PREFIX_LEN	   4
 
-#define HPACK_LHFNI	0x10	
+#define HPACK_LHFNI	0x10	/* Literal Header Field Never Indexed */
+#define HPACK_LHFNI_MASK	0xF0
+
+#define HPACK_DTSU	0x20	/* Dynamic Table Size Update */
+#define HPACK_DTSU_MASK		0xE0
+#define HPACK_DTSU_PREFIX_LEN	   3
+
+/* We never send SETTINGS_HEADER_TABLE_SIZE, so the peer can use at most
+ * the default. Each entry counts its name, value and 32 octets.
+ */
+#define HPACK_TABLE_SIZE	4096
+#define HPACK_ENTRY_OVERHEAD	32
+#define HPACK_MAX_ENTRIES	(HPACK_TABLE_SIZE/HPACK_ENTRY_OVERHEAD)
+#define HPACK_ARENA_SIZE	(2*HPACK_TABLE_SIZE)
 
 #define HPACK_INT_MORE		0x80	/* More bytes follow */
 
@@ -87,7 +108,6 @@ struct http2_hdr
 #define HPACK_H_MASK		0x80
 #define HPACK_H_PREFIX_LEN	   1
 
-#define HPACK_HUFF_ENC_NO	256	/* Number of entries in huffman table */
 
 static struct table_ent
 {
@@ -255,7 +275,7 @@ struct huffman_encode
 /*  86 */ {       0x71,	 7,	'V' },
 /*  87 */ {       0x72,	 7,	'W' },
 /*  88 */ {       0xfc,	 8,	'X' },
-/*  89 */ {       0xf3,	 7,	'Y' },
+/*  89 */ {       0x73,	 7,	'Y' },
 /*  90 */ {       0xfd,	 8,	'Z' },
 /*  91 */ {     0x1ffb,	13,	'[' },
 /*  92 */ {    0x7fff0,	19,	'\\' },
@@ -424,64 +444,87 @@ struct huffman_encode
 /* 255 */ {  0x3ffffee,	26,	255 },
 };
 
-struct huffman_decode
-{
-	uint8_t bits;
-	uint8_t value;
-};
-
-static struct huffman_decode huffman_decode0[256];
-static struct huffman_decode huffman_decode_fe[256];
-static struct huffman_decode huffman_decode_ff[256];
-static struct huffman_decode huffman_decode_fffe[256];
-static struct huffman_decode huffman_decode_ffff[256];
-static struct huffman_decode huffman_decode_fffff[256];
-static struct huffman_decode huffman_decode_fffffe[16];
-static struct huffman_decode huffman_decode_ffffff[256];
-
 struct dyn
 {
-	char *key;
+	size_t offset;		/* Of the key in the arena, value follows */
 	size_t keylen;
-	char *value;
 	size_t valuelen;
 };
 
+/* One request on a connection */
+struct http2_stream
+{
+	struct http2_stream *next;
+	uint32_t id;
+	uint32_t send_credits;
+	int64_t window;			/* Send window, can go negative */
+	void *ref;
+	u_char *pending;		/* Request body waiting for credits */
+	size_t pending_len;
+	u_char *data;
+	size_t data_max;
+	size_t data_len;
+	bool type_html;
+	bool type_dns;
+	unsigned status;
+};
+
 struct http2_env
 {
 	uint32_t http2_send_global_credits;
-	uint32_t http2_send_stream1_credits;
-	uint32_t http2_connection_window;
-	uint32_t http2_stream1_window;
+	int64_t http2_connection_window;
+	uint32_t initial_window;	/* For new streams */
+	uint32_t max_streams;
+	uint32_t next_stream_id;
+	unsigned nstreams;
+	bool started;			/* Connection preface is sent */
+	bool goaway;
+	struct http2_stream *streams;
 	uint8_t *http2_headers;
 	size_t http2_headers_max;
 	size_t http2_headers_offset;
-	struct dyn *http2_dyn;
-	size_t http2_dyn_max;
-	size_t http2_dyn_idx;
+
+	/* HPACK dynamic table. Entries form a ring, oldest first. Their
+	 * keys and values are appended to the arena, which is compacted
+	 * when the end is reached.
+	 */
+	struct dyn http2_dyn[HPACK_MAX_ENTRIES];
+	unsigned http2_dyn_first;
+	unsigned http2_dyn_count;
+	size_t http2_dyn_size;		/* Current size as defined by HPACK */
+	size_t http2_dyn_max_size;	/* From table size updates */
+	size_t http2_dyn_end;		/* In use part of the arena */
+	bool http2_dyn_update_ok;	/* At the start of a header block */
+	char http2_dyn_arena[HPACK_ARENA_SIZE];
+
 	u_char *http2_input;
 	size_t http2_input_max;
 	size_t http2_input_len;
-	u_char *http2_data;
-	size_t http2_data_max;
-	size_t http2_data_len;
-	bool type_html;
-	bool type_dns;
-	bool done;
-	unsigned status;
 
 	struct evbuffer *outbuf;
 };
 
 static void send_request2(struct http2_env *env, struct evbuffer *outbuf,
-	char *hostname_port, const char *path, u_char *data, size_t datalen);
+	struct http2_stream *stream, char *hostname_port, const char *path,
+	u_char *data, size_t datalen);
+static void send_pending2(struct http2_env *env);
 static void send_settings2(struct evbuffer *outbuf);
+static void send_settings_ack2(struct evbuffer *outbuf);
 static void send_headers2(struct http2_env *env, struct evbuffer *outbuf,
 	uint32_t stream_id);
 static void send_data2(struct evbuffer *outbuf, u_char *data, size_t datalen,
 	uint32_t stream_id);
 static void send_goaway2(struct evbuffer *outbuf, uint32_t error_code,
 	uint32_t last_stream_id, const char *reason);
+static void send_rst_stream2(struct evbuffer *outbuf, uint32_t stream_id,
+	uint32_t error_code);
+static void send_window_update2(struct evbuffer *outbuf, uint32_t stream_id,
+	uint32_t increment);
+static struct http2_stream *find_stream2(struct http2_env *env,
+	uint32_t stream_id);
+static struct http2_stream *end_stream2(struct http2_env *env,
+	uint32_t stream_id);
+static void free_stream2(struct http2_stream *stream);
 static void add_header2(struct http2_env *env,
 	const char *name, const char *value);
 static void add_byte2(struct http2_env *env, uint8_t byte);
@@ -490,7 +533,8 @@ static void add_length2(struct http2_env *env, int prefix_len,
 static void add_str2(struct http2_env *env, const char *str);
 static int Xhttp2_dns_input1(struct http2_env *env, struct evbuffer *inbuf,
 	void *ref, http2_write_response_cb_t write_response_cb,
-	http2_read_response_cb_t read_response_cb);
+	http2_read_response_cb_t read_response_cb,
+	struct http2_stream **donep);
 static int Xreceive_data2(struct http2_env *env, struct http2_hdr *hdrp,
 	uint32_t length, uint32_t stream_id, u_char *buf);
 static int Xreceive_headers2(struct http2_env *env, struct http2_hdr *hdrp,
@@ -506,19 +550,21 @@ static int Xreceive_goaway2(struct http2_env *env,
 static int Xreceive_window_update2(struct http2_env *env,
 	uint32_t length, uint32_t stream_id, u_char *buf);
 static size_t Xdecode_header2(struct http2_env *env,
-	uint8_t *buf, size_t len, int verbose);
+	struct http2_stream *stream, uint8_t *buf, size_t len, int verbose);
 static void add_dyn(struct http2_env *env, const char *key, size_t keylen,
 	const char *value, size_t valuelen);
+static void evict_dyn(struct http2_env *env);
+static int Xresize_dyn(struct http2_env *env, uint32_t size);
 static int Xget_dyn(struct http2_env *env, uint32_t value,
 	const char **kp, size_t *klen, const char **vp, size_t *vlen);
 static size_t Xdecode_int2(struct http2_env *env, uint8_t *buf, size_t len,
 	int prefix_len, uint32_t *valuep);
-static void init_huffman(void);
 static size_t Xdecode_huffman2(struct http2_env *env, uint8_t *buf, size_t len,
 	char *outbuf, size_t outbuflen);
 static void add_credits2(struct http2_env *env,
-	uint32_t stream_id, uint32_t credits);
-static int Xreport_header(struct http2_env *env, int verbose,
+	struct http2_stream *stream, uint32_t credits);
+static int Xreport_header(struct http2_env *env,
+	struct http2_stream *stream, int verbose,
 	const char *key, size_t keylen, const char *value, size_t valuelen);
 static int Xparse_status_code2(struct http2_env *env, 
 	const char *value, size_t valuelen, int *statusp);
@@ -531,24 +577,26 @@ struct http2_env *http2_init(void)
 
 	env= malloc(sizeof(*env));
 	env->http2_send_global_credits= 0;
-	env->http2_send_stream1_credits= 0;
 	env->http2_connection_window= HTTP2_DEFAULT_WINDOW;
-	env->http2_stream1_window= HTTP2_DEFAULT_WINDOW;
+	env->initial_window= HTTP2_DEFAULT_WINDOW;
+	env->max_streams= UINT32_MAX;	/* No limit until the peer sets one */
+	env->next_stream_id= 1;
+	env->nstreams= 0;
+	env->started= false;
+	env->goaway= false;
+	env->streams= NULL;
 	env->http2_headers= NULL;
 	env->http2_headers_max= 0;
 	env->http2_headers_offset= 0;
-	env->http2_dyn= NULL;
-	env->http2_dyn_max= 0;
-	env->http2_dyn_idx= 0;
+	env->http2_dyn_first= 0;
+	env->http2_dyn_count= 0;
+	env->http2_dyn_size= 0;
+	env->http2_dyn_max_size= HPACK_TABLE_SIZE;
+	env->http2_dyn_end= 0;
+	env->http2_dyn_update_ok= false;
 	env->http2_input= NULL;
 	env->http2_input_max= 0;
 	env->http2_input_len= 0;
-	env->http2_data= NULL;
-	env->http2_data_max= 0;
-	env->http2_data_len= 0;
-	env->type_html= false;
-	env->type_dns= false;
-	env->done= false;
 	env->outbuf= NULL;
 
 	return env;
@@ -556,39 +604,41 @@ struct http2_env *http2_init(void)
 
 void http2_free(struct http2_env *env)
 {
-	int i;
+	struct http2_stream *stream;
 
-	free(env->http2_headers);
-	env->http2_headers= NULL;
-	for (i= 0; i<env->http2_dyn_idx; i++)
+	while ((stream= env->streams) != NULL)
 	{
-		free(env->http2_dyn[i].key);
-		env->http2_dyn[i].key= NULL;
-		free(env->http2_dyn[i].value);
-		env->http2_dyn[i].value= NULL;
+		env->streams= stream->next;
+		free_stream2(stream);
 	}
-	free(env->http2_dyn);
-	env->http2_dyn= NULL;
+	free(env->http2_headers);
+	env->http2_headers= NULL;
 	free(env->http2_input);
 	env->http2_input= NULL;
-	free(env->http2_data);
-	env->http2_data= NULL;
 	free(env);
 }
 
-void http2_dns(struct http2_env *env, struct bufferevent *bev,
-	const char *hostname, const char *port, const char *path,
-	u_char *req, size_t reqlen)
+/* Whether another request can be started on this connection */
+int http2_dns_avail(struct http2_env *env)
 {
-	static int first= 1;
+	return !env->goaway && env->next_stream_id <= HTTP2_MAX_STREAM_ID &&
+		env->nstreams < env->max_streams;
+}
 
+/* Start a request on a new stream. The reply is passed to reply_cb with
+ * 'ref'. Returns the stream ID, or 0 if the connection cannot take
+ * another stream.
+ */
+uint32_t http2_dns(struct http2_env *env, struct bufferevent *bev,
+	const char *hostname, const char *port, const char *path,
+	u_char *req, size_t reqlen, void *ref)
+{
+	struct evbuffer *outbuf;
+	struct http2_stream *stream;
 	char hostname_port[300];
 
-	if (first)
-	{
-		first= 0;
-		init_huffman();
-	}
+	if (!http2_dns_avail(env))
+		return 0;
 
 	if (strcmp(port, "443") == 0)
 	{
@@ -600,13 +650,55 @@ void http2_dns(struct http2_env *env, struct bufferevent *bev,
 			hostname, port);
 	}
 
+	stream= calloc(1, sizeof(*stream));
+	stream->id= env->next_stream_id;
+	stream->window= env->initial_window;
+	stream->ref= ref;
+	stream->next= env->streams;
+	env->streams= stream;
+	env->next_stream_id += 2;	/* Client streams are odd */
+	env->nstreams++;
+
+	if (bev)
+	{
+		outbuf= bufferevent_get_output(bev);
+		if (!env->started)
+		{
+			evbuffer_add(outbuf, HTTP2_PREFACE,
+				strlen(HTTP2_PREFACE));
+			send_settings2(outbuf);
+		}
+		send_request2(env, outbuf, stream, hostname_port, path,
+			req, reqlen);
+	}
+	env->started= true;
+
+	return stream->id;
+}
+
+/* Stop waiting for the reply on 'stream_id'. Data that is still in
+ * flight for the stream is dropped.
+ */
+void http2_dns_cancel(struct http2_env *env, struct bufferevent *bev,
+	uint32_t stream_id)
+{
+	struct http2_stream *stream;
+
+	stream= end_stream2(env, stream_id);
+	if (stream == NULL)
+		return;
 	if (bev)
 	{
-		send_request2(env, bufferevent_get_output(bev),
-			hostname_port, path, req, reqlen);
+		send_rst_stream2(bufferevent_get_output(bev), stream_id,
+			HTTP2_CANCEL);
 	}
+	free_stream2(stream);
 }
 
+/* Returns 0 after passing one reply to reply_cb, 1 if more input is needed
+ * and -1 on protocol errors. Call again after 0, there may be more replies
+ * in the input.
+ */
 int http2_dns_input(struct http2_env *env, struct bufferevent *bev,
 	http2_reply_cb_t reply_cb, void *ref,
 	http2_write_response_cb_t write_response_cb,
@@ -615,9 +707,7 @@ int http2_dns_input(struct http2_env *env, struct bufferevent *bev,
 	int r;
 	size_t avail;
 	struct evbuffer *inbuf;
-
-	if (env->done)
-		return -1;
+	struct http2_stream *stream;
 
 	if (bev)
 	{
@@ -643,27 +733,33 @@ int http2_dns_input(struct http2_env *env, struct bufferevent *bev,
 			return 1;
 		}
 
+		stream= NULL;
 		r= Xhttp2_dns_input1(env, inbuf, ref, write_response_cb,
-			read_response_cb);
+			read_response_cb, &stream);
 		if (r == -1)
 		{
 			env->outbuf= NULL;
 			return -1;
 		}
-		if (env->done)
+		if (stream)
 		{
-			reply_cb(ref, env->status,
-				env->http2_data, env->http2_data_len);
-			break;
+			/* The callback may free env */
+			env->outbuf= NULL;
+			reply_cb(stream->ref, stream->status,
+				stream->data, stream->data_len);
+			free_stream2(stream);
+			return 0;
 		}
 	}
-	env->outbuf= NULL;
-	return 0;
 }
 
+/* Process one frame. A stream that is complete is removed from env and
+ * returned in donep.
+ */
 static int Xhttp2_dns_input1(struct http2_env *env, struct evbuffer *inbuf,
 	void *ref, http2_write_response_cb_t write_response_cb,
-	http2_read_response_cb_t read_response_cb)
+	http2_read_response_cb_t read_response_cb,
+	struct http2_stream **donep)
 {
 	int r;
 	ssize_t n;
@@ -772,13 +868,15 @@ static int Xhttp2_dns_input1(struct http2_env *env, struct evbuffer *inbuf,
 		if (r == -1)
 			return -1;
 		if (http2_hdr->flags & HTTP2_HDR_DATA_END_STREAM)
-			env->done= true;
+			*donep= end_stream2(env, stream_id);
 		break;
 	case HTTP2_HDR_TYPE_HEADERS:
 		r= Xreceive_headers2(env, http2_hdr, length, stream_id,
 			0/*verbose*/, data);
 		if (r == -1)
 			return -1;
+		if (http2_hdr->flags & HTTP2_HDR_HEADERS_END_STREAM)
+			*donep= end_stream2(env, stream_id);
 		break;
 	case HTTP2_HDR_TYPE_RST_STREAM:
 		r= Xreceive_rst_stream2(env, length, stream_id, data);
@@ -817,16 +915,11 @@ static int Xhttp2_dns_input1(struct http2_env *env, struct evbuffer *inbuf,
 }
 
 static void send_request2(struct http2_env *env, struct evbuffer *outbuf,
-	char *hostname_port, const char *path, u_char *data, size_t datalen)
+	struct http2_stream *stream, char *hostname_port, const char *path,
+	u_char *data, size_t datalen)
 {
-	const char *start= "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n";
-
 	char str[20];
 
-	evbuffer_add(outbuf, start, strlen(start));
-
-	send_settings2(outbuf);
-
 	snprintf(str, sizeof(str), "%lu", datalen);
 	add_header2(env, ":method", "POST");
 	add_header2(env, ":scheme", "https");	/* We only do HTTP2 over TLS */
@@ -837,8 +930,47 @@ static void send_request2(struct http2_env *env, struct evbuffer *outbuf,
 	add_header2(env, "content-type", "application/dns-message");
 	add_header2(env, "content-length", str);
 
-	send_headers2(env, outbuf, 1);
-	send_data2(outbuf, data, datalen, 1);
+	send_headers2(env, outbuf, stream->id);
+
+	if (datalen > env->http2_connection_window ||
+		(int64_t)datalen > stream->window)
+	{
+		/* Wait for a window update */
+		stream->pending= malloc(datalen);
+		memcpy(stream->pending, data, datalen);
+		stream->pending_len= datalen;
+		return;
+	}
+	env->http2_connection_window -= datalen;
+	stream->window -= datalen;
+	send_data2(outbuf, data, datalen, stream->id);
+}
+
+/* Send request bodies that were held back by flow control */
+static void send_pending2(struct http2_env *env)
+{
+	struct http2_stream *stream;
+
+	if (env->outbuf == NULL)
+		return;
+
+	for (stream= env->streams; stream; stream= stream->next)
+	{
+		if (stream->pending == NULL)
+			continue;
+		if (stream->pending_len > env->http2_connection_window ||
+			(int64_t)stream->pending_len > stream->window)
+		{
+			continue;
+		}
+		env->http2_connection_window -= stream->pending_len;
+		stream->window -= stream->pending_len;
+		send_data2(env->outbuf, stream->pending, stream->pending_len,
+			stream->id);
+		free(stream->pending);
+		stream->pending= NULL;
+		stream->pending_len= 0;
+	}
 }
 
 static void send_settings2(struct evbuffer *outbuf)
@@ -869,6 +1001,26 @@ static void send_settings2(struct evbuffer *outbuf)
 	evbuffer_add(outbuf, &value, sizeof(value));
 }
 
+static void send_settings_ack2(struct evbuffer *outbuf)
+{
+	struct http2_hdr http2_hdr;
+
+	if (outbuf == NULL)
+		return;
+
+	http2_hdr.length[0]= 
+		http2_hdr.length[1]= 
+		http2_hdr.length[2]= 0;
+	http2_hdr.type= HTTP2_HDR_TYPE_SETTINGS;
+	http2_hdr.flags= HTTP2_HDR_SETTINGS_ACK;
+	http2_hdr.stream_id[0]= 
+		http2_hdr.stream_id[1]= 
+		http2_hdr.stream_id[2]= 
+		http2_hdr.stream_id[3]= 0;
+
+	evbuffer_add(outbuf, &http2_hdr, sizeof(http2_hdr));
+}
+
 static void send_headers2(struct http2_env *env, struct evbuffer *outbuf,
 	uint32_t stream_id)
 {
@@ -929,6 +1081,9 @@ static void send_goaway2(struct evbuffer *outbuf, uint32_t error_code,
 	fprintf(stderr, "send_goaway2: error %d, lat stream id %d, reason %s\n",
 		error_code, last_stream_id, reason);
 
+	if (outbuf == NULL)
+		return;		/* Replay */
+
 	data[0]= htonl(last_stream_id);
 	data[1]= htonl(error_code);
 
@@ -952,6 +1107,94 @@ static void send_goaway2(struct evbuffer *outbuf, uint32_t error_code,
 		evbuffer_add(outbuf, reason, strlen(reason));
 }
 
+static void send_rst_stream2(struct evbuffer *outbuf, uint32_t stream_id,
+	uint32_t error_code)
+{
+	size_t length;
+	uint32_t value;
+	struct http2_hdr http2_hdr;
+
+	length= sizeof(value);
+	http2_hdr.length[0]= (length >> 16) & 0xff;
+	http2_hdr.length[1]= (length >> 8) & 0xff;
+	http2_hdr.length[2]= length & 0xff;
+	http2_hdr.type= HTTP2_HDR_TYPE_RST_STREAM;
+	http2_hdr.flags= 0;
+	http2_hdr.stream_id[0]= (stream_id >> 24) & 0x7f;
+	http2_hdr.stream_id[1]= (stream_id >> 16) & 0xff;
+	http2_hdr.stream_id[2]= (stream_id >> 8) & 0xff;
+	http2_hdr.stream_id[3]= stream_id & 0xff;
+	value= htonl(error_code);
+
+	evbuffer_add(outbuf, &http2_hdr, sizeof(http2_hdr));
+	evbuffer_add(outbuf, &value, sizeof(value));
+}
+
+static void send_window_update2(struct evbuffer *outbuf, uint32_t stream_id,
+	uint32_t increment)
+{
+	size_t length;
+	uint32_t value;
+	struct http2_hdr http2_hdr;
+
+	if (outbuf == NULL)
+		return;		/* Replay */
+
+	length= sizeof(value);
+	http2_hdr.length[0]= (length >> 16) & 0xff;
+	http2_hdr.length[1]= (length >> 8) & 0xff;
+	http2_hdr.length[2]= length & 0xff;
+	http2_hdr.type= HTTP2_HDR_TYPE_WINDOW_UPDATE;
+	http2_hdr.flags= 0;
+	http2_hdr.stream_id[0]= (stream_id >> 24) & 0x7f;
+	http2_hdr.stream_id[1]= (stream_id >> 16) & 0xff;
+	http2_hdr.stream_id[2]= (stream_id >> 8) & 0xff;
+	http2_hdr.stream_id[3]= stream_id & 0xff;
+	value= htonl(increment);
+
+	evbuffer_add(outbuf, &http2_hdr, sizeof(http2_hdr));
+	evbuffer_add(outbuf, &value, sizeof(value));
+}
+
+static struct http2_stream *find_stream2(struct http2_env *env,
+	uint32_t stream_id)
+{
+	struct http2_stream *stream;
+
+	for (stream= env->streams; stream; stream= stream->next)
+	{
+		if (stream->id == stream_id)
+			return stream;
+	}
+	return NULL;
+}
+
+/* Remove a stream from env. Returns NULL if the stream is not open */
+static struct http2_stream *end_stream2(struct http2_env *env,
+	uint32_t stream_id)
+{
+	struct http2_stream *stream, **streamp;
+
+	for (streamp= &env->streams; *streamp; streamp= &(*streamp)->next)
+	{
+		stream= *streamp;
+		if (stream->id != stream_id)
+			continue;
+		*streamp= stream->next;
+		stream->next= NULL;
+		env->nstreams--;
+		return stream;
+	}
+	return NULL;
+}
+
+static void free_stream2(struct http2_stream *stream)
+{
+	free(stream->pending);
+	free(stream->data);
+	free(stream);
+}
+
 static void add_header2(struct http2_env *env,
 	const char *name, const char *value)
 {
@@ -1118,51 +1361,20 @@ static size_t encode_huffman2(char *buf, size_t len,
 	fatal("should do trailer");
 }
 
-static void send_credits2(FILE *file)
-{
-	u32_t length, window, stream_id;
-	struct http2_hdr http2_hdr;
-
-	length= sizeof(window);
-	http2_hdr.length[0]= (length >> 16) & 0xff;
-	http2_hdr.length[1]= (length >> 8) & 0xff;
-	http2_hdr.length[2]= length & 0xff;
-	http2_hdr.type= HTTP2_HDR_TYPE_WINDOW_UPDATE;
-	http2_hdr.flags= 0;
-	http2_hdr.stream_id[0]= 
-		http2_hdr.stream_id[1]= 
-		http2_hdr.stream_id[2]= 
-		http2_hdr.stream_id[3]= 0;
-	window= htonl(http2_send_global_credits);
-	http2_send_global_credits= 0;
-	assert(window);
-
-	fwrite(&http2_hdr, sizeof(http2_hdr), 1, file);
-	fwrite(&window, sizeof(window), 1, file);
-
-	if (http2_send_stream1_credits)
-	{
-		stream_id= 1;
-		http2_hdr.stream_id[0]= (stream_id >> 24) & 0x7f;
-		http2_hdr.stream_id[1]= (stream_id >> 16) & 0xff;
-		http2_hdr.stream_id[2]= (stream_id >> 8) & 0xff;
-		http2_hdr.stream_id[3]= stream_id & 0xff;
-
-		window= htonl(http2_send_stream1_credits);
-		http2_send_stream1_credits= 0;
-		assert(window);
-
-		fwrite(&http2_hdr, sizeof(http2_hdr), 1, file);
-		fwrite(&window, sizeof(window), 1, file);
-	}
-}
-
 #endif
 
 static int Xreceive_data2(struct http2_env *env, struct http2_hdr *hdrp,
 	uint32_t length, uint32_t stream_id, u_char *buf)
 {
 	size_t data_len, needed, pad_offset, pad_length;
+	struct http2_stream *stream;
+
+	if (stream_id == 0 || stream_id >= env->next_stream_id)
+	{
+		send_goaway2(env->outbuf, HTTP2_PROTOCOL_ERROR, 0,
+			"data on stream that is not open");
+		return -1;
+	}
 
 	if (hdrp->flags & HTTP2_HDR_DATA_PADDED)
 	{
@@ -1181,25 +1393,31 @@ static int Xreceive_data2(struct http2_env *env, struct http2_hdr *hdrp,
 		pad_length= 0;
 	}
 
-	add_credits2(env, stream_id, length);
+	/* A cancelled stream still uses up the connection window */
+	stream= find_stream2(env, stream_id);
+	add_credits2(env,
+		(hdrp->flags & HTTP2_HDR_DATA_END_STREAM) ? NULL : stream,
+		length);
+	if (stream == NULL)
+		return 0;
 
 	data_len= length-(pad_offset+pad_length);
-	if (env->type_html)
+	if (stream->type_html)
 	{
 		fprintf(stderr, "%.*s", (int)data_len, buf+pad_offset);
 	}
-	if (env->type_dns)
+	if (stream->type_dns)
 	{
-		needed= env->http2_data_len+data_len;
-		if (env->http2_data_max < needed)
+		needed= stream->data_len+data_len;
+		if (stream->data_max < needed)
 		{
 			needed += 4096;
-			env->http2_data= realloc(env->http2_data, needed);
-			env->http2_data_max= needed;
+			stream->data= realloc(stream->data, needed);
+			stream->data_max= needed;
 		}
-		memcpy(env->http2_data+env->http2_data_len,
+		memcpy(stream->data+stream->data_len,
 			buf+pad_offset, data_len);
-		env->http2_data_len += data_len;
+		stream->data_len += data_len;
 	}
 
 	return 0;
@@ -1209,6 +1427,7 @@ static int Xreceive_headers2(struct http2_env *env, struct http2_hdr *hdrp,
 	uint32_t length, uint32_t stream_id,  int verbose, u_char *buf)
 {
 	size_t o, headers_len, len, pad_offset, pad_length, prio_offset;
+	struct http2_stream *stream;
 
 	if (stream_id == 0)
 	{
@@ -1216,14 +1435,19 @@ static int Xreceive_headers2(struct http2_env *env, struct http2_hdr *hdrp,
 			"0 stream ID");
 		return -1;
 	}
-	if (stream_id != 1)
+	if (stream_id >= env->next_stream_id || !(stream_id & 1))
 	{
-		/* We create and support only one stream */
+		/* Push is disabled, only our own streams can be open */
 		send_goaway2(env->outbuf, HTTP2_PROTOCOL_ERROR, 0,
 			"stream not open");
 		return -1;
 	}
 
+	/* Headers of a cancelled stream are decoded anyway to keep the
+	 * dynamic table in sync.
+	 */
+	stream= find_stream2(env, stream_id);
+
 	if (hdrp->flags & HTTP2_HDR_HEADERS_PADDED)
 	{
 		pad_offset= 1;
@@ -1249,9 +1473,11 @@ static int Xreceive_headers2(struct http2_env *env, struct http2_hdr *hdrp,
 
 	o= pad_offset+prio_offset;
 	headers_len= length-pad_length;
+	env->http2_dyn_update_ok= true;
 	while (o < length)
 	{
-		len= Xdecode_header2(env, buf+o, headers_len-o, verbose);
+		len= Xdecode_header2(env, stream, buf+o, headers_len-o,
+			verbose);
 		if (len == 0)
 			return -1;
 		o += len;
@@ -1263,6 +1489,7 @@ static int Xreceive_rst_stream2(struct http2_env *env, uint32_t length,
 	uint32_t stream_id, u_char *buf)
 {
 	uint32_t value;
+	struct http2_stream *stream;
 
 	if (length != 4)
 	{
@@ -1281,6 +1508,11 @@ static int Xreceive_rst_stream2(struct http2_env *env, uint32_t length,
 
 	fprintf(stderr, "Got RST on stream %u with error %u\n", 
 		stream_id, value);
+
+	/* The request times out */
+	stream= end_stream2(env, stream_id);
+	if (stream)
+		free_stream2(stream);
 	return 0;
 }
 
@@ -1291,6 +1523,7 @@ static int Xreceive_settings2(struct http2_env *env, struct http2_hdr *hdrp,
 	uint16_t type;
 	uint32_t value;
 	uint8_t *setting;
+	struct http2_stream *stream;
 
 	if (length % 6 != 0)
 	{
@@ -1347,6 +1580,7 @@ static int Xreceive_settings2(struct http2_env *env, struct http2_hdr *hdrp,
 			"receive_settings2: max concurrent streams %u\n",
 				value);
 #endif
+			env->max_streams= value;
 			break;
 		case HTTP2_HDR_SETTINGS_INITIAL_WINDOW_SIZE:
 #if 0
@@ -1354,6 +1588,22 @@ static int Xreceive_settings2(struct http2_env *env, struct http2_hdr *hdrp,
 			"receive_settings2: initial window size %u\n",
 				value);
 #endif
+			if (value > HTTP2_MAX_WINDOW)
+			{
+				send_goaway2(env->outbuf,
+					HTTP2_FLOW_CONTROL_ERROR,
+					0, "initial window too large");
+				return -1;
+			}
+
+			/* Applies to streams that are already open */
+			for (stream= env->streams; stream;
+				stream= stream->next)
+			{
+				stream->window += (int64_t)value -
+					env->initial_window;
+			}
+			env->initial_window= value;
 			break;
 		case HTTP2_HDR_SETTINGS_MAX_FRAME_SIZE:
 #if 0
@@ -1376,6 +1626,11 @@ static int Xreceive_settings2(struct http2_env *env, struct http2_hdr *hdrp,
 			break;
 		}
 	}
+	if (!(hdrp->flags & HTTP2_HDR_SETTINGS_ACK))
+	{
+		send_settings_ack2(env->outbuf);
+		send_pending2(env);
+	}
 	return 0;
 }
 
@@ -1426,6 +1681,9 @@ static int Xreceive_goaway2(struct http2_env *env,
 
 	fprintf(stderr, "receive_goaway2: last-stream-ID: %u\n", value);
 
+	/* No new streams on this connection */
+	env->goaway= true;
+
 	memcpy(&value, data+4, sizeof(value));
 	value= ntohl(value);
 
@@ -1443,7 +1701,8 @@ static int Xreceive_window_update2(struct http2_env *env,
 	uint32_t length, uint32_t stream_id, u_char *buf)
 {
 	uint32_t value;
-	uint32_t *windowp;
+	int64_t *windowp;
+	struct http2_stream *stream;
 
 	if (length != 4)
 	{
@@ -1463,16 +1722,21 @@ static int Xreceive_window_update2(struct http2_env *env,
 
 	if (stream_id == 0)
 		windowp= &env->http2_connection_window;
-	else if (stream_id == 1)
-		windowp= &env->http2_stream1_window;
-	else
+	else if (stream_id >= env->next_stream_id)
 	{
-		send_goaway2(env->outbuf, HTTP2_INTERNAL_ERROR,
-			0, "window increment for unknown stream");
+		send_goaway2(env->outbuf, HTTP2_PROTOCOL_ERROR,
+			0, "window increment for idle stream");
 		return -1;
 	}
+	else
+	{
+		stream= find_stream2(env, stream_id);
+		if (stream == NULL)
+			return 0;	/* Stream is closed */
+		windowp= &stream->window;
+	}
 	
-	/* Update connection window */
+	/* Update window */
 	*windowp += value;
 	if (*windowp > HTTP2_MAX_WINDOW)
 	{
@@ -1480,13 +1744,15 @@ static int Xreceive_window_update2(struct http2_env *env,
 			0, "window overflow");
 		return -1;
 	}
+	send_pending2(env);
 	return 0;
 }
 
 static size_t Xdecode_header2(struct http2_env *env,
-	uint8_t *buf, size_t len, int verbose)
+	struct http2_stream *stream, uint8_t *buf, size_t len, int verbose)
 {
 	int r;
+	bool indexing;
 	uint8_t byte;
 	uint32_t value;
 	size_t o, klen, vlen, namelen, tmplen;
@@ -1502,6 +1768,27 @@ static size_t Xdecode_header2(struct http2_env *env,
 #if 0
 	fprintf(stderr, "decode_header2: byte 0x%x\n", byte);
 #endif
+	if ((byte & HPACK_DTSU_MASK) == HPACK_DTSU)
+	{
+		/* Dynamic Table Size Update, only before the first header
+		 * field of a block.
+		 */
+		if (!env->http2_dyn_update_ok)
+		{
+			send_goaway2(env->outbuf, HTTP2_COMPRESSION_ERROR,
+				0, "table size update after header field");
+			return 0;
+		}
+		tmplen= Xdecode_int2(env, buf, len, HPACK_DTSU_PREFIX_LEN,
+			&value);
+		if (tmplen == 0)
+			return 0;
+		if (Xresize_dyn(env, value) == -1)
+			return 0;
+		return tmplen;
+	}
+	env->http2_dyn_update_ok= false;
+
 	if ((byte & HPACK_IHF_MASK) == HPACK_IHF)
 	{
 		tmplen= Xdecode_int2(env, buf, len, HPACK_IHF_PREFIX_LEN, &value);
@@ -1518,7 +1805,8 @@ static size_t Xdecode_header2(struct http2_env *env,
 			r= Xget_dyn(env, value, &kp, &klen, &vp, &vlen);
 			if (r == -1)
 				return 0;
-			r= Xreport_header(env, verbose, kp, klen, vp, vlen);
+			r= Xreport_header(env, stream, verbose,
+				kp, klen, vp, vlen);
  			if (r == -1)
 				return 0;
 			return tmplen;
@@ -1530,22 +1818,25 @@ static size_t Xdecode_header2(struct http2_env *env,
 				0, "entry has no value");
 			return 0;
 		}
-		add_dyn(env, ent->name, strlen(ent->name),
-                        ent->value, strlen(ent->value));
-		r= Xreport_header(env, verbose, ent->name, strlen(ent->name),
+		r= Xreport_header(env, stream, verbose,
+			ent->name, strlen(ent->name),
 			ent->value, strlen(ent->value));
  		if (r == -1)
 			return 0;
 		return tmplen;
 	}
-	if (byte == HPACK_LHFII || byte == HPACK_LHFwI)
+	if (byte == HPACK_LHFII || byte == HPACK_LHFwI || byte == HPACK_LHFNI)
 	{
 		/* Literal Header Field without Indexing --
 		 * New Name
 		 * or
 		 * Literal Header Field with Incremental Indexing --
 		 * New Name
+		 * or
+		 * Literal Header Field Never Indexed --
+		 * New Name
 		 */
+		indexing= (byte == HPACK_LHFII);
 		o= 1;
 		if (o >= len)
 		{
@@ -1617,19 +1908,25 @@ static size_t Xdecode_header2(struct http2_env *env,
 			if (tmplen == 0)
 				return 0;
 			o += value;
-			add_dyn(env, namebuf, strlen(namebuf),
-                        	strbuf, tmplen);
-			r= Xreport_header(env, verbose, namebuf, strlen(namebuf),
-				strbuf, tmplen);
+			if (indexing)
+			{
+				add_dyn(env, namebuf, strlen(namebuf),
+					strbuf, tmplen);
+			}
+			r= Xreport_header(env, stream, verbose,
+				namebuf, strlen(namebuf), strbuf, tmplen);
  			if (r == -1)
 				return 0;
 			return o;
 		}
 
-		add_dyn(env, namebuf, strlen(namebuf),
-                        (char *)buf+o, value);
-		r= Xreport_header(env, verbose, namebuf, strlen(namebuf),
-			(char *)buf+o, value);
+		if (indexing)
+		{
+			add_dyn(env, namebuf, strlen(namebuf),
+				(char *)buf+o, value);
+		}
+		r= Xreport_header(env, stream, verbose,
+			namebuf, strlen(namebuf), (char *)buf+o, value);
  		if (r == -1)
 			return 0;
 		o += value;
@@ -1656,6 +1953,17 @@ static size_t Xdecode_header2(struct http2_env *env,
 			r= Xget_dyn(env, value, &namep, &namelen, &vp, &vlen);
 			if (r == -1)
 				return 0;
+
+			/* The entry may be evicted by add_dyn */
+			if (namelen > sizeof(namebuf))
+			{
+				send_goaway2(env->outbuf,
+					HTTP2_COMPRESSION_ERROR,
+					0, "name too long");
+				return 0;
+			}
+			memcpy(namebuf, namep, namelen);
+			namep= namebuf;
 			ent= NULL;
 		}
 		else
@@ -1694,7 +2002,7 @@ static size_t Xdecode_header2(struct http2_env *env,
 				return 0;
 			o += value;
 			add_dyn(env, namep, namelen, strbuf, tmplen);
-			r= Xreport_header(env, verbose, namep, namelen,
+			r= Xreport_header(env, stream, verbose, namep, namelen,
 				strbuf, tmplen);
  			if (r == -1)
 				return 0;
@@ -1702,16 +2010,20 @@ static size_t Xdecode_header2(struct http2_env *env,
 		}
 
 		add_dyn(env, namep, namelen, (char *)buf+o, value);
-		r= Xreport_header(env, verbose, namep, namelen,
+		r= Xreport_header(env, stream, verbose, namep, namelen,
 			(char *)buf+o, value);
  		if (r == -1)
 			return 0;
 		o += value;
 		return o;
 	}
-	if ((byte & HPACK_LHFwI_MASK) == HPACK_LHFwI)
+	if ((byte & HPACK_LHFwI_MASK) == HPACK_LHFwI ||
+		(byte & HPACK_LHFNI_MASK) == HPACK_LHFNI)
 	{
 		/* Literal Header Field without Indexing --
+		 * Indexed Name
+		 * or
+		 * Literal Header Field Never Indexed --
 		 * Indexed Name
 		 */
 		o= 0;
@@ -1767,14 +2079,14 @@ static size_t Xdecode_header2(struct http2_env *env,
 			if (tmplen == 0)
 				return 0;
 			o += value;
-			r= Xreport_header(env, verbose, namep, namelen,
+			r= Xreport_header(env, stream, verbose, namep, namelen,
 				strbuf, tmplen);
  			if (r == -1)
 				return 0;
 			return o;
 		}
 
-		r= Xreport_header(env, verbose, namep, namelen,
+		r= Xreport_header(env, stream, verbose, namep, namelen,
 			(char *)buf+o, value);
  		if (r == -1)
 			return 0;
@@ -1787,50 +2099,108 @@ static size_t Xdecode_header2(struct http2_env *env,
 	return 0;
 }
 
+/* Add an entry, evicting old ones to make room. Key and value must not
+ * point into the table.
+ */
 static void add_dyn(struct http2_env *env, const char *key, size_t keylen,
 	const char *value, size_t valuelen)
 {
-	size_t needed;
-	void *k1, *v1;
+	unsigned i;
+	size_t size, start;
 	struct dyn *dyn;
 
-	if (env->http2_dyn_max < env->http2_dyn_idx+1)
+	size= keylen + valuelen + HPACK_ENTRY_OVERHEAD;
+	while (env->http2_dyn_count > 0 &&
+		env->http2_dyn_size + size > env->http2_dyn_max_size)
 	{
-		needed= env->http2_dyn_idx+16;
-		env->http2_dyn= realloc(env->http2_dyn, needed*sizeof(*dyn));
-		env->http2_input_max= needed;
+		evict_dyn(env);
+	}
+
+	/* An entry that is larger than the table just empties it */
+	if (size > env->http2_dyn_max_size)
+		return;
+
+	if (env->http2_dyn_end + keylen + valuelen > HPACK_ARENA_SIZE)
+	{
+		/* Move the live entries to the start of the arena. They
+		 * take less than HPACK_TABLE_SIZE, so this happens at
+		 * most once per HPACK_TABLE_SIZE octets added.
+		 */
+		start= env->http2_dyn[env->http2_dyn_first].offset;
+		memmove(env->http2_dyn_arena, env->http2_dyn_arena+start,
+			env->http2_dyn_end-start);
+		env->http2_dyn_end -= start;
+		for (i= 0; i<env->http2_dyn_count; i++)
+		{
+			env->http2_dyn[(env->http2_dyn_first+i) %
+				HPACK_MAX_ENTRIES].offset -= start;
+		}
 	}
-	dyn= &env->http2_dyn[env->http2_dyn_idx];
-	k1= malloc(keylen);
-	memcpy(k1, key, keylen);
-	v1= malloc(valuelen);
-	memcpy(v1, value, valuelen);
-	dyn->key= k1;
+
+	dyn= &env->http2_dyn[(env->http2_dyn_first+env->http2_dyn_count) %
+		HPACK_MAX_ENTRIES];
+	dyn->offset= env->http2_dyn_end;
 	dyn->keylen= keylen;
-	dyn->value= v1;
 	dyn->valuelen= valuelen;
-	env->http2_dyn_idx++;
+	memcpy(env->http2_dyn_arena+dyn->offset, key, keylen);
+	memcpy(env->http2_dyn_arena+dyn->offset+keylen, value, valuelen);
+	env->http2_dyn_end += keylen+valuelen;
+	env->http2_dyn_size += size;
+	env->http2_dyn_count++;
+}
+
+/* Remove the oldest entry */
+static void evict_dyn(struct http2_env *env)
+{
+	struct dyn *dyn;
+
+	assert(env->http2_dyn_count > 0);
+	dyn= &env->http2_dyn[env->http2_dyn_first];
+	env->http2_dyn_size -= dyn->keylen + dyn->valuelen +
+		HPACK_ENTRY_OVERHEAD;
+	env->http2_dyn_first= (env->http2_dyn_first+1) % HPACK_MAX_ENTRIES;
+	env->http2_dyn_count--;
+	if (env->http2_dyn_count == 0)
+		env->http2_dyn_end= 0;
+}
+
+static int Xresize_dyn(struct http2_env *env, uint32_t size)
+{
+	if (size > HPACK_TABLE_SIZE)
+	{
+		send_goaway2(env->outbuf, HTTP2_COMPRESSION_ERROR,
+			0, "table size update too large");
+		return -1;
+	}
+	env->http2_dyn_max_size= size;
+	while (env->http2_dyn_size > env->http2_dyn_max_size)
+		evict_dyn(env);
+	return 0;
 }
 
+/* Index 62 is the newest entry. The result is valid until the next call
+ * to add_dyn.
+ */
 static int Xget_dyn(struct http2_env *env, uint32_t value,
 	const char **kp, size_t *klen, const char **vp, size_t *vlen)
 {
 	struct dyn *dyn;
 
-	if (value < HPACK_STATIC_NR)
+	if (value <= HPACK_STATIC_NR)
 		fatal("bad value for get_dyn");
-	value -= HPACK_STATIC_NR;
-	if (value >= env->http2_dyn_idx)
+	value -= HPACK_STATIC_NR+1;
+	if (value >= env->http2_dyn_count)
 	{
 		send_goaway2(env->outbuf, HTTP2_COMPRESSION_ERROR,
 			0, "bad dynamic index");
 		return -1;
 	}
-	dyn= &env->http2_dyn[env->http2_dyn_idx-1-value];
+	dyn= &env->http2_dyn[(env->http2_dyn_first+env->http2_dyn_count-1-
+		value) % HPACK_MAX_ENTRIES];
 
-	*kp= dyn->key;
+	*kp= env->http2_dyn_arena+dyn->offset;
 	*klen= dyn->keylen;
-	*vp= dyn->value;
+	*vp= env->http2_dyn_arena+dyn->offset+dyn->keylen;
 	*vlen= dyn->valuelen;
 
 	return 0;
@@ -1895,1124 +2265,131 @@ static size_t Xdecode_int2(struct http2_env *env, uint8_t *buf, size_t len,
 	return 0;
 }
 
-static void init_huffman(void)
+/* Returns the number of octets decoded, 0 on errors */
+static size_t Xdecode_huffman2(struct http2_env *env, uint8_t *buf, size_t len,
+	char *outbuf, size_t outbuflen)
 {
-	uint8_t byte, mask, nibble;
-	int i, j, len;
-
-	/* Check consitency of huffman_encode */
-	assert(sizeof(huffman_encode)/sizeof(huffman_encode[0]) ==
-		HPACK_HUFF_ENC_NO);
+	unsigned l, nbits, sym;
+	uint32_t code;
+	uint64_t acc;
+	size_t o, o_out;
+	const struct huffman_fast *f;
 
-	for (i= 0; i< HPACK_HUFF_ENC_NO; i++)
+	/* Bits are kept left-aligned in acc */
+	acc= 0;
+	nbits= 0;
+	o= 0;
+	o_out= 0;
+	for (;;)
 	{
-		if (huffman_encode[i].value != i)
+		if (nbits < 32)
 		{
-			fatal(
-		"init_huffman: bad value in huffman_encode: row %d, found %d",
-				i, huffman_encode[i].value);
-		}
-	}
-
-	/* Fill in huffman_decode0 table */
-	for (i= 0; i< HPACK_HUFF_ENC_NO; i++)
-	{
-		len= huffman_encode[i].bits;
-		if (len >= 8)
-		{
-			byte= huffman_encode[i].encoding >> (len-8);
-			assert(byte < 256);
-			if (huffman_decode0[byte].bits == 0)
-			{
-				/* New entry */
-				huffman_decode0[byte].bits= len;
-				huffman_decode0[byte].value=
-					huffman_encode[i].value;
-			}
-			else
-			{
-				/* Existing entry. Old and new bits need
-				 * to be more than 8
-				 */
-				if (huffman_decode0[byte].bits <= 8 ||
-					len <= 8)
-				{
-					fatal(
-					"init_huffman: inconsistent entry");
-				}
-			}
-			continue;
-		}
-		byte= huffman_encode[i].encoding << (8-len);
-		assert(byte < 256);
-		mask= (1 << (8-len))-1;
-		for (j= 0; j<= mask; j++)
-		{
-			if (huffman_decode0[byte+j].bits != 0)
-			{
-				fatal(
-"init_huffman: duplicate entry: adding row %d, byte 0x%x, offset %d, found bits %d, value %d",
-					i, byte, j,
-					huffman_decode0[byte+j].bits,
-					huffman_decode0[byte+j].value);
-			}
-
-			/* New entry */
-			huffman_decode0[byte+j].bits= len;
-			huffman_decode0[byte+j].value=
-				huffman_encode[i].value;
-		}
-	}
-
-	/* Check that all entries have been filled-in */
-	for (i= 0; i< HPACK_HUFF_ENC_NO; i++)
-	{
-		assert(huffman_decode0[i].bits > 0);
-	}
-
-	/* Fill in huffman_decode_fe table */
-	for (i= 0; i< HPACK_HUFF_ENC_NO; i++)
-	{
-		len= huffman_encode[i].bits;
-		if (len <= 8)
-			continue;
-
-		if (((huffman_encode[i].encoding >> (len-8)) & 0xff) != 0xfe)
-			continue;	/* No FE prefix */
-
-		len -= 8;
-		assert(len < 8);
-
-		byte= huffman_encode[i].encoding << (8-len);
-		assert(byte < 256);
-		mask= (1 << (8-len))-1;
-		for (j= 0; j<= mask; j++)
-		{
-			if (huffman_decode_fe[byte+j].bits != 0)
-			{
-				fatal(
-"init_huffman: duplicate entry: adding row %d, byte 0x%x, offset %d, found bits %d, value %d",
-					i, byte, j,
-					huffman_decode_fe[byte+j].bits,
-					huffman_decode_fe[byte+j].value);
-			}
-
-			/* New entry */
-			huffman_decode_fe[byte+j].bits= len;
-			huffman_decode_fe[byte+j].value=
-				huffman_encode[i].value;
-		}
-	}
-
-	/* Check that all entries have been filled-in */
-	for (i= 0; i< HPACK_HUFF_ENC_NO; i++)
-	{
-		if (huffman_decode_fe[i].bits == 0)
-		{
-			fatal(
-			"init_huffman: empty entry %d in huffman_decode_fe",
-				i);
-		}
-	}
-
-	/* Fill in huffman_decode_ff table */
-	for (i= 0; i< HPACK_HUFF_ENC_NO; i++)
-	{
-		len= huffman_encode[i].bits;
-		if (len <= 8)
-			continue;
-
-		if (((huffman_encode[i].encoding >> (len-8)) & 0xff) != 0xff)
-			continue;	/* No FF prefix */
-
-		len -= 8;
-		if (len >= 8)
-		{
-			byte= huffman_encode[i].encoding >> (len-8);
-			assert(byte < 256);
-			if (huffman_decode_ff[byte].bits == 0)
-			{
-				/* New entry */
-				huffman_decode_ff[byte].bits= len;
-				huffman_decode_ff[byte].value=
-					huffman_encode[i].value;
-			}
-			else
-			{
-				/* Existing entry. Old and new bits need
-				 * to be more than 8
-				 */
-				if (huffman_decode_ff[byte].bits <= 8 ||
-					len <= 8)
-				{
-					fatal(
-					"init_huffman: inconsistent entry");
-				}
-			}
-			continue;
-		}
-
-		byte= huffman_encode[i].encoding << (8-len);
-		assert(byte < 256);
-		mask= (1 << (8-len))-1;
-		for (j= 0; j<= mask; j++)
-		{
-			if (huffman_decode_ff[byte+j].bits != 0)
-			{
-				fatal(
-"init_huffman: duplicate entry: adding row %d, byte 0x%x, offset %d, found bits %d, value %d",
-					i, byte, j,
-					huffman_decode_ff[byte+j].bits,
-					huffman_decode_ff[byte+j].value);
-			}
-
-			/* New entry */
-			huffman_decode_ff[byte+j].bits= len;
-			huffman_decode_ff[byte+j].value=
-				huffman_encode[i].value;
-		}
-	}
-
-	/* Check that all entries have been filled-in */
-	for (i= 0; i< HPACK_HUFF_ENC_NO; i++)
-	{
-		if (huffman_decode_ff[i].bits == 0)
-		{
-			fatal(
-			"init_huffman: empty entry %d in huffman_decode_ff",
-				i);
-		}
-	}
-
-	/* Fill in huffman_decode_fffe table */
-	for (i= 0; i< HPACK_HUFF_ENC_NO; i++)
-	{
-		len= huffman_encode[i].bits;
-		if (len <= 16)
-			continue;
-
-		if (((huffman_encode[i].encoding >> (len-16)) & 0xffff) !=
-			0xfffe)
-		{
-			continue;	/* No FFFE prefix */
-		}
-
-		len -= 16;
-#if 0
-		if (len >= 8)
-		{
-			byte= huffman_encode[i].encoding >> (len-8);
-			assert(byte < 256);
-			if (huffman_decode_ff[byte].bits == 0)
-			{
-				/* New entry */
-				huffman_decode_ff[byte].bits= len;
-				huffman_decode_ff[byte].value=
-					huffman_encode[i].value;
-			}
-			else
-			{
-				/* Existing entry. Old and new bits need
-				 * to be more than 8
-				 */
-				if (huffman_decode_ff[byte].bits <= 8 ||
-					len <= 8)
-				{
-					fatal(
-					"init_huffman: inconsistent entry");
-				}
-			}
-			continue;
-		}
-#endif
-
-		byte= huffman_encode[i].encoding << (8-len);
-		assert(byte < 256);
-		mask= (1 << (8-len))-1;
-		for (j= 0; j<= mask; j++)
-		{
-			if (huffman_decode_fffe[byte+j].bits != 0)
-			{
-				fatal(
-"init_huffman: duplicate entry: adding row %d, byte 0x%x, offset %d, found bits %d, value %d",
-					i, byte, j,
-					huffman_decode_fffe[byte+j].bits,
-					huffman_decode_fffe[byte+j].value);
-			}
-
-			/* New entry */
-			huffman_decode_fffe[byte+j].bits= len;
-			huffman_decode_fffe[byte+j].value=
-				huffman_encode[i].value;
-		}
-	}
-
-	/* Check that all entries have been filled-in */
-	for (i= 0; i< HPACK_HUFF_ENC_NO; i++)
-	{
-		if (huffman_decode_fffe[i].bits == 0)
-		{
-			fatal(
-			"init_huffman: empty entry %d in huffman_decode_fffe",
-				i);
-		}
-	}
-
-	/* Fill in huffman_decode_ffff table */
-	for (i= 0; i< HPACK_HUFF_ENC_NO; i++)
-	{
-		len= huffman_encode[i].bits;
-		if (len <= 16)
-			continue;
-
-		if (((huffman_encode[i].encoding >> (len-16)) & 0xffff) !=
-			0xffff)
-		{
-			continue;	/* No FFFF prefix */
-		}
-
-		len -= 16;
-
-		if (len >= 8)
-		{
-			byte= huffman_encode[i].encoding >> (len-8);
-			assert(byte < 256);
-			if (huffman_decode_ffff[byte].bits == 0)
-			{
-				/* New entry */
-				huffman_decode_ffff[byte].bits= len;
-				huffman_decode_ffff[byte].value=
-					huffman_encode[i].value;
-			}
-			else
-			{
-				/* Existing entry. Old and new bits need
-				 * to be more than 8
-				 */
-				if (huffman_decode_ffff[byte].bits <= 8 ||
-					len <= 8)
-				{
-					fatal(
-					"init_huffman: inconsistent entry");
-				}
-			}
-			continue;
-		}
-
-		byte= huffman_encode[i].encoding << (8-len);
-		assert(byte < 256);
-		mask= (1 << (8-len))-1;
-		for (j= 0; j<= mask; j++)
-		{
-			if (huffman_decode_ffff[byte+j].bits != 0)
-			{
-				fatal(
-"init_huffman: duplicate entry: adding row %d, byte 0x%x, offset %d, found bits %d, value %d",
-					i, byte, j,
-					huffman_decode_ffff[byte+j].bits,
-					huffman_decode_ffff[byte+j].value);
-			}
-
-			/* New entry */
-			huffman_decode_ffff[byte+j].bits= len;
-			huffman_decode_ffff[byte+j].value=
-				huffman_encode[i].value;
-		}
-	}
-
-	/* Check that all entries have been filled-in */
-	for (i= 0; i< HPACK_HUFF_ENC_NO; i++)
-	{
-		if (huffman_decode_ffff[i].bits == 0)
-		{
-			fatal(
-			"init_huffman: empty entry %d in huffman_decode_ffff",
-				i);
-		}
-	}
-
-	/* Fill in huffman_decode_fffff table */
-	for (i= 0; i< HPACK_HUFF_ENC_NO; i++)
-	{
-		len= huffman_encode[i].bits;
-		if (len <= 20)
-			continue;
-
-		if (((huffman_encode[i].encoding >> (len-20)) & 0xfffff) !=
-			0xfffff)
-		{
-			continue;	/* No FFFFF prefix */
-		}
-
-		len -= 20;
-
-		if (len >= 8)
-		{
-			byte= huffman_encode[i].encoding >> (len-8);
-			assert(byte < 256);
-			if (huffman_decode_fffff[byte].bits == 0)
-			{
-				/* New entry */
-				huffman_decode_fffff[byte].bits= len;
-				huffman_decode_fffff[byte].value=
-					huffman_encode[i].value;
-			}
-			else
-			{
-				/* Existing entry. Old and new bits need
-				 * to be more than 8
-				 */
-				if (huffman_decode_fffff[byte].bits <= 8 ||
-					len <= 8)
-				{
-					fatal(
-					"init_huffman: inconsistent entry");
-				}
-			}
-			continue;
-		}
-
-		byte= huffman_encode[i].encoding << (8-len);
-		assert(byte < 256);
-		mask= (1 << (8-len))-1;
-		for (j= 0; j<= mask; j++)
-		{
-			if (huffman_decode_fffff[byte+j].bits != 0)
-			{
-				fatal(
-"init_huffman: duplicate entry: adding row %d, byte 0x%x, offset %d, found bits %d, value %d",
-					i, byte, j,
-					huffman_decode_fffff[byte+j].bits,
-					huffman_decode_fffff[byte+j].value);
-			}
-
-			/* New entry */
-			huffman_decode_fffff[byte+j].bits= len;
-			huffman_decode_fffff[byte+j].value=
-				huffman_encode[i].value;
-		}
-	}
-
-	/* Check that all entries have been filled-in */
-	for (i= 0; i< HPACK_HUFF_ENC_NO; i++)
-	{
-		if (huffman_decode_fffff[i].bits == 0)
-		{
-			fatal(
-			"init_huffman: empty entry %d in huffman_decode_fffff",
-				i);
-		}
-	}
-
-	/* Fill in huffman_decode_fffffe table */
-	for (i= 0; i< HPACK_HUFF_ENC_NO; i++)
-	{
-		len= huffman_encode[i].bits;
-		if (len <= 24)
-			continue;
-
-		if (((huffman_encode[i].encoding >> (len-24)) & 0xffffff) !=
-			0xfffffe)
-		{
-			continue;	/* No FFFFFE prefix */
-		}
-
-		len -= 24;
-
-		if (len >= 4)
-		{
-			nibble= (huffman_encode[i].encoding >> (len-4)) & 0xf;
-			assert(nibble < 16);
-			if (huffman_decode_fffffe[nibble].bits == 0)
+			if (len-o >= 4)
 			{
-				/* New entry */
-				huffman_decode_fffffe[nibble].bits= len;
-				huffman_decode_fffffe[nibble].value=
-					huffman_encode[i].value;
+				acc |= (uint64_t)((uint32_t)buf[o] << 24 |
+					(uint32_t)buf[o+1] << 16 |
+					(uint32_t)buf[o+2] << 8 |
+					buf[o+3]) << (32-nbits);
+				o += 4;
+				nbits += 32;
 			}
 			else
 			{
-				/* Existing entry. Old and new bits need
-				 * to be more than 8
-				 */
-				if (huffman_decode_fffffe[byte].bits <= 4 ||
-					len <= 4)
+				while (o < len)
 				{
-					fatal(
-					"init_huffman: inconsistent entry");
+					acc |= (uint64_t)buf[o++] << (56-nbits);
+					nbits += 8;
 				}
 			}
-			continue;
-		}
-
-		nibble= (huffman_encode[i].encoding << (4-len)) & 0xf;
-		assert(nibble < 16);
-		mask= (1 << (4-len))-1;
-		for (j= 0; j<= mask; j++)
-		{
-			if (huffman_decode_fffffe[nibble+j].bits != 0)
-			{
-				fatal(
-"init_huffman: duplicate entry: adding row %d, byte 0x%x, offset %d, found bits %d, value %d",
-					i, byte, j,
-					huffman_decode_fffffe[nibble+j].bits,
-					huffman_decode_fffffe[nibble+j].value);
-			}
-
-			/* New entry */
-			huffman_decode_fffffe[nibble+j].bits= len;
-			huffman_decode_fffffe[nibble+j].value=
-				huffman_encode[i].value;
 		}
-	}
 
-	/* Check that all entries have been filled-in */
-	for (i= 0; i<16; i++)
-	{
-		if (huffman_decode_fffffe[i].bits == 0)
+		f= &huffman_fast[acc >> (64-HUFFMAN_FAST_BITS)];
+		if (f->bits1 != 0 && nbits >= HUFFMAN_FAST_BITS &&
+			outbuflen-o_out >= 2)
 		{
-			fatal(
-			"init_huffman: empty entry %d in huffman_decode_fffffe",
-				i);
-		}
-	}
-
-	/* Fill in huffman_decode_ffffff table */
-	for (i= 0; i< HPACK_HUFF_ENC_NO; i++)
-	{
-		len= huffman_encode[i].bits;
-		if (len <= 24)
+			/* Common case, one or two symbols */
+			outbuf[o_out]= f->sym1;
+			outbuf[o_out+1]= f->sym2;
+			o_out += 1 + (f->bits != f->bits1);
+			acc <<= f->bits;
+			nbits -= f->bits;
 			continue;
-
-		if (((huffman_encode[i].encoding >> (len-24)) & 0xffffff) !=
-			0xffffff)
-		{
-			continue;	/* No FFFFFF prefix */
 		}
-
-		len -= 24;
-#if 0
-		if (len >= 8)
+		if (f->bits1 != 0)
 		{
-			byte= huffman_encode[i].encoding >> (len-8);
-			assert(byte < 256);
-			if (huffman_decode_ff[byte].bits == 0)
-			{
-				/* New entry */
-				huffman_decode_ff[byte].bits= len;
-				huffman_decode_ff[byte].value=
-					huffman_encode[i].value;
-			}
-			else
-			{
-				/* Existing entry. Old and new bits need
-				 * to be more than 8
-				 */
-				if (huffman_decode_ff[byte].bits <= 8 ||
-					len <= 8)
-				{
-					fatal(
-					"init_huffman: inconsistent entry");
-				}
-			}
+			/* Near the end of input or output */
+			if (f->bits1 > nbits)
+				break;	/* Padding */
+			if (o_out >= outbuflen)
+				goto full;
+			outbuf[o_out++]= f->sym1;
+			acc <<= f->bits1;
+			nbits -= f->bits1;
 			continue;
 		}
-#endif
-
-		byte= huffman_encode[i].encoding << (8-len);
-		assert(byte < 256);
-		mask= (1 << (8-len))-1;
-		for (j= 0; j<= mask; j++)
-		{
-			if (huffman_decode_ffffff[byte+j].bits != 0)
-			{
-				fatal(
-"init_huffman: duplicate entry: adding row %d, byte 0x%x, offset %d, found bits %d, value %d",
-					i, byte, j,
-					huffman_decode_ffffff[byte+j].bits,
-					huffman_decode_ffffff[byte+j].value);
-			}
-
-			/* New entry */
-			huffman_decode_ffffff[byte+j].bits= len;
-			huffman_decode_ffffff[byte+j].value=
-				huffman_encode[i].value;
-		}
-	}
 
-	/* Claim unused entries */
-	for (j= 252; j<256; j++)
-	{
-		huffman_decode_ffffff[j].bits= 42;
-		huffman_decode_ffffff[j].value= 42;
-	}
-
-	/* Check that all entries have been filled-in */
-	for (i= 0; i< HPACK_HUFF_ENC_NO; i++)
-	{
-		if (huffman_decode_ffffff[i].bits == 0)
+		/* Long code */
+		for (l= HUFFMAN_FAST_BITS+1; l <= nbits; l++)
 		{
-			fatal(
-			"init_huffman: empty entry %d in huffman_decode_ffffff",
-				i);
+			code= acc >> (64-l);
+			if (code - huffman_first[l] < huffman_count[l])
+				break;
 		}
+		if (l > nbits)
+			break;	/* Padding */
+		sym= huffman_sorted[huffman_base[l] + code - huffman_first[l]];
+		if (sym == HUFFMAN_EOS)
+			goto eos;
+		if (o_out >= outbuflen)
+			goto full;
+		outbuf[o_out++]= sym;
+		acc <<= l;
+		nbits -= l;
 	}
-}
-
-static size_t Xdecode_huffman2(struct http2_env *env, uint8_t *buf, size_t len,
-	char *outbuf, size_t outbuflen)
-{
-	uint8_t byte, decval, mask, nibble;
-	size_t o, o_out;
-	uint32_t bits;
-	int bitslen, declen;
 
-	o= 0;
-	o_out= 0;
-	bits= 0;
-	bitslen= 0;
-
-	for(;;)
+	/* The string has to end in at most 7 bits of EOS */
+	if (nbits >= 8 || (nbits > 0 && (~acc >> (64-nbits)) != 0))
 	{
-		/* Try to have at least 8 bits. At the end of the string that
-		 * may not work.
-		 */
-		if (bitslen < 8 && o < len)
-		{
-			bits= (bits << 8) | buf[o];
-			bitslen += 8;
-			o++;
-		}
-
-#if 0
-		fprintf(stderr, "decode_huffman2: got bits 0x%x, len %d\n",
-			bits & ((1 << bitslen)-1), bitslen);
-#endif
-
-		/* Extract first byte */
-		if (bitslen < 8)
-			byte= bits << (8-bitslen);
-		else
-			byte= (bits >> (bitslen-8)) & 0xff;
-
-#if 0
-		fprintf(stderr, "decode_huffman2: got first byte 0x%02x\n", 
-			byte);
-#endif
-
-		if (bitslen >= 8 && byte == 0xfe)
-		{
-			/* Use huffman_decode_fe table */
-			bitslen -= 8;
-			if (bitslen < 8 && o < len)
-			{
-				bits= (bits << 8) | buf[o];
-				bitslen += 8;
-				o++;
-			}
-
-			/* Extract second byte */
-			if (bitslen < 8)
-				byte= bits << (8-bitslen);
-			else
-				byte= (bits >> (bitslen-8)) & 0xff;
-
-#if 0
-			fprintf(stderr,
-				"decode_huffman2: got 2nd byte 0x%02x\n", 
-				byte);
-#endif
-			
-			declen= huffman_decode_fe[byte].bits;
-			decval= huffman_decode_fe[byte].value;
-
-#if 0
-			fprintf(stderr,
-			"decode_huffman2: got len %d, value '%c'\n", 
-				declen, decval);
-#endif
-
-			assert(declen <= 8);
-			if (declen <= bitslen)
-			{
-				bitslen -= declen;
-				if (o_out >= outbuflen)
-				{
-					send_goaway2(env->outbuf,
-						HTTP2_COMPRESSION_ERROR,
-						0, "no space in output buffer");
-					return 0;
-				}
-				outbuf[o_out]= decval;
-				o_out++;
-				continue;
-			}
-
-			send_goaway2(env->outbuf,
-				HTTP2_COMPRESSION_ERROR,
-				0, "not enough bits");
-			return 0;
-		}
-
-		if (byte != 0xff)
-		{
-			declen= huffman_decode0[byte].bits;
-			decval= huffman_decode0[byte].value;
-
-#if 0
-			fprintf(stderr,
-				"decode_huffman2: got len %d, value '%c'\n", 
-				declen, decval);
-#endif
-
-			if (declen <= bitslen)
-			{
-				assert(declen <= 8);
-				bitslen -= declen;
-				if (o_out >= outbuflen)
-				{
-					send_goaway2(env->outbuf,
-						HTTP2_COMPRESSION_ERROR,
-						0, "no space in output buffer");
-					return 0;
-				}
-				outbuf[o_out]= decval;
-				o_out++;
-				continue;
-			}
-
-			/* An incomplete symbol marks the end the string.
-			 * Perform some checks.
-			 */
-			assert(bitslen < 8);
-			assert(o == len);
-
-			/* The remaining bits should be a prefix of the EOS
-			 * symbol, basically all bits have to be one.
-			 */
-			mask= (1 << bitslen)-1;
-			if ((bits & mask) == mask)
-				break;
-
-			send_goaway2(env->outbuf,
-				HTTP2_COMPRESSION_ERROR,
-				0, "garbage at end of string");
-			return 0;
-		}
-
-		assert(bitslen >= 8);
-		assert(byte == 0xff);
-
-		/* Use huffman_decode_ff table */
-		bitslen -= 8;
-		if (bitslen < 8 && o < len)
-		{
-			bits= (bits << 8) | buf[o];
-			bitslen += 8;
-			o++;
-		}
-
-		/* Extract second byte */
-		if (bitslen < 8)
-			byte= bits << (8-bitslen);
-		else
-			byte= (bits >> (bitslen-8)) & 0xff;
-
-#if 0
-		fprintf(stderr,
-			"decode_huffman2: got 2nd byte 0x%02x\n", 
-			byte);
-#endif
-
-		if (bitslen >= 8 && byte == 0xfe)
-		{
-			/* Use huffman_decode_fffe table */
-			bitslen -= 8;
-			if (bitslen < 8 && o < len)
-			{
-				bits= (bits << 8) | buf[o];
-				bitslen += 8;
-				o++;
-			}
-
-			/* Extract third byte */
-			if (bitslen < 8)
-				byte= bits << (8-bitslen);
-			else
-				byte= (bits >> (bitslen-8)) & 0xff;
-
-#if 0
-			fprintf(stderr,
-				"decode_huffman2: got 3rd byte 0x%02x\n", 
-				byte);
-#endif
-			
-			declen= huffman_decode_fffe[byte].bits;
-			decval= huffman_decode_fffe[byte].value;
-
-#if 0
-			fprintf(stderr,
-			"decode_huffman2: got len %d, value '%c'\n", 
-				declen, decval);
-#endif
-
-			assert(declen <= 8);
-			if (declen <= bitslen)
-			{
-				bitslen -= declen;
-				if (o_out >= outbuflen)
-				{
-					send_goaway2(env->outbuf,
-						HTTP2_COMPRESSION_ERROR,
-						0, "no space in output buffer");
-					return 0;
-				}
-				outbuf[o_out]= decval;
-				o_out++;
-				continue;
-			}
-
-			send_goaway2(env->outbuf, HTTP2_COMPRESSION_ERROR,
-				0, "not enough bits");
-			return 0;
-		}
-
-
-		if (byte != 0xff)
-		{
-			declen= huffman_decode_ff[byte].bits;
-			decval= huffman_decode_ff[byte].value;
-
-#if 0
-			fprintf(stderr,
-				"decode_huffman2: got len %d, value '%c'\n", 
-				declen, decval);
-#endif
-
-			assert(declen <= 8);
-
-			if (declen <= bitslen)
-			{
-				assert(declen <= 8);
-				bitslen -= declen;
-				if (o_out >= outbuflen)
-				{
-					send_goaway2(env->outbuf,
-						HTTP2_COMPRESSION_ERROR,
-						0, "no space in output buffer");
-					return 0;
-				}
-				outbuf[o_out]= decval;
-				o_out++;
-				continue;
-			}
-
-			send_goaway2(env->outbuf, HTTP2_COMPRESSION_ERROR,
-				0, "garbage at end of string");
-			return 0;
-		}
-
-		assert(bitslen >= 8);
-		assert(byte == 0xff);
-
-		/* Use huffman_decode_ffff table */
-		bitslen -= 8;
-		if (bitslen < 8 && o < len)
-		{
-			bits= (bits << 8) | buf[o];
-			bitslen += 8;
-			o++;
-		}
-
-		/* Extract third byte */
-		if (bitslen < 8)
-			byte= bits << (8-bitslen);
-		else
-			byte= (bits >> (bitslen-8)) & 0xff;
-
-#if 0
-		fprintf(stderr,
-			"decode_huffman2: got 3rd byte 0x%02x\n", 
-			byte);
-#endif
-
-		if (bitslen >= 8 && byte == 0xfe)
-		{
-			/* Use huffman_decode_fffffe table. This table
-			 * is index using 4 bits
-			 */
-			bitslen -= 8;
-			if (bitslen < 4 && o < len)
-			{
-				bits= (bits << 8) | buf[o];
-				bitslen += 8;
-				o++;
-			}
-
-			/* Extract high nibble of fourth byte */
-			if (bitslen < 4)
-				nibble= bits << (4-bitslen);
-			else
-				nibble= (bits >> (bitslen-4)) & 0xf;
-
-#if 0
-			fprintf(stderr,
-		"decode_huffman2: got high nibble of 4th byte 0x%x\n", 
-				nibble);
-#endif
-			
-			declen= huffman_decode_fffffe[nibble].bits;
-			decval= huffman_decode_fffffe[nibble].value;
-
-#if 0
-			fprintf(stderr,
-			"decode_huffman2: got len %d, value '%c'\n", 
-				declen, decval);
-#endif
-
-			assert(declen <= 4);
-			if (declen <= bitslen)
-			{
-				bitslen -= declen;
-				if (o_out >= outbuflen)
-				{
-					send_goaway2(env->outbuf,
-						HTTP2_COMPRESSION_ERROR,
-						0, "no space in output buffer");
-					return 0;
-				}
-				outbuf[o_out]= decval;
-				o_out++;
-				continue;
-			}
-
-			send_goaway2(env->outbuf, HTTP2_COMPRESSION_ERROR,
-				0, "not enough bits");
-			return 0;
-		}
-
-		if (bitslen >= 8 && (byte & 0xf0) == 0xf0 && byte != 0xff)
-		{
-			/* Use huffman_decode_fffff table. The prefix is
-			 * 20 bits.
-			 */
-			bitslen -= 4;
-			if (bitslen < 8 && o < len)
-			{
-				bits= (bits << 8) | buf[o];
-				bitslen += 8;
-				o++;
-			}
-
-			/* Extract low nibble of the third byte and the
-			 * high nibble of fourth byte
-			 */
-			if (bitslen < 8)
-				byte= bits << (8-bitslen);
-			else
-				byte= bits >> (bitslen-8);
-
-#if 0
-			fprintf(stderr,
-		"decode_huffman2: got low 3rd/high 4th 0x%x\n", 
-				byte);
-#endif
-			
-			declen= huffman_decode_fffff[byte].bits;
-			decval= huffman_decode_fffff[byte].value;
-
-#if 0
-			fprintf(stderr,
-			"decode_huffman2: got len %d, value '%c'\n", 
-				declen, decval);
-#endif
-
-			assert(declen <= 8);
-			if (declen <= bitslen)
-			{
-				bitslen -= declen;
-				if (o_out >= outbuflen)
-				{
-					send_goaway2(env->outbuf,
-						HTTP2_COMPRESSION_ERROR,
-						0, "no space in output buffer");
-					return 0;
-				}
-				outbuf[o_out]= decval;
-				o_out++;
-				continue;
-			}
-
-			send_goaway2(env->outbuf, HTTP2_COMPRESSION_ERROR,
-				0, "not enough bits");
-			return 0;
-		}
-
-		if (byte != 0xff)
-		{
-			declen= huffman_decode_ffff[byte].bits;
-			decval= huffman_decode_ffff[byte].value;
-
-#if 0
-			fprintf(stderr,
-				"decode_huffman2: got len %d, value '%c'\n", 
-				declen, decval);
-#endif
-
-			assert(declen <= 8);
-
-			if (declen <= bitslen)
-			{
-				assert(declen <= 8);
-				bitslen -= declen;
-				if (o_out >= outbuflen)
-				{
-					send_goaway2(env->outbuf,
-						HTTP2_COMPRESSION_ERROR,
-						0, "no space in output buffer");
-					return 0;
-				}
-				outbuf[o_out]= decval;
-				o_out++;
-				continue;
-			}
-
-			send_goaway2(env->outbuf, HTTP2_COMPRESSION_ERROR,
-				0, "garbage at end of string");
-			return 0;
-		}
-
-		assert(bitslen >= 8);
-		assert(byte == 0xff);
-
-		/* Use huffman_decode_ffffff table */
-		bitslen -= 8;
-		if (bitslen < 8 && o < len)
-		{
-			bits= (bits << 8) | buf[o];
-			bitslen += 8;
-			o++;
-		}
-
-		/* Extract fourth byte */
-		if (bitslen < 8)
-			byte= bits << (8-bitslen);
-		else
-			byte= (bits >> (bitslen-8)) & 0xff;
-
-#if 0
-		fprintf(stderr,
-			"decode_huffman2: got 4th byte 0x%02x\n", 
-			byte);
-#endif
-
-#if 0
-		if (bitslen >= 8 && byte == 0xfe)
-		{
-			/* Use huffman_decode_fffe table */
-			bitslen -= 8;
-			if (bitslen < 8 && o < len)
-			{
-				bits= (bits << 8) | buf[o];
-				bitslen += 8;
-				o++;
-			}
-
-			/* Extract third byte */
-			if (bitslen < 8)
-				byte= bits << (8-bitslen);
-			else
-				byte= (bits >> (bitslen-8)) & 0xff;
-
-			fprintf(stderr,
-				"decode_huffman2: got 3rd byte 0x%02x\n", 
-				byte);
-			
-			declen= huffman_decode_fffe[byte].bits;
-			decval= huffman_decode_fffe[byte].value;
-
-#if 0
-			fprintf(stderr,
-			"decode_huffman2: got len %d, value '%c'\n", 
-				declen, decval);
-#endif
-
-			assert(declen <= 8);
-			if (declen <= bitslen)
-			{
-				bitslen -= declen;
-				if (o_out >= outbuflen)
-				{
-					send_goaway2(env->outbuf,
-						HTTP2_COMPRESSION_ERROR,
-						0, "no space in output buffer");
-					return 0;
-				}
-				outbuf[o_out]= decval;
-				o_out++;
-				continue;
-			}
-
-			send_goaway2(env->outbuf, HTTP2_COMPRESSION_ERROR,
-				0, "not enough bits");
-			return 0;
-		}
-#endif
-
-		if (byte != 0xff)
-		{
-			declen= huffman_decode_ffffff[byte].bits;
-			decval= huffman_decode_ffffff[byte].value;
-
-#if 0
-			fprintf(stderr,
-				"decode_huffman2: got len %d, value '%c'\n", 
-				declen, decval);
-#endif
-
-			assert(declen <= 8);
-
-			if (declen <= bitslen)
-			{
-				assert(declen <= 8);
-				bitslen -= declen;
-				if (o_out >= outbuflen)
-				{
-					send_goaway2(env->outbuf,
-						HTTP2_COMPRESSION_ERROR,
-						0, "no space in output buffer");
-					return 0;
-				}
-				outbuf[o_out]= decval;
-				o_out++;
-				continue;
-			}
-
-			send_goaway2(env->outbuf, HTTP2_COMPRESSION_ERROR,
-				0, "garbage at end of string");
-			return 0;
-		}
-
 		send_goaway2(env->outbuf, HTTP2_COMPRESSION_ERROR,
-			0, "should decode ff");
+			0, "garbage at end of string");
 		return 0;
 	}
 	return o_out;
+
+eos:
+	send_goaway2(env->outbuf, HTTP2_COMPRESSION_ERROR,
+		0, "EOS in string");
+	return 0;
+
+full:
+	send_goaway2(env->outbuf, HTTP2_COMPRESSION_ERROR,
+		0, "no space in output buffer");
+	return 0;
 }
 
 static void add_credits2(struct http2_env *env,
-	uint32_t stream_id, uint32_t credits)
+	struct http2_stream *stream, uint32_t credits)
 {
 	env->http2_send_global_credits += credits;
-	if (stream_id == 1)
-		env->http2_send_stream1_credits += credits;
-	else
+	if (env->http2_send_global_credits >= HTTP2_UPDATE_THRESHOLD)
+	{
+		send_window_update2(env->outbuf, 0,
+			env->http2_send_global_credits);
+		env->http2_send_global_credits= 0;
+	}
+	if (stream == NULL)
+		return;
+	stream->send_credits += credits;
+	if (stream->send_credits >= HTTP2_UPDATE_THRESHOLD)
 	{
-		fatal("add_credits2: should handle more streams");
+		send_window_update2(env->outbuf, stream->id,
+			stream->send_credits);
+		stream->send_credits= 0;
 	}
 }
 
-static int Xreport_header(struct http2_env *env, int verbose,
+static int Xreport_header(struct http2_env *env,
+	struct http2_stream *stream, int verbose,
 	const char *key, size_t keylen, const char *value, size_t valuelen)
 {
 	int r, status;
@@ -3031,7 +2408,8 @@ static int Xreport_header(struct http2_env *env, int verbose,
 		r= Xparse_status_code2(env, value, valuelen, &status);
 		if (r == -1)
 			return -1;
-		env->status= status;
+		if (stream)
+			stream->status= status;
 		if (verbose)
 			fprintf(stderr, "HTTP/2 %.*s\n", (int)valuelen, value);
 		else if (status != 200)
@@ -3055,15 +2433,15 @@ static int Xreport_header(struct http2_env *env, int verbose,
 			p++;
 		len= (const u_char *)value+len-p;
 
-		if (len == strlen(TEXT_HTML) &&
+		if (stream && len == strlen(TEXT_HTML) &&
 			memcasecmp(p, TEXT_HTML, len) == 0)
 		{
-			env->type_html= true;
+			stream->type_html= true;
 		}
-		if (len == strlen(APPLICATION_DNS_MESSAGE) &&
+		if (stream && len == strlen(APPLICATION_DNS_MESSAGE) &&
 			memcasecmp(p, APPLICATION_DNS_MESSAGE, len) == 0)
 		{
-			env->type_dns= true;
+			stream->type_dns= true;
 		}
 
 			
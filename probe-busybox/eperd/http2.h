@@ -19,9 +19,12 @@ typedef size_t (*http2_read_response_cb_t)(void *ref, void *data, size_t len);
 
 struct http2_env *http2_init(void);
 void http2_free(struct http2_env *env);
-void http2_dns(struct http2_env *env, struct bufferevent *bev,
+int http2_dns_avail(struct http2_env *env);
+uint32_t http2_dns(struct http2_env *env, struct bufferevent *bev,
 	const char *hostname, const char *port, const char *path,
-	u_char *req, size_t reqlen);
+	u_char *req, size_t reqlen, void *ref);
+void http2_dns_cancel(struct http2_env *env, struct bufferevent *bev,
+	uint32_t stream_id);
 int http2_dns_input(struct http2_env *env, struct bufferevent *bev,
 	http2_reply_cb_t reply_cb, void *ref,
 	http2_write_response_cb_t write_response_cb,
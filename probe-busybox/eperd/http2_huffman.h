@@ -0,0 +1,1122 @@
+/*
+ * Copyright (c) 2026 RIPE NCC <atlas@ripe.net>
+ * Licensed under GPLv2 or later, see file LICENSE in this tarball for details.
+ * http2_huffman.h
+ */
+
+/* HPACK Huffman decoding tables (RFC 7541, Appendix B). Generated by
+ * scripts/mk_http2_huffman.py from huffman_encode in http2.c.
+ *
+ * huffman_fast is indexed by the next 12 bits of input and gives the one
+ * or two symbols with codes that fit. Longer codes are canonical, so they
+ * are decoded by length with huffman_first, huffman_count and huffman_base
+ * into huffman_sorted.
+ */
+
+#define HUFFMAN_FAST_BITS	12
+#define HUFFMAN_MAX_BITS	30
+#define HUFFMAN_EOS		256
+
+struct huffman_fast
+{
+	uint8_t sym1;
+	uint8_t sym2;
+	uint8_t bits1;		/* Code of sym1, 0 if longer than the table */
+	uint8_t bits;		/* Codes of sym1 and sym2, bits1 if there is no sym2 */
+};
+
+static const struct huffman_fast huffman_fast[1 << HUFFMAN_FAST_BITS]=
+{
+	{  48,  48,  5, 10 }, {  48,  48,  5, 10 }, {  48,  48,  5, 10 }, {  48,  48,  5, 10 },
+	{  48,  49,  5, 10 }, {  48,  49,  5, 10 }, {  48,  49,  5, 10 }, {  48,  49,  5, 10 },
+	{  48,  50,  5, 10 }, {  48,  50,  5, 10 }, {  48,  50,  5, 10 }, {  48,  50,  5, 10 },
+	{  48,  97,  5, 10 }, {  48,  97,  5, 10 }, {  48,  97,  5, 10 }, {  48,  97,  5, 10 },
+	{  48,  99,  5, 10 }, {  48,  99,  5, 10 }, {  48,  99,  5, 10 }, {  48,  99,  5, 10 },
+	{  48, 101,  5, 10 }, {  48, 101,  5, 10 }, {  48, 101,  5, 10 }, {  48, 101,  5, 10 },
+	{  48, 105,  5, 10 }, {  48, 105,  5, 10 }, {  48, 105,  5, 10 }, {  48, 105,  5, 10 },
+	{  48, 111,  5, 10 }, {  48, 111,  5, 10 }, {  48, 111,  5, 10 }, {  48, 111,  5, 10 },
+	{  48, 115,  5, 10 }, {  48, 115,  5, 10 }, {  48, 115,  5, 10 }, {  48, 115,  5, 10 },
+	{  48, 116,  5, 10 }, {  48, 116,  5, 10 }, {  48, 116,  5, 10 }, {  48, 116,  5, 10 },
+	{  48,  32,  5, 11 }, {  48,  32,  5, 11 }, {  48,  37,  5, 11 }, {  48,  37,  5, 11 },
+	{  48,  45,  5, 11 }, {  48,  45,  5, 11 }, {  48,  46,  5, 11 }, {  48,  46,  5, 11 },
+	{  48,  47,  5, 11 }, {  48,  47,  5, 11 }, {  48,  51,  5, 11 }, {  48,  51,  5, 11 },
+	{  48,  52,  5, 11 }, {  48,  52,  5, 11 }, {  48,  53,  5, 11 }, {  48,  53,  5, 11 },
+	{  48,  54,  5, 11 }, {  48,  54,  5, 11 }, {  48,  55,  5, 11 }, {  48,  55,  5, 11 },
+	{  48,  56,  5, 11 }, {  48,  56,  5, 11 }, {  48,  57,  5, 11 }, {  48,  57,  5, 11 },
+	{  48,  61,  5, 11 }, {  48,  61,  5, 11 }, {  48,  65,  5, 11 }, {  48,  65,  5, 11 },
+	{  48,  95,  5, 11 }, {  48,  95,  5, 11 }, {  48,  98,  5, 11 }, {  48,  98,  5, 11 },
+	{  48, 100,  5, 11 }, {  48, 100,  5, 11 }, {  48, 102,  5, 11 }, {  48, 102,  5, 11 },
+	{  48, 103,  5, 11 }, {  48, 103,  5, 11 }, {  48, 104,  5, 11 }, {  48, 104,  5, 11 },
+	{  48, 108,  5, 11 }, {  48, 108,  5, 11 }, {  48, 109,  5, 11 }, {  48, 109,  5, 11 },
+	{  48, 110,  5, 11 }, {  48, 110,  5, 11 }, {  48, 112,  5, 11 }, {  48, 112,  5, 11 },
+	{  48, 114,  5, 11 }, {  48, 114,  5, 11 }, {  48, 117,  5, 11 }, {  48, 117,  5, 11 },
+	{  48,  58,  5, 12 }, {  48,  66,  5, 12 }, {  48,  67,  5, 12 }, {  48,  68,  5, 12 },
+	{  48,  69,  5, 12 }, {  48,  70,  5, 12 }, {  48,  71,  5, 12 }, {  48,  72,  5, 12 },
+	{  48,  73,  5, 12 }, {  48,  74,  5, 12 }, {  48,  75,  5, 12 }, {  48,  76,  5, 12 },
+	{  48,  77,  5, 12 }, {  48,  78,  5, 12 }, {  48,  79,  5, 12 }, {  48,  80,  5, 12 },
+	{  48,  81,  5, 12 }, {  48,  82,  5, 12 }, {  48,  83,  5, 12 }, {  48,  84,  5, 12 },
+	{  48,  85,  5, 12 }, {  48,  86,  5, 12 }, {  48,  87,  5, 12 }, {  48,  89,  5, 12 },
+	{  48, 106,  5, 12 }, {  48, 107,  5, 12 }, {  48, 113,  5, 12 }, {  48, 118,  5, 12 },
+	{  48, 119,  5, 12 }, {  48, 120,  5, 12 }, {  48, 121,  5, 12 }, {  48, 122,  5, 12 },
+	{  48,   0,  5,  5 }, {  48,   0,  5,  5 }, {  48,   0,  5,  5 }, {  48,   0,  5,  5 },
+	{  49,  48,  5, 10 }, {  49,  48,  5, 10 }, {  49,  48,  5, 10 }, {  49,  48,  5, 10 },
+	{  49,  49,  5, 10 }, {  49,  49,  5, 10 }, {  49,  49,  5, 10 }, {  49,  49,  5, 10 },
+	{  49,  50,  5, 10 }, {  49,  50,  5, 10 }, {  49,  50,  5, 10 }, {  49,  50,  5, 10 },
+	{  49,  97,  5, 10 }, {  49,  97,  5, 10 }, {  49,  97,  5, 10 }, {  49,  97,  5, 10 },
+	{  49,  99,  5, 10 }, {  49,  99,  5, 10 }, {  49,  99,  5, 10 }, {  49,  99,  5, 10 },
+	{  49, 101,  5, 10 }, {  49, 101,  5, 10 }, {  49, 101,  5, 10 }, {  49, 101,  5, 10 },
+	{  49, 105,  5, 10 }, {  49, 105,  5, 10 }, {  49, 105,  5, 10 }, {  49, 105,  5, 10 },
+	{  49, 111,  5, 10 }, {  49, 111,  5, 10 }, {  49, 111,  5, 10 }, {  49, 111,  5, 10 },
+	{  49, 115,  5, 10 }, {  49, 115,  5, 10 }, {  49, 115,  5, 10 }, {  49, 115,  5, 10 },
+	{  49, 116,  5, 10 }, {  49, 116,  5, 10 }, {  49, 116,  5, 10 }, {  49, 116,  5, 10 },
+	{  49,  32,  5, 11 }, {  49,  32,  5, 11 }, {  49,  37,  5, 11 }, {  49,  37,  5, 11 },
+	{  49,  45,  5, 11 }, {  49,  45,  5, 11 }, {  49,  46,  5, 11 }, {  49,  46,  5, 11 },
+	{  49,  47,  5, 11 }, {  49,  47,  5, 11 }, {  49,  51,  5, 11 }, {  49,  51,  5, 11 },
+	{  49,  52,  5, 11 }, {  49,  52,  5, 11 }, {  49,  53,  5, 11 }, {  49,  53,  5, 11 },
+	{  49,  54,  5, 11 }, {  49,  54,  5, 11 }, {  49,  55,  5, 11 }, {  49,  55,  5, 11 },
+	{  49,  56,  5, 11 }, {  49,  56,  5, 11 }, {  49,  57,  5, 11 }, {  49,  57,  5, 11 },
+	{  49,  61,  5, 11 }, {  49,  61,  5, 11 }, {  49,  65,  5, 11 }, {  49,  65,  5, 11 },
+	{  49,  95,  5, 11 }, {  49,  95,  5, 11 }, {  49,  98,  5, 11 }, {  49,  98,  5, 11 },
+	{  49, 100,  5, 11 }, {  49, 100,  5, 11 }, {  49, 102,  5, 11 }, {  49, 102,  5, 11 },
+	{  49, 103,  5, 11 }, {  49, 103,  5, 11 }, {  49, 104,  5, 11 }, {  49, 104,  5, 11 },
+	{  49, 108,  5, 11 }, {  49, 108,  5, 11 }, {  49, 109,  5, 11 }, {  49, 109,  5, 11 },
+	{  49, 110,  5, 11 }, {  49, 110,  5, 11 }, {  49, 112,  5, 11 }, {  49, 112,  5, 11 },
+	{  49, 114,  5, 11 }, {  49, 114,  5, 11 }, {  49, 117,  5, 11 }, {  49, 117,  5, 11 },
+	{  49,  58,  5, 12 }, {  49,  66,  5, 12 }, {  49,  67,  5, 12 }, {  49,  68,  5, 12 },
+	{  49,  69,  5, 12 }, {  49,  70,  5, 12 }, {  49,  71,  5, 12 }, {  49,  72,  5, 12 },
+	{  49,  73,  5, 12 }, {  49,  74,  5, 12 }, {  49,  75,  5, 12 }, {  49,  76,  5, 12 },
+	{  49,  77,  5, 12 }, {  49,  78,  5, 12 }, {  49,  79,  5, 12 }, {  49,  80,  5, 12 },
+	{  49,  81,  5, 12 }, {  49,  82,  5, 12 }, {  49,  83,  5, 12 }, {  49,  84,  5, 12 },
+	{  49,  85,  5, 12 }, {  49,  86,  5, 12 }, {  49,  87,  5, 12 }, {  49,  89,  5, 12 },
+	{  49, 106,  5, 12 }, {  49, 107,  5, 12 }, {  49, 113,  5, 12 }, {  49, 118,  5, 12 },
+	{  49, 119,  5, 12 }, {  49, 120,  5, 12 }, {  49, 121,  5, 12 }, {  49, 122,  5, 12 },
+	{  49,   0,  5,  5 }, {  49,   0,  5,  5 }, {  49,   0,  5,  5 }, {  49,   0,  5,  5 },
+	{  50,  48,  5, 10 }, {  50,  48,  5, 10 }, {  50,  48,  5, 10 }, {  50,  48,  5, 10 },
+	{  50,  49,  5, 10 }, {  50,  49,  5, 10 }, {  50,  49,  5, 10 }, {  50,  49,  5, 10 },
+	{  50,  50,  5, 10 }, {  50,  50,  5, 10 }, {  50,  50,  5, 10 }, {  50,  50,  5, 10 },
+	{  50,  97,  5, 10 }, {  50,  97,  5, 10 }, {  50,  97,  5, 10 }, {  50,  97,  5, 10 },
+	{  50,  99,  5, 10 }, {  50,  99,  5, 10 }, {  50,  99,  5, 10 }, {  50,  99,  5, 10 },
+	{  50, 101,  5, 10 }, {  50, 101,  5, 10 }, {  50, 101,  5, 10 }, {  50, 101,  5, 10 },
+	{  50, 105,  5, 10 }, {  50, 105,  5, 10 }, {  50, 105,  5, 10 }, {  50, 105,  5, 10 },
+	{  50, 111,  5, 10 }, {  50, 111,  5, 10 }, {  50, 111,  5, 10 }, {  50, 111,  5, 10 },
+	{  50, 115,  5, 10 }, {  50, 115,  5, 10 }, {  50, 115,  5, 10 }, {  50, 115,  5, 10 },
+	{  50, 116,  5, 10 }, {  50, 116,  5, 10 }, {  50, 116,  5, 10 }, {  50, 116,  5, 10 },
+	{  50,  32,  5, 11 }, {  50,  32,  5, 11 }, {  50,  37,  5, 11 }, {  50,  37,  5, 11 },
+	{  50,  45,  5, 11 }, {  50,  45,  5, 11 }, {  50,  46,  5, 11 }, {  50,  46,  5, 11 },
+	{  50,  47,  5, 11 }, {  50,  47,  5, 11 }, {  50,  51,  5, 11 }, {  50,  51,  5, 11 },
+	{  50,  52,  5, 11 }, {  50,  52,  5, 11 }, {  50,  53,  5, 11 }, {  50,  53,  5, 11 },
+	{  50,  54,  5, 11 }, {  50,  54,  5, 11 }, {  50,  55,  5, 11 }, {  50,  55,  5, 11 },
+	{  50,  56,  5, 11 }, {  50,  56,  5, 11 }, {  50,  57,  5, 11 }, {  50,  57,  5, 11 },
+	{  50,  61,  5, 11 }, {  50,  61,  5, 11 }, {  50,  65,  5, 11 }, {  50,  65,  5, 11 },
+	{  50,  95,  5, 11 }, {  50,  95,  5, 11 }, {  50,  98,  5, 11 }, {  50,  98,  5, 11 },
+	{  50, 100,  5, 11 }, {  50, 100,  5, 11 }, {  50, 102,  5, 11 }, {  50, 102,  5, 11 },
+	{  50, 103,  5, 11 }, {  50, 103,  5, 11 }, {  50, 104,  5, 11 }, {  50, 104,  5, 11 },
+	{  50, 108,  5, 11 }, {  50, 108,  5, 11 }, {  50, 109,  5, 11 }, {  50, 109,  5, 11 },
+	{  50, 110,  5, 11 }, {  50, 110,  5, 11 }, {  50, 112,  5, 11 }, {  50, 112,  5, 11 },
+	{  50, 114,  5, 11 }, {  50, 114,  5, 11 }, {  50, 117,  5, 11 }, {  50, 117,  5, 11 },
+	{  50,  58,  5, 12 }, {  50,  66,  5, 12 }, {  50,  67,  5, 12 }, {  50,  68,  5, 12 },
+	{  50,  69,  5, 12 }, {  50,  70,  5, 12 }, {  50,  71,  5, 12 }, {  50,  72,  5, 12 },
+	{  50,  73,  5, 12 }, {  50,  74,  5, 12 }, {  50,  75,  5, 12 }, {  50,  76,  5, 12 },
+	{  50,  77,  5, 12 }, {  50,  78,  5, 12 }, {  50,  79,  5, 12 }, {  50,  80,  5, 12 },
+	{  50,  81,  5, 12 }, {  50,  82,  5, 12 }, {  50,  83,  5, 12 }, {  50,  84,  5, 12 },
+	{  50,  85,  5, 12 }, {  50,  86,  5, 12 }, {  50,  87,  5, 12 }, {  50,  89,  5, 12 },
+	{  50, 106,  5, 12 }, {  50, 107,  5, 12 }, {  50, 113,  5, 12 }, {  50, 118,  5, 12 },
+	{  50, 119,  5, 12 }, {  50, 120,  5, 12 }, {  50, 121,  5, 12 }, {  50, 122,  5, 12 },
+	{  50,   0,  5,  5 }, {  50,   0,  5,  5 }, {  50,   0,  5,  5 }, {  50,   0,  5,  5 },
+	{  97,  48,  5, 10 }, {  97,  48,  5, 10 }, {  97,  48,  5, 10 }, {  97,  48,  5, 10 },
+	{  97,  49,  5, 10 }, {  97,  49,  5, 10 }, {  97,  49,  5, 10 }, {  97,  49,  5, 10 },
+	{  97,  50,  5, 10 }, {  97,  50,  5, 10 }, {  97,  50,  5, 10 }, {  97,  50,  5, 10 },
+	{  97,  97,  5, 10 }, {  97,  97,  5, 10 }, {  97,  97,  5, 10 }, {  97,  97,  5, 10 },
+	{  97,  99,  5, 10 }, {  97,  99,  5, 10 }, {  97,  99,  5, 10 }, {  97,  99,  5, 10 },
+	{  97, 101,  5, 10 }, {  97, 101,  5, 10 }, {  97, 101,  5, 10 }, {  97, 101,  5, 10 },
+	{  97, 105,  5, 10 }, {  97, 105,  5, 10 }, {  97, 105,  5, 10 }, {  97, 105,  5, 10 },
+	{  97, 111,  5, 10 }, {  97, 111,  5, 10 }, {  97, 111,  5, 10 }, {  97, 111,  5, 10 },
+	{  97, 115,  5, 10 }, {  97, 115,  5, 10 }, {  97, 115,  5, 10 }, {  97, 115,  5, 10 },
+	{  97, 116,  5, 10 }, {  97, 116,  5, 10 }, {  97, 116,  5, 10 }, {  97, 116,  5, 10 },
+	{  97,  32,  5, 11 }, {  97,  32,  5, 11 }, {  97,  37,  5, 11 }, {  97,  37,  5, 11 },
+	{  97,  45,  5, 11 }, {  97,  45,  5, 11 }, {  97,  46,  5, 11 }, {  97,  46,  5, 11 },
+	{  97,  47,  5, 11 }, {  97,  47,  5, 11 }, {  97,  51,  5, 11 }, {  97,  51,  5, 11 },
+	{  97,  52,  5, 11 }, {  97,  52,  5, 11 }, {  97,  53,  5, 11 }, {  97,  53,  5, 11 },
+	{  97,  54,  5, 11 }, {  97,  54,  5, 11 }, {  97,  55,  5, 11 }, {  97,  55,  5, 11 },
+	{  97,  56,  5, 11 }, {  97,  56,  5, 11 }, {  97,  57,  5, 11 }, {  97,  57,  5, 11 },
+	{  97,  61,  5, 11 }, {  97,  61,  5, 11 }, {  97,  65,  5, 11 }, {  97,  65,  5, 11 },
+	{  97,  95,  5, 11 }, {  97,  95,  5, 11 }, {  97,  98,  5, 11 }, {  97,  98,  5, 11 },
+	{  97, 100,  5, 11 }, {  97, 100,  5, 11 }, {  97, 102,  5, 11 }, {  97, 102,  5, 11 },
+	{  97, 103,  5, 11 }, {  97, 103,  5, 11 }, {  97, 104,  5, 11 }, {  97, 104,  5, 11 },
+	{  97, 108,  5, 11 }, {  97, 108,  5, 11 }, {  97, 109,  5, 11 }, {  97, 109,  5, 11 },
+	{  97, 110,  5, 11 }, {  97, 110,  5, 11 }, {  97, 112,  5, 11 }, {  97, 112,  5, 11 },
+	{  97, 114,  5, 11 }, {  97, 114,  5, 11 }, {  97, 117,  5, 11 }, {  97, 117,  5, 11 },
+	{  97,  58,  5, 12 }, {  97,  66,  5, 12 }, {  97,  67,  5, 12 }, {  97,  68,  5, 12 },
+	{  97,  69,  5, 12 }, {  97,  70,  5, 12 }, {  97,  71,  5, 12 }, {  97,  72,  5, 12 },
+	{  97,  73,  5, 12 }, {  97,  74,  5, 12 }, {  97,  75,  5, 12 }, {  97,  76,  5, 12 },
+	{  97,  77,  5, 12 }, {  97,  78,  5, 12 }, {  97,  79,  5, 12 }, {  97,  80,  5, 12 },
+	{  97,  81,  5, 12 }, {  97,  82,  5, 12 }, {  97,  83,  5, 12 }, {  97,  84,  5, 12 },
+	{  97,  85,  5, 12 }, {  97,  86,  5, 12 }, {  97,  87,  5, 12 }, {  97,  89,  5, 12 },
+	{  97, 106,  5, 12 }, {  97, 107,  5, 12 }, {  97, 113,  5, 12 }, {  97, 118,  5, 12 },
+	{  97, 119,  5, 12 }, {  97, 120,  5, 12 }, {  97, 121,  5, 12 }, {  97, 122,  5, 12 },
+	{  97,   0,  5,  5 }, {  97,   0,  5,  5 }, {  97,   0,  5,  5 }, {  97,   0,  5,  5 },
+	{  99,  48,  5, 10 }, {  99,  48,  5, 10 }, {  99,  48,  5, 10 }, {  99,  48,  5, 10 },
+	{  99,  49,  5, 10 }, {  99,  49,  5, 10 }, {  99,  49,  5, 10 }, {  99,  49,  5, 10 },
+	{  99,  50,  5, 10 }, {  99,  50,  5, 10 }, {  99,  50,  5, 10 }, {  99,  50,  5, 10 },
+	{  99,  97,  5, 10 }, {  99,  97,  5, 10 }, {  99,  97,  5, 10 }, {  99,  97,  5, 10 },
+	{  99,  99,  5, 10 }, {  99,  99,  5, 10 }, {  99,  99,  5, 10 }, {  99,  99,  5, 10 },
+	{  99, 101,  5, 10 }, {  99, 101,  5, 10 }, {  99, 101,  5, 10 }, {  99, 101,  5, 10 },
+	{  99, 105,  5, 10 }, {  99, 105,  5, 10 }, {  99, 105,  5, 10 }, {  99, 105,  5, 10 },
+	{  99, 111,  5, 10 }, {  99, 111,  5, 10 }, {  99, 111,  5, 10 }, {  99, 111,  5, 10 },
+	{  99, 115,  5, 10 }, {  99, 115,  5, 10 }, {  99, 115,  5, 10 }, {  99, 115,  5, 10 },
+	{  99, 116,  5, 10 }, {  99, 116,  5, 10 }, {  99, 116,  5, 10 }, {  99, 116,  5, 10 },
+	{  99,  32,  5, 11 }, {  99,  32,  5, 11 }, {  99,  37,  5, 11 }, {  99,  37,  5, 11 },
+	{  99,  45,  5, 11 }, {  99,  45,  5, 11 }, {  99,  46,  5, 11 }, {  99,  46,  5, 11 },
+	{  99,  47,  5, 11 }, {  99,  47,  5, 11 }, {  99,  51,  5, 11 }, {  99,  51,  5, 11 },
+	{  99,  52,  5, 11 }, {  99,  52,  5, 11 }, {  99,  53,  5, 11 }, {  99,  53,  5, 11 },
+	{  99,  54,  5, 11 }, {  99,  54,  5, 11 }, {  99,  55,  5, 11 }, {  99,  55,  5, 11 },
+	{  99,  56,  5, 11 }, {  99,  56,  5, 11 }, {  99,  57,  5, 11 }, {  99,  57,  5, 11 },
+	{  99,  61,  5, 11 }, {  99,  61,  5, 11 }, {  99,  65,  5, 11 }, {  99,  65,  5, 11 },
+	{  99,  95,  5, 11 }, {  99,  95,  5, 11 }, {  99,  98,  5, 11 }, {  99,  98,  5, 11 },
+	{  99, 100,  5, 11 }, {  99, 100,  5, 11 }, {  99, 102,  5, 11 }, {  99, 102,  5, 11 },
+	{  99, 103,  5, 11 }, {  99, 103,  5, 11 }, {  99, 104,  5, 11 }, {  99, 104,  5, 11 },
+	{  99, 108,  5, 11 }, {  99, 108,  5, 11 }, {  99, 109,  5, 11 }, {  99, 109,  5, 11 },
+	{  99, 110,  5, 11 }, {  99, 110,  5, 11 }, {  99, 112,  5, 11 }, {  99, 112,  5, 11 },
+	{  99, 114,  5, 11 }, {  99, 114,  5, 11 }, {  99, 117,  5, 11 }, {  99, 117,  5, 11 },
+	{  99,  58,  5, 12 }, {  99,  66,  5, 12 }, {  99,  67,  5, 12 }, {  99,  68,  5, 12 },
+	{  99,  69,  5, 12 }, {  99,  70,  5, 12 }, {  99,  71,  5, 12 }, {  99,  72,  5, 12 },
+	{  99,  73,  5, 12 }, {  99,  74,  5, 12 }, {  99,  75,  5, 12 }, {  99,  76,  5, 12 },
+	{  99,  77,  5, 12 }, {  99,  78,  5, 12 }, {  99,  79,  5, 12 }, {  99,  80,  5, 12 },
+	{  99,  81,  5, 12 }, {  99,  82,  5, 12 }, {  99,  83,  5, 12 }, {  99,  84,  5, 12 },
+	{  99,  85,  5, 12 }, {  99,  86,  5, 12 }, {  99,  87,  5, 12 }, {  99,  89,  5, 12 },
+	{  99, 106,  5, 12 }, {  99, 107,  5, 12 }, {  99, 113,  5, 12 }, {  99, 118,  5, 12 },
+	{  99, 119,  5, 12 }, {  99, 120,  5, 12 }, {  99, 121,  5, 12 }, {  99, 122,  5, 12 },
+	{  99,   0,  5,  5 }, {  99,   0,  5,  5 }, {  99,   0,  5,  5 }, {  99,   0,  5,  5 },
+	{ 101,  48,  5, 10 }, { 101,  48,  5, 10 }, { 101,  48,  5, 10 }, { 101,  48,  5, 10 },
+	{ 101,  49,  5, 10 }, { 101,  49,  5, 10 }, { 101,  49,  5, 10 }, { 101,  49,  5, 10 },
+	{ 101,  50,  5, 10 }, { 101,  50,  5, 10 }, { 101,  50,  5, 10 }, { 101,  50,  5, 10 },
+	{ 101,  97,  5, 10 }, { 101,  97,  5, 10 }, { 101,  97,  5, 10 }, { 101,  97,  5, 10 },
+	{ 101,  99,  5, 10 }, { 101,  99,  5, 10 }, { 101,  99,  5, 10 }, { 101,  99,  5, 10 },
+	{ 101, 101,  5, 10 }, { 101, 101,  5, 10 }, { 101, 101,  5, 10 }, { 101, 101,  5, 10 },
+	{ 101, 105,  5, 10 }, { 101, 105,  5, 10 }, { 101, 105,  5, 10 }, { 101, 105,  5, 10 },
+	{ 101, 111,  5, 10 }, { 101, 111,  5, 10 }, { 101, 111,  5, 10 }, { 101, 111,  5, 10 },
+	{ 101, 115,  5, 10 }, { 101, 115,  5, 10 }, { 101, 115,  5, 10 }, { 101, 115,  5, 10 },
+	{ 101, 116,  5, 10 }, { 101, 116,  5, 10 }, { 101, 116,  5, 10 }, { 101, 116,  5, 10 },
+	{ 101,  32,  5, 11 }, { 101,  32,  5, 11 }, { 101,  37,  5, 11 }, { 101,  37,  5, 11 },
+	{ 101,  45,  5, 11 }, { 101,  45,  5, 11 }, { 101,  46,  5, 11 }, { 101,  46,  5, 11 },
+	{ 101,  47,  5, 11 }, { 101,  47,  5, 11 }, { 101,  51,  5, 11 }, { 101,  51,  5, 11 },
+	{ 101,  52,  5, 11 }, { 101,  52,  5, 11 }, { 101,  53,  5, 11 }, { 101,  53,  5, 11 },
+	{ 101,  54,  5, 11 }, { 101,  54,  5, 11 }, { 101,  55,  5, 11 }, { 101,  55,  5, 11 },
+	{ 101,  56,  5, 11 }, { 101,  56,  5, 11 }, { 101,  57,  5, 11 }, { 101,  57,  5, 11 },
+	{ 101,  61,  5, 11 }, { 101,  61,  5, 11 }, { 101,  65,  5, 11 }, { 101,  65,  5, 11 },
+	{ 101,  95,  5, 11 }, { 101,  95,  5, 11 }, { 101,  98,  5, 11 }, { 101,  98,  5, 11 },
+	{ 101, 100,  5, 11 }, { 101, 100,  5, 11 }, { 101, 102,  5, 11 }, { 101, 102,  5, 11 },
+	{ 101, 103,  5, 11 }, { 101, 103,  5, 11 }, { 101, 104,  5, 11 }, { 101, 104,  5, 11 },
+	{ 101, 108,  5, 11 }, { 101, 108,  5, 11 }, { 101, 109,  5, 11 }, { 101, 109,  5, 11 },
+	{ 101, 110,  5, 11 }, { 101, 110,  5, 11 }, { 101, 112,  5, 11 }, { 101, 112,  5, 11 },
+	{ 101, 114,  5, 11 }, { 101, 114,  5, 11 }, { 101, 117,  5, 11 }, { 101, 117,  5, 11 },
+	{ 101,  58,  5, 12 }, { 101,  66,  5, 12 }, { 101,  67,  5, 12 }, { 101,  68,  5, 12 },
+	{ 101,  69,  5, 12 }, { 101,  70,  5, 12 }, { 101,  71,  5, 12 }, { 101,  72,  5, 12 },
+	{ 101,  73,  5, 12 }, { 101,  74,  5, 12 }, { 101,  75,  5, 12 }, { 101,  76,  5, 12 },
+	{ 101,  77,  5, 12 }, { 101,  78,  5, 12 }, { 101,  79,  5, 12 }, { 101,  80,  5, 12 },
+	{ 101,  81,  5, 12 }, { 101,  82,  5, 12 }, { 101,  83,  5, 12 }, { 101,  84,  5, 12 },
+	{ 101,  85,  5, 12 }, { 101,  86,  5, 12 }, { 101,  87,  5, 12 }, { 101,  89,  5, 12 },
+	{ 101, 106,  5, 12 }, { 101, 107,  5, 12 }, { 101, 113,  5, 12 }, { 101, 118,  5, 12 },
+	{ 101, 119,  5, 12 }, { 101, 120,  5, 12 }, { 101, 121,  5, 12 }, { 101, 122,  5, 12 },
+	{ 101,   0,  5,  5 }, { 101,   0,  5,  5 }, { 101,   0,  5,  5 }, { 101,   0,  5,  5 },
+	{ 105,  48,  5, 10 }, { 105,  48,  5, 10 }, { 105,  48,  5, 10 }, { 105,  48,  5, 10 },
+	{ 105,  49,  5, 10 }, { 105,  49,  5, 10 }, { 105,  49,  5, 10 }, { 105,  49,  5, 10 },
+	{ 105,  50,  5, 10 }, { 105,  50,  5, 10 }, { 105,  50,  5, 10 }, { 105,  50,  5, 10 },
+	{ 105,  97,  5, 10 }, { 105,  97,  5, 10 }, { 105,  97,  5, 10 }, { 105,  97,  5, 10 },
+	{ 105,  99,  5, 10 }, { 105,  99,  5, 10 }, { 105,  99,  5, 10 }, { 105,  99,  5, 10 },
+	{ 105, 101,  5, 10 }, { 105, 101,  5, 10 }, { 105, 101,  5, 10 }, { 105, 101,  5, 10 },
+	{ 105, 105,  5, 10 }, { 105, 105,  5, 10 }, { 105, 105,  5, 10 }, { 105, 105,  5, 10 },
+	{ 105, 111,  5, 10 }, { 105, 111,  5, 10 }, { 105, 111,  5, 10 }, { 105, 111,  5, 10 },
+	{ 105, 115,  5, 10 }, { 105, 115,  5, 10 }, { 105, 115,  5, 10 }, { 105, 115,  5, 10 },
+	{ 105, 116,  5, 10 }, { 105, 116,  5, 10 }, { 105, 116,  5, 10 }, { 105, 116,  5, 10 },
+	{ 105,  32,  5, 11 }, { 105,  32,  5, 11 }, { 105,  37,  5, 11 }, { 105,  37,  5, 11 },
+	{ 105,  45,  5, 11 }, { 105,  45,  5, 11 }, { 105,  46,  5, 11 }, { 105,  46,  5, 11 },
+	{ 105,  47,  5, 11 }, { 105,  47,  5, 11 }, { 105,  51,  5, 11 }, { 105,  51,  5, 11 },
+	{ 105,  52,  5, 11 }, { 105,  52,  5, 11 }, { 105,  53,  5, 11 }, { 105,  53,  5, 11 },
+	{ 105,  54,  5, 11 }, { 105,  54,  5, 11 }, { 105,  55,  5, 11 }, { 105,  55,  5, 11 },
+	{ 105,  56,  5, 11 }, { 105,  56,  5, 11 }, { 105,  57,  5, 11 }, { 105,  57,  5, 11 },
+	{ 105,  61,  5, 11 }, { 105,  61,  5, 11 }, { 105,  65,  5, 11 }, { 105,  65,  5, 11 },
+	{ 105,  95,  5, 11 }, { 105,  95,  5, 11 }, { 105,  98,  5, 11 }, { 105,  98,  5, 11 },
+	{ 105, 100,  5, 11 }, { 105, 100,  5, 11 }, { 105, 102,  5, 11 }, { 105, 102,  5, 11 },
+	{ 105, 103,  5, 11 }, { 105, 103,  5, 11 }, { 105, 104,  5, 11 }, { 105, 104,  5, 11 },
+	{ 105, 108,  5, 11 }, { 105, 108,  5, 11 }, { 105, 109,  5, 11 }, { 105, 109,  5, 11 },
+	{ 105, 110,  5, 11 }, { 105, 110,  5, 11 }, { 105, 112,  5, 11 }, { 105, 112,  5, 11 },
+	{ 105, 114,  5, 11 }, { 105, 114,  5, 11 }, { 105, 117,  5, 11 }, { 105, 117,  5, 11 },
+	{ 105,  58,  5, 12 }, { 105,  66,  5, 12 }, { 105,  67,  5, 12 }, { 105,  68,  5, 12 },
+	{ 105,  69,  5, 12 }, { 105,  70,  5, 12 }, { 105,  71,  5, 12 }, { 105,  72,  5, 12 },
+	{ 105,  73,  5, 12 }, { 105,  74,  5, 12 }, { 105,  75,  5, 12 }, { 105,  76,  5, 12 },
+	{ 105,  77,  5, 12 }, { 105,  78,  5, 12 }, { 105,  79,  5, 12 }, { 105,  80,  5, 12 },
+	{ 105,  81,  5, 12 }, { 105,  82,  5, 12 }, { 105,  83,  5, 12 }, { 105,  84,  5, 12 },
+	{ 105,  85,  5, 12 }, { 105,  86,  5, 12 }, { 105,  87,  5, 12 }, { 105,  89,  5, 12 },
+	{ 105, 106,  5, 12 }, { 105, 107,  5, 12 }, { 105, 113,  5, 12 }, { 105, 118,  5, 12 },
+	{ 105, 119,  5, 12 }, { 105, 120,  5, 12 }, { 105, 121,  5, 12 }, { 105, 122,  5, 12 },
+	{ 105,   0,  5,  5 }, { 105,   0,  5,  5 }, { 105,   0,  5,  5 }, { 105,   0,  5,  5 },
+	{ 111,  48,  5, 10 }, { 111,  48,  5, 10 }, { 111,  48,  5, 10 }, { 111,  48,  5, 10 },
+	{ 111,  49,  5, 10 }, { 111,  49,  5, 10 }, { 111,  49,  5, 10 }, { 111,  49,  5, 10 },
+	{ 111,  50,  5, 10 }, { 111,  50,  5, 10 }, { 111,  50,  5, 10 }, { 111,  50,  5, 10 },
+	{ 111,  97,  5, 10 }, { 111,  97,  5, 10 }, { 111,  97,  5, 10 }, { 111,  97,  5, 10 },
+	{ 111,  99,  5, 10 }, { 111,  99,  5, 10 }, { 111,  99,  5, 10 }, { 111,  99,  5, 10 },
+	{ 111, 101,  5, 10 }, { 111, 101,  5, 10 }, { 111, 101,  5, 10 }, { 111, 101,  5, 10 },
+	{ 111, 105,  5, 10 }, { 111, 105,  5, 10 }, { 111, 105,  5, 10 }, { 111, 105,  5, 10 },
+	{ 111, 111,  5, 10 }, { 111, 111,  5, 10 }, { 111, 111,  5, 10 }, { 111, 111,  5, 10 },
+	{ 111, 115,  5, 10 }, { 111, 115,  5, 10 }, { 111, 115,  5, 10 }, { 111, 115,  5, 10 },
+	{ 111, 116,  5, 10 }, { 111, 116,  5, 10 }, { 111, 116,  5, 10 }, { 111, 116,  5, 10 },
+	{ 111,  32,  5, 11 }, { 111,  32,  5, 11 }, { 111,  37,  5, 11 }, { 111,  37,  5, 11 },
+	{ 111,  45,  5, 11 }, { 111,  45,  5, 11 }, { 111,  46,  5, 11 }, { 111,  46,  5, 11 },
+	{ 111,  47,  5, 11 }, { 111,  47,  5, 11 }, { 111,  51,  5, 11 }, { 111,  51,  5, 11 },
+	{ 111,  52,  5, 11 }, { 111,  52,  5, 11 }, { 111,  53,  5, 11 }, { 111,  53,  5, 11 },
+	{ 111,  54,  5, 11 }, { 111,  54,  5, 11 }, { 111,  55,  5, 11 }, { 111,  55,  5, 11 },
+	{ 111,  56,  5, 11 }, { 111,  56,  5, 11 }, { 111,  57,  5, 11 }, { 111,  57,  5, 11 },
+	{ 111,  61,  5, 11 }, { 111,  61,  5, 11 }, { 111,  65,  5, 11 }, { 111,  65,  5, 11 },
+	{ 111,  95,  5, 11 }, { 111,  95,  5, 11 }, { 111,  98,  5, 11 }, { 111,  98,  5, 11 },
+	{ 111, 100,  5, 11 }, { 111, 100,  5, 11 }, { 111, 102,  5, 11 }, { 111, 102,  5, 11 },
+	{ 111, 103,  5, 11 }, { 111, 103,  5, 11 }, { 111, 104,  5, 11 }, { 111, 104,  5, 11 },
+	{ 111, 108,  5, 11 }, { 111, 108,  5, 11 }, { 111, 109,  5, 11 }, { 111, 109,  5, 11 },
+	{ 111, 110,  5, 11 }, { 111, 110,  5, 11 }, { 111, 112,  5, 11 }, { 111, 112,  5, 11 },
+	{ 111, 114,  5, 11 }, { 111, 114,  5, 11 }, { 111, 117,  5, 11 }, { 111, 117,  5, 11 },
+	{ 111,  58,  5, 12 }, { 111,  66,  5, 12 }, { 111,  67,  5, 12 }, { 111,  68,  5, 12 },
+	{ 111,  69,  5, 12 }, { 111,  70,  5, 12 }, { 111,  71,  5, 12 }, { 111,  72,  5, 12 },
+	{ 111,  73,  5, 12 }, { 111,  74,  5, 12 }, { 111,  75,  5, 12 }, { 111,  76,  5, 12 },
+	{ 111,  77,  5, 12 }, { 111,  78,  5, 12 }, { 111,  79,  5, 12 }, { 111,  80,  5, 12 },
+	{ 111,  81,  5, 12 }, { 111,  82,  5, 12 }, { 111,  83,  5, 12 }, { 111,  84,  5, 12 },
+	{ 111,  85,  5, 12 }, { 111,  86,  5, 12 }, { 111,  87,  5, 12 }, { 111,  89,  5, 12 },
+	{ 111, 106,  5, 12 }, { 111, 107,  5, 12 }, { 111, 113,  5, 12 }, { 111, 118,  5, 12 },
+	{ 111, 119,  5, 12 }, { 111, 120,  5, 12 }, { 111, 121,  5, 12 }, { 111, 122,  5, 12 },
+	{ 111,   0,  5,  5 }, { 111,   0,  5,  5 }, { 111,   0,  5,  5 }, { 111,   0,  5,  5 },
+	{ 115,  48,  5, 10 }, { 115,  48,  5, 10 }, { 115,  48,  5, 10 }, { 115,  48,  5, 10 },
+	{ 115,  49,  5, 10 }, { 115,  49,  5, 10 }, { 115,  49,  5, 10 }, { 115,  49,  5, 10 },
+	{ 115,  50,  5, 10 }, { 115,  50,  5, 10 }, { 115,  50,  5, 10 }, { 115,  50,  5, 10 },
+	{ 115,  97,  5, 10 }, { 115,  97,  5, 10 }, { 115,  97,  5, 10 }, { 115,  97,  5, 10 },
+	{ 115,  99,  5, 10 }, { 115,  99,  5, 10 }, { 115,  99,  5, 10 }, { 115,  99,  5, 10 },
+	{ 115, 101,  5, 10 }, { 115, 101,  5, 10 }, { 115, 101,  5, 10 }, { 115, 101,  5, 10 },
+	{ 115, 105,  5, 10 }, { 115, 105,  5, 10 }, { 115, 105,  5, 10 }, { 115, 105,  5, 10 },
+	{ 115, 111,  5, 10 }, { 115, 111,  5, 10 }, { 115, 111,  5, 10 }, { 115, 111,  5, 10 },
+	{ 115, 115,  5, 10 }, { 115, 115,  5, 10 }, { 115, 115,  5, 10 }, { 115, 115,  5, 10 },
+	{ 115, 116,  5, 10 }, { 115, 116,  5, 10 }, { 115, 116,  5, 10 }, { 115, 116,  5, 10 },
+	{ 115,  32,  5, 11 }, { 115,  32,  5, 11 }, { 115,  37,  5, 11 }, { 115,  37,  5, 11 },
+	{ 115,  45,  5, 11 }, { 115,  45,  5, 11 }, { 115,  46,  5, 11 }, { 115,  46,  5, 11 },
+	{ 115,  47,  5, 11 }, { 115,  47,  5, 11 }, { 115,  51,  5, 11 }, { 115,  51,  5, 11 },
+	{ 115,  52,  5, 11 }, { 115,  52,  5, 11 }, { 115,  53,  5, 11 }, { 115,  53,  5, 11 },
+	{ 115,  54,  5, 11 }, { 115,  54,  5, 11 }, { 115,  55,  5, 11 }, { 115,  55,  5, 11 },
+	{ 115,  56,  5, 11 }, { 115,  56,  5, 11 }, { 115,  57,  5, 11 }, { 115,  57,  5, 11 },
+	{ 115,  61,  5, 11 }, { 115,  61,  5, 11 }, { 115,  65,  5, 11 }, { 115,  65,  5, 11 },
+	{ 115,  95,  5, 11 }, { 115,  95,  5, 11 }, { 115,  98,  5, 11 }, { 115,  98,  5, 11 },
+	{ 115, 100,  5, 11 }, { 115, 100,  5, 11 }, { 115, 102,  5, 11 }, { 115, 102,  5, 11 },
+	{ 115, 103,  5, 11 }, { 115, 103,  5, 11 }, { 115, 104,  5, 11 }, { 115, 104,  5, 11 },
+	{ 115, 108,  5, 11 }, { 115, 108,  5, 11 }, { 115, 109,  5, 11 }, { 115, 109,  5, 11 },
+	{ 115, 110,  5, 11 }, { 115, 110,  5, 11 }, { 115, 112,  5, 11 }, { 115, 112,  5, 11 },
+	{ 115, 114,  5, 11 }, { 115, 114,  5, 11 }, { 115, 117,  5, 11 }, { 115, 117,  5, 11 },
+	{ 115,  58,  5, 12 }, { 115,  66,  5, 12 }, { 115,  67,  5, 12 }, { 115,  68,  5, 12 },
+	{ 115,  69,  5, 12 }, { 115,  70,  5, 12 }, { 115,  71,  5, 12 }, { 115,  72,  5, 12 },
+	{ 115,  73,  5, 12 }, { 115,  74,  5, 12 }, { 115,  75,  5, 12 }, { 115,  76,  5, 12 },
+	{ 115,  77,  5, 12 }, { 115,  78,  5, 12 }, { 115,  79,  5, 12 }, { 115,  80,  5, 12 },
+	{ 115,  81,  5, 12 }, { 115,  82,  5, 12 }, { 115,  83,  5, 12 }, { 115,  84,  5, 12 },
+	{ 115,  85,  5, 12 }, { 115,  86,  5, 12 }, { 115,  87,  5, 12 }, { 115,  89,  5, 12 },
+	{ 115, 106,  5, 12 }, { 115, 107,  5, 12 }, { 115, 113,  5, 12 }, { 115, 118,  5, 12 },
+	{ 115, 119,  5, 12 }, { 115, 120,  5, 12 }, { 115, 121,  5, 12 }, { 115, 122,  5, 12 },
+	{ 115,   0,  5,  5 }, { 115,   0,  5,  5 }, { 115,   0,  5,  5 }, { 115,   0,  5,  5 },
+	{ 116,  48,  5, 10 }, { 116,  48,  5, 10 }, { 116,  48,  5, 10 }, { 116,  48,  5, 10 },
+	{ 116,  49,  5, 10 }, { 116,  49,  5, 10 }, { 116,  49,  5, 10 }, { 116,  49,  5, 10 },
+	{ 116,  50,  5, 10 }, { 116,  50,  5, 10 }, { 116,  50,  5, 10 }, { 116,  50,  5, 10 },
+	{ 116,  97,  5, 10 }, { 116,  97,  5, 10 }, { 116,  97,  5, 10 }, { 116,  97,  5, 10 },
+	{ 116,  99,  5, 10 }, { 116,  99,  5, 10 }, { 116,  99,  5, 10 }, { 116,  99,  5, 10 },
+	{ 116, 101,  5, 10 }, { 116, 101,  5, 10 }, { 116, 101,  5, 10 }, { 116, 101,  5, 10 },
+	{ 116, 105,  5, 10 }, { 116, 105,  5, 10 }, { 116, 105,  5, 10 }, { 116, 105,  5, 10 },
+	{ 116, 111,  5, 10 }, { 116, 111,  5, 10 }, { 116, 111,  5, 10 }, { 116, 111,  5, 10 },
+	{ 116, 115,  5, 10 }, { 116, 115,  5, 10 }, { 116, 115,  5, 10 }, { 116, 115,  5, 10 },
+	{ 116, 116,  5, 10 }, { 116, 116,  5, 10 }, { 116, 116,  5, 10 }, { 116, 116,  5, 10 },
+	{ 116,  32,  5, 11 }, { 116,  32,  5, 11 }, { 116,  37,  5, 11 }, { 116,  37,  5, 11 },
+	{ 116,  45,  5, 11 }, { 116,  45,  5, 11 }, { 116,  46,  5, 11 }, { 116,  46,  5, 11 },
+	{ 116,  47,  5, 11 }, { 116,  47,  5, 11 }, { 116,  51,  5, 11 }, { 116,  51,  5, 11 },
+	{ 116,  52,  5, 11 }, { 116,  52,  5, 11 }, { 116,  53,  5, 11 }, { 116,  53,  5, 11 },
+	{ 116,  54,  5, 11 }, { 116,  54,  5, 11 }, { 116,  55,  5, 11 }, { 116,  55,  5, 11 },
+	{ 116,  56,  5, 11 }, { 116,  56,  5, 11 }, { 116,  57,  5, 11 }, { 116,  57,  5, 11 },
+	{ 116,  61,  5, 11 }, { 116,  61,  5, 11 }, { 116,  65,  5, 11 }, { 116,  65,  5, 11 },
+	{ 116,  95,  5, 11 }, { 116,  95,  5, 11 }, { 116,  98,  5, 11 }, { 116,  98,  5, 11 },
+	{ 116, 100,  5, 11 }, { 116, 100,  5, 11 }, { 116, 102,  5, 11 }, { 116, 102,  5, 11 },
+	{ 116, 103,  5, 11 }, { 116, 103,  5, 11 }, { 116, 104,  5, 11 }, { 116, 104,  5, 11 },
+	{ 116, 108,  5, 11 }, { 116, 108,  5, 11 }, { 116, 109,  5, 11 }, { 116, 109,  5, 11 },
+	{ 116, 110,  5, 11 }, { 116, 110,  5, 11 }, { 116, 112,  5, 11 }, { 116, 112,  5, 11 },
+	{ 116, 114,  5, 11 }, { 116, 114,  5, 11 }, { 116, 117,  5, 11 }, { 116, 117,  5, 11 },
+	{ 116,  58,  5, 12 }, { 116,  66,  5, 12 }, { 116,  67,  5, 12 }, { 116,  68,  5, 12 },
+	{ 116,  69,  5, 12 }, { 116,  70,  5, 12 }, { 116,  71,  5, 12 }, { 116,  72,  5, 12 },
+	{ 116,  73,  5, 12 }, { 116,  74,  5, 12 }, { 116,  75,  5, 12 }, { 116,  76,  5, 12 },
+	{ 116,  77,  5, 12 }, { 116,  78,  5, 12 }, { 116,  79,  5, 12 }, { 116,  80,  5, 12 },
+	{ 116,  81,  5, 12 }, { 116,  82,  5, 12 }, { 116,  83,  5, 12 }, { 116,  84,  5, 12 },
+	{ 116,  85,  5, 12 }, { 116,  86,  5, 12 }, { 116,  87,  5, 12 }, { 116,  89,  5, 12 },
+	{ 116, 106,  5, 12 }, { 116, 107,  5, 12 }, { 116, 113,  5, 12 }, { 116, 118,  5, 12 },
+	{ 116, 119,  5, 12 }, { 116, 120,  5, 12 }, { 116, 121,  5, 12 }, { 116, 122,  5, 12 },
+	{ 116,   0,  5,  5 }, { 116,   0,  5,  5 }, { 116,   0,  5,  5 }, { 116,   0,  5,  5 },
+	{  32,  48,  6, 11 }, {  32,  48,  6, 11 }, {  32,  49,  6, 11 }, {  32,  49,  6, 11 },
+	{  32,  50,  6, 11 }, {  32,  50,  6, 11 }, {  32,  97,  6, 11 }, {  32,  97,  6, 11 },
+	{  32,  99,  6, 11 }, {  32,  99,  6, 11 }, {  32, 101,  6, 11 }, {  32, 101,  6, 11 },
+	{  32, 105,  6, 11 }, {  32, 105,  6, 11 }, {  32, 111,  6, 11 }, {  32, 111,  6, 11 },
+	{  32, 115,  6, 11 }, {  32, 115,  6, 11 }, {  32, 116,  6, 11 }, {  32, 116,  6, 11 },
+	{  32,  32,  6, 12 }, {  32,  37,  6, 12 }, {  32,  45,  6, 12 }, {  32,  46,  6, 12 },
+	{  32,  47,  6, 12 }, {  32,  51,  6, 12 }, {  32,  52,  6, 12 }, {  32,  53,  6, 12 },
+	{  32,  54,  6, 12 }, {  32,  55,  6, 12 }, {  32,  56,  6, 12 }, {  32,  57,  6, 12 },
+	{  32,  61,  6, 12 }, {  32,  65,  6, 12 }, {  32,  95,  6, 12 }, {  32,  98,  6, 12 },
+	{  32, 100,  6, 12 }, {  32, 102,  6, 12 }, {  32, 103,  6, 12 }, {  32, 104,  6, 12 },
+	{  32, 108,  6, 12 }, {  32, 109,  6, 12 }, {  32, 110,  6, 12 }, {  32, 112,  6, 12 },
+	{  32, 114,  6, 12 }, {  32, 117,  6, 12 }, {  32,   0,  6,  6 }, {  32,   0,  6,  6 },
+	{  32,   0,  6,  6 }, {  32,   0,  6,  6 }, {  32,   0,  6,  6 }, {  32,   0,  6,  6 },
+	{  32,   0,  6,  6 }, {  32,   0,  6,  6 }, {  32,   0,  6,  6 }, {  32,   0,  6,  6 },
+	{  32,   0,  6,  6 }, {  32,   0,  6,  6 }, {  32,   0,  6,  6 }, {  32,   0,  6,  6 },
+	{  32,   0,  6,  6 }, {  32,   0,  6,  6 }, {  32,   0,  6,  6 }, {  32,   0,  6,  6 },
+	{  37,  48,  6, 11 }, {  37,  48,  6, 11 }, {  37,  49,  6, 11 }, {  37,  49,  6, 11 },
+	{  37,  50,  6, 11 }, {  37,  50,  6, 11 }, {  37,  97,  6, 11 }, {  37,  97,  6, 11 },
+	{  37,  99,  6, 11 }, {  37,  99,  6, 11 }, {  37, 101,  6, 11 }, {  37, 101,  6, 11 },
+	{  37, 105,  6, 11 }, {  37, 105,  6, 11 }, {  37, 111,  6, 11 }, {  37, 111,  6, 11 },
+	{  37, 115,  6, 11 }, {  37, 115,  6, 11 }, {  37, 116,  6, 11 }, {  37, 116,  6, 11 },
+	{  37,  32,  6, 12 }, {  37,  37,  6, 12 }, {  37,  45,  6, 12 }, {  37,  46,  6, 12 },
+	{  37,  47,  6, 12 }, {  37,  51,  6, 12 }, {  37,  52,  6, 12 }, {  37,  53,  6, 12 },
+	{  37,  54,  6, 12 }, {  37,  55,  6, 12 }, {  37,  56,  6, 12 }, {  37,  57,  6, 12 },
+	{  37,  61,  6, 12 }, {  37,  65,  6, 12 }, {  37,  95,  6, 12 }, {  37,  98,  6, 12 },
+	{  37, 100,  6, 12 }, {  37, 102,  6, 12 }, {  37, 103,  6, 12 }, {  37, 104,  6, 12 },
+	{  37, 108,  6, 12 }, {  37, 109,  6, 12 }, {  37, 110,  6, 12 }, {  37, 112,  6, 12 },
+	{  37, 114,  6, 12 }, {  37, 117,  6, 12 }, {  37,   0,  6,  6 }, {  37,   0,  6,  6 },
+	{  37,   0,  6,  6 }, {  37,   0,  6,  6 }, {  37,   0,  6,  6 }, {  37,   0,  6,  6 },
+	{  37,   0,  6,  6 }, {  37,   0,  6,  6 }, {  37,   0,  6,  6 }, {  37,   0,  6,  6 },
+	{  37,   0,  6,  6 }, {  37,   0,  6,  6 }, {  37,   0,  6,  6 }, {  37,   0,  6,  6 },
+	{  37,   0,  6,  6 }, {  37,   0,  6,  6 }, {  37,   0,  6,  6 }, {  37,   0,  6,  6 },
+	{  45,  48,  6, 11 }, {  45,  48,  6, 11 }, {  45,  49,  6, 11 }, {  45,  49,  6, 11 },
+	{  45,  50,  6, 11 }, {  45,  50,  6, 11 }, {  45,  97,  6, 11 }, {  45,  97,  6, 11 },
+	{  45,  99,  6, 11 }, {  45,  99,  6, 11 }, {  45, 101,  6, 11 }, {  45, 101,  6, 11 },
+	{  45, 105,  6, 11 }, {  45, 105,  6, 11 }, {  45, 111,  6, 11 }, {  45, 111,  6, 11 },
+	{  45, 115,  6, 11 }, {  45, 115,  6, 11 }, {  45, 116,  6, 11 }, {  45, 116,  6, 11 },
+	{  45,  32,  6, 12 }, {  45,  37,  6, 12 }, {  45,  45,  6, 12 }, {  45,  46,  6, 12 },
+	{  45,  47,  6, 12 }, {  45,  51,  6, 12 }, {  45,  52,  6, 12 }, {  45,  53,  6, 12 },
+	{  45,  54,  6, 12 }, {  45,  55,  6, 12 }, {  45,  56,  6, 12 }, {  45,  57,  6, 12 },
+	{  45,  61,  6, 12 }, {  45,  65,  6, 12 }, {  45,  95,  6, 12 }, {  45,  98,  6, 12 },
+	{  45, 100,  6, 12 }, {  45, 102,  6, 12 }, {  45, 103,  6, 12 }, {  45, 104,  6, 12 },
+	{  45, 108,  6, 12 }, {  45, 109,  6, 12 }, {  45, 110,  6, 12 }, {  45, 112,  6, 12 },
+	{  45, 114,  6, 12 }, {  45, 117,  6, 12 }, {  45,   0,  6,  6 }, {  45,   0,  6,  6 },
+	{  45,   0,  6,  6 }, {  45,   0,  6,  6 }, {  45,   0,  6,  6 }, {  45,   0,  6,  6 },
+	{  45,   0,  6,  6 }, {  45,   0,  6,  6 }, {  45,   0,  6,  6 }, {  45,   0,  6,  6 },
+	{  45,   0,  6,  6 }, {  45,   0,  6,  6 }, {  45,   0,  6,  6 }, {  45,   0,  6,  6 },
+	{  45,   0,  6,  6 }, {  45,   0,  6,  6 }, {  45,   0,  6,  6 }, {  45,   0,  6,  6 },
+	{  46,  48,  6, 11 }, {  46,  48,  6, 11 }, {  46,  49,  6, 11 }, {  46,  49,  6, 11 },
+	{  46,  50,  6, 11 }, {  46,  50,  6, 11 }, {  46,  97,  6, 11 }, {  46,  97,  6, 11 },
+	{  46,  99,  6, 11 }, {  46,  99,  6, 11 }, {  46, 101,  6, 11 }, {  46, 101,  6, 11 },
+	{  46, 105,  6, 11 }, {  46, 105,  6, 11 }, {  46, 111,  6, 11 }, {  46, 111,  6, 11 },
+	{  46, 115,  6, 11 }, {  46, 115,  6, 11 }, {  46, 116,  6, 11 }, {  46, 116,  6, 11 },
+	{  46,  32,  6, 12 }, {  46,  37,  6, 12 }, {  46,  45,  6, 12 }, {  46,  46,  6, 12 },
+	{  46,  47,  6, 12 }, {  46,  51,  6, 12 }, {  46,  52,  6, 12 }, {  46,  53,  6, 12 },
+	{  46,  54,  6, 12 }, {  46,  55,  6, 12 }, {  46,  56,  6, 12 }, {  46,  57,  6, 12 },
+	{  46,  61,  6, 12 }, {  46,  65,  6, 12 }, {  46,  95,  6, 12 }, {  46,  98,  6, 12 },
+	{  46, 100,  6, 12 }, {  46, 102,  6, 12 }, {  46, 103,  6, 12 }, {  46, 104,  6, 12 },
+	{  46, 108,  6, 12 }, {  46, 109,  6, 12 }, {  46, 110,  6, 12 }, {  46, 112,  6, 12 },
+	{  46, 114,  6, 12 }, {  46, 117,  6, 12 }, {  46,   0,  6,  6 }, {  46,   0,  6,  6 },
+	{  46,   0,  6,  6 }, {  46,   0,  6,  6 }, {  46,   0,  6,  6 }, {  46,   0,  6,  6 },
+	{  46,   0,  6,  6 }, {  46,   0,  6,  6 }, {  46,   0,  6,  6 }, {  46,   0,  6,  6 },
+	{  46,   0,  6,  6 }, {  46,   0,  6,  6 }, {  46,   0,  6,  6 }, {  46,   0,  6,  6 },
+	{  46,   0,  6,  6 }, {  46,   0,  6,  6 }, {  46,   0,  6,  6 }, {  46,   0,  6,  6 },
+	{  47,  48,  6, 11 }, {  47,  48,  6, 11 }, {  47,  49,  6, 11 }, {  47,  49,  6, 11 },
+	{  47,  50,  6, 11 }, {  47,  50,  6, 11 }, {  47,  97,  6, 11 }, {  47,  97,  6, 11 },
+	{  47,  99,  6, 11 }, {  47,  99,  6, 11 }, {  47, 101,  6, 11 }, {  47, 101,  6, 11 },
+	{  47, 105,  6, 11 }, {  47, 105,  6, 11 }, {  47, 111,  6, 11 }, {  47, 111,  6, 11 },
+	{  47, 115,  6, 11 }, {  47, 115,  6, 11 }, {  47, 116,  6, 11 }, {  47, 116,  6, 11 },
+	{  47,  32,  6, 12 }, {  47,  37,  6, 12 }, {  47,  45,  6, 12 }, {  47,  46,  6, 12 },
+	{  47,  47,  6, 12 }, {  47,  51,  6, 12 }, {  47,  52,  6, 12 }, {  47,  53,  6, 12 },
+	{  47,  54,  6, 12 }, {  47,  55,  6, 12 }, {  47,  56,  6, 12 }, {  47,  57,  6, 12 },
+	{  47,  61,  6, 12 }, {  47,  65,  6, 12 }, {  47,  95,  6, 12 }, {  47,  98,  6, 12 },
+	{  47, 100,  6, 12 }, {  47, 102,  6, 12 }, {  47, 103,  6, 12 }, {  47, 104,  6, 12 },
+	{  47, 108,  6, 12 }, {  47, 109,  6, 12 }, {  47, 110,  6, 12 }, {  47, 112,  6, 12 },
+	{  47, 114,  6, 12 }, {  47, 117,  6, 12 }, {  47,   0,  6,  6 }, {  47,   0,  6,  6 },
+	{  47,   0,  6,  6 }, {  47,   0,  6,  6 }, {  47,   0,  6,  6 }, {  47,   0,  6,  6 },
+	{  47,   0,  6,  6 }, {  47,   0,  6,  6 }, {  47,   0,  6,  6 }, {  47,   0,  6,  6 },
+	{  47,   0,  6,  6 }, {  47,   0,  6,  6 }, {  47,   0,  6,  6 }, {  47,   0,  6,  6 },
+	{  47,   0,  6,  6 }, {  47,   0,  6,  6 }, {  47,   0,  6,  6 }, {  47,   0,  6,  6 },
+	{  51,  48,  6, 11 }, {  51,  48,  6, 11 }, {  51,  49,  6, 11 }, {  51,  49,  6, 11 },
+	{  51,  50,  6, 11 }, {  51,  50,  6, 11 }, {  51,  97,  6, 11 }, {  51,  97,  6, 11 },
+	{  51,  99,  6, 11 }, {  51,  99,  6, 11 }, {  51, 101,  6, 11 }, {  51, 101,  6, 11 },
+	{  51, 105,  6, 11 }, {  51, 105,  6, 11 }, {  51, 111,  6, 11 }, {  51, 111,  6, 11 },
+	{  51, 115,  6, 11 }, {  51, 115,  6, 11 }, {  51, 116,  6, 11 }, {  51, 116,  6, 11 },
+	{  51,  32,  6, 12 }, {  51,  37,  6, 12 }, {  51,  45,  6, 12 }, {  51,  46,  6, 12 },
+	{  51,  47,  6, 12 }, {  51,  51,  6, 12 }, {  51,  52,  6, 12 }, {  51,  53,  6, 12 },
+	{  51,  54,  6, 12 }, {  51,  55,  6, 12 }, {  51,  56,  6, 12 }, {  51,  57,  6, 12 },
+	{  51,  61,  6, 12 }, {  51,  65,  6, 12 }, {  51,  95,  6, 12 }, {  51,  98,  6, 12 },
+	{  51, 100,  6, 12 }, {  51, 102,  6, 12 }, {  51, 103,  6, 12 }, {  51, 104,  6, 12 },
+	{  51, 108,  6, 12 }, {  51, 109,  6, 12 }, {  51, 110,  6, 12 }, {  51, 112,  6, 12 },
+	{  51, 114,  6, 12 }, {  51, 117,  6, 12 }, {  51,   0,  6,  6 }, {  51,   0,  6,  6 },
+	{  51,   0,  6,  6 }, {  51,   0,  6,  6 }, {  51,   0,  6,  6 }, {  51,   0,  6,  6 },
+	{  51,   0,  6,  6 }, {  51,   0,  6,  6 }, {  51,   0,  6,  6 }, {  51,   0,  6,  6 },
+	{  51,   0,  6,  6 }, {  51,   0,  6,  6 }, {  51,   0,  6,  6 }, {  51,   0,  6,  6 },
+	{  51,   0,  6,  6 }, {  51,   0,  6,  6 }, {  51,   0,  6,  6 }, {  51,   0,  6,  6 },
+	{  52,  48,  6, 11 }, {  52,  48,  6, 11 }, {  52,  49,  6, 11 }, {  52,  49,  6, 11 },
+	{  52,  50,  6, 11 }, {  52,  50,  6, 11 }, {  52,  97,  6, 11 }, {  52,  97,  6, 11 },
+	{  52,  99,  6, 11 }, {  52,  99,  6, 11 }, {  52, 101,  6, 11 }, {  52, 101,  6, 11 },
+	{  52, 105,  6, 11 }, {  52, 105,  6, 11 }, {  52, 111,  6, 11 }, {  52, 111,  6, 11 },
+	{  52, 115,  6, 11 }, {  52, 115,  6, 11 }, {  52, 116,  6, 11 }, {  52, 116,  6, 11 },
+	{  52,  32,  6, 12 }, {  52,  37,  6, 12 }, {  52,  45,  6, 12 }, {  52,  46,  6, 12 },
+	{  52,  47,  6, 12 }, {  52,  51,  6, 12 }, {  52,  52,  6, 12 }, {  52,  53,  6, 12 },
+	{  52,  54,  6, 12 }, {  52,  55,  6, 12 }, {  52,  56,  6, 12 }, {  52,  57,  6, 12 },
+	{  52,  61,  6, 12 }, {  52,  65,  6, 12 }, {  52,  95,  6, 12 }, {  52,  98,  6, 12 },
+	{  52, 100,  6, 12 }, {  52, 102,  6, 12 }, {  52, 103,  6, 12 }, {  52, 104,  6, 12 },
+	{  52, 108,  6, 12 }, {  52, 109,  6, 12 }, {  52, 110,  6, 12 }, {  52, 112,  6, 12 },
+	{  52, 114,  6, 12 }, {  52, 117,  6, 12 }, {  52,   0,  6,  6 }, {  52,   0,  6,  6 },
+	{  52,   0,  6,  6 }, {  52,   0,  6,  6 }, {  52,   0,  6,  6 }, {  52,   0,  6,  6 },
+	{  52,   0,  6,  6 }, {  52,   0,  6,  6 }, {  52,   0,  6,  6 }, {  52,   0,  6,  6 },
+	{  52,   0,  6,  6 }, {  52,   0,  6,  6 }, {  52,   0,  6,  6 }, {  52,   0,  6,  6 },
+	{  52,   0,  6,  6 }, {  52,   0,  6,  6 }, {  52,   0,  6,  6 }, {  52,   0,  6,  6 },
+	{  53,  48,  6, 11 }, {  53,  48,  6, 11 }, {  53,  49,  6, 11 }, {  53,  49,  6, 11 },
+	{  53,  50,  6, 11 }, {  53,  50,  6, 11 }, {  53,  97,  6, 11 }, {  53,  97,  6, 11 },
+	{  53,  99,  6, 11 }, {  53,  99,  6, 11 }, {  53, 101,  6, 11 }, {  53, 101,  6, 11 },
+	{  53, 105,  6, 11 }, {  53, 105,  6, 11 }, {  53, 111,  6, 11 }, {  53, 111,  6, 11 },
+	{  53, 115,  6, 11 }, {  53, 115,  6, 11 }, {  53, 116,  6, 11 }, {  53, 116,  6, 11 },
+	{  53,  32,  6, 12 }, {  53,  37,  6, 12 }, {  53,  45,  6, 12 }, {  53,  46,  6, 12 },
+	{  53,  47,  6, 12 }, {  53,  51,  6, 12 }, {  53,  52,  6, 12 }, {  53,  53,  6, 12 },
+	{  53,  54,  6, 12 }, {  53,  55,  6, 12 }, {  53,  56,  6, 12 }, {  53,  57,  6, 12 },
+	{  53,  61,  6, 12 }, {  53,  65,  6, 12 }, {  53,  95,  6, 12 }, {  53,  98,  6, 12 },
+	{  53, 100,  6, 12 }, {  53, 102,  6, 12 }, {  53, 103,  6, 12 }, {  53, 104,  6, 12 },
+	{  53, 108,  6, 12 }, {  53, 109,  6, 12 }, {  53, 110,  6, 12 }, {  53, 112,  6, 12 },
+	{  53, 114,  6, 12 }, {  53, 117,  6, 12 }, {  53,   0,  6,  6 }, {  53,   0,  6,  6 },
+	{  53,   0,  6,  6 }, {  53,   0,  6,  6 }, {  53,   0,  6,  6 }, {  53,   0,  6,  6 },
+	{  53,   0,  6,  6 }, {  53,   0,  6,  6 }, {  53,   0,  6,  6 }, {  53,   0,  6,  6 },
+	{  53,   0,  6,  6 }, {  53,   0,  6,  6 }, {  53,   0,  6,  6 }, {  53,   0,  6,  6 },
+	{  53,   0,  6,  6 }, {  53,   0,  6,  6 }, {  53,   0,  6,  6 }, {  53,   0,  6,  6 },
+	{  54,  48,  6, 11 }, {  54,  48,  6, 11 }, {  54,  49,  6, 11 }, {  54,  49,  6, 11 },
+	{  54,  50,  6, 11 }, {  54,  50,  6, 11 }, {  54,  97,  6, 11 }, {  54,  97,  6, 11 },
+	{  54,  99,  6, 11 }, {  54,  99,  6, 11 }, {  54, 101,  6, 11 }, {  54, 101,  6, 11 },
+	{  54, 105,  6, 11 }, {  54, 105,  6, 11 }, {  54, 111,  6, 11 }, {  54, 111,  6, 11 },
+	{  54, 115,  6, 11 }, {  54, 115,  6, 11 }, {  54, 116,  6, 11 }, {  54, 116,  6, 11 },
+	{  54,  32,  6, 12 }, {  54,  37,  6, 12 }, {  54,  45,  6, 12 }, {  54,  46,  6, 12 },
+	{  54,  47,  6, 12 }, {  54,  51,  6, 12 }, {  54,  52,  6, 12 }, {  54,  53,  6, 12 },
+	{  54,  54,  6, 12 }, {  54,  55,  6, 12 }, {  54,  56,  6, 12 }, {  54,  57,  6, 12 },
+	{  54,  61,  6, 12 }, {  54,  65,  6, 12 }, {  54,  95,  6, 12 }, {  54,  98,  6, 12 },
+	{  54, 100,  6, 12 }, {  54, 102,  6, 12 }, {  54, 103,  6, 12 }, {  54, 104,  6, 12 },
+	{  54, 108,  6, 12 }, {  54, 109,  6, 12 }, {  54, 110,  6, 12 }, {  54, 112,  6, 12 },
+	{  54, 114,  6, 12 }, {  54, 117,  6, 12 }, {  54,   0,  6,  6 }, {  54,   0,  6,  6 },
+	{  54,   0,  6,  6 }, {  54,   0,  6,  6 }, {  54,   0,  6,  6 }, {  54,   0,  6,  6 },
+	{  54,   0,  6,  6 }, {  54,   0,  6,  6 }, {  54,   0,  6,  6 }, {  54,   0,  6,  6 },
+	{  54,   0,  6,  6 }, {  54,   0,  6,  6 }, {  54,   0,  6,  6 }, {  54,   0,  6,  6 },
+	{  54,   0,  6,  6 }, {  54,   0,  6,  6 }, {  54,   0,  6,  6 }, {  54,   0,  6,  6 },
+	{  55,  48,  6, 11 }, {  55,  48,  6, 11 }, {  55,  49,  6, 11 }, {  55,  49,  6, 11 },
+	{  55,  50,  6, 11 }, {  55,  50,  6, 11 }, {  55,  97,  6, 11 }, {  55,  97,  6, 11 },
+	{  55,  99,  6, 11 }, {  55,  99,  6, 11 }, {  55, 101,  6, 11 }, {  55, 101,  6, 11 },
+	{  55, 105,  6, 11 }, {  55, 105,  6, 11 }, {  55, 111,  6, 11 }, {  55, 111,  6, 11 },
+	{  55, 115,  6, 11 }, {  55, 115,  6, 11 }, {  55, 116,  6, 11 }, {  55, 116,  6, 11 },
+	{  55,  32,  6, 12 }, {  55,  37,  6, 12 }, {  55,  45,  6, 12 }, {  55,  46,  6, 12 },
+	{  55,  47,  6, 12 }, {  55,  51,  6, 12 }, {  55,  52,  6, 12 }, {  55,  53,  6, 12 },
+	{  55,  54,  6, 12 }, {  55,  55,  6, 12 }, {  55,  56,  6, 12 }, {  55,  57,  6, 12 },
+	{  55,  61,  6, 12 }, {  55,  65,  6, 12 }, {  55,  95,  6, 12 }, {  55,  98,  6, 12 },
+	{  55, 100,  6, 12 }, {  55, 102,  6, 12 }, {  55, 103,  6, 12 }, {  55, 104,  6, 12 },
+	{  55, 108,  6, 12 }, {  55, 109,  6, 12 }, {  55, 110,  6, 12 }, {  55, 112,  6, 12 },
+	{  55, 114,  6, 12 }, {  55, 117,  6, 12 }, {  55,   0,  6,  6 }, {  55,   0,  6,  6 },
+	{  55,   0,  6,  6 }, {  55,   0,  6,  6 }, {  55,   0,  6,  6 }, {  55,   0,  6,  6 },
+	{  55,   0,  6,  6 }, {  55,   0,  6,  6 }, {  55,   0,  6,  6 }, {  55,   0,  6,  6 },
+	{  55,   0,  6,  6 }, {  55,   0,  6,  6 }, {  55,   0,  6,  6 }, {  55,   0,  6,  6 },
+	{  55,   0,  6,  6 }, {  55,   0,  6,  6 }, {  55,   0,  6,  6 }, {  55,   0,  6,  6 },
+	{  56,  48,  6, 11 }, {  56,  48,  6, 11 }, {  56,  49,  6, 11 }, {  56,  49,  6, 11 },
+	{  56,  50,  6, 11 }, {  56,  50,  6, 11 }, {  56,  97,  6, 11 }, {  56,  97,  6, 11 },
+	{  56,  99,  6, 11 }, {  56,  99,  6, 11 }, {  56, 101,  6, 11 }, {  56, 101,  6, 11 },
+	{  56, 105,  6, 11 }, {  56, 105,  6, 11 }, {  56, 111,  6, 11 }, {  56, 111,  6, 11 },
+	{  56, 115,  6, 11 }, {  56, 115,  6, 11 }, {  56, 116,  6, 11 }, {  56, 116,  6, 11 },
+	{  56,  32,  6, 12 }, {  56,  37,  6, 12 }, {  56,  45,  6, 12 }, {  56,  46,  6, 12 },
+	{  56,  47,  6, 12 }, {  56,  51,  6, 12 }, {  56,  52,  6, 12 }, {  56,  53,  6, 12 },
+	{  56,  54,  6, 12 }, {  56,  55,  6, 12 }, {  56,  56,  6, 12 }, {  56,  57,  6, 12 },
+	{  56,  61,  6, 12 }, {  56,  65,  6, 12 }, {  56,  95,  6, 12 }, {  56,  98,  6, 12 },
+	{  56, 100,  6, 12 }, {  56, 102,  6, 12 }, {  56, 103,  6, 12 }, {  56, 104,  6, 12 },
+	{  56, 108,  6, 12 }, {  56, 109,  6, 12 }, {  56, 110,  6, 12 }, {  56, 112,  6, 12 },
+	{  56, 114,  6, 12 }, {  56, 117,  6, 12 }, {  56,   0,  6,  6 }, {  56,   0,  6,  6 },
+	{  56,   0,  6,  6 }, {  56,   0,  6,  6 }, {  56,   0,  6,  6 }, {  56,   0,  6,  6 },
+	{  56,   0,  6,  6 }, {  56,   0,  6,  6 }, {  56,   0,  6,  6 }, {  56,   0,  6,  6 },
+	{  56,   0,  6,  6 }, {  56,   0,  6,  6 }, {  56,   0,  6,  6 }, {  56,   0,  6,  6 },
+	{  56,   0,  6,  6 }, {  56,   0,  6,  6 }, {  56,   0,  6,  6 }, {  56,   0,  6,  6 },
+	{  57,  48,  6, 11 }, {  57,  48,  6, 11 }, {  57,  49,  6, 11 }, {  57,  49,  6, 11 },
+	{  57,  50,  6, 11 }, {  57,  50,  6, 11 }, {  57,  97,  6, 11 }, {  57,  97,  6, 11 },
+	{  57,  99,  6, 11 }, {  57,  99,  6, 11 }, {  57, 101,  6, 11 }, {  57, 101,  6, 11 },
+	{  57, 105,  6, 11 }, {  57, 105,  6, 11 }, {  57, 111,  6, 11 }, {  57, 111,  6, 11 },
+	{  57, 115,  6, 11 }, {  57, 115,  6, 11 }, {  57, 116,  6, 11 }, {  57, 116,  6, 11 },
+	{  57,  32,  6, 12 }, {  57,  37,  6, 12 }, {  57,  45,  6, 12 }, {  57,  46,  6, 12 },
+	{  57,  47,  6, 12 }, {  57,  51,  6, 12 }, {  57,  52,  6, 12 }, {  57,  53,  6, 12 },
+	{  57,  54,  6, 12 }, {  57,  55,  6, 12 }, {  57,  56,  6, 12 }, {  57,  57,  6, 12 },
+	{  57,  61,  6, 12 }, {  57,  65,  6, 12 }, {  57,  95,  6, 12 }, {  57,  98,  6, 12 },
+	{  57, 100,  6, 12 }, {  57, 102,  6, 12 }, {  57, 103,  6, 12 }, {  57, 104,  6, 12 },
+	{  57, 108,  6, 12 }, {  57, 109,  6, 12 }, {  57, 110,  6, 12 }, {  57, 112,  6, 12 },
+	{  57, 114,  6, 12 }, {  57, 117,  6, 12 }, {  57,   0,  6,  6 }, {  57,   0,  6,  6 },
+	{  57,   0,  6,  6 }, {  57,   0,  6,  6 }, {  57,   0,  6,  6 }, {  57,   0,  6,  6 },
+	{  57,   0,  6,  6 }, {  57,   0,  6,  6 }, {  57,   0,  6,  6 }, {  57,   0,  6,  6 },
+	{  57,   0,  6,  6 }, {  57,   0,  6,  6 }, {  57,   0,  6,  6 }, {  57,   0,  6,  6 },
+	{  57,   0,  6,  6 }, {  57,   0,  6,  6 }, {  57,   0,  6,  6 }, {  57,   0,  6,  6 },
+	{  61,  48,  6, 11 }, {  61,  48,  6, 11 }, {  61,  49,  6, 11 }, {  61,  49,  6, 11 },
+	{  61,  50,  6, 11 }, {  61,  50,  6, 11 }, {  61,  97,  6, 11 }, {  61,  97,  6, 11 },
+	{  61,  99,  6, 11 }, {  61,  99,  6, 11 }, {  61, 101,  6, 11 }, {  61, 101,  6, 11 },
+	{  61, 105,  6, 11 }, {  61, 105,  6, 11 }, {  61, 111,  6, 11 }, {  61, 111,  6, 11 },
+	{  61, 115,  6, 11 }, {  61, 115,  6, 11 }, {  61, 116,  6, 11 }, {  61, 116,  6, 11 },
+	{  61,  32,  6, 12 }, {  61,  37,  6, 12 }, {  61,  45,  6, 12 }, {  61,  46,  6, 12 },
+	{  61,  47,  6, 12 }, {  61,  51,  6, 12 }, {  61,  52,  6, 12 }, {  61,  53,  6, 12 },
+	{  61,  54,  6, 12 }, {  61,  55,  6, 12 }, {  61,  56,  6, 12 }, {  61,  57,  6, 12 },
+	{  61,  61,  6, 12 }, {  61,  65,  6, 12 }, {  61,  95,  6, 12 }, {  61,  98,  6, 12 },
+	{  61, 100,  6, 12 }, {  61, 102,  6, 12 }, {  61, 103,  6, 12 }, {  61, 104,  6, 12 },
+	{  61, 108,  6, 12 }, {  61, 109,  6, 12 }, {  61, 110,  6, 12 }, {  61, 112,  6, 12 },
+	{  61, 114,  6, 12 }, {  61, 117,  6, 12 }, {  61,   0,  6,  6 }, {  61,   0,  6,  6 },
+	{  61,   0,  6,  6 }, {  61,   0,  6,  6 }, {  61,   0,  6,  6 }, {  61,   0,  6,  6 },
+	{  61,   0,  6,  6 }, {  61,   0,  6,  6 }, {  61,   0,  6,  6 }, {  61,   0,  6,  6 },
+	{  61,   0,  6,  6 }, {  61,   0,  6,  6 }, {  61,   0,  6,  6 }, {  61,   0,  6,  6 },
+	{  61,   0,  6,  6 }, {  61,   0,  6,  6 }, {  61,   0,  6,  6 }, {  61,   0,  6,  6 },
+	{  65,  48,  6, 11 }, {  65,  48,  6, 11 }, {  65,  49,  6, 11 }, {  65,  49,  6, 11 },
+	{  65,  50,  6, 11 }, {  65,  50,  6, 11 }, {  65,  97,  6, 11 }, {  65,  97,  6, 11 },
+	{  65,  99,  6, 11 }, {  65,  99,  6, 11 }, {  65, 101,  6, 11 }, {  65, 101,  6, 11 },
+	{  65, 105,  6, 11 }, {  65, 105,  6, 11 }, {  65, 111,  6, 11 }, {  65, 111,  6, 11 },
+	{  65, 115,  6, 11 }, {  65, 115,  6, 11 }, {  65, 116,  6, 11 }, {  65, 116,  6, 11 },
+	{  65,  32,  6, 12 }, {  65,  37,  6, 12 }, {  65,  45,  6, 12 }, {  65,  46,  6, 12 },
+	{  65,  47,  6, 12 }, {  65,  51,  6, 12 }, {  65,  52,  6, 12 }, {  65,  53,  6, 12 },
+	{  65,  54,  6, 12 }, {  65,  55,  6, 12 }, {  65,  56,  6, 12 }, {  65,  57,  6, 12 },
+	{  65,  61,  6, 12 }, {  65,  65,  6, 12 }, {  65,  95,  6, 12 }, {  65,  98,  6, 12 },
+	{  65, 100,  6, 12 }, {  65, 102,  6, 12 }, {  65, 103,  6, 12 }, {  65, 104,  6, 12 },
+	{  65, 108,  6, 12 }, {  65, 109,  6, 12 }, {  65, 110,  6, 12 }, {  65, 112,  6, 12 },
+	{  65, 114,  6, 12 }, {  65, 117,  6, 12 }, {  65,   0,  6,  6 }, {  65,   0,  6,  6 },
+	{  65,   0,  6,  6 }, {  65,   0,  6,  6 }, {  65,   0,  6,  6 }, {  65,   0,  6,  6 },
+	{  65,   0,  6,  6 }, {  65,   0,  6,  6 }, {  65,   0,  6,  6 }, {  65,   0,  6,  6 },
+	{  65,   0,  6,  6 }, {  65,   0,  6,  6 }, {  65,   0,  6,  6 }, {  65,   0,  6,  6 },
+	{  65,   0,  6,  6 }, {  65,   0,  6,  6 }, {  65,   0,  6,  6 }, {  65,   0,  6,  6 },
+	{  95,  48,  6, 11 }, {  95,  48,  6, 11 }, {  95,  49,  6, 11 }, {  95,  49,  6, 11 },
+	{  95,  50,  6, 11 }, {  95,  50,  6, 11 }, {  95,  97,  6, 11 }, {  95,  97,  6, 11 },
+	{  95,  99,  6, 11 }, {  95,  99,  6, 11 }, {  95, 101,  6, 11 }, {  95, 101,  6, 11 },
+	{  95, 105,  6, 11 }, {  95, 105,  6, 11 }, {  95, 111,  6, 11 }, {  95, 111,  6, 11 },
+	{  95, 115,  6, 11 }, {  95, 115,  6, 11 }, {  95, 116,  6, 11 }, {  95, 116,  6, 11 },
+	{  95,  32,  6, 12 }, {  95,  37,  6, 12 }, {  95,  45,  6, 12 }, {  95,  46,  6, 12 },
+	{  95,  47,  6, 12 }, {  95,  51,  6, 12 }, {  95,  52,  6, 12 }, {  95,  53,  6, 12 },
+	{  95,  54,  6, 12 }, {  95,  55,  6, 12 }, {  95,  56,  6, 12 }, {  95,  57,  6, 12 },
+	{  95,  61,  6, 12 }, {  95,  65,  6, 12 }, {  95,  95,  6, 12 }, {  95,  98,  6, 12 },
+	{  95, 100,  6, 12 }, {  95, 102,  6, 12 }, {  95, 103,  6, 12 }, {  95, 104,  6, 12 },
+	{  95, 108,  6, 12 }, {  95, 109,  6, 12 }, {  95, 110,  6, 12 }, {  95, 112,  6, 12 },
+	{  95, 114,  6, 12 }, {  95, 117,  6, 12 }, {  95,   0,  6,  6 }, {  95,   0,  6,  6 },
+	{  95,   0,  6,  6 }, {  95,   0,  6,  6 }, {  95,   0,  6,  6 }, {  95,   0,  6,  6 },
+	{  95,   0,  6,  6 }, {  95,   0,  6,  6 }, {  95,   0,  6,  6 }, {  95,   0,  6,  6 },
+	{  95,   0,  6,  6 }, {  95,   0,  6,  6 }, {  95,   0,  6,  6 }, {  95,   0,  6,  6 },
+	{  95,   0,  6,  6 }, {  95,   0,  6,  6 }, {  95,   0,  6,  6 }, {  95,   0,  6,  6 },
+	{  98,  48,  6, 11 }, {  98,  48,  6, 11 }, {  98,  49,  6, 11 }, {  98,  49,  6, 11 },
+	{  98,  50,  6, 11 }, {  98,  50,  6, 11 }, {  98,  97,  6, 11 }, {  98,  97,  6, 11 },
+	{  98,  99,  6, 11 }, {  98,  99,  6, 11 }, {  98, 101,  6, 11 }, {  98, 101,  6, 11 },
+	{  98, 105,  6, 11 }, {  98, 105,  6, 11 }, {  98, 111,  6, 11 }, {  98, 111,  6, 11 },
+	{  98, 115,  6, 11 }, {  98, 115,  6, 11 }, {  98, 116,  6, 11 }, {  98, 116,  6, 11 },
+	{  98,  32,  6, 12 }, {  98,  37,  6, 12 }, {  98,  45,  6, 12 }, {  98,  46,  6, 12 },
+	{  98,  47,  6, 12 }, {  98,  51,  6, 12 }, {  98,  52,  6, 12 }, {  98,  53,  6, 12 },
+	{  98,  54,  6, 12 }, {  98,  55,  6, 12 }, {  98,  56,  6, 12 }, {  98,  57,  6, 12 },
+	{  98,  61,  6, 12 }, {  98,  65,  6, 12 }, {  98,  95,  6, 12 }, {  98,  98,  6, 12 },
+	{  98, 100,  6, 12 }, {  98, 102,  6, 12 }, {  98, 103,  6, 12 }, {  98, 104,  6, 12 },
+	{  98, 108,  6, 12 }, {  98, 109,  6, 12 }, {  98, 110,  6, 12 }, {  98, 112,  6, 12 },
+	{  98, 114,  6, 12 }, {  98, 117,  6, 12 }, {  98,   0,  6,  6 }, {  98,   0,  6,  6 },
+	{  98,   0,  6,  6 }, {  98,   0,  6,  6 }, {  98,   0,  6,  6 }, {  98,   0,  6,  6 },
+	{  98,   0,  6,  6 }, {  98,   0,  6,  6 }, {  98,   0,  6,  6 }, {  98,   0,  6,  6 },
+	{  98,   0,  6,  6 }, {  98,   0,  6,  6 }, {  98,   0,  6,  6 }, {  98,   0,  6,  6 },
+	{  98,   0,  6,  6 }, {  98,   0,  6,  6 }, {  98,   0,  6,  6 }, {  98,   0,  6,  6 },
+	{ 100,  48,  6, 11 }, { 100,  48,  6, 11 }, { 100,  49,  6, 11 }, { 100,  49,  6, 11 },
+	{ 100,  50,  6, 11 }, { 100,  50,  6, 11 }, { 100,  97,  6, 11 }, { 100,  97,  6, 11 },
+	{ 100,  99,  6, 11 }, { 100,  99,  6, 11 }, { 100, 101,  6, 11 }, { 100, 101,  6, 11 },
+	{ 100, 105,  6, 11 }, { 100, 105,  6, 11 }, { 100, 111,  6, 11 }, { 100, 111,  6, 11 },
+	{ 100, 115,  6, 11 }, { 100, 115,  6, 11 }, { 100, 116,  6, 11 }, { 100, 116,  6, 11 },
+	{ 100,  32,  6, 12 }, { 100,  37,  6, 12 }, { 100,  45,  6, 12 }, { 100,  46,  6, 12 },
+	{ 100,  47,  6, 12 }, { 100,  51,  6, 12 }, { 100,  52,  6, 12 }, { 100,  53,  6, 12 },
+	{ 100,  54,  6, 12 }, { 100,  55,  6, 12 }, { 100,  56,  6, 12 }, { 100,  57,  6, 12 },
+	{ 100,  61,  6, 12 }, { 100,  65,  6, 12 }, { 100,  95,  6, 12 }, { 100,  98,  6, 12 },
+	{ 100, 100,  6, 12 }, { 100, 102,  6, 12 }, { 100, 103,  6, 12 }, { 100, 104,  6, 12 },
+	{ 100, 108,  6, 12 }, { 100, 109,  6, 12 }, { 100, 110,  6, 12 }, { 100, 112,  6, 12 },
+	{ 100, 114,  6, 12 }, { 100, 117,  6, 12 }, { 100,   0,  6,  6 }, { 100,   0,  6,  6 },
+	{ 100,   0,  6,  6 }, { 100,   0,  6,  6 }, { 100,   0,  6,  6 }, { 100,   0,  6,  6 },
+	{ 100,   0,  6,  6 }, { 100,   0,  6,  6 }, { 100,   0,  6,  6 }, { 100,   0,  6,  6 },
+	{ 100,   0,  6,  6 }, { 100,   0,  6,  6 }, { 100,   0,  6,  6 }, { 100,   0,  6,  6 },
+	{ 100,   0,  6,  6 }, { 100,   0,  6,  6 }, { 100,   0,  6,  6 }, { 100,   0,  6,  6 },
+	{ 102,  48,  6, 11 }, { 102,  48,  6, 11 }, { 102,  49,  6, 11 }, { 102,  49,  6, 11 },
+	{ 102,  50,  6, 11 }, { 102,  50,  6, 11 }, { 102,  97,  6, 11 }, { 102,  97,  6, 11 },
+	{ 102,  99,  6, 11 }, { 102,  99,  6, 11 }, { 102, 101,  6, 11 }, { 102, 101,  6, 11 },
+	{ 102, 105,  6, 11 }, { 102, 105,  6, 11 }, { 102, 111,  6, 11 }, { 102, 111,  6, 11 },
+	{ 102, 115,  6, 11 }, { 102, 115,  6, 11 }, { 102, 116,  6, 11 }, { 102, 116,  6, 11 },
+	{ 102,  32,  6, 12 }, { 102,  37,  6, 12 }, { 102,  45,  6, 12 }, { 102,  46,  6, 12 },
+	{ 102,  47,  6, 12 }, { 102,  51,  6, 12 }, { 102,  52,  6, 12 }, { 102,  53,  6, 12 },
+	{ 102,  54,  6, 12 }, { 102,  55,  6, 12 }, { 102,  56,  6, 12 }, { 102,  57,  6, 12 },
+	{ 102,  61,  6, 12 }, { 102,  65,  6, 12 }, { 102,  95,  6, 12 }, { 102,  98,  6, 12 },
+	{ 102, 100,  6, 12 }, { 102, 102,  6, 12 }, { 102, 103,  6, 12 }, { 102, 104,  6, 12 },
+	{ 102, 108,  6, 12 }, { 102, 109,  6, 12 }, { 102, 110,  6, 12 }, { 102, 112,  6, 12 },
+	{ 102, 114,  6, 12 }, { 102, 117,  6, 12 }, { 102,   0,  6,  6 }, { 102,   0,  6,  6 },
+	{ 102,   0,  6,  6 }, { 102,   0,  6,  6 }, { 102,   0,  6,  6 }, { 102,   0,  6,  6 },
+	{ 102,   0,  6,  6 }, { 102,   0,  6,  6 }, { 102,   0,  6,  6 }, { 102,   0,  6,  6 },
+	{ 102,   0,  6,  6 }, { 102,   0,  6,  6 }, { 102,   0,  6,  6 }, { 102,   0,  6,  6 },
+	{ 102,   0,  6,  6 }, { 102,   0,  6,  6 }, { 102,   0,  6,  6 }, { 102,   0,  6,  6 },
+	{ 103,  48,  6, 11 }, { 103,  48,  6, 11 }, { 103,  49,  6, 11 }, { 103,  49,  6, 11 },
+	{ 103,  50,  6, 11 }, { 103,  50,  6, 11 }, { 103,  97,  6, 11 }, { 103,  97,  6, 11 },
+	{ 103,  99,  6, 11 }, { 103,  99,  6, 11 }, { 103, 101,  6, 11 }, { 103, 101,  6, 11 },
+	{ 103, 105,  6, 11 }, { 103, 105,  6, 11 }, { 103, 111,  6, 11 }, { 103, 111,  6, 11 },
+	{ 103, 115,  6, 11 }, { 103, 115,  6, 11 }, { 103, 116,  6, 11 }, { 103, 116,  6, 11 },
+	{ 103,  32,  6, 12 }, { 103,  37,  6, 12 }, { 103,  45,  6, 12 }, { 103,  46,  6, 12 },
+	{ 103,  47,  6, 12 }, { 103,  51,  6, 12 }, { 103,  52,  6, 12 }, { 103,  53,  6, 12 },
+	{ 103,  54,  6, 12 }, { 103,  55,  6, 12 }, { 103,  56,  6, 12 }, { 103,  57,  6, 12 },
+	{ 103,  61,  6, 12 }, { 103,  65,  6, 12 }, { 103,  95,  6, 12 }, { 103,  98,  6, 12 },
+	{ 103, 100,  6, 12 }, { 103, 102,  6, 12 }, { 103, 103,  6, 12 }, { 103, 104,  6, 12 },
+	{ 103, 108,  6, 12 }, { 103, 109,  6, 12 }, { 103, 110,  6, 12 }, { 103, 112,  6, 12 },
+	{ 103, 114,  6, 12 }, { 103, 117,  6, 12 }, { 103,   0,  6,  6 }, { 103,   0,  6,  6 },
+	{ 103,   0,  6,  6 }, { 103,   0,  6,  6 }, { 103,   0,  6,  6 }, { 103,   0,  6,  6 },
+	{ 103,   0,  6,  6 }, { 103,   0,  6,  6 }, { 103,   0,  6,  6 }, { 103,   0,  6,  6 },
+	{ 103,   0,  6,  6 }, { 103,   0,  6,  6 }, { 103,   0,  6,  6 }, { 103,   0,  6,  6 },
+	{ 103,   0,  6,  6 }, { 103,   0,  6,  6 }, { 103,   0,  6,  6 }, { 103,   0,  6,  6 },
+	{ 104,  48,  6, 11 }, { 104,  48,  6, 11 }, { 104,  49,  6, 11 }, { 104,  49,  6, 11 },
+	{ 104,  50,  6, 11 }, { 104,  50,  6, 11 }, { 104,  97,  6, 11 }, { 104,  97,  6, 11 },
+	{ 104,  99,  6, 11 }, { 104,  99,  6, 11 }, { 104, 101,  6, 11 }, { 104, 101,  6, 11 },
+	{ 104, 105,  6, 11 }, { 104, 105,  6, 11 }, { 104, 111,  6, 11 }, { 104, 111,  6, 11 },
+	{ 104, 115,  6, 11 }, { 104, 115,  6, 11 }, { 104, 116,  6, 11 }, { 104, 116,  6, 11 },
+	{ 104,  32,  6, 12 }, { 104,  37,  6, 12 }, { 104,  45,  6, 12 }, { 104,  46,  6, 12 },
+	{ 104,  47,  6, 12 }, { 104,  51,  6, 12 }, { 104,  52,  6, 12 }, { 104,  53,  6, 12 },
+	{ 104,  54,  6, 12 }, { 104,  55,  6, 12 }, { 104,  56,  6, 12 }, { 104,  57,  6, 12 },
+	{ 104,  61,  6, 12 }, { 104,  65,  6, 12 }, { 104,  95,  6, 12 }, { 104,  98,  6, 12 },
+	{ 104, 100,  6, 12 }, { 104, 102,  6, 12 }, { 104, 103,  6, 12 }, { 104, 104,  6, 12 },
+	{ 104, 108,  6, 12 }, { 104, 109,  6, 12 }, { 104, 110,  6, 12 }, { 104, 112,  6, 12 },
+	{ 104, 114,  6, 12 }, { 104, 117,  6, 12 }, { 104,   0,  6,  6 }, { 104,   0,  6,  6 },
+	{ 104,   0,  6,  6 }, { 104,   0,  6,  6 }, { 104,   0,  6,  6 }, { 104,   0,  6,  6 },
+	{ 104,   0,  6,  6 }, { 104,   0,  6,  6 }, { 104,   0,  6,  6 }, { 104,   0,  6,  6 },
+	{ 104,   0,  6,  6 }, { 104,   0,  6,  6 }, { 104,   0,  6,  6 }, { 104,   0,  6,  6 },
+	{ 104,   0,  6,  6 }, { 104,   0,  6,  6 }, { 104,   0,  6,  6 }, { 104,   0,  6,  6 },
+	{ 108,  48,  6, 11 }, { 108,  48,  6, 11 }, { 108,  49,  6, 11 }, { 108,  49,  6, 11 },
+	{ 108,  50,  6, 11 }, { 108,  50,  6, 11 }, { 108,  97,  6, 11 }, { 108,  97,  6, 11 },
+	{ 108,  99,  6, 11 }, { 108,  99,  6, 11 }, { 108, 101,  6, 11 }, { 108, 101,  6, 11 },
+	{ 108, 105,  6, 11 }, { 108, 105,  6, 11 }, { 108, 111,  6, 11 }, { 108, 111,  6, 11 },
+	{ 108, 115,  6, 11 }, { 108, 115,  6, 11 }, { 108, 116,  6, 11 }, { 108, 116,  6, 11 },
+	{ 108,  32,  6, 12 }, { 108,  37,  6, 12 }, { 108,  45,  6, 12 }, { 108,  46,  6, 12 },
+	{ 108,  47,  6, 12 }, { 108,  51,  6, 12 }, { 108,  52,  6, 12 }, { 108,  53,  6, 12 },
+	{ 108,  54,  6, 12 }, { 108,  55,  6, 12 }, { 108,  56,  6, 12 }, { 108,  57,  6, 12 },
+	{ 108,  61,  6, 12 }, { 108,  65,  6, 12 }, { 108,  95,  6, 12 }, { 108,  98,  6, 12 },
+	{ 108, 100,  6, 12 }, { 108, 102,  6, 12 }, { 108, 103,  6, 12 }, { 108, 104,  6, 12 },
+	{ 108, 108,  6, 12 }, { 108, 109,  6, 12 }, { 108, 110,  6, 12 }, { 108, 112,  6, 12 },
+	{ 108, 114,  6, 12 }, { 108, 117,  6, 12 }, { 108,   0,  6,  6 }, { 108,   0,  6,  6 },
+	{ 108,   0,  6,  6 }, { 108,   0,  6,  6 }, { 108,   0,  6,  6 }, { 108,   0,  6,  6 },
+	{ 108,   0,  6,  6 }, { 108,   0,  6,  6 }, { 108,   0,  6,  6 }, { 108,   0,  6,  6 },
+	{ 108,   0,  6,  6 }, { 108,   0,  6,  6 }, { 108,   0,  6,  6 }, { 108,   0,  6,  6 },
+	{ 108,   0,  6,  6 }, { 108,   0,  6,  6 }, { 108,   0,  6,  6 }, { 108,   0,  6,  6 },
+	{ 109,  48,  6, 11 }, { 109,  48,  6, 11 }, { 109,  49,  6, 11 }, { 109,  49,  6, 11 },
+	{ 109,  50,  6, 11 }, { 109,  50,  6, 11 }, { 109,  97,  6, 11 }, { 109,  97,  6, 11 },
+	{ 109,  99,  6, 11 }, { 109,  99,  6, 11 }, { 109, 101,  6, 11 }, { 109, 101,  6, 11 },
+	{ 109, 105,  6, 11 }, { 109, 105,  6, 11 }, { 109, 111,  6, 11 }, { 109, 111,  6, 11 },
+	{ 109, 115,  6, 11 }, { 109, 115,  6, 11 }, { 109, 116,  6, 11 }, { 109, 116,  6, 11 },
+	{ 109,  32,  6, 12 }, { 109,  37,  6, 12 }, { 109,  45,  6, 12 }, { 109,  46,  6, 12 },
+	{ 109,  47,  6, 12 }, { 109,  51,  6, 12 }, { 109,  52,  6, 12 }, { 109,  53,  6, 12 },
+	{ 109,  54,  6, 12 }, { 109,  55,  6, 12 }, { 109,  56,  6, 12 }, { 109,  57,  6, 12 },
+	{ 109,  61,  6, 12 }, { 109,  65,  6, 12 }, { 109,  95,  6, 12 }, { 109,  98,  6, 12 },
+	{ 109, 100,  6, 12 }, { 109, 102,  6, 12 }, { 109, 103,  6, 12 }, { 109, 104,  6, 12 },
+	{ 109, 108,  6, 12 }, { 109, 109,  6, 12 }, { 109, 110,  6, 12 }, { 109, 112,  6, 12 },
+	{ 109, 114,  6, 12 }, { 109, 117,  6, 12 }, { 109,   0,  6,  6 }, { 109,   0,  6,  6 },
+	{ 109,   0,  6,  6 }, { 109,   0,  6,  6 }, { 109,   0,  6,  6 }, { 109,   0,  6,  6 },
+	{ 109,   0,  6,  6 }, { 109,   0,  6,  6 }, { 109,   0,  6,  6 }, { 109,   0,  6,  6 },
+	{ 109,   0,  6,  6 }, { 109,   0,  6,  6 }, { 109,   0,  6,  6 }, { 109,   0,  6,  6 },
+	{ 109,   0,  6,  6 }, { 109,   0,  6,  6 }, { 109,   0,  6,  6 }, { 109,   0,  6,  6 },
+	{ 110,  48,  6, 11 }, { 110,  48,  6, 11 }, { 110,  49,  6, 11 }, { 110,  49,  6, 11 },
+	{ 110,  50,  6, 11 }, { 110,  50,  6, 11 }, { 110,  97,  6, 11 }, { 110,  97,  6, 11 },
+	{ 110,  99,  6, 11 }, { 110,  99,  6, 11 }, { 110, 101,  6, 11 }, { 110, 101,  6, 11 },
+	{ 110, 105,  6, 11 }, { 110, 105,  6, 11 }, { 110, 111,  6, 11 }, { 110, 111,  6, 11 },
+	{ 110, 115,  6, 11 }, { 110, 115,  6, 11 }, { 110, 116,  6, 11 }, { 110, 116,  6, 11 },
+	{ 110,  32,  6, 12 }, { 110,  37,  6, 12 }, { 110,  45,  6, 12 }, { 110,  46,  6, 12 },
+	{ 110,  47,  6, 12 }, { 110,  51,  6, 12 }, { 110,  52,  6, 12 }, { 110,  53,  6, 12 },
+	{ 110,  54,  6, 12 }, { 110,  55,  6, 12 }, { 110,  56,  6, 12 }, { 110,  57,  6, 12 },
+	{ 110,  61,  6, 12 }, { 110,  65,  6, 12 }, { 110,  95,  6, 12 }, { 110,  98,  6, 12 },
+	{ 110, 100,  6, 12 }, { 110, 102,  6, 12 }, { 110, 103,  6, 12 }, { 110, 104,  6, 12 },
+	{ 110, 108,  6, 12 }, { 110, 109,  6, 12 }, { 110, 110,  6, 12 }, { 110, 112,  6, 12 },
+	{ 110, 114,  6, 12 }, { 110, 117,  6, 12 }, { 110,   0,  6,  6 }, { 110,   0,  6,  6 },
+	{ 110,   0,  6,  6 }, { 110,   0,  6,  6 }, { 110,   0,  6,  6 }, { 110,   0,  6,  6 },
+	{ 110,   0,  6,  6 }, { 110,   0,  6,  6 }, { 110,   0,  6,  6 }, { 110,   0,  6,  6 },
+	{ 110,   0,  6,  6 }, { 110,   0,  6,  6 }, { 110,   0,  6,  6 }, { 110,   0,  6,  6 },
+	{ 110,   0,  6,  6 }, { 110,   0,  6,  6 }, { 110,   0,  6,  6 }, { 110,   0,  6,  6 },
+	{ 112,  48,  6, 11 }, { 112,  48,  6, 11 }, { 112,  49,  6, 11 }, { 112,  49,  6, 11 },
+	{ 112,  50,  6, 11 }, { 112,  50,  6, 11 }, { 112,  97,  6, 11 }, { 112,  97,  6, 11 },
+	{ 112,  99,  6, 11 }, { 112,  99,  6, 11 }, { 112, 101,  6, 11 }, { 112, 101,  6, 11 },
+	{ 112, 105,  6, 11 }, { 112, 105,  6, 11 }, { 112, 111,  6, 11 }, { 112, 111,  6, 11 },
+	{ 112, 115,  6, 11 }, { 112, 115,  6, 11 }, { 112, 116,  6, 11 }, { 112, 116,  6, 11 },
+	{ 112,  32,  6, 12 }, { 112,  37,  6, 12 }, { 112,  45,  6, 12 }, { 112,  46,  6, 12 },
+	{ 112,  47,  6, 12 }, { 112,  51,  6, 12 }, { 112,  52,  6, 12 }, { 112,  53,  6, 12 },
+	{ 112,  54,  6, 12 }, { 112,  55,  6, 12 }, { 112,  56,  6, 12 }, { 112,  57,  6, 12 },
+	{ 112,  61,  6, 12 }, { 112,  65,  6, 12 }, { 112,  95,  6, 12 }, { 112,  98,  6, 12 },
+	{ 112, 100,  6, 12 }, { 112, 102,  6, 12 }, { 112, 103,  6, 12 }, { 112, 104,  6, 12 },
+	{ 112, 108,  6, 12 }, { 112, 109,  6, 12 }, { 112, 110,  6, 12 }, { 112, 112,  6, 12 },
+	{ 112, 114,  6, 12 }, { 112, 117,  6, 12 }, { 112,   0,  6,  6 }, { 112,   0,  6,  6 },
+	{ 112,   0,  6,  6 }, { 112,   0,  6,  6 }, { 112,   0,  6,  6 }, { 112,   0,  6,  6 },
+	{ 112,   0,  6,  6 }, { 112,   0,  6,  6 }, { 112,   0,  6,  6 }, { 112,   0,  6,  6 },
+	{ 112,   0,  6,  6 }, { 112,   0,  6,  6 }, { 112,   0,  6,  6 }, { 112,   0,  6,  6 },
+	{ 112,   0,  6,  6 }, { 112,   0,  6,  6 }, { 112,   0,  6,  6 }, { 112,   0,  6,  6 },
+	{ 114,  48,  6, 11 }, { 114,  48,  6, 11 }, { 114,  49,  6, 11 }, { 114,  49,  6, 11 },
+	{ 114,  50,  6, 11 }, { 114,  50,  6, 11 }, { 114,  97,  6, 11 }, { 114,  97,  6, 11 },
+	{ 114,  99,  6, 11 }, { 114,  99,  6, 11 }, { 114, 101,  6, 11 }, { 114, 101,  6, 11 },
+	{ 114, 105,  6, 11 }, { 114, 105,  6, 11 }, { 114, 111,  6, 11 }, { 114, 111,  6, 11 },
+	{ 114, 115,  6, 11 }, { 114, 115,  6, 11 }, { 114, 116,  6, 11 }, { 114, 116,  6, 11 },
+	{ 114,  32,  6, 12 }, { 114,  37,  6, 12 }, { 114,  45,  6, 12 }, { 114,  46,  6, 12 },
+	{ 114,  47,  6, 12 }, { 114,  51,  6, 12 }, { 114,  52,  6, 12 }, { 114,  53,  6, 12 },
+	{ 114,  54,  6, 12 }, { 114,  55,  6, 12 }, { 114,  56,  6, 12 }, { 114,  57,  6, 12 },
+	{ 114,  61,  6, 12 }, { 114,  65,  6, 12 }, { 114,  95,  6, 12 }, { 114,  98,  6, 12 },
+	{ 114, 100,  6, 12 }, { 114, 102,  6, 12 }, { 114, 103,  6, 12 }, { 114, 104,  6, 12 },
+	{ 114, 108,  6, 12 }, { 114, 109,  6, 12 }, { 114, 110,  6, 12 }, { 114, 112,  6, 12 },
+	{ 114, 114,  6, 12 }, { 114, 117,  6, 12 }, { 114,   0,  6,  6 }, { 114,   0,  6,  6 },
+	{ 114,   0,  6,  6 }, { 114,   0,  6,  6 }, { 114,   0,  6,  6 }, { 114,   0,  6,  6 },
+	{ 114,   0,  6,  6 }, { 114,   0,  6,  6 }, { 114,   0,  6,  6 }, { 114,   0,  6,  6 },
+	{ 114,   0,  6,  6 }, { 114,   0,  6,  6 }, { 114,   0,  6,  6 }, { 114,   0,  6,  6 },
+	{ 114,   0,  6,  6 }, { 114,   0,  6,  6 }, { 114,   0,  6,  6 }, { 114,   0,  6,  6 },
+	{ 117,  48,  6, 11 }, { 117,  48,  6, 11 }, { 117,  49,  6, 11 }, { 117,  49,  6, 11 },
+	{ 117,  50,  6, 11 }, { 117,  50,  6, 11 }, { 117,  97,  6, 11 }, { 117,  97,  6, 11 },
+	{ 117,  99,  6, 11 }, { 117,  99,  6, 11 }, { 117, 101,  6, 11 }, { 117, 101,  6, 11 },
+	{ 117, 105,  6, 11 }, { 117, 105,  6, 11 }, { 117, 111,  6, 11 }, { 117, 111,  6, 11 },
+	{ 117, 115,  6, 11 }, { 117, 115,  6, 11 }, { 117, 116,  6, 11 }, { 117, 116,  6, 11 },
+	{ 117,  32,  6, 12 }, { 117,  37,  6, 12 }, { 117,  45,  6, 12 }, { 117,  46,  6, 12 },
+	{ 117,  47,  6, 12 }, { 117,  51,  6, 12 }, { 117,  52,  6, 12 }, { 117,  53,  6, 12 },
+	{ 117,  54,  6, 12 }, { 117,  55,  6, 12 }, { 117,  56,  6, 12 }, { 117,  57,  6, 12 },
+	{ 117,  61,  6, 12 }, { 117,  65,  6, 12 }, { 117,  95,  6, 12 }, { 117,  98,  6, 12 },
+	{ 117, 100,  6, 12 }, { 117, 102,  6, 12 }, { 117, 103,  6, 12 }, { 117, 104,  6, 12 },
+	{ 117, 108,  6, 12 }, { 117, 109,  6, 12 }, { 117, 110,  6, 12 }, { 117, 112,  6, 12 },
+	{ 117, 114,  6, 12 }, { 117, 117,  6, 12 }, { 117,   0,  6,  6 }, { 117,   0,  6,  6 },
+	{ 117,   0,  6,  6 }, { 117,   0,  6,  6 }, { 117,   0,  6,  6 }, { 117,   0,  6,  6 },
+	{ 117,   0,  6,  6 }, { 117,   0,  6,  6 }, { 117,   0,  6,  6 }, { 117,   0,  6,  6 },
+	{ 117,   0,  6,  6 }, { 117,   0,  6,  6 }, { 117,   0,  6,  6 }, { 117,   0,  6,  6 },
+	{ 117,   0,  6,  6 }, { 117,   0,  6,  6 }, { 117,   0,  6,  6 }, { 117,   0,  6,  6 },
+	{  58,  48,  7, 12 }, {  58,  49,  7, 12 }, {  58,  50,  7, 12 }, {  58,  97,  7, 12 },
+	{  58,  99,  7, 12 }, {  58, 101,  7, 12 }, {  58, 105,  7, 12 }, {  58, 111,  7, 12 },
+	{  58, 115,  7, 12 }, {  58, 116,  7, 12 }, {  58,   0,  7,  7 }, {  58,   0,  7,  7 },
+	{  58,   0,  7,  7 }, {  58,   0,  7,  7 }, {  58,   0,  7,  7 }, {  58,   0,  7,  7 },
+	{  58,   0,  7,  7 }, {  58,   0,  7,  7 }, {  58,   0,  7,  7 }, {  58,   0,  7,  7 },
+	{  58,   0,  7,  7 }, {  58,   0,  7,  7 }, {  58,   0,  7,  7 }, {  58,   0,  7,  7 },
+	{  58,   0,  7,  7 }, {  58,   0,  7,  7 }, {  58,   0,  7,  7 }, {  58,   0,  7,  7 },
+	{  58,   0,  7,  7 }, {  58,   0,  7,  7 }, {  58,   0,  7,  7 }, {  58,   0,  7,  7 },
+	{  66,  48,  7, 12 }, {  66,  49,  7, 12 }, {  66,  50,  7, 12 }, {  66,  97,  7, 12 },
+	{  66,  99,  7, 12 }, {  66, 101,  7, 12 }, {  66, 105,  7, 12 }, {  66, 111,  7, 12 },
+	{  66, 115,  7, 12 }, {  66, 116,  7, 12 }, {  66,   0,  7,  7 }, {  66,   0,  7,  7 },
+	{  66,   0,  7,  7 }, {  66,   0,  7,  7 }, {  66,   0,  7,  7 }, {  66,   0,  7,  7 },
+	{  66,   0,  7,  7 }, {  66,   0,  7,  7 }, {  66,   0,  7,  7 }, {  66,   0,  7,  7 },
+	{  66,   0,  7,  7 }, {  66,   0,  7,  7 }, {  66,   0,  7,  7 }, {  66,   0,  7,  7 },
+	{  66,   0,  7,  7 }, {  66,   0,  7,  7 }, {  66,   0,  7,  7 }, {  66,   0,  7,  7 },
+	{  66,   0,  7,  7 }, {  66,   0,  7,  7 }, {  66,   0,  7,  7 }, {  66,   0,  7,  7 },
+	{  67,  48,  7, 12 }, {  67,  49,  7, 12 }, {  67,  50,  7, 12 }, {  67,  97,  7, 12 },
+	{  67,  99,  7, 12 }, {  67, 101,  7, 12 }, {  67, 105,  7, 12 }, {  67, 111,  7, 12 },
+	{  67, 115,  7, 12 }, {  67, 116,  7, 12 }, {  67,   0,  7,  7 }, {  67,   0,  7,  7 },
+	{  67,   0,  7,  7 }, {  67,   0,  7,  7 }, {  67,   0,  7,  7 }, {  67,   0,  7,  7 },
+	{  67,   0,  7,  7 }, {  67,   0,  7,  7 }, {  67,   0,  7,  7 }, {  67,   0,  7,  7 },
+	{  67,   0,  7,  7 }, {  67,   0,  7,  7 }, {  67,   0,  7,  7 }, {  67,   0,  7,  7 },
+	{  67,   0,  7,  7 }, {  67,   0,  7,  7 }, {  67,   0,  7,  7 }, {  67,   0,  7,  7 },
+	{  67,   0,  7,  7 }, {  67,   0,  7,  7 }, {  67,   0,  7,  7 }, {  67,   0,  7,  7 },
+	{  68,  48,  7, 12 }, {  68,  49,  7, 12 }, {  68,  50,  7, 12 }, {  68,  97,  7, 12 },
+	{  68,  99,  7, 12 }, {  68, 101,  7, 12 }, {  68, 105,  7, 12 }, {  68, 111,  7, 12 },
+	{  68, 115,  7, 12 }, {  68, 116,  7, 12 }, {  68,   0,  7,  7 }, {  68,   0,  7,  7 },
+	{  68,   0,  7,  7 }, {  68,   0,  7,  7 }, {  68,   0,  7,  7 }, {  68,   0,  7,  7 },
+	{  68,   0,  7,  7 }, {  68,   0,  7,  7 }, {  68,   0,  7,  7 }, {  68,   0,  7,  7 },
+	{  68,   0,  7,  7 }, {  68,   0,  7,  7 }, {  68,   0,  7,  7 }, {  68,   0,  7,  7 },
+	{  68,   0,  7,  7 }, {  68,   0,  7,  7 }, {  68,   0,  7,  7 }, {  68,   0,  7,  7 },
+	{  68,   0,  7,  7 }, {  68,   0,  7,  7 }, {  68,   0,  7,  7 }, {  68,   0,  7,  7 },
+	{  69,  48,  7, 12 }, {  69,  49,  7, 12 }, {  69,  50,  7, 12 }, {  69,  97,  7, 12 },
+	{  69,  99,  7, 12 }, {  69, 101,  7, 12 }, {  69, 105,  7, 12 }, {  69, 111,  7, 12 },
+	{  69, 115,  7, 12 }, {  69, 116,  7, 12 }, {  69,   0,  7,  7 }, {  69,   0,  7,  7 },
+	{  69,   0,  7,  7 }, {  69,   0,  7,  7 }, {  69,   0,  7,  7 }, {  69,   0,  7,  7 },
+	{  69,   0,  7,  7 }, {  69,   0,  7,  7 }, {  69,   0,  7,  7 }, {  69,   0,  7,  7 },
+	{  69,   0,  7,  7 }, {  69,   0,  7,  7 }, {  69,   0,  7,  7 }, {  69,   0,  7,  7 },
+	{  69,   0,  7,  7 }, {  69,   0,  7,  7 }, {  69,   0,  7,  7 }, {  69,   0,  7,  7 },
+	{  69,   0,  7,  7 }, {  69,   0,  7,  7 }, {  69,   0,  7,  7 }, {  69,   0,  7,  7 },
+	{  70,  48,  7, 12 }, {  70,  49,  7, 12 }, {  70,  50,  7, 12 }, {  70,  97,  7, 12 },
+	{  70,  99,  7, 12 }, {  70, 101,  7, 12 }, {  70, 105,  7, 12 }, {  70, 111,  7, 12 },
+	{  70, 115,  7, 12 }, {  70, 116,  7, 12 }, {  70,   0,  7,  7 }, {  70,   0,  7,  7 },
+	{  70,   0,  7,  7 }, {  70,   0,  7,  7 }, {  70,   0,  7,  7 }, {  70,   0,  7,  7 },
+	{  70,   0,  7,  7 }, {  70,   0,  7,  7 }, {  70,   0,  7,  7 }, {  70,   0,  7,  7 },
+	{  70,   0,  7,  7 }, {  70,   0,  7,  7 }, {  70,   0,  7,  7 }, {  70,   0,  7,  7 },
+	{  70,   0,  7,  7 }, {  70,   0,  7,  7 }, {  70,   0,  7,  7 }, {  70,   0,  7,  7 },
+	{  70,   0,  7,  7 }, {  70,   0,  7,  7 }, {  70,   0,  7,  7 }, {  70,   0,  7,  7 },
+	{  71,  48,  7, 12 }, {  71,  49,  7, 12 }, {  71,  50,  7, 12 }, {  71,  97,  7, 12 },
+	{  71,  99,  7, 12 }, {  71, 101,  7, 12 }, {  71, 105,  7, 12 }, {  71, 111,  7, 12 },
+	{  71, 115,  7, 12 }, {  71, 116,  7, 12 }, {  71,   0,  7,  7 }, {  71,   0,  7,  7 },
+	{  71,   0,  7,  7 }, {  71,   0,  7,  7 }, {  71,   0,  7,  7 }, {  71,   0,  7,  7 },
+	{  71,   0,  7,  7 }, {  71,   0,  7,  7 }, {  71,   0,  7,  7 }, {  71,   0,  7,  7 },
+	{  71,   0,  7,  7 }, {  71,   0,  7,  7 }, {  71,   0,  7,  7 }, {  71,   0,  7,  7 },
+	{  71,   0,  7,  7 }, {  71,   0,  7,  7 }, {  71,   0,  7,  7 }, {  71,   0,  7,  7 },
+	{  71,   0,  7,  7 }, {  71,   0,  7,  7 }, {  71,   0,  7,  7 }, {  71,   0,  7,  7 },
+	{  72,  48,  7, 12 }, {  72,  49,  7, 12 }, {  72,  50,  7, 12 }, {  72,  97,  7, 12 },
+	{  72,  99,  7, 12 }, {  72, 101,  7, 12 }, {  72, 105,  7, 12 }, {  72, 111,  7, 12 },
+	{  72, 115,  7, 12 }, {  72, 116,  7, 12 }, {  72,   0,  7,  7 }, {  72,   0,  7,  7 },
+	{  72,   0,  7,  7 }, {  72,   0,  7,  7 }, {  72,   0,  7,  7 }, {  72,   0,  7,  7 },
+	{  72,   0,  7,  7 }, {  72,   0,  7,  7 }, {  72,   0,  7,  7 }, {  72,   0,  7,  7 },
+	{  72,   0,  7,  7 }, {  72,   0,  7,  7 }, {  72,   0,  7,  7 }, {  72,   0,  7,  7 },
+	{  72,   0,  7,  7 }, {  72,   0,  7,  7 }, {  72,   0,  7,  7 }, {  72,   0,  7,  7 },
+	{  72,   0,  7,  7 }, {  72,   0,  7,  7 }, {  72,   0,  7,  7 }, {  72,   0,  7,  7 },
+	{  73,  48,  7, 12 }, {  73,  49,  7, 12 }, {  73,  50,  7, 12 }, {  73,  97,  7, 12 },
+	{  73,  99,  7, 12 }, {  73, 101,  7, 12 }, {  73, 105,  7, 12 }, {  73, 111,  7, 12 },
+	{  73, 115,  7, 12 }, {  73, 116,  7, 12 }, {  73,   0,  7,  7 }, {  73,   0,  7,  7 },
+	{  73,   0,  7,  7 }, {  73,   0,  7,  7 }, {  73,   0,  7,  7 }, {  73,   0,  7,  7 },
+	{  73,   0,  7,  7 }, {  73,   0,  7,  7 }, {  73,   0,  7,  7 }, {  73,   0,  7,  7 },
+	{  73,   0,  7,  7 }, {  73,   0,  7,  7 }, {  73,   0,  7,  7 }, {  73,   0,  7,  7 },
+	{  73,   0,  7,  7 }, {  73,   0,  7,  7 }, {  73,   0,  7,  7 }, {  73,   0,  7,  7 },
+	{  73,   0,  7,  7 }, {  73,   0,  7,  7 }, {  73,   0,  7,  7 }, {  73,   0,  7,  7 },
+	{  74,  48,  7, 12 }, {  74,  49,  7, 12 }, {  74,  50,  7, 12 }, {  74,  97,  7, 12 },
+	{  74,  99,  7, 12 }, {  74, 101,  7, 12 }, {  74, 105,  7, 12 }, {  74, 111,  7, 12 },
+	{  74, 115,  7, 12 }, {  74, 116,  7, 12 }, {  74,   0,  7,  7 }, {  74,   0,  7,  7 },
+	{  74,   0,  7,  7 }, {  74,   0,  7,  7 }, {  74,   0,  7,  7 }, {  74,   0,  7,  7 },
+	{  74,   0,  7,  7 }, {  74,   0,  7,  7 }, {  74,   0,  7,  7 }, {  74,   0,  7,  7 },
+	{  74,   0,  7,  7 }, {  74,   0,  7,  7 }, {  74,   0,  7,  7 }, {  74,   0,  7,  7 },
+	{  74,   0,  7,  7 }, {  74,   0,  7,  7 }, {  74,   0,  7,  7 }, {  74,   0,  7,  7 },
+	{  74,   0,  7,  7 }, {  74,   0,  7,  7 }, {  74,   0,  7,  7 }, {  74,   0,  7,  7 },
+	{  75,  48,  7, 12 }, {  75,  49,  7, 12 }, {  75,  50,  7, 12 }, {  75,  97,  7, 12 },
+	{  75,  99,  7, 12 }, {  75, 101,  7, 12 }, {  75, 105,  7, 12 }, {  75, 111,  7, 12 },
+	{  75, 115,  7, 12 }, {  75, 116,  7, 12 }, {  75,   0,  7,  7 }, {  75,   0,  7,  7 },
+	{  75,   0,  7,  7 }, {  75,   0,  7,  7 }, {  75,   0,  7,  7 }, {  75,   0,  7,  7 },
+	{  75,   0,  7,  7 }, {  75,   0,  7,  7 }, {  75,   0,  7,  7 }, {  75,   0,  7,  7 },
+	{  75,   0,  7,  7 }, {  75,   0,  7,  7 }, {  75,   0,  7,  7 }, {  75,   0,  7,  7 },
+	{  75,   0,  7,  7 }, {  75,   0,  7,  7 }, {  75,   0,  7,  7 }, {  75,   0,  7,  7 },
+	{  75,   0,  7,  7 }, {  75,   0,  7,  7 }, {  75,   0,  7,  7 }, {  75,   0,  7,  7 },
+	{  76,  48,  7, 12 }, {  76,  49,  7, 12 }, {  76,  50,  7, 12 }, {  76,  97,  7, 12 },
+	{  76,  99,  7, 12 }, {  76, 101,  7, 12 }, {  76, 105,  7, 12 }, {  76, 111,  7, 12 },
+	{  76, 115,  7, 12 }, {  76, 116,  7, 12 }, {  76,   0,  7,  7 }, {  76,   0,  7,  7 },
+	{  76,   0,  7,  7 }, {  76,   0,  7,  7 }, {  76,   0,  7,  7 }, {  76,   0,  7,  7 },
+	{  76,   0,  7,  7 }, {  76,   0,  7,  7 }, {  76,   0,  7,  7 }, {  76,   0,  7,  7 },
+	{  76,   0,  7,  7 }, {  76,   0,  7,  7 }, {  76,   0,  7,  7 }, {  76,   0,  7,  7 },
+	{  76,   0,  7,  7 }, {  76,   0,  7,  7 }, {  76,   0,  7,  7 }, {  76,   0,  7,  7 },
+	{  76,   0,  7,  7 }, {  76,   0,  7,  7 }, {  76,   0,  7,  7 }, {  76,   0,  7,  7 },
+	{  77,  48,  7, 12 }, {  77,  49,  7, 12 }, {  77,  50,  7, 12 }, {  77,  97,  7, 12 },
+	{  77,  99,  7, 12 }, {  77, 101,  7, 12 }, {  77, 105,  7, 12 }, {  77, 111,  7, 12 },
+	{  77, 115,  7, 12 }, {  77, 116,  7, 12 }, {  77,   0,  7,  7 }, {  77,   0,  7,  7 },
+	{  77,   0,  7,  7 }, {  77,   0,  7,  7 }, {  77,   0,  7,  7 }, {  77,   0,  7,  7 },
+	{  77,   0,  7,  7 }, {  77,   0,  7,  7 }, {  77,   0,  7,  7 }, {  77,   0,  7,  7 },
+	{  77,   0,  7,  7 }, {  77,   0,  7,  7 }, {  77,   0,  7,  7 }, {  77,   0,  7,  7 },
+	{  77,   0,  7,  7 }, {  77,   0,  7,  7 }, {  77,   0,  7,  7 }, {  77,   0,  7,  7 },
+	{  77,   0,  7,  7 }, {  77,   0,  7,  7 }, {  77,   0,  7,  7 }, {  77,   0,  7,  7 },
+	{  78,  48,  7, 12 }, {  78,  49,  7, 12 }, {  78,  50,  7, 12 }, {  78,  97,  7, 12 },
+	{  78,  99,  7, 12 }, {  78, 101,  7, 12 }, {  78, 105,  7, 12 }, {  78, 111,  7, 12 },
+	{  78, 115,  7, 12 }, {  78, 116,  7, 12 }, {  78,   0,  7,  7 }, {  78,   0,  7,  7 },
+	{  78,   0,  7,  7 }, {  78,   0,  7,  7 }, {  78,   0,  7,  7 }, {  78,   0,  7,  7 },
+	{  78,   0,  7,  7 }, {  78,   0,  7,  7 }, {  78,   0,  7,  7 }, {  78,   0,  7,  7 },
+	{  78,   0,  7,  7 }, {  78,   0,  7,  7 }, {  78,   0,  7,  7 }, {  78,   0,  7,  7 },
+	{  78,   0,  7,  7 }, {  78,   0,  7,  7 }, {  78,   0,  7,  7 }, {  78,   0,  7,  7 },
+	{  78,   0,  7,  7 }, {  78,   0,  7,  7 }, {  78,   0,  7,  7 }, {  78,   0,  7,  7 },
+	{  79,  48,  7, 12 }, {  79,  49,  7, 12 }, {  79,  50,  7, 12 }, {  79,  97,  7, 12 },
+	{  79,  99,  7, 12 }, {  79, 101,  7, 12 }, {  79, 105,  7, 12 }, {  79, 111,  7, 12 },
+	{  79, 115,  7, 12 }, {  79, 116,  7, 12 }, {  79,   0,  7,  7 }, {  79,   0,  7,  7 },
+	{  79,   0,  7,  7 }, {  79,   0,  7,  7 }, {  79,   0,  7,  7 }, {  79,   0,  7,  7 },
+	{  79,   0,  7,  7 }, {  79,   0,  7,  7 }, {  79,   0,  7,  7 }, {  79,   0,  7,  7 },
+	{  79,   0,  7,  7 }, {  79,   0,  7,  7 }, {  79,   0,  7,  7 }, {  79,   0,  7,  7 },
+	{  79,   0,  7,  7 }, {  79,   0,  7,  7 }, {  79,   0,  7,  7 }, {  79,   0,  7,  7 },
+	{  79,   0,  7,  7 }, {  79,   0,  7,  7 }, {  79,   0,  7,  7 }, {  79,   0,  7,  7 },
+	{  80,  48,  7, 12 }, {  80,  49,  7, 12 }, {  80,  50,  7, 12 }, {  80,  97,  7, 12 },
+	{  80,  99,  7, 12 }, {  80, 101,  7, 12 }, {  80, 105,  7, 12 }, {  80, 111,  7, 12 },
+	{  80, 115,  7, 12 }, {  80, 116,  7, 12 }, {  80,   0,  7,  7 }, {  80,   0,  7,  7 },
+	{  80,   0,  7,  7 }, {  80,   0,  7,  7 }, {  80,   0,  7,  7 }, {  80,   0,  7,  7 },
+	{  80,   0,  7,  7 }, {  80,   0,  7,  7 }, {  80,   0,  7,  7 }, {  80,   0,  7,  7 },
+	{  80,   0,  7,  7 }, {  80,   0,  7,  7 }, {  80,   0,  7,  7 }, {  80,   0,  7,  7 },
+	{  80,   0,  7,  7 }, {  80,   0,  7,  7 }, {  80,   0,  7,  7 }, {  80,   0,  7,  7 },
+	{  80,   0,  7,  7 }, {  80,   0,  7,  7 }, {  80,   0,  7,  7 }, {  80,   0,  7,  7 },
+	{  81,  48,  7, 12 }, {  81,  49,  7, 12 }, {  81,  50,  7, 12 }, {  81,  97,  7, 12 },
+	{  81,  99,  7, 12 }, {  81, 101,  7, 12 }, {  81, 105,  7, 12 }, {  81, 111,  7, 12 },
+	{  81, 115,  7, 12 }, {  81, 116,  7, 12 }, {  81,   0,  7,  7 }, {  81,   0,  7,  7 },
+	{  81,   0,  7,  7 }, {  81,   0,  7,  7 }, {  81,   0,  7,  7 }, {  81,   0,  7,  7 },
+	{  81,   0,  7,  7 }, {  81,   0,  7,  7 }, {  81,   0,  7,  7 }, {  81,   0,  7,  7 },
+	{  81,   0,  7,  7 }, {  81,   0,  7,  7 }, {  81,   0,  7,  7 }, {  81,   0,  7,  7 },
+	{  81,   0,  7,  7 }, {  81,   0,  7,  7 }, {  81,   0,  7,  7 }, {  81,   0,  7,  7 },
+	{  81,   0,  7,  7 }, {  81,   0,  7,  7 }, {  81,   0,  7,  7 }, {  81,   0,  7,  7 },
+	{  82,  48,  7, 12 }, {  82,  49,  7, 12 }, {  82,  50,  7, 12 }, {  82,  97,  7, 12 },
+	{  82,  99,  7, 12 }, {  82, 101,  7, 12 }, {  82, 105,  7, 12 }, {  82, 111,  7, 12 },
+	{  82, 115,  7, 12 }, {  82, 116,  7, 12 }, {  82,   0,  7,  7 }, {  82,   0,  7,  7 },
+	{  82,   0,  7,  7 }, {  82,   0,  7,  7 }, {  82,   0,  7,  7 }, {  82,   0,  7,  7 },
+	{  82,   0,  7,  7 }, {  82,   0,  7,  7 }, {  82,   0,  7,  7 }, {  82,   0,  7,  7 },
+	{  82,   0,  7,  7 }, {  82,   0,  7,  7 }, {  82,   0,  7,  7 }, {  82,   0,  7,  7 },
+	{  82,   0,  7,  7 }, {  82,   0,  7,  7 }, {  82,   0,  7,  7 }, {  82,   0,  7,  7 },
+	{  82,   0,  7,  7 }, {  82,   0,  7,  7 }, {  82,   0,  7,  7 }, {  82,   0,  7,  7 },
+	{  83,  48,  7, 12 }, {  83,  49,  7, 12 }, {  83,  50,  7, 12 }, {  83,  97,  7, 12 },
+	{  83,  99,  7, 12 }, {  83, 101,  7, 12 }, {  83, 105,  7, 12 }, {  83, 111,  7, 12 },
+	{  83, 115,  7, 12 }, {  83, 116,  7, 12 }, {  83,   0,  7,  7 }, {  83,   0,  7,  7 },
+	{  83,   0,  7,  7 }, {  83,   0,  7,  7 }, {  83,   0,  7,  7 }, {  83,   0,  7,  7 },
+	{  83,   0,  7,  7 }, {  83,   0,  7,  7 }, {  83,   0,  7,  7 }, {  83,   0,  7,  7 },
+	{  83,   0,  7,  7 }, {  83,   0,  7,  7 }, {  83,   0,  7,  7 }, {  83,   0,  7,  7 },
+	{  83,   0,  7,  7 }, {  83,   0,  7,  7 }, {  83,   0,  7,  7 }, {  83,   0,  7,  7 },
+	{  83,   0,  7,  7 }, {  83,   0,  7,  7 }, {  83,   0,  7,  7 }, {  83,   0,  7,  7 },
+	{  84,  48,  7, 12 }, {  84,  49,  7, 12 }, {  84,  50,  7, 12 }, {  84,  97,  7, 12 },
+	{  84,  99,  7, 12 }, {  84, 101,  7, 12 }, {  84, 105,  7, 12 }, {  84, 111,  7, 12 },
+	{  84, 115,  7, 12 }, {  84, 116,  7, 12 }, {  84,   0,  7,  7 }, {  84,   0,  7,  7 },
+	{  84,   0,  7,  7 }, {  84,   0,  7,  7 }, {  84,   0,  7,  7 }, {  84,   0,  7,  7 },
+	{  84,   0,  7,  7 }, {  84,   0,  7,  7 }, {  84,   0,  7,  7 }, {  84,   0,  7,  7 },
+	{  84,   0,  7,  7 }, {  84,   0,  7,  7 }, {  84,   0,  7,  7 }, {  84,   0,  7,  7 },
+	{  84,   0,  7,  7 }, {  84,   0,  7,  7 }, {  84,   0,  7,  7 }, {  84,   0,  7,  7 },
+	{  84,   0,  7,  7 }, {  84,   0,  7,  7 }, {  84,   0,  7,  7 }, {  84,   0,  7,  7 },
+	{  85,  48,  7, 12 }, {  85,  49,  7, 12 }, {  85,  50,  7, 12 }, {  85,  97,  7, 12 },
+	{  85,  99,  7, 12 }, {  85, 101,  7, 12 }, {  85, 105,  7, 12 }, {  85, 111,  7, 12 },
+	{  85, 115,  7, 12 }, {  85, 116,  7, 12 }, {  85,   0,  7,  7 }, {  85,   0,  7,  7 },
+	{  85,   0,  7,  7 }, {  85,   0,  7,  7 }, {  85,   0,  7,  7 }, {  85,   0,  7,  7 },
+	{  85,   0,  7,  7 }, {  85,   0,  7,  7 }, {  85,   0,  7,  7 }, {  85,   0,  7,  7 },
+	{  85,   0,  7,  7 }, {  85,   0,  7,  7 }, {  85,   0,  7,  7 }, {  85,   0,  7,  7 },
+	{  85,   0,  7,  7 }, {  85,   0,  7,  7 }, {  85,   0,  7,  7 }, {  85,   0,  7,  7 },
+	{  85,   0,  7,  7 }, {  85,   0,  7,  7 }, {  85,   0,  7,  7 }, {  85,   0,  7,  7 },
+	{  86,  48,  7, 12 }, {  86,  49,  7, 12 }, {  86,  50,  7, 12 }, {  86,  97,  7, 12 },
+	{  86,  99,  7, 12 }, {  86, 101,  7, 12 }, {  86, 105,  7, 12 }, {  86, 111,  7, 12 },
+	{  86, 115,  7, 12 }, {  86, 116,  7, 12 }, {  86,   0,  7,  7 }, {  86,   0,  7,  7 },
+	{  86,   0,  7,  7 }, {  86,   0,  7,  7 }, {  86,   0,  7,  7 }, {  86,   0,  7,  7 },
+	{  86,   0,  7,  7 }, {  86,   0,  7,  7 }, {  86,   0,  7,  7 }, {  86,   0,  7,  7 },
+	{  86,   0,  7,  7 }, {  86,   0,  7,  7 }, {  86,   0,  7,  7 }, {  86,   0,  7,  7 },
+	{  86,   0,  7,  7 }, {  86,   0,  7,  7 }, {  86,   0,  7,  7 }, {  86,   0,  7,  7 },
+	{  86,   0,  7,  7 }, {  86,   0,  7,  7 }, {  86,   0,  7,  7 }, {  86,   0,  7,  7 },
+	{  87,  48,  7, 12 }, {  87,  49,  7, 12 }, {  87,  50,  7, 12 }, {  87,  97,  7, 12 },
+	{  87,  99,  7, 12 }, {  87, 101,  7, 12 }, {  87, 105,  7, 12 }, {  87, 111,  7, 12 },
+	{  87, 115,  7, 12 }, {  87, 116,  7, 12 }, {  87,   0,  7,  7 }, {  87,   0,  7,  7 },
+	{  87,   0,  7,  7 }, {  87,   0,  7,  7 }, {  87,   0,  7,  7 }, {  87,   0,  7,  7 },
+	{  87,   0,  7,  7 }, {  87,   0,  7,  7 }, {  87,   0,  7,  7 }, {  87,   0,  7,  7 },
+	{  87,   0,  7,  7 }, {  87,   0,  7,  7 }, {  87,   0,  7,  7 }, {  87,   0,  7,  7 },
+	{  87,   0,  7,  7 }, {  87,   0,  7,  7 }, {  87,   0,  7,  7 }, {  87,   0,  7,  7 },
+	{  87,   0,  7,  7 }, {  87,   0,  7,  7 }, {  87,   0,  7,  7 }, {  87,   0,  7,  7 },
+	{  89,  48,  7, 12 }, {  89,  49,  7, 12 }, {  89,  50,  7, 12 }, {  89,  97,  7, 12 },
+	{  89,  99,  7, 12 }, {  89, 101,  7, 12 }, {  89, 105,  7, 12 }, {  89, 111,  7, 12 },
+	{  89, 115,  7, 12 }, {  89, 116,  7, 12 }, {  89,   0,  7,  7 }, {  89,   0,  7,  7 },
+	{  89,   0,  7,  7 }, {  89,   0,  7,  7 }, {  89,   0,  7,  7 }, {  89,   0,  7,  7 },
+	{  89,   0,  7,  7 }, {  89,   0,  7,  7 }, {  89,   0,  7,  7 }, {  89,   0,  7,  7 },
+	{  89,   0,  7,  7 }, {  89,   0,  7,  7 }, {  89,   0,  7,  7 }, {  89,   0,  7,  7 },
+	{  89,   0,  7,  7 }, {  89,   0,  7,  7 }, {  89,   0,  7,  7 }, {  89,   0,  7,  7 },
+	{  89,   0,  7,  7 }, {  89,   0,  7,  7 }, {  89,   0,  7,  7 }, {  89,   0,  7,  7 },
+	{ 106,  48,  7, 12 }, { 106,  49,  7, 12 }, { 106,  50,  7, 12 }, { 106,  97,  7, 12 },
+	{ 106,  99,  7, 12 }, { 106, 101,  7, 12 }, { 106, 105,  7, 12 }, { 106, 111,  7, 12 },
+	{ 106, 115,  7, 12 }, { 106, 116,  7, 12 }, { 106,   0,  7,  7 }, { 106,   0,  7,  7 },
+	{ 106,   0,  7,  7 }, { 106,   0,  7,  7 }, { 106,   0,  7,  7 }, { 106,   0,  7,  7 },
+	{ 106,   0,  7,  7 }, { 106,   0,  7,  7 }, { 106,   0,  7,  7 }, { 106,   0,  7,  7 },
+	{ 106,   0,  7,  7 }, { 106,   0,  7,  7 }, { 106,   0,  7,  7 }, { 106,   0,  7,  7 },
+	{ 106,   0,  7,  7 }, { 106,   0,  7,  7 }, { 106,   0,  7,  7 }, { 106,   0,  7,  7 },
+	{ 106,   0,  7,  7 }, { 106,   0,  7,  7 }, { 106,   0,  7,  7 }, { 106,   0,  7,  7 },
+	{ 107,  48,  7, 12 }, { 107,  49,  7, 12 }, { 107,  50,  7, 12 }, { 107,  97,  7, 12 },
+	{ 107,  99,  7, 12 }, { 107, 101,  7, 12 }, { 107, 105,  7, 12 }, { 107, 111,  7, 12 },
+	{ 107, 115,  7, 12 }, { 107, 116,  7, 12 }, { 107,   0,  7,  7 }, { 107,   0,  7,  7 },
+	{ 107,   0,  7,  7 }, { 107,   0,  7,  7 }, { 107,   0,  7,  7 }, { 107,   0,  7,  7 },
+	{ 107,   0,  7,  7 }, { 107,   0,  7,  7 }, { 107,   0,  7,  7 }, { 107,   0,  7,  7 },
+	{ 107,   0,  7,  7 }, { 107,   0,  7,  7 }, { 107,   0,  7,  7 }, { 107,   0,  7,  7 },
+	{ 107,   0,  7,  7 }, { 107,   0,  7,  7 }, { 107,   0,  7,  7 }, { 107,   0,  7,  7 },
+	{ 107,   0,  7,  7 }, { 107,   0,  7,  7 }, { 107,   0,  7,  7 }, { 107,   0,  7,  7 },
+	{ 113,  48,  7, 12 }, { 113,  49,  7, 12 }, { 113,  50,  7, 12 }, { 113,  97,  7, 12 },
+	{ 113,  99,  7, 12 }, { 113, 101,  7, 12 }, { 113, 105,  7, 12 }, { 113, 111,  7, 12 },
+	{ 113, 115,  7, 12 }, { 113, 116,  7, 12 }, { 113,   0,  7,  7 }, { 113,   0,  7,  7 },
+	{ 113,   0,  7,  7 }, { 113,   0,  7,  7 }, { 113,   0,  7,  7 }, { 113,   0,  7,  7 },
+	{ 113,   0,  7,  7 }, { 113,   0,  7,  7 }, { 113,   0,  7,  7 }, { 113,   0,  7,  7 },
+	{ 113,   0,  7,  7 }, { 113,   0,  7,  7 }, { 113,   0,  7,  7 }, { 113,   0,  7,  7 },
+	{ 113,   0,  7,  7 }, { 113,   0,  7,  7 }, { 113,   0,  7,  7 }, { 113,   0,  7,  7 },
+	{ 113,   0,  7,  7 }, { 113,   0,  7,  7 }, { 113,   0,  7,  7 }, { 113,   0,  7,  7 },
+	{ 118,  48,  7, 12 }, { 118,  49,  7, 12 }, { 118,  50,  7, 12 }, { 118,  97,  7, 12 },
+	{ 118,  99,  7, 12 }, { 118, 101,  7, 12 }, { 118, 105,  7, 12 }, { 118, 111,  7, 12 },
+	{ 118, 115,  7, 12 }, { 118, 116,  7, 12 }, { 118,   0,  7,  7 }, { 118,   0,  7,  7 },
+	{ 118,   0,  7,  7 }, { 118,   0,  7,  7 }, { 118,   0,  7,  7 }, { 118,   0,  7,  7 },
+	{ 118,   0,  7,  7 }, { 118,   0,  7,  7 }, { 118,   0,  7,  7 }, { 118,   0,  7,  7 },
+	{ 118,   0,  7,  7 }, { 118,   0,  7,  7 }, { 118,   0,  7,  7 }, { 118,   0,  7,  7 },
+	{ 118,   0,  7,  7 }, { 118,   0,  7,  7 }, { 118,   0,  7,  7 }, { 118,   0,  7,  7 },
+	{ 118,   0,  7,  7 }, { 118,   0,  7,  7 }, { 118,   0,  7,  7 }, { 118,   0,  7,  7 },
+	{ 119,  48,  7, 12 }, { 119,  49,  7, 12 }, { 119,  50,  7, 12 }, { 119,  97,  7, 12 },
+	{ 119,  99,  7, 12 }, { 119, 101,  7, 12 }, { 119, 105,  7, 12 }, { 119, 111,  7, 12 },
+	{ 119, 115,  7, 12 }, { 119, 116,  7, 12 }, { 119,   0,  7,  7 }, { 119,   0,  7,  7 },
+	{ 119,   0,  7,  7 }, { 119,   0,  7,  7 }, { 119,   0,  7,  7 }, { 119,   0,  7,  7 },
+	{ 119,   0,  7,  7 }, { 119,   0,  7,  7 }, { 119,   0,  7,  7 }, { 119,   0,  7,  7 },
+	{ 119,   0,  7,  7 }, { 119,   0,  7,  7 }, { 119,   0,  7,  7 }, { 119,   0,  7,  7 },
+	{ 119,   0,  7,  7 }, { 119,   0,  7,  7 }, { 119,   0,  7,  7 }, { 119,   0,  7,  7 },
+	{ 119,   0,  7,  7 }, { 119,   0,  7,  7 }, { 119,   0,  7,  7 }, { 119,   0,  7,  7 },
+	{ 120,  48,  7, 12 }, { 120,  49,  7, 12 }, { 120,  50,  7, 12 }, { 120,  97,  7, 12 },
+	{ 120,  99,  7, 12 }, { 120, 101,  7, 12 }, { 120, 105,  7, 12 }, { 120, 111,  7, 12 },
+	{ 120, 115,  7, 12 }, { 120, 116,  7, 12 }, { 120,   0,  7,  7 }, { 120,   0,  7,  7 },
+	{ 120,   0,  7,  7 }, { 120,   0,  7,  7 }, { 120,   0,  7,  7 }, { 120,   0,  7,  7 },
+	{ 120,   0,  7,  7 }, { 120,   0,  7,  7 }, { 120,   0,  7,  7 }, { 120,   0,  7,  7 },
+	{ 120,   0,  7,  7 }, { 120,   0,  7,  7 }, { 120,   0,  7,  7 }, { 120,   0,  7,  7 },
+	{ 120,   0,  7,  7 }, { 120,   0,  7,  7 }, { 120,   0,  7,  7 }, { 120,   0,  7,  7 },
+	{ 120,   0,  7,  7 }, { 120,   0,  7,  7 }, { 120,   0,  7,  7 }, { 120,   0,  7,  7 },
+	{ 121,  48,  7, 12 }, { 121,  49,  7, 12 }, { 121,  50,  7, 12 }, { 121,  97,  7, 12 },
+	{ 121,  99,  7, 12 }, { 121, 101,  7, 12 }, { 121, 105,  7, 12 }, { 121, 111,  7, 12 },
+	{ 121, 115,  7, 12 }, { 121, 116,  7, 12 }, { 121,   0,  7,  7 }, { 121,   0,  7,  7 },
+	{ 121,   0,  7,  7 }, { 121,   0,  7,  7 }, { 121,   0,  7,  7 }, { 121,   0,  7,  7 },
+	{ 121,   0,  7,  7 }, { 121,   0,  7,  7 }, { 121,   0,  7,  7 }, { 121,   0,  7,  7 },
+	{ 121,   0,  7,  7 }, { 121,   0,  7,  7 }, { 121,   0,  7,  7 }, { 121,   0,  7,  7 },
+	{ 121,   0,  7,  7 }, { 121,   0,  7,  7 }, { 121,   0,  7,  7 }, { 121,   0,  7,  7 },
+	{ 121,   0,  7,  7 }, { 121,   0,  7,  7 }, { 121,   0,  7,  7 }, { 121,   0,  7,  7 },
+	{ 122,  48,  7, 12 }, { 122,  49,  7, 12 }, { 122,  50,  7, 12 }, { 122,  97,  7, 12 },
+	{ 122,  99,  7, 12 }, { 122, 101,  7, 12 }, { 122, 105,  7, 12 }, { 122, 111,  7, 12 },
+	{ 122, 115,  7, 12 }, { 122, 116,  7, 12 }, { 122,   0,  7,  7 }, { 122,   0,  7,  7 },
+	{ 122,   0,  7,  7 }, { 122,   0,  7,  7 }, { 122,   0,  7,  7 }, { 122,   0,  7,  7 },
+	{ 122,   0,  7,  7 }, { 122,   0,  7,  7 }, { 122,   0,  7,  7 }, { 122,   0,  7,  7 },
+	{ 122,   0,  7,  7 }, { 122,   0,  7,  7 }, { 122,   0,  7,  7 }, { 122,   0,  7,  7 },
+	{ 122,   0,  7,  7 }, { 122,   0,  7,  7 }, { 122,   0,  7,  7 }, { 122,   0,  7,  7 },
+	{ 122,   0,  7,  7 }, { 122,   0,  7,  7 }, { 122,   0,  7,  7 }, { 122,   0,  7,  7 },
+	{  38,   0,  8,  8 }, {  38,   0,  8,  8 }, {  38,   0,  8,  8 }, {  38,   0,  8,  8 },
+	{  38,   0,  8,  8 }, {  38,   0,  8,  8 }, {  38,   0,  8,  8 }, {  38,   0,  8,  8 },
+	{  38,   0,  8,  8 }, {  38,   0,  8,  8 }, {  38,   0,  8,  8 }, {  38,   0,  8,  8 },
+	{  38,   0,  8,  8 }, {  38,   0,  8,  8 }, {  38,   0,  8,  8 }, {  38,   0,  8,  8 },
+	{  42,   0,  8,  8 }, {  42,   0,  8,  8 }, {  42,   0,  8,  8 }, {  42,   0,  8,  8 },
+	{  42,   0,  8,  8 }, {  42,   0,  8,  8 }, {  42,   0,  8,  8 }, {  42,   0,  8,  8 },
+	{  42,   0,  8,  8 }, {  42,   0,  8,  8 }, {  42,   0,  8,  8 }, {  42,   0,  8,  8 },
+	{  42,   0,  8,  8 }, {  42,   0,  8,  8 }, {  42,   0,  8,  8 }, {  42,   0,  8,  8 },
+	{  44,   0,  8,  8 }, {  44,   0,  8,  8 }, {  44,   0,  8,  8 }, {  44,   0,  8,  8 },
+	{  44,   0,  8,  8 }, {  44,   0,  8,  8 }, {  44,   0,  8,  8 }, {  44,   0,  8,  8 },
+	{  44,   0,  8,  8 }, {  44,   0,  8,  8 }, {  44,   0,  8,  8 }, {  44,   0,  8,  8 },
+	{  44,   0,  8,  8 }, {  44,   0,  8,  8 }, {  44,   0,  8,  8 }, {  44,   0,  8,  8 },
+	{  59,   0,  8,  8 }, {  59,   0,  8,  8 }, {  59,   0,  8,  8 }, {  59,   0,  8,  8 },
+	{  59,   0,  8,  8 }, {  59,   0,  8,  8 }, {  59,   0,  8,  8 }, {  59,   0,  8,  8 },
+	{  59,   0,  8,  8 }, {  59,   0,  8,  8 }, {  59,   0,  8,  8 }, {  59,   0,  8,  8 },
+	{  59,   0,  8,  8 }, {  59,   0,  8,  8 }, {  59,   0,  8,  8 }, {  59,   0,  8,  8 },
+	{  88,   0,  8,  8 }, {  88,   0,  8,  8 }, {  88,   0,  8,  8 }, {  88,   0,  8,  8 },
+	{  88,   0,  8,  8 }, {  88,   0,  8,  8 }, {  88,   0,  8,  8 }, {  88,   0,  8,  8 },
+	{  88,   0,  8,  8 }, {  88,   0,  8,  8 }, {  88,   0,  8,  8 }, {  88,   0,  8,  8 },
+	{  88,   0,  8,  8 }, {  88,   0,  8,  8 }, {  88,   0,  8,  8 }, {  88,   0,  8,  8 },
+	{  90,   0,  8,  8 }, {  90,   0,  8,  8 }, {  90,   0,  8,  8 }, {  90,   0,  8,  8 },
+	{  90,   0,  8,  8 }, {  90,   0,  8,  8 }, {  90,   0,  8,  8 }, {  90,   0,  8,  8 },
+	{  90,   0,  8,  8 }, {  90,   0,  8,  8 }, {  90,   0,  8,  8 }, {  90,   0,  8,  8 },
+	{  90,   0,  8,  8 }, {  90,   0,  8,  8 }, {  90,   0,  8,  8 }, {  90,   0,  8,  8 },
+	{  33,   0, 10, 10 }, {  33,   0, 10, 10 }, {  33,   0, 10, 10 }, {  33,   0, 10, 10 },
+	{  34,   0, 10, 10 }, {  34,   0, 10, 10 }, {  34,   0, 10, 10 }, {  34,   0, 10, 10 },
+	{  40,   0, 10, 10 }, {  40,   0, 10, 10 }, {  40,   0, 10, 10 }, {  40,   0, 10, 10 },
+	{  41,   0, 10, 10 }, {  41,   0, 10, 10 }, {  41,   0, 10, 10 }, {  41,   0, 10, 10 },
+	{  63,   0, 10, 10 }, {  63,   0, 10, 10 }, {  63,   0, 10, 10 }, {  63,   0, 10, 10 },
+	{  39,   0, 11, 11 }, {  39,   0, 11, 11 }, {  43,   0, 11, 11 }, {  43,   0, 11, 11 },
+	{ 124,   0, 11, 11 }, { 124,   0, 11, 11 }, {  35,   0, 12, 12 }, {  62,   0, 12, 12 },
+	{   0,   0,  0,  0 }, {   0,   0,  0,  0 }, {   0,   0,  0,  0 }, {   0,   0,  0,  0 },
+};
+
+/* First code and number of codes of each length */
+static const uint32_t huffman_first[HUFFMAN_MAX_BITS+1]=
+{
+	0x00000000, 0x00000000, 0x00000000, 0x00000000,
+	0x00000000, 0x00000000, 0x00000014, 0x0000005c,
+	0x000000f8, 0x000001fc, 0x000003f8, 0x000007fa,
+	0x00000ffa, 0x00001ff8, 0x00003ffc, 0x00007ffc,
+	0x0000fffe, 0x0001fffc, 0x0003fff8, 0x0007fff0,
+	0x000fffe6, 0x001fffdc, 0x003fffd2, 0x007fffd8,
+	0x00ffffea, 0x01ffffec, 0x03ffffe0, 0x07ffffde,
+	0x0fffffe2, 0x1ffffffe, 0x3ffffffc,
+};
+
+static const uint8_t huffman_count[HUFFMAN_MAX_BITS+1]=
+{
+	 0,  0,  0,  0,  0, 10, 26, 32,
+	 6,  0,  5,  3,  2,  6,  2,  3,
+	 0,  0,  0,  3,  8, 13, 26, 29,
+	12,  4, 15, 19, 29,  0,  4,
+};
+
+/* Index in huffman_sorted of the first code of each length */
+static const uint16_t huffman_base[HUFFMAN_MAX_BITS+1]=
+{
+	  0,   0,   0,   0,   0,   0,  10,  36,
+	 68,  74,  74,  79,  82,  84,  90,  92,
+	 95,  95,  95,  95,  98, 106, 119, 145,
+	174, 186, 190, 205, 224, 253, 253,
+};
+
+/* Symbols ordered by code */
+static const uint16_t huffman_sorted[HUFFMAN_EOS+1]=
+{
+	 48,  49,  50,  97,  99, 101, 105, 111,
+	115, 116,  32,  37,  45,  46,  47,  51,
+	 52,  53,  54,  55,  56,  57,  61,  65,
+	 95,  98, 100, 102, 103, 104, 108, 109,
+	110, 112, 114, 117,  58,  66,  67,  68,
+	 69,  70,  71,  72,  73,  74,  75,  76,
+	 77,  78,  79,  80,  81,  82,  83,  84,
+	 85,  86,  87,  89, 106, 107, 113, 118,
+	119, 120, 121, 122,  38,  42,  44,  59,
+	 88,  90,  33,  34,  40,  41,  63,  39,
+	 43, 124,  35,  62,   0,  36,  64,  91,
+	 93, 126,  94, 125,  60,  96, 123,  92,
+	195, 208, 128, 130, 131, 162, 184, 194,
+	224, 226, 153, 161, 167, 172, 176, 177,
+	179, 209, 216, 217, 227, 229, 230, 129,
+	132, 133, 134, 136, 146, 154, 156, 160,
+	163, 164, 169, 170, 173, 178, 181, 185,
+	186, 187, 189, 190, 196, 198, 228, 232,
+	233,   1, 135, 137, 138, 139, 140, 141,
+	143, 147, 149, 150, 151, 152, 155, 157,
+	158, 165, 166, 168, 174, 175, 180, 182,
+	183, 188, 191, 197, 231, 239,   9, 142,
+	144, 145, 148, 159, 171, 206, 215, 225,
+	236, 237, 199, 207, 234, 235, 192, 193,
+	200, 201, 202, 205, 210, 213, 218, 219,
+	238, 240, 242, 243, 255, 203, 204, 211,
+	212, 214, 221, 222, 223, 241, 244, 245,
+	246, 247, 248, 250, 251, 252, 253, 254,
+	  2,   3,   4,   5,   6,   7,   8,  11,
+	 12,  14,  15,  16,  17,  18,  19,  20,
+	 21,  23,  24,  25,  26,  27,  28,  29,
+	 30,  31, 127, 220, 249,  10,  13,  22,
+	256,
+};
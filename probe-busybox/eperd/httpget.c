@@ -29,11 +29,14 @@
 
 #define MAX_LINE_LEN	2048	/* We don't deal with lines longer than this */
 #define POST_BUF_SIZE	2048	/* Big enough to be efficient? */
+#define MAX_PACKET_LEN	16384	/* Largest RESP_PACKET in a response file */
+#define MAX_REQUESTS	100	/* Requests on one connection */
 
 #define RESP_PACKET	1
 #define RESP_SOCKNAME	2
 #define RESP_DSTADDR	3
 #define RESP_READ_ERROR	4
+#define RESP_ATTEMPT	5
 
 static struct option longopts[]=
 {
@@ -52,6 +55,13 @@ static struct option longopts[]=
 	{ "user-agent",	required_argument, NULL, 'u' },
 	{ "sni",	required_argument, NULL, 's' },
 	{ "timeout",	required_argument, NULL, 'S' },
+	{ "tls-resume",	no_argument, NULL, 'e' },
+	{ "happy-eyeballs", no_argument, NULL, 'y' },
+	{ "no-dns-cache", no_argument, NULL, 'N' },
+	{ "tcp-fastopen", no_argument, NULL, 'F' },
+	{ "body-digest", no_argument, NULL, 'D' },
+	{ "requests",	required_argument, NULL, 'q' },
+	{ "pipeline",	no_argument, NULL, 'l' },
 	{ "etim",	no_argument, NULL, 't' },
 	{ "eetim",	no_argument, NULL, 'T' },
 	{ NULL, }
@@ -77,6 +87,20 @@ struct hgbase
 	void (*done)(void *state, int error);
 };
 
+/* Result of one request on a persistent connection */
+struct hgreq
+{
+	struct timespec sent;
+	double ttfb;		/* Relative to sent */
+	double rt;		/* Relative to sent */
+	int http_result;
+	char res_major;
+	char res_minor;
+	int headers_size;
+	int content_offset;
+	char digest[2*32+1];	/* SHA-256 in hex */
+};
+
 struct hgstate
 {
 	/* Parameters */
@@ -91,6 +115,15 @@ struct hgstate
 	char do_head;
 	char do_post;
 	bool do_tls;
+	bool tls_resume;
+	bool race;
+	bool dns_nocache;
+	bool tfo;
+	bool body_digest;
+	bool pipeline;
+	int nreq;		/* Requests on one connection */
+	char **paths;		/* Paths of additional URLs */
+	int npaths;
 	char do_http10;
 	char *user_agent;
 	char *post_header;
@@ -116,12 +149,15 @@ struct hgstate
 	char *hostport;
 	char *path;
 	char *sni;
+	char tls_resumed;
+	const char *tfo_result;	/* Set at the first byte */
 	struct bufferevent *bev;
 	enum readstate readstate;
 	enum writestate writestate;
 	int http_result;
 	char res_major;
 	char res_minor;
+	int hdr_limit;		/* max_headers for the current response */
 	int headers_size;
 	int tot_headers;
 	int chunked;
@@ -143,10 +179,13 @@ struct hgstate
 	FILE *post_fh;
 	char *post_buf;
 
-	char *line;
-	size_t linemax;		/* Allocated size of line */
-	size_t linelen;		/* Current amount of data in line */
-	size_t lineoffset;	/* Offset in line where to start processing */
+	struct evbuffer *inbuf;	/* Input when replaying a response file */
+	size_t inlen;		/* Bytes of input accounted for by get_input */
+	sha256_ctx_t body_ctx;	/* Running digest of the body */
+
+	struct hgreq *reqs;	/* Only when nreq > 1 */
+	int req_sent;
+	int req_done;
 
 	/* Base and index in table */
 	struct hgbase *base;
@@ -174,6 +213,10 @@ static void report(struct hgstate *state);
 static void add_str(struct hgstate *state, const char *str);
 static void add_str_quoted(struct hgstate *state, char *str);
 static void add_str2(struct hgstate *state, const char *str);
+static void report_attempts(struct hgstate *state);
+static void write_attempts(struct hgstate *state);
+static void report_requests(struct hgstate *state);
+static void writecb(struct bufferevent *bev, void *ptr);
 
 static struct hgbase *httpget_base_new(struct event_base *event_base)
 {
@@ -369,7 +412,7 @@ static void timeout_callback(int __attribute((unused)) unused,
 		report(state);
 		break;
 	case READ_HEADER:
-		if (state->max_headers)
+		if (state->hdr_limit)
 			add_str(state, " ], ");
 		add_str(state, ", " DBQ(err) ":" DBQ(timeout reading headers));
 		report(state);
@@ -391,11 +434,11 @@ static void timeout_callback(int __attribute((unused)) unused,
 #if 1
 		snprintf(errline, sizeof(errline), 
 			DBQ(err) ":"
-	DBQ(timeout reading chunk: state %ld linelen %ld lineoffset %ld)
+	DBQ(timeout reading chunk: state %ld inlen %ld offset %ld)
 			", ",
 			(long)state->readstate,
-			(long)state->linelen,
-			(long)state->lineoffset);
+			(long)state->inlen,
+			(long)state->content_offset);
 		add_str(state, errline);
 #else
 		add_str(state, DBQ(err) ":" DBQ(timeout reading chunk) ", ");
@@ -413,14 +456,18 @@ static void *httpget_init(int __attribute((unused)) argc, char *argv[],
 {
 	int c, i, do_combine, do_get, do_head, do_post,
 		max_headers, max_body, only_v4, only_v6,
-		do_all, do_http10, do_etim, do_eetim;
-	bool do_tls;
+		do_all, do_http10, do_etim, do_eetim, nreq, npaths;
+	bool do_tls, tls_resume, race, dns_nocache, tfo, body_digest,
+		pipeline, url_tls;
 	size_t newsiz, read_limit;
 	unsigned timeout;
 	char *url, *check;
 	char *host_arg, *post_file, *output_file, *post_footer, *post_header,
 		*A_arg, *b_arg, *store_headers, *store_body, *read_limit_str,
-		*timeout_str, *infname, *response_in, *response_out;
+		*timeout_str, *infname, *response_in, *response_out,
+		*requests_str;
+	char *url_host, *url_port, *url_hostport, *url_path;
+	char **paths;
 	char *validated_response_in= NULL;
 	char *validated_response_out= NULL;
 	char *validated_output_file= NULL;
@@ -440,6 +487,12 @@ static void *httpget_init(int __attribute((unused)) argc, char *argv[],
 	do_head= 0;
 	do_post= 0;
 	do_tls = 0;
+	tls_resume = 0;
+	race = 0;
+	dns_nocache = 0;
+	tfo = 0;
+	body_digest = 0;
+	pipeline = 0;
 	host_arg= NULL;
 	post_file= NULL; 
 	post_footer=NULL;
@@ -449,6 +502,7 @@ static void *httpget_init(int __attribute((unused)) argc, char *argv[],
 	store_body= NULL;
 	read_limit_str= NULL;
 	timeout_str= NULL;
+	requests_str= NULL;
 	A_arg= NULL;
 	b_arg= NULL;
 	infname= NULL;
@@ -565,18 +619,40 @@ static void *httpget_init(int __attribute((unused)) argc, char *argv[],
 		case 'u':				/* --user-agent */
 			user_agent= optarg;
 			break;
+		case 'e':				/* --tls-resume */
+			tls_resume= 1;
+			break;
+		case 'y':				/* --happy-eyeballs */
+			race= 1;
+			break;
+		case 'N':				/* --no-dns-cache */
+			dns_nocache= 1;
+			break;
+		case 'F':				/* --tcp-fastopen */
+			tfo= 1;
+			break;
+		case 'D':				/* --body-digest */
+			body_digest= 1;
+			break;
+		case 'q':				/* --requests */
+			requests_str= optarg;
+			break;
+		case 'l':				/* --pipeline */
+			pipeline= 1;
+			break;
 		default:
 			crondlog(LVL8 "bad option '%c'", c);
 			return NULL;
 		}
 	}
 
-	if (optind != argc-1)
+	if (optind > argc-1)
 	{
-		crondlog(LVL8 "exactly one url expected");
+		crondlog(LVL8 "at least one url expected");
 		return NULL;
 	}
 	url= argv[optind];
+	npaths= argc-optind-1;
 
 	if (response_in)
 	{
@@ -721,12 +797,69 @@ static void *httpget_init(int __attribute((unused)) argc, char *argv[],
 		}
 	}
 
+	nreq= npaths+1;
+	if (requests_str)
+	{
+		nreq= strtoul(requests_str, &check, 10);
+		if (check[0] != '\0' || nreq < 1 || nreq > MAX_REQUESTS)
+		{
+			crondlog(LVL8
+				"unable to parse argument (--requests) '%s'",
+				requests_str);
+			return NULL;
+		}
+	}
+	if (nreq > 1 && (do_http10 || do_post))
+	{
+		crondlog(LVL8
+		"multiple requests need HTTP/1.1 and a GET or HEAD method");
+		return NULL;
+	}
+
 	if (!parse_url(url, &host, &port, &hostport, &path, &do_tls))
 	{
 		/* Do we need to report an error? */
 		return NULL;
 	}
 
+	/* Additional URLs go over the same connection, so only the path
+	 * can be different.
+	 */
+	paths= npaths ? xzalloc(npaths * sizeof(*paths)) : NULL;
+	for (i= 0; i<npaths; i++)
+	{
+		if (!parse_url(argv[optind+1+i], &url_host, &url_port,
+			&url_hostport, &url_path, &url_tls))
+		{
+			break;
+		}
+		free(url_hostport);
+		if (strcmp(url_host, host) != 0 ||
+			strcmp(url_port, port) != 0 || url_tls != do_tls)
+		{
+			crondlog(LVL8 "url '%s' is not on the same server",
+				argv[optind+1+i]);
+			free(url_host);
+			free(url_port);
+			free(url_path);
+			break;
+		}
+		free(url_host);
+		free(url_port);
+		paths[i]= url_path;
+	}
+	if (i < npaths)
+	{
+		while (i > 0)
+			free(paths[--i]);
+		free(paths);
+		free(host);
+		free(port);
+		free(hostport);
+		free(path);
+		return NULL;
+	}
+
 	if (host_arg)
 	{
 		/* Replace hostport from the URL with host_arg */
@@ -759,6 +892,17 @@ static void *httpget_init(int __attribute((unused)) argc, char *argv[],
 	state->do_head= do_head;
 	state->do_post= do_post;
 	state->do_tls= do_tls;
+	state->tls_resume= tls_resume;
+	state->race= race && !do_all;	/* Racing picks one address */
+	state->dns_nocache= dns_nocache;
+	state->tfo= tfo && !state->race;
+	state->body_digest= body_digest;
+	state->nreq= nreq;
+	state->pipeline= pipeline && nreq > 1;
+	state->paths= paths;
+	state->npaths= npaths;
+	if (nreq > 1)
+		state->reqs= xzalloc(nreq * sizeof(*state->reqs));
 	state->post_header= validated_post_header;
 		validated_post_header= NULL;
 	state->post_file= validated_post_file;
@@ -781,8 +925,8 @@ static void *httpget_init(int __attribute((unused)) argc, char *argv[],
 	
 	if (do_eetim)
 		state->etim= 2;
-	else if (do_etim)
-		state->etim= 1;
+	else if (do_etim || nreq > 1)
+		state->etim= 1;	/* Connection timings for multiple requests */
 	else
 		state->etim= 0;
 
@@ -790,10 +934,8 @@ static void *httpget_init(int __attribute((unused)) argc, char *argv[],
 	//evtimer_assign(&state->timer, state->base->event_base,
 	//	timeout_callback, state);
 
-	state->line= NULL;
-	state->linemax= 0;
-	state->linelen= 0;
-	state->lineoffset= 0;
+	state->inbuf= NULL;
+	state->inlen= 0;
 
 	for (i= 0; i<hg_base->tabsiz; i++)
 	{
@@ -920,6 +1062,9 @@ static void report(struct hgstate *state)
 			add_str(state, line);
 		}
 
+		if (state->race && state->tu_env.nattempts > 0)
+			report_attempts(state);
+
 		/* End of readtiming */
 		if (state->etim >= 2)
 		{
@@ -942,6 +1087,22 @@ static void report(struct hgstate *state)
 		snprintf(line, sizeof(line), ", " DBQ(src_addr) ":" DBQ(%s),
 			namebuf);
 		add_str(state, line);
+
+		if (state->do_tls && state->tls_resume)
+		{
+			add_str(state, state->tls_resumed ?
+				", " DBQ(resumed) ": true" :
+				", " DBQ(resumed) ": false");
+		}
+
+		if (state->tfo)
+		{
+			snprintf(line, sizeof(line), ", " DBQ(tfo) ":" DBQ(%s),
+				state->tfo_result ? state->tfo_result :
+				state->response_in ? "none" :
+				tu_tfo_result(&state->tu_env, NULL));
+			add_str(state, line);
+		}
 	}
 
 	done= (state->readstate == READ_DONE);
@@ -970,8 +1131,22 @@ static void report(struct hgstate *state)
 				state->ttfb);
 			add_str(state, line);
 		}
+		if (state->body_digest && !state->reqs)
+		{
+			unsigned char digest[32];
+			char hex[2*sizeof(digest)+1];
+
+			sha256_end(&state->body_ctx, digest);
+			*bin2hex(hex, (char *)digest, sizeof(digest))= '\0';
+			snprintf(line, sizeof(line),
+				", " DBQ(bsha256) ":" DBQ(%s), hex);
+			add_str(state, line);
+		}
 	}
 
+	if (state->reqs && !state->connecting && !state->dnserr)
+		report_requests(state);
+
 	if (!state->dnserr)
 	{
 		add_str(state, " }");
@@ -1001,11 +1176,10 @@ static void report(struct hgstate *state)
 		tu_restart_connect(&state->tu_env);
 		return;
 	}
-	if (state->linemax)
+	if (state->inbuf)
 	{
-		state->linemax= 0;
-		free(state->line);
-		state->line= NULL;
+		evbuffer_free(state->inbuf);
+		state->inbuf= NULL;
 	}
 
 	state->bev= NULL;
@@ -1024,42 +1198,27 @@ static void report(struct hgstate *state)
 		state->base->done(state, 0);
 }
 
-static int get_input(struct hgstate *state)
+/* The input is parsed in place. New data in the input buffer is only looked
+ * at after it has been accounted for (readtiming, read limit, response
+ * file) by get_input.
+ */
+static struct evbuffer *get_inbuf(struct hgstate *state)
+{
+	if (state->response_in)
+		return state->inbuf;
+	return bufferevent_get_input(state->bev);
+}
+
+static int get_input(struct hgstate *state, struct evbuffer *input)
 {
 	int n;
 	double t;
+	size_t len, off;
 	struct timespec endtime;
+	struct evbuffer_iovec iov;
+	struct evbuffer_ptr pos;
 	char line[80];
 
-	/* Assume that we always end up with a full buffer anyway */
-	if (state->linemax == 0)
-	{
-		if (state->line)
-			crondlog(DIE9 "line is not empty");
-
-		state->linemax= MAX_LINE_LEN;
-		state->line= xmalloc(state->linemax);
-	}
-
-	if (state->lineoffset)
-	{
-		if (state->linelen > state->lineoffset)
-		{
-			memmove(state->line, &state->line[state->lineoffset],
-				state->linelen-state->lineoffset);
-			state->linelen -= state->lineoffset;
-		}
-		else
-		{
-			state->linelen= 0;
-		}
-		state->lineoffset= 0;
-	}
-	if (state->linelen >= state->linemax)
-	{
-		return -1;	/* We cannot get more data */
-	}
-
 	if (state->etim >= 2 && state->report_roffset)
 	{
 		gettime_mono(&endtime);
@@ -1078,29 +1237,92 @@ static int get_input(struct hgstate *state)
 	{
 		size_t tmplen;
 
-		tmplen= state->linemax-state->linelen;
+		if (evbuffer_reserve_space(input, MAX_PACKET_LEN, &iov, 1) < 1)
+			return -1;
+		tmplen= MAX_PACKET_LEN;
 		read_response_file(state->resp_file, RESP_PACKET,
-			&tmplen, &state->line[state->linelen]);
+			&tmplen, iov.iov_base);
+		iov.iov_len= tmplen;
+		if (evbuffer_commit_space(input, &iov, 1) == -1)
+			return -1;
 		n= tmplen;
 	}
 	else
-	{
-		n= bufferevent_read(state->bev,
-			&state->line[state->linelen],
-			state->linemax-state->linelen);
-	}
-	if (n < 0)
-		return -1;
+		n= evbuffer_get_length(input)-state->inlen;
 	if (state->response_out)
 	{
-		write_response(state->resp_file, RESP_PACKET,
-				n, &state->line[state->linelen]);
+		/* Record the new data as it is, in pieces that fit the
+		 * buffer used when replaying.
+		 */
+		for (off= state->inlen; off < state->inlen+n; off += len)
+		{
+			evbuffer_ptr_set(input, &pos, off, EVBUFFER_PTR_SET);
+			evbuffer_peek(input, -1, &pos, &iov, 1);
+			len= iov.iov_len;
+			if (len > MAX_PACKET_LEN)
+				len= MAX_PACKET_LEN;
+			write_response(state->resp_file, RESP_PACKET,
+				len, iov.iov_base);
+		}
 	}
-	state->linelen += n;
+	state->inlen += n;
 	state->roffset += n;
 	return 0;
 }
 
+/* Length of the next line in the input, including the '\n'. Returns 0 if
+ * there is no complete line yet and -1 if the line is too long.
+ */
+static ssize_t find_line(struct hgstate *state, struct evbuffer *input)
+{
+	struct evbuffer_ptr pos;
+
+	pos= evbuffer_search_eol(input, NULL, NULL, EVBUFFER_EOL_LF);
+	if (pos.pos != -1 && pos.pos < state->inlen)
+	{
+		if (pos.pos >= MAX_LINE_LEN)
+			return -1;
+		return pos.pos+1;
+	}
+	if (state->inlen >= MAX_LINE_LEN)
+		return -1;
+	return 0;
+}
+
+static void consume(struct hgstate *state, struct evbuffer *input,
+	size_t len)
+{
+	evbuffer_drain(input, len);
+	state->inlen -= len;
+}
+
+/* Account for len bytes of body at the start of the input and drop them */
+static void consume_body(struct hgstate *state, struct evbuffer *input,
+	size_t len)
+{
+	size_t chunk;
+	struct evbuffer_iovec iov;
+
+	state->content_offset += len;
+	if (!state->body_digest)
+	{
+		consume(state, input, len);
+		return;
+	}
+
+	/* Hash the body where it is, one buffer chain at a time */
+	while (len > 0)
+	{
+		evbuffer_peek(input, len, NULL, &iov, 1);
+		chunk= iov.iov_len;
+		if (chunk > len)
+			chunk= len;
+		sha256_hash(&state->body_ctx, iov.iov_base, chunk);
+		consume(state, input, chunk);
+		len -= chunk;
+	}
+}
+
 static void skip_spaces(const char *cp, char **ncp)
 {
 	const unsigned char *ucp;
@@ -1111,6 +1333,98 @@ static void skip_spaces(const char *cp, char **ncp)
 	*ncp= (char *)ucp;
 }
 
+/* Per-attempt results of a connection race */
+static void report_attempts(struct hgstate *state)
+{
+	int i;
+	struct tu_attempt *att;
+	static const char *results[]=
+		{ "connecting", "connected", "failed", "cancelled" };
+	char namebuf[NI_MAXHOST];
+	char line[NI_MAXHOST+128];
+
+	add_str(state, ", " DBQ(attempts) ": [ ");
+	for (i= 0; i<state->tu_env.nattempts; i++)
+	{
+		att= &state->tu_env.attempts[i];
+		getnameinfo((struct sockaddr *)&att->addr, att->addrlen,
+			namebuf, sizeof(namebuf), NULL, 0, NI_NUMERICHOST);
+		snprintf(line, sizeof(line), "%s{ " DBQ(dst_addr) ":" DBQ(%s)
+			", " DBQ(start) ":%f, ",
+			i == 0 ? "" : ", ", namebuf, att->start);
+		add_str(state, line);
+
+		/* An attempt still connecting has no end yet */
+		if (att->state == TU_ATTEMPT_CONNECTING)
+			add_str(state, DBQ(time) ":null, ");
+		else
+		{
+			snprintf(line, sizeof(line), DBQ(time) ":%f, ",
+				att->end - att->start);
+			add_str(state, line);
+		}
+		snprintf(line, sizeof(line), DBQ(result) ":" DBQ(%s),
+			results[att->state]);
+		add_str(state, line);
+		if (att->state == TU_ATTEMPT_FAILED)
+		{
+			snprintf(line, sizeof(line), ", " DBQ(err) ":" DBQ(%s),
+				att->err);
+			add_str(state, line);
+		}
+		add_str(state, " }");
+	}
+	add_str(state, " ]");
+}
+
+/* Path of request req, cycling through the URLs */
+static char *req_path(struct hgstate *state, int req)
+{
+	req %= state->npaths+1;
+	return req == 0 ? state->path : state->paths[req-1];
+}
+
+/* Per-request results of a persistent connection */
+static void report_requests(struct hgstate *state)
+{
+	int i;
+	struct hgreq *req;
+	char line[256];
+
+	snprintf(line, sizeof(line), ", " DBQ(nreq) ":%d, " DBQ(pipeline)
+		": %s, " DBQ(requests) ": [ ", state->nreq,
+		state->pipeline ? "true" : "false");
+	add_str(state, line);
+	for (i= 0; i<state->req_done; i++)
+	{
+		req= &state->reqs[i];
+		add_str(state, i == 0 ? "{ " DBQ(path) ":\"" :
+			", { " DBQ(path) ":\"");
+		add_str_quoted(state, req_path(state, i));
+		snprintf(line, sizeof(line), "\", " DBQ(res) ":%d"
+			", " DBQ(ver) ":" DBQ(%d.%d)
+			", " DBQ(hsize) ":%d"
+			", " DBQ(bsize) ":%d"
+			", " DBQ(ttfb) ":%f"
+			", " DBQ(rt) ":%f",
+			req->http_result,
+			req->res_major, req->res_minor,
+			req->headers_size,
+			req->content_offset,
+			req->ttfb,
+			req->rt);
+		add_str(state, line);
+		if (state->body_digest)
+		{
+			snprintf(line, sizeof(line),
+				", " DBQ(bsha256) ":" DBQ(%s), req->digest);
+			add_str(state, line);
+		}
+		add_str(state, " }");
+	}
+	add_str(state, " ]");
+}
+
 static void add_str(struct hgstate *state, const char *str)
 {
 	size_t len;
@@ -1180,7 +1494,7 @@ static void err_header(struct hgstate *state, const char *reason)
 {
 	char line[80];
 
-	if (state->max_headers != 0)
+	if (state->hdr_limit != 0)
 		add_str(state, " ], ");
 	snprintf(line, sizeof(line),
 		DBQ(err) ":" DBQ(bad header line: %s) ", ", reason);
@@ -1197,20 +1511,66 @@ static void err_chunked(struct hgstate *state, const char *reason)
 	report(state);
 }
 
-static void readcb(struct bufferevent *bev UNUSED_PARAM, void *ptr)
+/* Record the result of the current response on a persistent connection */
+static void finish_request(struct hgstate *state, struct timespec *endtime)
+{
+	unsigned char digest[32];
+	struct hgreq *req;
+
+	req= &state->reqs[state->req_done];
+	req->rt= (endtime->tv_sec-req->sent.tv_sec)*1e3 +
+		(endtime->tv_nsec-req->sent.tv_nsec)/1e6;
+	req->http_result= state->http_result;
+	req->res_major= state->res_major;
+	req->res_minor= state->res_minor;
+	req->headers_size= state->headers_size;
+	req->content_offset= state->content_offset;
+	if (state->body_digest)
+	{
+		sha256_end(&state->body_ctx, digest);
+		*bin2hex(req->digest, (char *)digest, sizeof(digest))= '\0';
+	}
+	state->req_done++;
+}
+
+/* Get ready to read the next response on the same connection */
+static void next_response(struct hgstate *state)
+{
+	state->readstate= READ_FIRST;
+	state->hdr_limit= 0;	/* Only the headers of the first response */
+	state->headers_size= 0;
+	state->tot_headers= 0;
+	state->chunked= 0;
+	state->content_offset= 0;
+}
+
+static void readcb(struct bufferevent *bev, void *ptr)
 {
 	int r, major, minor, need_line, no_body;
-	size_t len;
+	size_t len, drain;
+	ssize_t linelen;
 	char *cp, *ncp, *check, *line;
 	const char *prefix, *kw;
 	struct hgstate *state;
+	struct hgreq *req;
+	struct evbuffer *input;
 	struct timespec endtime;
 
 	state= ENV2STATE(ptr);
+	input= get_inbuf(state);
 
 	state->report_roffset= 1;
+	line= NULL;
+	drain= 0;
 	for (;;)
 	{
+		/* Drop the line that was handled in the previous round */
+		if (drain)
+		{
+			consume(state, input, drain);
+			drain= 0;
+		}
+
 		if (state->read_limit > 0 &&
 			state->roffset >= state->read_limit)
 		{
@@ -1232,12 +1592,42 @@ static void readcb(struct bufferevent *bev UNUSED_PARAM, void *ptr)
 		switch(state->readstate)
 		{
 		case READ_FIRST:
+			if (state->req_done > 0 && state->inlen == 0)
+			{
+				/* Wait for the first byte of the next
+				 * response.
+				 */
+				r= get_input(state, input);
+				if (r == -1)
+				{
+					printf(
+			"readcb: get_input failed, should do something\n");
+					return;
+				}
+				if (state->inlen == 0)
+					return;
+			}
 			gettime_mono(&endtime);
+			state->readstate= READ_STATUS;
+			if (state->reqs)
+			{
+				req= &state->reqs[state->req_done];
+				req->ttfb= (endtime.tv_sec-
+					req->sent.tv_sec)*1e3 +
+					(endtime.tv_nsec-req->sent.tv_nsec)/1e6;
+				if (state->req_done > 0)
+					continue;
+			}
 			state->ttfb= (endtime.tv_sec-
 				state->start.tv_sec)*1e3 +
 				(endtime.tv_nsec-state->start.tv_nsec)/1e6;
-			state->readstate= READ_STATUS;
 			state->roffset= 0;
+			if (state->tfo && !state->response_in)
+			{
+				/* The handshake is done by now */
+				state->tfo_result= tu_tfo_result(
+					&state->tu_env, state->bev);
+			}
 			if (state->etim >= 2)
 				add_str2(state, ", " DBQ(readtiming) ": [");
 			continue;
@@ -1256,11 +1646,10 @@ static void readcb(struct bufferevent *bev UNUSED_PARAM, void *ptr)
 		if (need_line)
 		{
 			/* Wait for a complete line */
-			if (state->linemax == 0 ||
-				memchr(&state->line[state->lineoffset], '\n',
-				state->linelen-state->lineoffset) == NULL)
+			linelen= find_line(state, input);
+			if (linelen == 0)
 			{
-				r= get_input(state);
+				r= get_input(state, input);
 				if (r == -1)
 				{
 					printf(
@@ -1269,28 +1658,27 @@ static void readcb(struct bufferevent *bev UNUSED_PARAM, void *ptr)
 				}
 
 				/* Did we get what we want? */
-				if (memchr(&state->line[state->lineoffset],
-					'\n', state->linelen-state->lineoffset)
-					== NULL)
+				linelen= find_line(state, input);
+			}
+			if (linelen <= 0)
+			{
+				/* No */
+				if (linelen == -1)
 				{
-					/* No */
-					if (state->linelen-state->lineoffset >=
-						MAX_LINE_LEN)
-					{
-						add_str(state, DBQ(err) ":"
-							DBQ(line too long)
-							", ");
-						report(state);
-					}
-					return;
+					add_str(state, DBQ(err) ":"
+						DBQ(line too long) ", ");
+					report(state);
 				}
+				return;
 			}
+
+			/* Usually already contiguous, so no copy */
+			line= (char *)evbuffer_pullup(input, linelen);
 		}
 
 		switch(state->readstate)
 		{
 		case READ_STATUS:
-			line= &state->line[state->lineoffset];
 			cp= strchr(line, '\n');
 			if (cp == NULL)
 			{
@@ -1299,7 +1687,7 @@ static void readcb(struct bufferevent *bev UNUSED_PARAM, void *ptr)
 				return;
 			}
 
-			state->lineoffset += (cp-line+1);
+			drain= (cp-line+1);
 
 			cp[0]= '\0';
 			if (cp > line && cp[-1] == '\r')
@@ -1342,10 +1730,13 @@ static void readcb(struct bufferevent *bev UNUSED_PARAM, void *ptr)
 			state->res_major= major;
 			state->res_minor= minor;
 
+			if (state->body_digest)
+				sha256_begin(&state->body_ctx);
+
 			state->readstate= READ_HEADER;
 			state->content_length= -1;
 
-			if (state->max_headers)
+			if (state->hdr_limit)
 			{
 				add_str(state, DBQ(header) ": [");
 			}
@@ -1353,7 +1744,6 @@ static void readcb(struct bufferevent *bev UNUSED_PARAM, void *ptr)
 			continue;
 
 		case READ_HEADER:
-			line= &state->line[state->lineoffset];
 			cp= strchr(line, '\n');
 			if (cp == NULL)
 			{
@@ -1362,7 +1752,7 @@ static void readcb(struct bufferevent *bev UNUSED_PARAM, void *ptr)
 			}
 
 			len= (cp-line+1);
-			state->lineoffset += len;
+			drain= len;
 
 			cp[0]= '\0';
 			if (cp > line && cp[-1] == '\r')
@@ -1370,14 +1760,14 @@ static void readcb(struct bufferevent *bev UNUSED_PARAM, void *ptr)
 
 			if (line[0] == '\0')
 			{
-				if (state->tot_headers <= state->max_headers &&
-					state->max_headers != 0)
+				if (state->tot_headers <= state->hdr_limit &&
+					state->hdr_limit != 0)
 				{
 					if (state->tot_headers != 0)
 						add_str(state, ",");
 					add_str(state, " \"\"");
 				}
-				if (state->max_headers)
+				if (state->hdr_limit)
 					add_str(state, " ], ");
 				state->readstate= READ_BODY;
 				continue;
@@ -1386,7 +1776,7 @@ static void readcb(struct bufferevent *bev UNUSED_PARAM, void *ptr)
 			state->headers_size += len;
 
 			len= strlen(line);
-			if (state->tot_headers+len+1 <= state->max_headers)
+			if (state->tot_headers+len+1 <= state->hdr_limit)
 			{
 				if (state->tot_headers != 0)
 					add_str(state, ",");
@@ -1394,17 +1784,17 @@ static void readcb(struct bufferevent *bev UNUSED_PARAM, void *ptr)
 				add_str_quoted(state, line);
 				add_str(state, "\"");
 				state->tot_headers += len;
-			} else if (state->tot_headers <= state->max_headers &&
-				state->max_headers != 0)
+			} else if (state->tot_headers <= state->hdr_limit &&
+				state->hdr_limit != 0)
 			{
 				/* Fill up remaining space and report
 				 * truncation */
 				if (state->tot_headers != 0)
 					add_str(state, ",");
 				add_str(state, " \"");
-				if (state->tot_headers < state->max_headers)
+				if (state->tot_headers < state->hdr_limit)
 				{
-					line[state->max_headers-
+					line[state->hdr_limit-
 						state->tot_headers]= '\0';
 					add_str_quoted(state, line);
 				}
@@ -1528,7 +1918,6 @@ static void readcb(struct bufferevent *bev UNUSED_PARAM, void *ptr)
 			continue;
 
 		case READ_CHUNKED:
-			line= &state->line[state->lineoffset];
 			cp= strchr(line, '\n');
 			if (cp == NULL)
 			{
@@ -1537,7 +1926,7 @@ static void readcb(struct bufferevent *bev UNUSED_PARAM, void *ptr)
 			}
 
 			len= (cp-line+1);
-			state->lineoffset += len;
+			drain= len;
 
 			cp[0]= '\0';
 			if (cp > line && cp[-1] == '\r')
@@ -1569,10 +1958,9 @@ static void readcb(struct bufferevent *bev UNUSED_PARAM, void *ptr)
 			}
 
 			/* Do we need more input? */
-			if (state->linemax == 0 ||
-				state->lineoffset >= state->linelen)
+			if (state->inlen == 0)
 			{
-				r= get_input(state);
+				r= get_input(state, input);
 				if (r == -1)
 				{
 					printf(
@@ -1581,14 +1969,14 @@ static void readcb(struct bufferevent *bev UNUSED_PARAM, void *ptr)
 				}
 
 				/* Did we get what we want? */
-				if (state->lineoffset >= state->linelen)
+				if (state->inlen == 0)
 				{
 					/* No */
 					return;
 				}
 			}
 
-			len= state->linelen-state->lineoffset;
+			len= state->inlen;
 			if (state->content_offset+len > state->tot_chunked)
 				len= state->tot_chunked-state->content_offset;
 
@@ -1620,13 +2008,11 @@ static void readcb(struct bufferevent *bev UNUSED_PARAM, void *ptr)
 				"readcb: should add truncation indicator\n");
 			}
 
-			state->content_offset += len;
-			state->lineoffset += len;
+			consume_body(state, input, len);
 
 			continue;
 
 		case READ_CHUNK_END:
-			line= &state->line[state->lineoffset];
 			cp= strchr(line, '\n');
 			if (cp == NULL)
 			{
@@ -1635,7 +2021,7 @@ static void readcb(struct bufferevent *bev UNUSED_PARAM, void *ptr)
 			}
 
 			len= (cp-line+1);
-			state->lineoffset += len;
+			drain= len;
 
 			cp[0]= '\0';
 			if (cp > line && cp[-1] == '\r')
@@ -1652,7 +2038,6 @@ static void readcb(struct bufferevent *bev UNUSED_PARAM, void *ptr)
 			continue;
 
 		case READ_CHUNKED_TRAILER:
-			line= &state->line[state->lineoffset];
 			cp= strchr(line, '\n');
 			if (cp == NULL)
 			{
@@ -1661,7 +2046,7 @@ static void readcb(struct bufferevent *bev UNUSED_PARAM, void *ptr)
 			}
 
 			len= (cp-line+1);
-			state->lineoffset += len;
+			drain= len;
 
 			cp[0]= '\0';
 			if (cp > line && cp[-1] == '\r')
@@ -1683,10 +2068,9 @@ static void readcb(struct bufferevent *bev UNUSED_PARAM, void *ptr)
 			}
 
 			/* Do we need more input? */
-			if (state->linemax == 0 ||
-				state->lineoffset >= state->linelen)
+			if (state->inlen == 0)
 			{
-				r= get_input(state);
+				r= get_input(state, input);
 				if (r == -1)
 				{
 					printf(
@@ -1695,14 +2079,26 @@ static void readcb(struct bufferevent *bev UNUSED_PARAM, void *ptr)
 				}
 
 				/* Did we get what we want? */
-				if (state->lineoffset >= state->linelen)
+				if (state->inlen == 0)
 				{
 					/* No */
 					return;
 				}
 			}
 
-			len= state->linelen-state->lineoffset;
+			len= state->inlen;
+
+			/* The next response may follow the body in the same
+			 * read.
+			 */
+			if (state->content_length >= 0 &&
+				state->content_offset+len >
+				state->content_length)
+			{
+				len= state->content_length-
+					state->content_offset;
+			}
+
 			if (state->content_offset+len <= state->max_body)
 			{
 #if 0
@@ -1731,16 +2127,30 @@ static void readcb(struct bufferevent *bev UNUSED_PARAM, void *ptr)
 				"readcb: should add truncation indicator\n");
 			}
 
-			state->content_offset += len;
-			state->lineoffset += len;
+			consume_body(state, input, len);
 
 			continue;
 
 		case READ_DONE:
 			if (state->bev || state->response_in)
 			{
-				state->bev= NULL;
 				gettime_mono(&endtime);
+				if (state->reqs)
+				{
+					finish_request(state, &endtime);
+					if (state->req_done < state->nreq)
+					{
+						next_response(state);
+						if (!state->pipeline)
+						{
+							state->writestate=
+								WRITE_HEADER;
+							writecb(bev, ptr);
+						}
+						continue;
+					}
+				}
+				state->bev= NULL;
 				state->resptime=
 					(endtime.tv_sec-
 					state->start.tv_sec)*1e3 +
@@ -1795,13 +2205,71 @@ static int post_file(struct hgstate *state, const char *filename)
 	return r;
 }
 
+/* Queue the next request. Without output (replay) only the bookkeeping
+ * is done.
+ */
+static void send_request(struct hgstate *state, struct evbuffer *output)
+{
+	int last;
+	off_t cLength;
+	struct stat sb;
+
+	last= (state->req_sent == state->nreq-1);
+	if (state->reqs)
+		gettime_mono(&state->reqs[state->req_sent].sent);
+	state->req_sent++;
+
+	if (!output)
+		return;
+
+	evbuffer_add_printf(output, "%s %s HTTP/1.%c\r\n",
+		state->do_get ? "GET" :
+		state->do_head ? "HEAD" : "POST",
+		req_path(state, state->req_sent-1),
+		state->do_http10 ? '0' : '1');
+	evbuffer_add_printf(output, "Host: %s\r\n",
+		state->hostport);
+	if (last)
+		evbuffer_add_printf(output, "Connection: close\r\n");
+	evbuffer_add_printf(output, "User-Agent: %s\r\n",
+		state->user_agent);
+	if (state->do_post)
+	{
+		evbuffer_add_printf(output,
+		"Content-Type: application/x-www-form-urlencoded\r\n");
+	}
+
+	cLength= 0;
+	if (state->do_post)
+	{
+		if (state->post_header)
+		{
+			if (stat(state->post_header, &sb) == 0)
+				cLength  +=  sb.st_size;
+		}
+		if (state->post_file)
+		{
+			if (stat(state->post_file, &sb) == 0)
+				cLength  +=  sb.st_size;
+		}
+		if (state->post_footer)
+		{
+			if (stat(state->post_footer, &sb) == 0)
+				cLength  +=  sb.st_size;
+		}
+		evbuffer_add_printf(output,
+			"Content-Length: %lu\r\n",
+			(unsigned long)cLength);
+	}
+
+	evbuffer_add_printf(output, "\r\n");
+}
+
 static void writecb(struct bufferevent *bev, void *ptr)
 {
 	int r;
 	struct hgstate *state;
 	struct evbuffer *output;
-	off_t cLength;
-	struct stat sb;
 	struct timespec endtime;
 
 	state= ENV2STATE(ptr);
@@ -1822,51 +2290,19 @@ static void writecb(struct bufferevent *bev, void *ptr)
 			state->writestate= WRITE_HEADER;
 			continue;
 		case WRITE_HEADER:
+			output= NULL;
+			if (!state->response_in)
+				output= bufferevent_get_output(bev);
+			do
+			{
+				send_request(state, output);
+			} while (state->pipeline &&
+				state->req_sent < state->nreq);
 			if (state->response_in)
 			{
 				state->writestate = WRITE_DONE;
 				continue;
 			}
-			output= bufferevent_get_output(bev);
-			evbuffer_add_printf(output, "%s %s HTTP/1.%c\r\n",
-				state->do_get ? "GET" :
-				state->do_head ? "HEAD" : "POST", state->path,
-				state->do_http10 ? '0' : '1');
-			evbuffer_add_printf(output, "Host: %s\r\n",
-				state->hostport);
-			evbuffer_add_printf(output, "Connection: close\r\n");
-			evbuffer_add_printf(output, "User-Agent: %s\r\n",
-				state->user_agent);
-			if (state->do_post)
-			{
-				evbuffer_add_printf(output,
-			"Content-Type: application/x-www-form-urlencoded\r\n");
-			}
-
-			cLength= 0;
-			if (state->do_post)
-			{
-				if (state->post_header)
-				{
-					if (stat(state->post_header, &sb) == 0)
-						cLength  +=  sb.st_size;
-				}
-				if (state->post_file)
-				{
-					if (stat(state->post_file, &sb) == 0)
-						cLength  +=  sb.st_size;
-				}
-				if (state->post_footer)
-				{
-					if (stat(state->post_footer, &sb) == 0)
-						cLength  +=  sb.st_size;
-				}
-				evbuffer_add_printf(output,
-					"Content-Length: %lu\r\n",
-					(unsigned long)cLength);
-			}
-
-			evbuffer_add_printf(output, "\r\n");
 			if (state->do_post)
 				state->writestate = WRITE_POST_HEADER;
 			else
@@ -1938,7 +2374,7 @@ static void err_reading(struct hgstate *state)
 		report(state);
 		break;
 	case READ_HEADER:
-		if (state->max_headers)
+		if (state->hdr_limit)
 			add_str(state, " ], ");
 		add_str(state, DBQ(err) ":" DBQ(error reading headers) ", ");
 		report(state);
@@ -1948,17 +2384,19 @@ static void err_reading(struct hgstate *state)
 		if (state->max_body)
 			add_str(state, " ]");
 #endif
+		gettime_mono(&endtime);
 		if (state->content_length == -1)
 		{
 			/* EOF is normal */
 			state->readstate= READ_DONE;
+			if (state->reqs)
+				finish_request(state, &endtime);
 		}
 		else
 		{
 			add_str(state, DBQ(err) ":" DBQ(error reading body)
 				", ");
 		}
-		gettime_mono(&endtime);
 		state->resptime= (endtime.tv_sec-state->start.tv_sec)*1e3 +
 			(endtime.tv_nsec-state->start.tv_nsec)/1e6;
 		report(state);
@@ -1994,12 +2432,16 @@ static void beforeconnect(struct tu_env *env,
 	}
 
 	state->connecting= 1;
+	state->tls_resumed= 0;
+	state->tfo_result= NULL;
 	state->in_writecb= 0;
 	state->readstate= READ_FIRST;
 	state->writestate= WRITE_FIRST;
 
-	state->linelen= 0;
-	state->lineoffset= 0;
+	state->inlen= 0;
+	state->hdr_limit= state->max_headers;
+	state->req_sent= 0;
+	state->req_done= 0;
 	state->headers_size= 0;
 	state->tot_headers= 0;
 	state->roffset= 0;
@@ -2101,6 +2543,15 @@ static void connected(struct tu_env *env, struct bufferevent *bev)
 
 	state->connecting= 0;
 	state->bev= bev;
+	state->tls_resumed= env->tls_resumed;
+	if (state->race && !state->response_in)
+	{
+		/* The winner of the race */
+		state->socklen= env->dns_curr->ai_addrlen;
+		memcpy(&state->sin6, env->dns_curr->ai_addr, state->socklen);
+		if (state->response_out)
+			write_attempts(state);
+	}
 
 	state->loc_socklen= sizeof(state->loc_sin6);
 	if (state->response_in)
@@ -2125,9 +2576,63 @@ static void connected(struct tu_env *env, struct bufferevent *bev)
 	}
 }
 
+/* Record the attempts of a race, they are replayed instead of racing */
+static void write_attempts(struct hgstate *state)
+{
+	int i;
+
+	for (i= 0; i<state->tu_env.nattempts; i++)
+	{
+		write_response(state->resp_file, RESP_ATTEMPT,
+			sizeof(state->tu_env.attempts[i]),
+			&state->tu_env.attempts[i]);
+	}
+}
+
+static void read_attempts(struct hgstate *state)
+{
+	int type;
+	size_t len;
+	struct tu_attempt *att;
+	struct timespec now;
+
+	state->tu_env.nattempts= 0;
+	if (!state->tu_env.attempts)
+	{
+		state->tu_env.attempts= xzalloc(TU_ATTEMPT_MAX *
+			sizeof(*state->tu_env.attempts));
+	}
+	for (;;)
+	{
+		peek_response_file(state->resp_file, &type);
+		if (type != RESP_ATTEMPT ||
+			state->tu_env.nattempts >= TU_ATTEMPT_MAX)
+		{
+			break;
+		}
+		att= &state->tu_env.attempts[state->tu_env.nattempts++];
+		len= sizeof(*att);
+		read_response_file(state->resp_file, RESP_ATTEMPT, &len, att);
+		att->ai= NULL;
+		att->bev= NULL;
+
+		/* Emulate the clock readings at its start and end */
+		gettime_mono(&now);
+		gettime_mono(&now);
+
+		if (att->state == TU_ATTEMPT_CONNECTED)
+		{
+			/* The winner of the race */
+			state->socklen= att->addrlen;
+			memcpy(&state->sin6, &att->addr, state->socklen);
+		}
+	}
+}
+
 static void httpget_start(void *state)
 {
 	int type;
+	unsigned flags;
 	size_t len;
 	struct hgstate *hgstate;
 	struct evutil_addrinfo hints;
@@ -2199,11 +2704,19 @@ static void httpget_start(void *state)
 		/* Start time */
 		gettime_mono(&hgstate->start);
 
+		if (hgstate->race)
+			read_attempts(hgstate);
+
 		gettime_mono(&endtime);
 		hgstate->ttc= (endtime.tv_sec- hgstate->start.tv_sec)*1e3 +
 			(endtime.tv_nsec-hgstate->start.tv_nsec)/1e6;
 
 		hgstate->readstate= READ_FIRST;
+		hgstate->inbuf= evbuffer_new();
+		hgstate->inlen= 0;
+		hgstate->hdr_limit= hgstate->max_headers;
+		hgstate->req_sent= 0;
+		hgstate->req_done= 0;
 
 		connected(&hgstate->tu_env, NULL);
 
@@ -2225,8 +2738,19 @@ static void httpget_start(void *state)
 	}
 	else
 	{
+		flags= 0;
+		if (hgstate->do_tls)
+			flags |= TU_F_TLS;
+		if (hgstate->tls_resume)
+			flags |= TU_F_TLS_RESUME;
+		if (hgstate->race)
+			flags |= TU_F_RACE;
+		if (hgstate->dns_nocache)
+			flags |= TU_F_DNS_NOCACHE;
+		if (hgstate->tfo)
+			flags |= TU_F_TFO;
 		tu_connect_to_name(&hgstate->tu_env, hgstate->host,
-			hgstate->do_tls, 0, hgstate->port,
+			flags, hgstate->port,
 			&interval, &hints, hgstate->infname,
 			hgstate->sni, NULL,
 			timeout_callback,
@@ -2237,7 +2761,7 @@ static void httpget_start(void *state)
 
 static int httpget_delete(void *state)
 {
-	int ind;
+	int i, ind;
 	struct hgstate *hgstate;
 	struct hgbase *base;
 
@@ -2249,8 +2773,8 @@ static int httpget_delete(void *state)
 	if (hgstate->busy)
 		return 0;
 
-	if (hgstate->line)
-		crondlog(DIE9 "line is not empty");
+	if (hgstate->inbuf)
+		crondlog(DIE9 "inbuf is not empty");
 
 	base= hgstate->base;
 	ind= hgstate->index;
@@ -2277,6 +2801,12 @@ static int httpget_delete(void *state)
 	hgstate->port= NULL;
 	free(hgstate->path);
 	hgstate->path= NULL;
+	for (i= 0; i<hgstate->npaths; i++)
+		free(hgstate->paths[i]);
+	free(hgstate->paths);
+	hgstate->paths= NULL;
+	free(hgstate->reqs);
+	hgstate->reqs= NULL;
 	free(hgstate->sni);
 	hgstate->sni= NULL;
 	free(hgstate->user_agent);
@@ -2287,6 +2817,8 @@ static int httpget_delete(void *state)
 	hgstate->post_file= NULL;
 	free(hgstate->post_footer);
 	hgstate->post_footer= NULL;
+	free(hgstate->tu_env.attempts);	/* Replay doesn't call tu_cleanup */
+	hgstate->tu_env.attempts= NULL;
 
 	free(hgstate);
 
@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2026 RIPE NCC <atlas@ripe.net>
+ * Licensed under GPLv2 or later, see file LICENSE in this tarball for details.
+ * icmperr.c
+ */
+
+#include "libbb.h"
+#include <netinet/ip.h>
+#include <netinet/ip_icmp.h>
+#include <netinet/ip6.h>
+#include <netinet/icmp6.h>
+
+#include "icmperr.h"
+
+/* Routers that predate RFC 4884 put extensions after the first 128 bytes
+ * of the quoted packet.
+ */
+#define PRE4884_PREFIX	128
+
+static void find_ext(struct icmperr *ie, size_t prefixlen)
+{
+	if (prefixlen != 0)
+	{
+		if (ie->icmp_len > 8 + prefixlen)
+		{
+			ie->ext= ie->icmp + 8 + prefixlen;
+			ie->ext_len= ie->icmp_len - 8 - prefixlen;
+		}
+	}
+	else if (ie->icmp_len > 8 + PRE4884_PREFIX)
+	{
+		ie->ext= ie->icmp + 8 + PRE4884_PREFIX;
+		ie->ext_len= ie->icmp_len - 8 - PRE4884_PREFIX;
+		ie->ext_pre4884= 1;
+	}
+}
+
+/* Decode an IPv4 packet, starting at the IP header, as received on a raw
+ * ICMP socket. Returns -1 if the packet is too short for the headers it
+ * claims to have.
+ */
+int icmperr_decode4(const u_char *packet, size_t len, struct icmperr *ie)
+{
+	unsigned hlen, ehlen;
+	const struct ip *eip;
+
+	memset(ie, '\0', sizeof(*ie));
+
+	if (len < sizeof(struct ip))
+		return -1;
+	ie->ip= (const struct ip *)packet;
+	hlen= ie->ip->ip_hl*4;
+	if (ie->ip->ip_hl < 5 || len < hlen + ICMP_MINLEN)
+		return -1;
+
+	ie->icmp= packet + hlen;
+	ie->icmp_len= len - hlen;
+	ie->type= ie->icmp[0];
+	ie->code= ie->icmp[1];
+
+	if (ie->type != ICMP_TIME_EXCEEDED && ie->type != ICMP_DEST_UNREACH &&
+		ie->type != ICMP_PARAMPROB)
+	{
+		return 0;
+	}
+
+	if (ie->icmp_len < ICMP_MINLEN + sizeof(*eip))
+		return -1;
+	eip= (const struct ip *)(ie->icmp + ICMP_MINLEN);
+	ehlen= eip->ip_hl*4;
+	if (eip->ip_hl < 5 || ie->icmp_len < ICMP_MINLEN + ehlen)
+		return -1;
+
+	ie->inner= (const u_char *)eip;
+	ie->proto= eip->ip_p;
+	ie->l4= ie->inner + ehlen;
+	ie->l4_len= ie->icmp_len - ICMP_MINLEN - ehlen;
+
+	/* Length of the quoted packet in 32-bit words */
+	find_ext(ie, ie->icmp[5]*4);
+
+	return 0;
+}
+
+/* Decode an ICMPv6 packet, starting at the ICMPv6 header. The quoted
+ * packet may have hop-by-hop options, a fragment header and destination
+ * options, in that order. For a non-first fragment, l4 is NULL and
+ * frag_later is set.
+ */
+int icmperr_decode6(const u_char *packet, size_t len, struct icmperr *ie)
+{
+	int nxt;
+	size_t offset, optlen;
+	const struct ip6_hdr *eip;
+	const struct ip6_frag *frag;
+	const struct ip6_ext *opthdr;
+
+	memset(ie, '\0', sizeof(*ie));
+
+	if (len < sizeof(struct icmp6_hdr))
+		return -1;
+	ie->icmp= packet;
+	ie->icmp_len= len;
+	ie->type= packet[0];
+	ie->code= packet[1];
+
+	if (ie->type != ICMP6_DST_UNREACH &&
+		ie->type != ICMP6_PACKET_TOO_BIG &&
+		ie->type != ICMP6_TIME_EXCEEDED &&
+		ie->type != ICMP6_PARAM_PROB)
+	{
+		return 0;
+	}
+
+	offset= sizeof(struct icmp6_hdr);
+	if (len < offset + sizeof(*eip))
+		return -1;
+	eip= (const struct ip6_hdr *)(packet + offset);
+	ie->inner= (const u_char *)eip;
+	offset += sizeof(*eip);
+
+	nxt= eip->ip6_nxt;
+	if (nxt == IPPROTO_HOPOPTS)
+	{
+		if (offset + sizeof(*opthdr) > len)
+			return -1;
+		opthdr= (const struct ip6_ext *)(packet + offset);
+		ie->hbhoptsize= 8*opthdr->ip6e_len;
+		optlen= ie->hbhoptsize+8;
+		if (offset + optlen > len)
+			return -1;
+		nxt= opthdr->ip6e_nxt;
+		offset += optlen;
+	}
+	if (nxt == IPPROTO_FRAGMENT)
+	{
+		if (offset + sizeof(*frag) > len)
+			return -1;
+		frag= (const struct ip6_frag *)(packet + offset);
+		nxt= frag->ip6f_nxt;
+		offset += sizeof(*frag);
+		if ((ntohs(frag->ip6f_offlg) & ~3) != 0)
+			ie->frag_later= 1;
+	}
+	if (nxt == IPPROTO_DSTOPTS && !ie->frag_later)
+	{
+		if (offset + sizeof(*opthdr) > len)
+			return -1;
+		opthdr= (const struct ip6_ext *)(packet + offset);
+		ie->dstoptsize= 8*opthdr->ip6e_len;
+		optlen= ie->dstoptsize+8;
+		if (offset + optlen > len)
+			return -1;
+		nxt= opthdr->ip6e_nxt;
+		offset += optlen;
+	}
+
+	ie->proto= nxt;
+	if (!ie->frag_later)
+	{
+		ie->l4= packet + offset;
+		ie->l4_len= len - offset;
+	}
+
+	/* Length of the quoted packet in 64-bit words. Packet too big has
+	 * the MTU there.
+	 */
+	if (ie->type != ICMP6_PACKET_TOO_BIG)
+		find_ext(ie, ie->icmp[4]*8);
+	else
+		find_ext(ie, 0);
+
+	return 0;
+}
@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2026 RIPE NCC <atlas@ripe.net>
+ * Licensed under GPLv2 or later, see file LICENSE in this tarball for details.
+ * icmperr.h
+ */
+
+/* Layout of a received ICMP or ICMPv6 packet. Nothing is copied, all
+ * pointers point into the receive buffer.
+ */
+struct icmperr
+{
+	/* Outer packet */
+	const struct ip *ip;		/* IPv4 header, NULL for IPv6 */
+	const u_char *icmp;		/* ICMP or ICMPv6 header */
+	size_t icmp_len;		/* From icmp to the end of the packet */
+	int type;
+	int code;
+
+	/* Quoted packet, only for errors */
+	const u_char *inner;		/* IP header, NULL if not an error */
+	unsigned hbhoptsize;		/* Size of IPv6 hop-by-hop options */
+	unsigned dstoptsize;		/* Size of IPv6 destination options */
+	int frag_later;			/* Quotes a non-first IPv6 fragment */
+	int proto;			/* Quoted transport protocol */
+	const u_char *l4;		/* Quoted transport header */
+	size_t l4_len;			/* From l4 to the end of the packet */
+
+	/* Multi-part ICMP (RFC 4884), NULL if none */
+	const u_char *ext;
+	size_t ext_len;
+	int ext_pre4884;		/* At the fixed offset of older routers */
+};
+
+int icmperr_decode4(const u_char *packet, size_t len, struct icmperr *ie);
+int icmperr_decode6(const u_char *packet, size_t len, struct icmperr *ie);
@@ -18,6 +18,7 @@
 #include <netinet/udp.h>
 
 #include "eperd.h"
+#include "dnscache.h"
 #include "atlas_path.h"
 
 #define SAFE_PREFIX_REL ATLAS_DATA_NEW_REL
@@ -33,10 +34,11 @@
 
 #define NTP_PORT	123
 
-#define NTP_OPT_STRING ("!46c:i:s:w:A:B:O:R:W:")
+#define NTP_OPT_STRING ("!46Nc:i:s:w:A:B:O:R:W:")
 
 #define OPT_4	(1 << 0)
 #define OPT_6	(1 << 1)
+#define OPT_N	(1 << 2)
 
 #define IPHDR              20
 
@@ -86,6 +88,7 @@ struct ntpstate
 	char *out_filename;
 	char *interface;
 	char do_v6;
+	char dns_nocache;		/* Bypass the DNS cache */
 	char count;
 	uint16_t size;
 	unsigned timeout;
@@ -1103,6 +1106,7 @@ static void *ntp_init(int __attribute((unused)) argc, char *argv[],
 	state->bundle= str_bundle ? strdup(str_bundle) : NULL;
 	state->hostname= strdup(hostname);
 	state->do_v6= do_v6;
+	state->dns_nocache= !!(opt & OPT_N);
 	state->out_filename= validated_out_filename;
 		validated_out_filename= NULL;
 	state->response_in= validated_response_in;
@@ -1477,8 +1481,9 @@ static void ntp_start(void *state)
 		hints.ai_family= ntpstate->do_v6 ? AF_INET6 : AF_INET;
 		ntpstate->dnsip= 1;
 		gettime_mono(&ntpstate->start_time);
-		(void) evdns_getaddrinfo(DnsBase, ntpstate->hostname,
-			ntpstate->destportstr, &hints, dns_cb, ntpstate);
+		dnscache_getaddrinfo(DnsBase, ntpstate->hostname,
+			ntpstate->destportstr, &hints, ntpstate->dns_nocache,
+			dns_cb, ntpstate);
 	}
 }
 
@@ -13,22 +13,26 @@
 #include <event2/event_struct.h>
 
 #include <assert.h>
+#include <math.h>
 #include <netinet/in.h>
 #include <netinet/ip_icmp.h>
 #include <netinet/ip6.h>
 #include <netinet/icmp6.h>
 
 #include "eperd.h"
+#include "dnscache.h"
+#include "icmperr.h"
 #include "atlas_path.h"
 
 #define SAFE_PREFIX_REL ATLAS_DATA_NEW_REL
+#define TARGETS_PREFIX_REL ATLAS_CRONS_REL
 
 /* Don't report psize yet. */
 #define DO_PSIZE	0
 
 #define DBQ(str) "\"" #str "\""
 
-#define PING_OPT_STRING ("!46eprc:s:A:B:O:i:I:R:W:")
+#define PING_OPT_STRING ("!46eprMgqQNc:s:A:B:O:i:I:R:W:F:P:H:")
 
 enum 
 {
@@ -37,11 +41,32 @@ enum
 	opt_e = (1 << 2),
 	opt_p = (1 << 3),
 	opt_r = (1 << 4),
+	opt_M = (1 << 5),
+	opt_g = (1 << 6),
+	opt_q = (1 << 7),
+	opt_Q = (1 << 8),
+	opt_N = (1 << 9),
 };
 
 /* Intervals and timeouts (all are in milliseconds unless otherwise specified)
  */
 #define DEFAULT_PING_INTERVAL   1000           /* 1 sec - 0 means flood mode */
+#define DEFAULT_PING_PACE	10	/* Between packets to different targets
+					 * in multi-target mode
+					 */
+#define MULTI_MIN_WAIT		1000	/* Minimal time to wait for replies
+					 * after the last packet
+					 */
+#define MULTI_MAX_TARGETS	10000
+
+/* High-rate mode */
+#define RATE_MAX		10000	/* Packets per second */
+#define RATE_MAX_COUNT		1000000
+#define RATE_WINDOW		2	/* Seconds of outstanding packets that
+					 * can be matched
+					 */
+#define RATE_MIN_SLOTS		64
+#define RATE_MAX_BURST		64	/* Max. packets sent in one go */
 
 /* Max IP packet size is 65536 while fixed IP header size is 20;
  * the traditional ping program transmits 56 bytes of data, so the
@@ -74,6 +99,8 @@ enum
 #define RESP_DSTADDR		5
 #define RESP_ADDRINFO		6
 #define RESP_ADDRINFO_SA	7
+#define RESP_TIMEOUT		8
+#define RESP_SENDTO		9
 
 /* Definition for various types of counters */
 typedef uint64_t counter_t;
@@ -101,6 +128,118 @@ struct pingbase
 	u_char packet[MAX_DATA_SIZE];
 };
 
+/* Per target state in multi-target mode. This has to be small, a single
+ * measurement can have thousands of targets.
+ */
+struct pingtarget
+{
+	char *hostname;
+	union
+	{
+		struct in_addr in4;
+		struct in6_addr in6;
+	} addr;
+	uint64_t rtt_sum;		/* All RTTs are in microseconds */
+	uint32_t rtt_min;
+	uint32_t rtt_max;
+	uint32_t seen;			/* Bit i: reply to seq_top-i seen */
+	uint16_t seq_top;		/* Highest seq with a reply */
+	uint16_t sent;
+	uint16_t rcvd;
+	uint16_t dup;
+	uint8_t ttl;			/* TTL of the last reply */
+	uint8_t flags;
+};
+
+/* Replies more than this many sequence numbers behind the newest reply of
+ * a target are dropped, they can't be told apart from duplicates.
+ */
+#define TGT_SEEN_WIN	32
+
+#define TGT_F_ADDR	0x01		/* addr is valid */
+#define TGT_F_LITERAL	0x02		/* Given as address literal */
+#define TGT_F_DNS_ERR	0x04		/* Name resolution failed */
+#define TGT_F_BAD_ADDR	0x08		/* Address is not allowed */
+#define TGT_F_SEND_ERR	0x10		/* At least one sendto failed */
+
+struct pingmulti
+{
+	struct pingtarget *targets;
+	unsigned ntargets;
+	unsigned pace;			/* Time between two packets */
+	char grouped;			/* One result for all targets */
+
+	unsigned dns_pending;		/* Outstanding name lookups */
+	unsigned next;			/* Next target to send to */
+	unsigned round;			/* Current round (sequence number) */
+	struct timespec round_start;
+	struct event send_timer;
+};
+
+/* High-rate mode. Replies are matched through a ring of slots indexed
+ * by the low bits of the sequence number. The ring is allocated once, there
+ * are no allocations per packet.
+ */
+struct pingslot
+{
+	uint16_t seq;
+	uint8_t flags;
+};
+
+#define SLOT_F_SENT	0x01
+#define SLOT_F_RCVD	0x02
+
+struct pingrate
+{
+	unsigned rate;			/* Packets per second */
+	struct pingslot *slots;
+	unsigned mask;			/* Number of slots - 1 */
+	struct timespec start;		/* Time the first packet was sent */
+	char done_sending;
+
+	unsigned rcvd;
+	unsigned dup;
+	unsigned late;			/* Reply after the slot was reused */
+	unsigned lost;
+	uint64_t rtt_sum;		/* All RTTs are in microseconds */
+	uint32_t rtt_min;
+	uint32_t rtt_max;
+	uint32_t rtt_last;
+	uint64_t jitter_sum;		/* Sum of RTT differences between
+					 * consecutive replies
+					 */
+
+	struct event send_timer;
+};
+
+/* Summary of RTTs that uses a fixed amount of memory, no matter how many
+ * replies there are. Quantiles are estimated from a histogram with
+ * logarithmic buckets, bucket i holds RTTs up to RTT_GAMMA^i microseconds.
+ * The relative error of a quantile is at most (RTT_GAMMA-1)/2.
+ */
+#define RTT_GAMMA		1.02
+#define RTT_BUCKETS		1024	/* Up to about 10 minutes */
+
+struct rttstats
+{
+	unsigned rcvd;
+	unsigned dup;
+	double min;			/* All in milliseconds */
+	double max;
+	double mean;
+	double m2;			/* Sum of squared differences from the
+					 * mean (Welford)
+					 */
+	uint32_t buckets[RTT_BUCKETS];
+};
+
+/* Context for a name lookup in multi-target mode */
+struct pingmulti_dns
+{
+	struct pingstate *state;
+	unsigned index;
+};
+
 struct pingstate
 {
 	/* Parameters */
@@ -112,6 +251,7 @@ struct pingstate
 	char *out_filename;
 	char include_probe_id;
 	char delay_name_res;
+	char dns_nocache;		/* Bypass the DNS cache */
 	unsigned interval;
 
 	/* State */
@@ -150,9 +290,7 @@ struct pingstate
 	int maxpkts;			/* Number of packets to send */
 
 	int index;                     /* Index into the array of hosts */
-	u_int8_t seq;                  /* ICMP sequence (modulo 256) for next
-					* run
-					*/
+	u_int16_t seq;                 /* ICMP sequence for next run */
 	u_int8_t rcvd_ttl;		/* TTL in (last) reply packet */
 	char dnsip;
 	char send_error;
@@ -173,6 +311,16 @@ struct pingstate
 	char *response_in;
 	char *response_out;
 	FILE *resp_file_out;
+
+	/* Multi-target mode, NULL for a normal ping */
+	struct pingmulti *multi;
+
+	/* High-rate mode, NULL for a normal ping */
+	struct pingrate *rate;
+
+	/* RTT summary, NULL if not requested */
+	struct rttstats *stats;
+	char summary_only;		/* No list of individual RTTs */
 };
 
 /* User Data added to the ICMP header
@@ -189,6 +337,14 @@ struct evdata {
 	struct cookie cookie;
 };
 
+/* In multi-target mode, the index of the target is added after the normal
+ * user data.
+ */
+struct evdata_multi {
+	struct evdata evdata;
+	uint32_t target;
+};
+
 
 static void ready_callback4(int __attribute((unused)) unused,
 	const short __attribute((unused)) event, void * arg);
@@ -218,13 +374,9 @@ static void add_str(struct pingstate *state, const char *str)
 	//printf("add_str: result = '%s'\n", state->result);
 }
 
-static void report(struct pingstate *state)
+static FILE *report_open(struct pingstate *state)
 {
-	int r;
 	FILE *fh;
-	struct addrinfo *ai;
-	char namebuf[NI_MAXHOST];
-	struct addrinfo hints;
 
 	if (state->out_filename)
 	{
@@ -235,7 +387,11 @@ static void report(struct pingstate *state)
 	}
 	else
 		fh= stdout;
+	return fh;
+}
 
+static void report_hdr(FILE *fh, struct pingstate *state)
+{
 	fprintf(fh, "RESULT { ");
 	if (state->atlas)
 	{
@@ -249,6 +405,116 @@ static void report(struct pingstate *state)
 		if (state->bundle_id)
 			fprintf(fh, DBQ(bundle) ":%s, ", state->bundle_id);
 	}
+}
+
+static void rtt_stats_reset(struct rttstats *stats)
+{
+	memset(stats, '\0', sizeof(*stats));
+}
+
+static void rtt_stats_add(struct rttstats *stats, double rtt)
+{
+	int i;
+	double delta, usecs;
+
+	if (stats->rcvd == 0 || rtt < stats->min)
+		stats->min= rtt;
+	if (rtt > stats->max)
+		stats->max= rtt;
+	stats->rcvd++;
+	delta= rtt - stats->mean;
+	stats->mean += delta/stats->rcvd;
+	stats->m2 += delta*(rtt - stats->mean);
+
+	usecs= rtt*1000;
+	i= 0;
+	if (usecs > 1)
+		i= ceil(log(usecs)/log(RTT_GAMMA));
+	if (i >= RTT_BUCKETS)
+		i= RTT_BUCKETS-1;
+	stats->buckets[i]++;
+}
+
+static double rtt_stats_quantile(struct rttstats *stats, double q)
+{
+	int i;
+	uint32_t rank, count;
+	double value;
+
+	rank= q*(stats->rcvd-1);
+	count= 0;
+	for (i= 0; i<RTT_BUCKETS; i++)
+	{
+		count += stats->buckets[i];
+		if (count > rank)
+			break;
+	}
+
+	/* Middle of the bucket, in milliseconds */
+	value= 2*pow(RTT_GAMMA, i)/(RTT_GAMMA+1)/1000;
+	if (value < stats->min)
+		value= stats->min;
+	if (value > stats->max)
+		value= stats->max;
+	return value;
+}
+
+static void rtt_stats_report(FILE *fh, struct pingstate *state)
+{
+	struct rttstats *stats;
+
+	stats= state->stats;
+	fprintf(fh, ", " DBQ(summary) ": { " DBQ(sent) ":%llu, "
+		DBQ(rcvd) ":%u, " DBQ(dup) ":%u",
+		(unsigned long long)state->sentpkts, stats->rcvd, stats->dup);
+	if (stats->rcvd)
+	{
+		fprintf(fh, ", " DBQ(min) ":%f, " DBQ(avg) ":%f, "
+			DBQ(max) ":%f, " DBQ(stddev) ":%f, "
+			DBQ(p50) ":%f, " DBQ(p90) ":%f, " DBQ(p99) ":%f",
+			stats->min, stats->mean, stats->max,
+			stats->rcvd > 1 ? sqrt(stats->m2/(stats->rcvd-1)) : 0,
+			rtt_stats_quantile(stats, 0.5),
+			rtt_stats_quantile(stats, 0.9),
+			rtt_stats_quantile(stats, 0.99));
+	}
+	fprintf(fh, " }");
+}
+
+static void rate_report(FILE *fh, struct pingstate *state)
+{
+	struct pingrate *rate;
+
+	rate= state->rate;
+	fprintf(fh, ", " DBQ(rate) ":%u, " DBQ(sent) ":%llu, "
+		DBQ(rcvd) ":%u, " DBQ(dup) ":%u, " DBQ(late) ":%u, "
+		DBQ(lost) ":%u",
+		rate->rate, (unsigned long long)state->sentpkts, rate->rcvd,
+		rate->dup, rate->late, rate->lost);
+	if (rate->rcvd)
+	{
+		fprintf(fh, ", " DBQ(min) ":%f, " DBQ(avg) ":%f, "
+			DBQ(max) ":%f",
+			rate->rtt_min/1e3, rate->rtt_sum/1e3/rate->rcvd,
+			rate->rtt_max/1e3);
+	}
+	if (rate->rcvd > 1)
+	{
+		fprintf(fh, ", " DBQ(jitter) ":%f",
+			rate->jitter_sum/1e3/(rate->rcvd-1));
+	}
+}
+
+static void report(struct pingstate *state)
+{
+	int r;
+	FILE *fh;
+	struct addrinfo *ai;
+	char namebuf[NI_MAXHOST];
+	struct addrinfo hints;
+
+	fh= report_open(state);
+	report_hdr(fh, state);
 
 	fprintf(fh, DBQ(dst_name) ":" DBQ(%s),
 		state->hostname);
@@ -301,6 +567,11 @@ static void report(struct pingstate *state)
 		fprintf(fh, ", " DBQ(psize) ":%d", state->psize);
 #endif /* DO_PSIZE */
 
+	if (state->rate)
+		rate_report(fh, state);
+	if (state->stats)
+		rtt_stats_report(fh, state);
+
 	fprintf(fh, ", \"result\": [ %s ] }\n", state->result);
 
 	free(state->result);
@@ -359,6 +630,26 @@ static void ping_cb(int result, int bytes, int psize,
 		pingstate->ttl= ttl;
 	}
 
+	if (pingstate->stats && result == PING_ERR_DUP)
+		pingstate->stats->dup++;
+	else if (pingstate->stats && result == PING_ERR_NONE)
+	{
+		nsecs= (elapsed->tv_sec * 1e9 + elapsed->tv_nsec);
+		rtt_stats_add(pingstate->stats, nsecs/1e6);
+	}
+	if (pingstate->summary_only && (result == PING_ERR_NONE ||
+		result == PING_ERR_DUP || result == PING_ERR_TIMEOUT))
+	{
+		/* Only the summary is reported */
+		if (result == PING_ERR_NONE && !pingstate->got_reply)
+		{
+			memcpy(&pingstate->loc_sin6, loc_sa, loc_socklen);
+			pingstate->loc_socklen= loc_socklen;
+			pingstate->got_reply= 1;
+		}
+		return;
+	}
+
 	if (result == PING_ERR_NONE || result == PING_ERR_DUP)
 	{
 		/* Got a ping reply */
@@ -482,37 +773,6 @@ static void ping_cb(int result, int bytes, int psize,
 	}
 }
 
-/*
- * Checksum routine for Internet Protocol family headers (C Version).
- * From ping examples in W. Richard Stevens "Unix Network Programming" book.
- */
-static int mkcksum(u_short *p, int n)
-{
-	u_short answer;
-	long sum = 0;
-	u_short odd_byte = 0;
-
-	while (n > 1)
-	  {
-	    sum += *p++;
-	    n -= 2;
-	  }
-
-	/* mop up an odd byte, if necessary */
-	if (n == 1)
-	  {
-	    * (u_char *) &odd_byte = * (u_char *) p;
-	    sum += odd_byte;
-	  }
-
-	sum = (sum >> 16) + (sum & 0xffff);	/* add high 16 to low 16 */
-	sum += (sum >> 16);			/* add carry */
-	answer = ~sum;			/* ones-complement, truncate */
-
-	return answer;
-}
-
-
 /*
  * Format an ICMP Echo Request packet to be sent over the wire.
  *
@@ -528,18 +788,19 @@ static int mkcksum(u_short *p, int n)
  * to keep an unique integer used as index in the array
  * ho hosts being monitored
  */
-static void fmticmp4(u_char *buffer, size_t *sizep, u_int8_t seq,
+static void fmticmp4(u_char *buffer, size_t *sizep, u_int16_t seq,
 	uint32_t idx, pid_t pid, struct cookie *cookiep,
-	int include_probe_id)
+	int include_probe_id, const uint32_t *targetp)
 {
 	int probe_id;
-	size_t minlen, len;
+	size_t minlen, len, datalen;
 	struct icmp *icmp = (struct icmp *) buffer;
 	struct evdata *data = (struct evdata *) (buffer + ICMP_MINLEN);
 	struct timespec now;
 	char probe_id_line[80];
 
-	minlen= sizeof(*data);
+	datalen= targetp ? sizeof(struct evdata_multi) : sizeof(*data);
+	minlen= datalen;
 	if (*sizep < minlen)
 		*sizep= minlen;
 	if (*sizep > MAX_DATA_SIZE - ICMP_MINLEN)
@@ -560,6 +821,8 @@ static void fmticmp4(u_char *buffer, size_t *sizep, u_int8_t seq,
 	data->ts    = now;                       /* current uptime time */
 	data->index = idx;                     /* index into an array */
 	data->cookie= *cookiep;
+	if (targetp)
+		((struct evdata_multi *)data)->target= *targetp;
 
 	if (include_probe_id)
 	{
@@ -576,18 +839,18 @@ static void fmticmp4(u_char *buffer, size_t *sizep, u_int8_t seq,
 		}
 
 		len= strlen(probe_id_line);
-		if (*sizep < sizeof(*data) + len)
-			len= *sizep - sizeof(*data);
+		if (*sizep < datalen + len)
+			len= *sizep - datalen;
 		if (len)
 		{
-			memcpy(buffer + ICMP_MINLEN + sizeof(*data),
+			memcpy(buffer + ICMP_MINLEN + datalen,
 				probe_id_line, len);
 		}
 	}
 
 	/* Last, compute ICMP checksum */
 	icmp->icmp_cksum = 0;
-	icmp->icmp_cksum = mkcksum((u_short *) icmp, ICMP_MINLEN + *sizep);  /* ones complement checksum of struct */
+	icmp->icmp_cksum = inet_cksum((uint16_t *) icmp, ICMP_MINLEN + *sizep);  /* ones complement checksum of struct */
 }
 
 
@@ -607,17 +870,18 @@ static void fmticmp4(u_char *buffer, size_t *sizep, u_int8_t seq,
  * ho hosts being monitored
  */
 static void fmticmp6(u_char *buffer, size_t *sizep,
-	u_int8_t seq, uint32_t idx, pid_t pid, struct cookie *cookiep,
-	int include_probe_id)
+	u_int16_t seq, uint32_t idx, pid_t pid, struct cookie *cookiep,
+	int include_probe_id, const uint32_t *targetp)
 {
 	int probe_id;
-	size_t minlen, len;
+	size_t minlen, len, datalen;
 	struct icmp6_hdr *icmp = (struct icmp6_hdr *) buffer;
 	struct evdata *data = (struct evdata *) (buffer + ICMP6_HDRSIZE);
 	struct timespec now;
 	char probe_id_line[80];
 
-	minlen= sizeof(*data);
+	datalen= targetp ? sizeof(struct evdata_multi) : sizeof(*data);
+	minlen= datalen;
 	if (*sizep < minlen)
 		*sizep= minlen;
 	if (*sizep > MAX_DATA_SIZE - ICMP6_HDRSIZE)
@@ -636,6 +900,8 @@ static void fmticmp6(u_char *buffer, size_t *sizep,
 	data->ts    = now;                       /* current uptime time */
 	data->index = idx;                     /* index into an array */
 	data->cookie= *cookiep;
+	if (targetp)
+		((struct evdata_multi *)data)->target= *targetp;
 
 	if (include_probe_id)
 	{
@@ -652,11 +918,11 @@ static void fmticmp6(u_char *buffer, size_t *sizep,
 		}
 
 		len= strlen(probe_id_line);
-		if (*sizep < sizeof(*data) + len)
-			len= *sizep - sizeof(*data);
+		if (*sizep < datalen + len)
+			len= *sizep - datalen;
 		if (len)
 		{
-			memcpy(buffer + ICMP6_HDRSIZE + sizeof(*data),
+			memcpy(buffer + ICMP6_HDRSIZE + datalen,
 				probe_id_line, len);
 		}
 	}
@@ -697,7 +963,7 @@ static void ping_xmit(struct pingstate *host)
 	{
 		/* Format the ICMP Echo Reply packet to send */
 		fmticmp6(base->packet, &host->cursize, host->seq, host->index,
-			base->pid, &host->cookie, host->include_probe_id);
+			base->pid, &host->cookie, host->include_probe_id, NULL);
 
 		host->loc_socklen= sizeof(host->loc_sin6);
 		if (host->response_in)
@@ -741,7 +1007,7 @@ static void ping_xmit(struct pingstate *host)
 		/* Format the ICMP Echo Reply packet to send */
 		fmticmp4(base->packet, &host->cursize, host->seq,
 			host->index, base->pid, &host->cookie,
-			host->include_probe_id);
+			host->include_probe_id, NULL);
 
 		host->loc_socklen= sizeof(host->loc_sin6);
 		getsockname(host->socket, (struct sockaddr *)&host->loc_sin6,
@@ -808,12 +1074,270 @@ static void noreply_callback(int __attribute((unused)) unused, const short __att
 			NULL, 0, host->seq, -1, NULL, host);
 
 		/* Update the sequence number for the next run */
-		host->seq = (host->seq + 1) % 256;
+		host->seq++;
 	}
 
 	ping_xmit(host);
 }
 
+/* High-rate mode. Packets are sent on a fixed schedule (rate packets per
+ * second) without waiting for replies. The send timer catches up with the
+ * schedule by sending small bursts, so rates above the timer resolution
+ * work.
+ */
+static void rate_xmit(struct pingstate *state)
+{
+	int hdrlen;
+	struct pingbase *base;
+	struct pingrate *rate;
+	struct pingslot *slot;
+
+	base= state->base;
+	rate= state->rate;
+
+	slot= &rate->slots[state->seq & rate->mask];
+	if (slot->flags == SLOT_F_SENT)
+		rate->lost++;	/* Slot is reused, reply did not arrive */
+	slot->seq= state->seq;
+	slot->flags= SLOT_F_SENT;
+
+	if (state->af == AF_INET6)
+	{
+		fmticmp6(base->packet, &state->cursize, state->seq,
+			state->index, base->pid, &state->cookie,
+			state->include_probe_id, NULL);
+		hdrlen= ICMP6_HDRSIZE;
+	}
+	else
+	{
+		fmticmp4(base->packet, &state->cursize, state->seq,
+			state->index, base->pid, &state->cookie,
+			state->include_probe_id, NULL);
+		hdrlen= ICMP_MINLEN;
+	}
+	state->seq++;
+	state->sentpkts++;
+
+	if (state->response_in)
+		return;		/* Assume the send succeeded */
+
+	if (send(state->socket, base->packet, state->cursize+hdrlen,
+		MSG_DONTWAIT) <= 0 && !state->send_error)
+	{
+		state->send_error= 1;
+		ping_cb(PING_ERR_SENDTO, state->cursize, -1,
+			(struct sockaddr *)&state->sin6, state->socklen,
+			(struct sockaddr *)&state->loc_sin6, state->loc_socklen,
+			errno, 0, NULL, state);
+	}
+}
+
+static void rate_done(struct pingstate *state)
+{
+	unsigned i;
+	struct pingrate *rate;
+
+	rate= state->rate;
+
+	/* Whatever is still outstanding is lost */
+	for (i= 0; i <= rate->mask; i++)
+	{
+		if (rate->slots[i].flags == SLOT_F_SENT)
+			rate->lost++;
+	}
+
+	evtimer_del(&rate->send_timer);
+	if (state->resp_file_out)
+	{
+		fclose(state->resp_file_out);
+		state->resp_file_out= NULL;
+	}
+
+	ping_cb(PING_ERR_DONE, state->cursize, state->psize,
+		(struct sockaddr *)&state->sin6, state->socklen,
+		(struct sockaddr *)&state->loc_sin6, state->loc_socklen,
+		0, state->rcvd_ttl, NULL, state);
+	if (state->dns_res)
+	{
+		evutil_freeaddrinfo(state->dns_res);
+		state->dns_res= NULL;
+	}
+	if (state->base->done)
+		state->base->done(state, state->error);
+}
+
+/* Send everything that is due and return the time until the next packet
+ * (in microseconds). Returns 0 when all packets have been sent.
+ */
+static uint64_t rate_send_due(struct pingstate *state)
+{
+	unsigned burst;
+	uint64_t elapsed, due;
+	struct pingrate *rate;
+	struct timespec now;
+
+	rate= state->rate;
+
+	gettime_mono(&now);
+	if (state->sentpkts == 0)
+		rate->start= now;
+	elapsed= (now.tv_sec - rate->start.tv_sec)*1000000ULL +
+		(now.tv_nsec - rate->start.tv_nsec)/1000;
+	due= elapsed*rate->rate/1000000 + 1;
+	if (due > state->maxpkts)
+		due= state->maxpkts;
+
+	/* Limit bursts, if we fall behind we just send at a lower rate */
+	for (burst= 0; state->sentpkts < due && burst < RATE_MAX_BURST;
+		burst++)
+	{
+		rate_xmit(state);
+	}
+
+	if (state->sentpkts >= state->maxpkts)
+		return 0;
+	due= state->sentpkts*1000000ULL/rate->rate;
+	return due > elapsed ? due-elapsed : 1;
+}
+
+static void rate_send_callback(int __attribute((unused)) unused,
+	const short __attribute((unused)) event, void *s)
+{
+	uint64_t usecs;
+	struct pingstate *state;
+	struct pingrate *rate;
+	struct timeval tv;
+
+	state= s;
+	rate= state->rate;
+
+	if (state->resp_file_out)
+	{
+		write_response(state->resp_file_out,
+			rate->done_sending ? RESP_TIMEOUT : RESP_SENDTO,
+			0, NULL);
+	}
+
+	if (rate->done_sending)
+	{
+		rate_done(state);
+		return;
+	}
+
+	usecs= rate_send_due(state);
+	if (usecs == 0)
+	{
+		/* Wait for the last replies */
+		rate->done_sending= 1;
+		usecs= state->interval*1000ULL;
+	}
+	if (state->response_in)
+		return;
+
+	tv.tv_sec= usecs/1000000;
+	tv.tv_usec= usecs%1000000;
+	evtimer_add(&rate->send_timer, &tv);
+}
+
+static void rate_reply(struct pingstate *state, u_int16_t seq,
+	struct timespec *elapsed, int ttl,
+	struct sockaddr *loc_sa, socklen_t loc_socklen)
+{
+	uint32_t usecs, diff;
+	struct pingrate *rate;
+	struct pingslot *slot;
+
+	rate= state->rate;
+
+	slot= &rate->slots[seq & rate->mask];
+	if (slot->seq != seq || slot->flags == 0)
+	{
+		rate->late++;
+		return;
+	}
+	if (slot->flags == SLOT_F_RCVD)
+	{
+		rate->dup++;
+		if (state->stats)
+			state->stats->dup++;
+		return;
+	}
+	slot->flags= SLOT_F_RCVD;
+
+	usecs= elapsed->tv_sec*1000000 + elapsed->tv_nsec/1000;
+	if (rate->rcvd == 0 || usecs < rate->rtt_min)
+		rate->rtt_min= usecs;
+	if (usecs > rate->rtt_max)
+		rate->rtt_max= usecs;
+	rate->rtt_sum += usecs;
+	if (rate->rcvd > 0)
+	{
+		diff= usecs > rate->rtt_last ? usecs - rate->rtt_last :
+			rate->rtt_last - usecs;
+		rate->jitter_sum += diff;
+	}
+	rate->rtt_last= usecs;
+	rate->rcvd++;
+	if (state->stats)
+		rtt_stats_add(state->stats, usecs/1e3);
+
+	if (!state->got_reply)
+	{
+		state->size= state->cursize;
+		state->ttl= ttl;
+		memcpy(&state->loc_sin6, loc_sa, loc_socklen);
+		state->loc_socklen= loc_socklen;
+		state->got_reply= 1;
+	}
+}
+
+/* Replay of a high-rate ping follows the recorded order of timer events
+ * and received packets.
+ */
+static void rate_replay(struct pingstate *state)
+{
+	int type;
+	size_t len;
+
+	for (;;)
+	{
+		peek_response(state->socket, &type);
+		if (type == RESP_SENDTO || type == RESP_TIMEOUT)
+		{
+			len= 0;
+			read_response(state->socket, type, &len, NULL);
+			rate_send_callback(0, 0, state);
+			if (type == RESP_TIMEOUT)
+				break;
+			continue;
+		}
+		if (state->sin6.sin6_family == AF_INET6)
+			ready_callback6(0, 0, state);
+		else
+			ready_callback4(0, 0, state);
+	}
+}
+
+static void rate_start(struct pingstate *state)
+{
+	struct pingrate *rate;
+
+	rate= state->rate;
+	rate->done_sending= 0;
+	rate->rcvd= rate->dup= rate->late= rate->lost= 0;
+	rate->rtt_sum= 0;
+	rate->rtt_min= rate->rtt_max= rate->rtt_last= 0;
+	rate->jitter_sum= 0;
+	memset(rate->slots, '\0', (rate->mask+1)*sizeof(*rate->slots));
+
+	if (state->response_in)
+	{
+		rate_replay(state);
+		return;
+	}
+	rate_send_callback(0, 0, state);
+}
+
 /*
  * Called by libevent when the kernel says that the raw socket is ready for reading.
  *
@@ -838,7 +1362,7 @@ static void ready_callback4 (int __attribute((unused)) unused,
 	struct ip * ip;
 	struct icmphdr * icmp;
 	struct evdata * data;
-	int hlen = 0;
+	struct icmperr ie;
 	struct timespec now;
 	state= arg;
 	base = state->base;
@@ -887,19 +1411,16 @@ static void ready_callback4 (int __attribute((unused)) unused,
 		}
 #endif
 
-	/* Calculate the IP header length */
-	hlen = ip->ip_hl * 4;
-
 	/* Check the IP header */
-	if (nrecv < hlen + ICMP_MINLEN + sizeof (struct evdata) ||
-		ip->ip_hl < 5)
+	if (icmperr_decode4(base->packet, nrecv, &ie) == -1 ||
+		ie.icmp_len < ICMP_MINLEN + sizeof (struct evdata))
 	  {
 	    /* One more too short packet */
 	    goto done;
 	  }
 
 	/* The ICMP portion */
-	icmp = (struct icmphdr *) (base->packet + hlen);
+	icmp = (struct icmphdr *) ie.icmp;
 
 	/* Check the ICMP header to drop unexpected packets due to unrecognized id */
 	if (icmp->un.echo.id != (base->pid & 0x0fff))
@@ -912,7 +1433,7 @@ static void ready_callback4 (int __attribute((unused)) unused,
 	  }
 
 	/* Check the ICMP payload for legal values of the 'index' portion */
-	data = (struct evdata *) (base->packet + hlen + ICMP_MINLEN);
+	data = (struct evdata *) (ie.icmp + ICMP_MINLEN);
 	if (data->index >= base->tabsiz || base->table[data->index] == NULL)
 	{
 #if 0
@@ -959,6 +1480,14 @@ static void ready_callback4 (int __attribute((unused)) unused,
 	    sin4p->sin_addr= ip->ip_dst;
 	    state->rcvd_ttl= ip->ip_ttl;
 
+	    if (state->rate)
+	    {
+		rate_reply(state, ntohs(icmp->un.echo.sequence), &elapsed,
+			ip->ip_ttl, (struct sockaddr *)&loc_sin4,
+			sizeof(loc_sin4));
+		goto done;
+	    }
+
 	    /* Report everything with the wrong sequence number as a dup. 
 	     * This is not quite right, it could be a late packet. Do we
 	     * care?
@@ -976,17 +1505,17 @@ static void ready_callback4 (int __attribute((unused)) unused,
 		state->got_reply= 1;
 
 		/* Update the sequence number for the next run */
-		state->seq = (state->seq + 1) % 256;
+		state->seq++;
 	    }
 	  }
-	else
+	else if (!state->rate)
 	{
 	  /* Handle this condition exactly as the request has expired */
 	  noreply_callback (-1, -1, state);
 	}
 
 done:
-	if (state->response_in)
+	if (state->response_in && !state->rate)
 	  	noreply_callback (-1, -1, state);
 }
 
@@ -1171,6 +1700,14 @@ static void ready_callback6 (int __attribute((unused)) unused,
 				&state->rcvd_ttl);
 	    }
 
+	    if (state->rate)
+	    {
+		rate_reply(state, ntohs(icmp->icmp6_seq), &elapsed,
+			state->rcvd_ttl, (struct sockaddr *)&loc_sin6,
+			sizeof(loc_sin6));
+		goto done;
+	    }
+
 	    /* Report everything with the wrong sequence number as a dup. 
 	     * This is not quite right, it could be a late packet. Do we
 	     * care?
@@ -1184,53 +1721,809 @@ static void ready_callback6 (int __attribute((unused)) unused,
 		    state);
 
 	    /* Update the sequence number for the next run */
-	    state->seq = (state->seq + 1) % 256;
+	    state->seq++;
 
 	    if (!isDup)
 		state->got_reply= 1;
 	}
-	else
+	else if (!state->rate)
 	  /* Handle this condition exactly as the request has expired */
 	  noreply_callback (-1, -1, state);
 
 done:
-	if (state->response_in)
+	if (state->response_in && !state->rate)
 	  	noreply_callback (-1, -1, state);
 }
 
 
-static void *ping_init(int __attribute((unused)) argc, char *argv[],
-	void (*done)(void *state, int error))
+/* Multi-target mode. All targets share one raw socket and one timer.
+ * Packets are sent round-robin, 'pace' milliseconds apart. The sequence
+ * number is the round, so each target sees 1, 2, 3, ... just like a normal
+ * ping. Instead of a list of RTTs, only a summary is kept for each target.
+ */
+static int multi_add_target(struct pingmulti *multi, const char *name,
+	sa_family_t af)
 {
-	static struct pingbase *ping_base;
-
-	int i, r, fd, newsiz, include_probe_id, delay_name_res;
-	uint32_t opt;
-	unsigned pingcount; /* must be int-sized */
-	unsigned size, interval;
-	sa_family_t af;
-	const char *hostname;
-	char *str_Atlas;
-	char *str_bundle;
-	char *out_filename;
-	char *interface;
-	char *response_in, *response_out;
-	char *validated_response_in= NULL;
-	char *validated_response_out= NULL;
-	char *validated_out_filename= NULL;
-	struct pingstate *state;
-	len_and_sockaddr *lsa;
-	FILE *fh;
-	struct cookie cookie;
+	unsigned n;
+	struct pingtarget *tgt;
 
-	if (!ping_base)
+	n= multi->ntargets;
+	if (n >= MULTI_MAX_TARGETS)
 	{
-		ping_base = malloc(sizeof(*ping_base));
-		if (ping_base == NULL)
-			return (NULL);
-		memset(ping_base, 0, sizeof(*ping_base));
+		crondlog(LVL8 "ping: too many targets");
+		return -1;
+	}
 
-		ping_base->event_base = EventBase;
+	/* Grow by doubling, starting at 16 */
+	if (n == 0 || (n >= 16 && (n & (n-1)) == 0))
+	{
+		multi->targets= xrealloc(multi->targets,
+			(n ? 2*n : 16) * sizeof(*multi->targets));
+	}
+	tgt= &multi->targets[n];
+	memset(tgt, '\0', sizeof(*tgt));
+	tgt->hostname= strdup(name);
+	if (inet_pton(af, name, &tgt->addr) == 1)
+		tgt->flags= TGT_F_ADDR | TGT_F_LITERAL;
+	multi->ntargets= n+1;
+	return 0;
+}
+
+static int multi_read_targets(struct pingmulti *multi, const char *filename,
+	sa_family_t af)
+{
+	char *cp, *name;
+	FILE *file;
+	char line[NI_MAXHOST];
+
+	file= fopen(filename, "r");
+	if (!file)
+	{
+		crondlog(LVL8 "ping: unable to open '%s'", filename);
+		return -1;
+	}
+	while (fgets(line, sizeof(line), file) != NULL)
+	{
+		/* One target per line, comments start with '#' */
+		cp= strchr(line, '#');
+		if (cp)
+			*cp= '\0';
+		name= strtok(line, " \t\r\n");
+		if (!name)
+			continue;
+		if (multi_add_target(multi, name, af) == -1)
+		{
+			fclose(file);
+			return -1;
+		}
+	}
+	fclose(file);
+	return 0;
+}
+
+static void multi_free(struct pingmulti *multi)
+{
+	unsigned i;
+
+	if (!multi)
+		return;
+	for (i= 0; i<multi->ntargets; i++)
+		free(multi->targets[i].hostname);
+	free(multi->targets);
+	free(multi);
+}
+
+static socklen_t multi_sockaddr(struct pingstate *state,
+	struct pingtarget *tgt, struct sockaddr_in6 *sin6p)
+{
+	struct sockaddr_in *sin4p;
+
+	memset(sin6p, '\0', sizeof(*sin6p));
+	if (state->af == AF_INET)
+	{
+		sin4p= (struct sockaddr_in *)sin6p;
+		sin4p->sin_family= AF_INET;
+		sin4p->sin_addr= tgt->addr.in4;
+		return sizeof(*sin4p);
+	}
+	sin6p->sin6_family= AF_INET6;
+	sin6p->sin6_addr= tgt->addr.in6;
+	return sizeof(*sin6p);
+}
+
+static void multi_report_target(FILE *fh, struct pingstate *state,
+	struct pingtarget *tgt)
+{
+	socklen_t len;
+	struct sockaddr_in6 sin6;
+	char namebuf[NI_MAXHOST];
+
+	fprintf(fh, DBQ(dst_name) ":" DBQ(%s) ", " DBQ(af) ":%d",
+		tgt->hostname, state->af == AF_INET ? 4 : 6);
+	if (tgt->flags & (TGT_F_ADDR | TGT_F_BAD_ADDR))
+	{
+		len= multi_sockaddr(state, tgt, &sin6);
+		namebuf[0]= '\0';
+		getnameinfo((struct sockaddr *)&sin6, len,
+			namebuf, sizeof(namebuf), NULL, 0, NI_NUMERICHOST);
+		fprintf(fh, ", " DBQ(dst_addr) ":" DBQ(%s), namebuf);
+	}
+	fprintf(fh, ", " DBQ(proto) ":" DBQ(ICMP));
+	if (tgt->rcvd)
+		fprintf(fh, ", " DBQ(ttl) ":%d", tgt->ttl);
+	fprintf(fh, ", " DBQ(size) ":%d", (int)state->cursize);
+	fprintf(fh, ", " DBQ(sent) ":%u, " DBQ(rcvd) ":%u",
+		tgt->sent, tgt->rcvd);
+	if (tgt->dup)
+		fprintf(fh, ", " DBQ(dup) ":%u", tgt->dup);
+	if (tgt->rcvd)
+	{
+		fprintf(fh, ", " DBQ(min) ":%f, " DBQ(avg) ":%f, "
+			DBQ(max) ":%f",
+			tgt->rtt_min/1e3, tgt->rtt_sum/1e3/tgt->rcvd,
+			tgt->rtt_max/1e3);
+	}
+
+	if (state->reslen)
+		fprintf(fh, ", " DBQ(error) ":" DBQ(%s), state->result);
+	else if (tgt->flags & TGT_F_DNS_ERR)
+		fprintf(fh, ", " DBQ(error) ":" DBQ(dns resolution failed));
+	else if (tgt->flags & TGT_F_BAD_ADDR)
+		fprintf(fh, ", " DBQ(error) ":" DBQ(address not allowed));
+	else if (tgt->flags & TGT_F_SEND_ERR)
+		fprintf(fh, ", " DBQ(error) ":" DBQ(sendto failed));
+}
+
+static void multi_done(struct pingstate *state)
+{
+	unsigned i;
+	int error;
+	FILE *fh;
+	struct pingmulti *multi;
+
+	multi= state->multi;
+
+	fh= report_open(state);
+	if (multi->grouped)
+	{
+		report_hdr(fh, state);
+		fprintf(fh, DBQ(result) ": [ ");
+		for (i= 0; i<multi->ntargets; i++)
+		{
+			fprintf(fh, "%s{ ", i == 0 ? "" : ", ");
+			multi_report_target(fh, state, &multi->targets[i]);
+			fprintf(fh, " }");
+		}
+		fprintf(fh, " ] }\n");
+	}
+	else
+	{
+		for (i= 0; i<multi->ntargets; i++)
+		{
+			report_hdr(fh, state);
+			multi_report_target(fh, state, &multi->targets[i]);
+			fprintf(fh, " }\n");
+		}
+	}
+	if (state->out_filename)
+		fclose(fh);
+
+	error= 1;
+	for (i= 0; i<multi->ntargets; i++)
+	{
+		if (multi->targets[i].rcvd)
+		{
+			error= 0;
+			break;
+		}
+	}
+
+	evtimer_del(&multi->send_timer);
+	if (state->event_is_init && !state->response_in)
+		event_del(&state->event);
+	if (state->socket != -1)
+	{
+		close(state->socket);
+		state->socket= -1;
+	}
+	if (state->resp_file_out)
+	{
+		fclose(state->resp_file_out);
+		state->resp_file_out= NULL;
+	}
+	free(state->result);
+	state->result= NULL;
+	state->reslen= 0;
+	state->busy= 0;
+
+	if (state->base->done)
+		state->base->done(state, error);
+}
+
+static void multi_xmit(struct pingstate *state, uint32_t target,
+	u_int16_t seq)
+{
+	int hdrlen, nsent;
+	socklen_t len;
+	struct pingbase *base;
+	struct pingtarget *tgt;
+	struct sockaddr_in6 sin6;
+
+	base= state->base;
+	tgt= &state->multi->targets[target];
+
+	if (state->af == AF_INET6)
+	{
+		fmticmp6(base->packet, &state->cursize, seq, state->index,
+			base->pid, &state->cookie, state->include_probe_id,
+			&target);
+		hdrlen= ICMP6_HDRSIZE;
+	}
+	else
+	{
+		fmticmp4(base->packet, &state->cursize, seq, state->index,
+			base->pid, &state->cookie, state->include_probe_id,
+			&target);
+		hdrlen= ICMP_MINLEN;
+	}
+
+	tgt->sent++;
+	if (state->response_in)
+		return;		/* Assume the send succeeded */
+	if (state->resp_file_out)
+		write_response(state->resp_file_out, RESP_SENDTO, 0, NULL);
+
+	len= multi_sockaddr(state, tgt, &sin6);
+	nsent= sendto(state->socket, base->packet, state->cursize+hdrlen,
+		MSG_DONTWAIT, (struct sockaddr *)&sin6, len);
+	if (nsent <= 0)
+		tgt->flags |= TGT_F_SEND_ERR;
+}
+
+/* Send the next packet. Returns 0 if all packets have been sent. */
+static int multi_send_one(struct pingstate *state)
+{
+	unsigned i;
+	u_int16_t seq;
+	struct pingmulti *multi;
+
+	multi= state->multi;
+	while (multi->round < state->pingcount)
+	{
+		i= multi->next;
+		seq= multi->round+1;
+		if (i == 0)
+			gettime_mono(&multi->round_start);
+		multi->next++;
+		if (multi->next >= multi->ntargets)
+		{
+			multi->next= 0;
+			multi->round++;
+		}
+		if (multi->targets[i].flags & TGT_F_ADDR)
+		{
+			multi_xmit(state, i, seq);
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/* Time until the next packet has to be sent */
+static unsigned multi_next_delay(struct pingstate *state)
+{
+	unsigned delay, elapsed;
+	struct pingmulti *multi;
+	struct timespec now;
+
+	multi= state->multi;
+	if (multi->round >= state->pingcount)
+	{
+		delay= state->interval;
+		if (delay < MULTI_MIN_WAIT)
+			delay= MULTI_MIN_WAIT;
+		return delay;
+	}
+	if (multi->next != 0)
+		return multi->pace;
+
+	/* Start of a new round, make sure each target gets at most
+	 * one packet per interval.
+	 */
+	gettime_mono(&now);
+	elapsed= (now.tv_sec - multi->round_start.tv_sec)*1000 +
+		(now.tv_nsec - multi->round_start.tv_nsec)/1000000;
+	delay= multi->pace;
+	if (elapsed + delay < state->interval)
+		delay= state->interval - elapsed;
+	return delay;
+}
+
+static void multi_send_callback(int __attribute((unused)) unused,
+	const short __attribute((unused)) event, void *s)
+{
+	struct pingstate *state;
+	struct pingmulti *multi;
+	struct timeval tv;
+
+	state= s;
+	multi= state->multi;
+
+	if (multi->round >= state->pingcount)
+	{
+		/* Everything is sent and we waited for the last replies */
+		if (state->resp_file_out)
+		{
+			write_response(state->resp_file_out, RESP_TIMEOUT,
+				0, NULL);
+		}
+		multi_done(state);
+		return;
+	}
+
+	multi_send_one(state);
+
+	msecstotv(multi_next_delay(state), &tv);
+	evtimer_add(&multi->send_timer, &tv);
+}
+
+static void multi_ready_callback(int __attribute((unused)) unused,
+	const short __attribute((unused)) event, void *s)
+{
+	int nrecv, ttl, on;
+	unsigned shift;
+	uint32_t usecs, target;
+	u_int16_t seq, id;
+	struct pingstate *state;
+	struct pingbase *base;
+	struct pingmulti *multi;
+	struct pingtarget *tgt;
+	struct ip *ip;
+	struct icmp6_hdr *icmp6;
+	struct icmphdr *icmp4;
+	struct evdata_multi *data;
+	struct icmperr ie;
+	struct cmsghdr *cmsgptr;
+	struct sockaddr_in6 remote;
+	struct sockaddr_in *sin4p;
+	struct timespec now;
+	struct msghdr msg;
+	struct iovec iov[1];
+	size_t len;
+	char cmsgbuf[256];
+
+	state= s;
+	base= state->base;
+	multi= state->multi;
+
+	gettime_mono(&now);
+
+	ttl= -1;
+	memset(&remote, '\0', sizeof(remote));
+	if (state->response_in)
+	{
+		len= sizeof(base->packet);
+		read_response(state->socket, RESP_PACKET, &len, base->packet);
+		nrecv= len;
+		len= sizeof(remote);
+		read_response(state->socket, RESP_PEERNAME, &len, &remote);
+		if (state->af == AF_INET6)
+		{
+			len= sizeof(on);
+			read_response(state->socket, RESP_TTL, &len, &on);
+			ttl= on;
+		}
+	}
+	else
+	{
+		iov[0].iov_base= base->packet;
+		iov[0].iov_len= sizeof(base->packet);
+		msg.msg_name= &remote;
+		msg.msg_namelen= sizeof(remote);
+		msg.msg_iov= iov;
+		msg.msg_iovlen= 1;
+		msg.msg_control= cmsgbuf;
+		msg.msg_controllen= sizeof(cmsgbuf);
+		msg.msg_flags= 0;
+		nrecv= recvmsg(state->socket, &msg, MSG_DONTWAIT);
+		if (nrecv < 0)
+			return;
+		if (state->af == AF_INET6)
+		{
+			for (cmsgptr= CMSG_FIRSTHDR(&msg); cmsgptr;
+				cmsgptr= CMSG_NXTHDR(&msg, cmsgptr))
+			{
+				if (cmsgptr->cmsg_len == 0)
+					break;
+				if (cmsgptr->cmsg_level == IPPROTO_IPV6 &&
+					cmsgptr->cmsg_type == IPV6_HOPLIMIT)
+				{
+					ttl= *(int *)CMSG_DATA(cmsgptr);
+				}
+			}
+		}
+		if (state->resp_file_out)
+		{
+			write_response(state->resp_file_out, RESP_PACKET,
+				nrecv, base->packet);
+			write_response(state->resp_file_out, RESP_PEERNAME,
+				sizeof(remote), &remote);
+			if (state->af == AF_INET6)
+			{
+				on= ttl;
+				write_response(state->resp_file_out, RESP_TTL,
+					sizeof(on), &on);
+			}
+		}
+	}
+
+	if (state->af == AF_INET)
+	{
+		if (icmperr_decode4(base->packet, nrecv, &ie) == -1 ||
+			ie.icmp_len < ICMP_MINLEN + sizeof(*data))
+		{
+			return;
+		}
+		ip= (struct ip *)ie.ip;
+		icmp4= (struct icmphdr *)ie.icmp;
+		if (icmp4->type != ICMP_ECHOREPLY)
+			return;
+		id= icmp4->un.echo.id;
+		if (id != (base->pid & 0x0fff))
+			return;
+		seq= ntohs(icmp4->un.echo.sequence);
+		ttl= ip->ip_ttl;
+		data= (struct evdata_multi *)(ie.icmp + ICMP_MINLEN);
+	}
+	else
+	{
+		if (nrecv < ICMP6_HDRSIZE + sizeof(*data))
+			return;
+		icmp6= (struct icmp6_hdr *)base->packet;
+		if (icmp6->icmp6_type != ICMP6_ECHO_REPLY)
+			return;
+		if (icmp6->icmp6_id != (base->pid & 0xffff))
+			return;
+		seq= ntohs(icmp6->icmp6_seq);
+		data= (struct evdata_multi *)(base->packet + ICMP6_HDRSIZE);
+	}
+
+	if (data->evdata.index != state->index)
+		return;	/* Not for us */
+	if (memcmp(&state->cookie, &data->evdata.cookie,
+		sizeof(state->cookie)) != 0)
+	{
+		crondlog(LVL8 "ICMP with wrong cookie");
+		return;
+	}
+	target= data->target;
+	if (target >= multi->ntargets || seq < 1 || seq > state->pingcount)
+		return;
+	tgt= &multi->targets[target];
+
+	/* The reply has to come from the target */
+	if (state->af == AF_INET)
+	{
+		sin4p= (struct sockaddr_in *)&remote;
+		if (memcmp(&sin4p->sin_addr, &tgt->addr.in4,
+			sizeof(tgt->addr.in4)) != 0)
+		{
+			return;
+		}
+	}
+	else if (memcmp(&remote.sin6_addr, &tgt->addr.in6,
+		sizeof(tgt->addr.in6)) != 0)
+	{
+		return;
+	}
+
+	if (seq > tgt->seq_top)
+	{
+		shift= seq - tgt->seq_top;
+		tgt->seen= shift >= TGT_SEEN_WIN ? 0 : tgt->seen << shift;
+		tgt->seen |= 1;
+		tgt->seq_top= seq;
+	}
+	else
+	{
+		shift= tgt->seq_top - seq;
+		if (shift >= TGT_SEEN_WIN)
+			return;		/* Too late to tell */
+		if (tgt->seen & (1U << shift))
+		{
+			tgt->dup++;
+			return;
+		}
+		tgt->seen |= (1U << shift);
+	}
+
+	usecs= (now.tv_sec - data->evdata.ts.tv_sec)*1000000 +
+		(now.tv_nsec - data->evdata.ts.tv_nsec)/1000;
+	if (tgt->rcvd == 0 || usecs < tgt->rtt_min)
+		tgt->rtt_min= usecs;
+	if (usecs > tgt->rtt_max)
+		tgt->rtt_max= usecs;
+	tgt->rtt_sum += usecs;
+	tgt->rcvd++;
+	if (ttl != -1)
+		tgt->ttl= ttl;
+}
+
+static void multi_start2(struct pingstate *state)
+{
+	int fd, on, type;
+	unsigned i;
+	socklen_t len;
+	size_t tmp_len;
+	struct pingmulti *multi;
+	struct pingtarget *tgt;
+	struct evutil_addrinfo tmp_res;
+	struct sockaddr_in6 sin6;
+	char line[80];
+
+	multi= state->multi;
+
+	for (i= 0; i<multi->ntargets; i++)
+	{
+		tgt= &multi->targets[i];
+		len= multi_sockaddr(state, tgt, &sin6);
+		if (state->resp_file_out && !(tgt->flags & TGT_F_LITERAL))
+		{
+			/* A zero address length records a DNS failure */
+			memset(&tmp_res, '\0', sizeof(tmp_res));
+			tmp_res.ai_family= state->af;
+			if (tgt->flags & TGT_F_ADDR)
+				tmp_res.ai_addrlen= len;
+			write_response(state->resp_file_out, RESP_ADDRINFO,
+				sizeof(tmp_res), &tmp_res);
+			write_response(state->resp_file_out, RESP_ADDRINFO_SA,
+				tmp_res.ai_addrlen, &sin6);
+		}
+		if ((tgt->flags & TGT_F_ADDR) &&
+			atlas_check_addr((struct sockaddr *)&sin6, len) == -1)
+		{
+			tgt->flags &= ~TGT_F_ADDR;
+			tgt->flags |= TGT_F_BAD_ADDR;
+		}
+	}
+
+	if (!state->response_in)
+	{
+		if (state->af == AF_INET)
+			fd= socket(AF_INET, SOCK_RAW, IPPROTO_ICMP);
+		else
+			fd= socket(AF_INET6, SOCK_RAW, IPPROTO_ICMPV6);
+		if (fd == -1)
+		{
+			snprintf(line, sizeof(line), "socket failed: %s",
+				strerror(errno));
+			add_str(state, line);
+			multi_done(state);
+			return;
+		}
+		state->socket= fd;
+
+		if (state->af == AF_INET6)
+		{
+			on = 1;
+			setsockopt(fd, IPPROTO_IPV6, IPV6_RECVHOPLIMIT, &on,
+				sizeof(on));
+		}
+		evutil_make_socket_nonblocking(fd);
+
+		if (state->interface &&
+			bind_interface(fd, state->af, state->interface) == -1)
+		{
+			add_str(state, "bind to interface failed");
+			multi_done(state);
+			return;
+		}
+
+		state->event_is_init= 1;
+		event_assign(&state->event, state->base->event_base, fd,
+			EV_READ | EV_PERSIST, multi_ready_callback, state);
+		event_add(&state->event, NULL);
+
+		multi_send_callback(0, 0, state);
+		return;
+	}
+
+	/* Replay. Sends and receives are taken in the recorded order */
+	for (;;)
+	{
+		peek_response(state->socket, &type);
+		if (type == RESP_TIMEOUT)
+		{
+			tmp_len= 0;
+			read_response(state->socket, RESP_TIMEOUT, &tmp_len,
+				NULL);
+			break;
+		}
+		if (type == RESP_SENDTO)
+		{
+			tmp_len= 0;
+			read_response(state->socket, RESP_SENDTO, &tmp_len,
+				NULL);
+			multi_send_one(state);
+			multi_next_delay(state);
+			continue;
+		}
+		multi_ready_callback(0, 0, state);
+	}
+	multi_done(state);
+}
+
+static void multi_dns_cb(int result, struct evutil_addrinfo *res, void *ctx)
+{
+	struct pingmulti_dns *dns_ctx;
+	struct pingstate *state;
+	struct pingtarget *tgt;
+	struct evutil_addrinfo *cur;
+
+	dns_ctx= ctx;
+	state= dns_ctx->state;
+	tgt= &state->multi->targets[dns_ctx->index];
+	free(dns_ctx);
+
+	tgt->flags |= TGT_F_DNS_ERR;
+	if (result == 0)
+	{
+		for (cur= res; cur; cur= cur->ai_next)
+		{
+			if (cur->ai_family != state->af)
+				continue;
+			if (state->af == AF_INET)
+			{
+				tgt->addr.in4= ((struct sockaddr_in *)
+					cur->ai_addr)->sin_addr;
+			}
+			else
+			{
+				tgt->addr.in6= ((struct sockaddr_in6 *)
+					cur->ai_addr)->sin6_addr;
+			}
+			tgt->flags &= ~TGT_F_DNS_ERR;
+			tgt->flags |= TGT_F_ADDR;
+			break;
+		}
+	}
+	if (res)
+		evutil_freeaddrinfo(res);
+
+	state->multi->dns_pending--;
+	if (state->multi->dns_pending == 0)
+		multi_start2(state);
+}
+
+static void multi_start(struct pingstate *state)
+{
+	unsigned i;
+	size_t len;
+	struct pingmulti *multi;
+	struct pingtarget *tgt;
+	struct pingmulti_dns *dns_ctx;
+	struct evutil_addrinfo hints, tmp_res;
+	struct sockaddr_in6 sin6;
+
+	multi= state->multi;
+
+	state->cursize= state->maxsize;
+	multi->next= 0;
+	multi->round= 0;
+	evtimer_assign(&multi->send_timer, state->base->event_base,
+		multi_send_callback, state);
+
+	for (i= 0; i<multi->ntargets; i++)
+	{
+		tgt= &multi->targets[i];
+		tgt->flags &= TGT_F_LITERAL;
+		if (tgt->flags & TGT_F_LITERAL)
+			tgt->flags |= TGT_F_ADDR;
+		tgt->sent= tgt->rcvd= tgt->dup= 0;
+		tgt->seen= 0;
+		tgt->seq_top= 0;
+		tgt->rtt_min= tgt->rtt_max= 0;
+		tgt->rtt_sum= 0;
+		tgt->ttl= 0;
+	}
+
+	if (state->response_in)
+	{
+		state->socket= open(state->response_in, O_RDONLY);
+		if (state->socket == -1)
+		{
+			crondlog(DIE9 "unable to open '%s'",
+				state->response_in);
+		}
+		for (i= 0; i<multi->ntargets; i++)
+		{
+			tgt= &multi->targets[i];
+			if (tgt->flags & TGT_F_LITERAL)
+				continue;
+			len= sizeof(tmp_res);
+			read_response(state->socket, RESP_ADDRINFO, &len,
+				&tmp_res);
+			len= sizeof(sin6);
+			read_response(state->socket, RESP_ADDRINFO_SA, &len,
+				&sin6);
+			if (len == 0)
+			{
+				tgt->flags |= TGT_F_DNS_ERR;
+				continue;
+			}
+			if (state->af == AF_INET)
+			{
+				tgt->addr.in4=
+					((struct sockaddr_in *)&sin6)->sin_addr;
+			}
+			else
+				tgt->addr.in6= sin6.sin6_addr;
+			tgt->flags |= TGT_F_ADDR;
+		}
+		multi_start2(state);
+		return;
+	}
+
+	/* Resolve all names in parallel. The extra reference prevents
+	 * starting early if a callback happens to be called directly.
+	 */
+	multi->dns_pending= 1;
+	memset(&hints, '\0', sizeof(hints));
+	hints.ai_socktype= SOCK_DGRAM;
+	hints.ai_family= state->af;
+	for (i= 0; i<multi->ntargets; i++)
+	{
+		tgt= &multi->targets[i];
+		if (tgt->flags & TGT_F_LITERAL)
+			continue;
+		dns_ctx= xmalloc(sizeof(*dns_ctx));
+		dns_ctx->state= state;
+		dns_ctx->index= i;
+		multi->dns_pending++;
+		dnscache_getaddrinfo(DnsBase, tgt->hostname, NULL,
+			&hints, state->dns_nocache, multi_dns_cb, dns_ctx);
+	}
+	multi->dns_pending--;
+	if (multi->dns_pending == 0)
+		multi_start2(state);
+}
+
+static void *ping_init(int __attribute((unused)) argc, char *argv[],
+	void (*done)(void *state, int error))
+{
+	static struct pingbase *ping_base;
+
+	int i, r, fd, newsiz, include_probe_id, delay_name_res;
+	uint32_t opt;
+	unsigned pingcount; /* must be int-sized */
+	unsigned size, interval, pace, pkt_rate, nslots;
+	sa_family_t af;
+	const char *hostname;
+	char *str_Atlas;
+	char *str_bundle;
+	char *out_filename;
+	char *interface;
+	char *response_in, *response_out;
+	char *targets_file;
+	char *validated_response_in= NULL;
+	char *validated_response_out= NULL;
+	char *validated_out_filename= NULL;
+	char *validated_targets_file= NULL;
+	struct pingmulti *multi= NULL;
+	struct pingrate *rate= NULL;
+	struct pingstate *state;
+	len_and_sockaddr *lsa;
+	FILE *fh;
+	struct cookie cookie;
+
+	if (!ping_base)
+	{
+		ping_base = malloc(sizeof(*ping_base));
+		if (ping_base == NULL)
+			return (NULL);
+		memset(ping_base, 0, sizeof(*ping_base));
+
+		ping_base->event_base = EventBase;
 
 		ping_base->tabsiz= 10;
 		ping_base->table= xzalloc(ping_base->tabsiz *
@@ -1267,11 +2560,13 @@ static void *ping_init(int __attribute((unused)) argc, char *argv[],
 	interface= NULL;
 	response_in= NULL;
 	response_out= NULL;
-	/* exactly one argument needed; -c NUM */
-	opt_complementary = "=1:c+:s+:i+";
+	targets_file= NULL;
+	pace= DEFAULT_PING_PACE;
+	pkt_rate= 0;
+	opt_complementary = "c+:s+:i+:P+:H+";
 	opt = getopt32(argv, PING_OPT_STRING, &pingcount, &size,
 		&str_Atlas, &str_bundle, &out_filename, &interval, &interface,
-		&response_in, &response_out);
+		&response_in, &response_out, &targets_file, &pace, &pkt_rate);
 	hostname = argv[optind];
 
 	if (opt == 0xffffffff)
@@ -1280,6 +2575,13 @@ static void *ping_init(int __attribute((unused)) argc, char *argv[],
 		return NULL;
 	}
 
+	/* Exactly one target, except in multi-target mode */
+	if (!(opt & opt_M) && (hostname == NULL || argv[optind+1] != NULL))
+	{
+		crondlog(LVL8 "ping: need exactly one target");
+		return NULL;
+	}
+
 	if (interval < 1 || interval > 60000)
 	{
 		crondlog(LVL8 "bad interval");
@@ -1359,6 +2661,97 @@ static void *ping_init(int __attribute((unused)) argc, char *argv[],
 	if (opt & opt_e)
 		delay_name_res= 0;
 
+	if (pkt_rate)
+	{
+		if (opt & opt_M)
+		{
+			crondlog(LVL8 "ping: -H cannot be combined with -M");
+			goto err;
+		}
+		if (pkt_rate > RATE_MAX)
+		{
+			crondlog(LVL8 "bad rate");
+			goto err;
+		}
+		if (pingcount < 1 || pingcount > RATE_MAX_COUNT)
+		{
+			crondlog(LVL8 "bad count");
+			goto err;
+		}
+
+		/* Enough slots for RATE_WINDOW seconds of packets, but
+		 * never more than the sequence space.
+		 */
+		for (nslots= RATE_MIN_SLOTS;
+			nslots < pkt_rate*RATE_WINDOW && nslots < 65536;
+			nslots *= 2)
+		{
+			;	/* Nothing to do */
+		}
+		rate= xzalloc(sizeof(*rate));
+		rate->rate= pkt_rate;
+		rate->mask= nslots-1;
+		rate->slots= xzalloc(nslots*sizeof(*rate->slots));
+	}
+
+	if (opt & opt_M)
+	{
+		if (opt & (opt_q | opt_Q))
+		{
+			/* There is no room for a summary per target */
+			crondlog(LVL8
+				"ping: -q and -Q cannot be combined with -M");
+			goto err;
+		}
+		if (pingcount < 1 || pingcount > 65535)
+		{
+			crondlog(LVL8 "bad count");
+			goto err;
+		}
+		if (pace < 1 || pace > 1000)
+		{
+			crondlog(LVL8 "bad pace");
+			goto err;
+		}
+		multi= xzalloc(sizeof(*multi));
+		multi->pace= pace;
+		multi->grouped= !!(opt & opt_g);
+
+		/* Names are always resolved by the libevent resolver */
+		delay_name_res= 1;
+
+		for (i= optind; argv[i] != NULL; i++)
+		{
+			if (multi_add_target(multi, argv[i], af) == -1)
+				goto err;
+		}
+		if (targets_file)
+		{
+			validated_targets_file= rebased_validated_filename(
+				ATLAS_SPOOLDIR, targets_file,
+				TARGETS_PREFIX_REL);
+			if (!validated_targets_file)
+			{
+				crondlog(LVL8 "insecure file '%s'",
+					targets_file);
+				goto err;
+			}
+			if (multi_read_targets(multi, validated_targets_file,
+				af) == -1)
+			{
+				goto err;
+			}
+			free(validated_targets_file);
+			validated_targets_file= NULL;
+		}
+		if (multi->ntargets == 0)
+		{
+			crondlog(LVL8 "ping: no targets");
+			goto err;
+		}
+		hostname= multi->targets[0].hostname;
+	}
+
 	if (!delay_name_res)
 	{
 		/* Attempt to resolv 'name' */
@@ -1394,6 +2787,7 @@ static void *ping_init(int __attribute((unused)) argc, char *argv[],
 	state->af= af;
 	state->include_probe_id= include_probe_id;
 	state->delay_name_res= delay_name_res;
+	state->dns_nocache= !!(opt & opt_N);
 	state->interval= interval;
 	state->interface= interface ? strdup(interface) : NULL;
 	state->socket= -1;
@@ -1448,6 +2842,16 @@ static void *ping_init(int __attribute((unused)) argc, char *argv[],
 
 	state->maxsize = size;
 	state->base->done= done;
+	state->multi= multi;
+	state->rate= rate;
+	if (opt & (opt_q | opt_Q))
+		state->stats= xzalloc(sizeof(*state->stats));
+	state->summary_only= !!(opt & opt_q);
+	if (rate)
+	{
+		evtimer_assign(&rate->send_timer, state->base->event_base,
+			rate_send_callback, state);
+	}
 
 	return state;
 
@@ -1455,6 +2859,13 @@ err:
 	if (validated_response_in) free(validated_response_in);
 	if (validated_response_out) free(validated_response_out);
 	if (validated_out_filename) free(validated_out_filename);
+	if (validated_targets_file) free(validated_targets_file);
+	multi_free(multi);
+	if (rate)
+	{
+		free(rate->slots);
+		free(rate);
+	}
 
 	return NULL;
 }
@@ -1609,7 +3020,10 @@ static void ping_start2(void *state)
 	if (!pingstate->response_in)
 		event_add(&pingstate->event, NULL);
 
-	ping_xmit(pingstate);
+	if (pingstate->rate)
+		rate_start(pingstate);
+	else
+		ping_xmit(pingstate);
 }
 
 static void dns_cb(int result, struct evutil_addrinfo *res, void *ctx)
@@ -1766,6 +3180,8 @@ static void ping_start(void *state)
 	pingstate->event_is_init= 0;
 
 	pingstate->maxpkts= pingstate->pingcount;
+	if (pingstate->stats)
+		rtt_stats_reset(pingstate->stats);
 
 	if (pingstate->response_out)
 	{
@@ -1777,6 +3193,12 @@ static void ping_start(void *state)
 		}
 	}
 
+	if (pingstate->multi)
+	{
+		multi_start(pingstate);
+		return;
+	}
+
 	if (!pingstate->delay_name_res)
 	{
 		ping_start2(state);
@@ -1794,8 +3216,8 @@ static void ping_start(void *state)
 		memset(&hints, '\0', sizeof(hints));
 		hints.ai_socktype= SOCK_DGRAM;
 		hints.ai_family= pingstate->af;
-		(void) evdns_getaddrinfo(DnsBase, pingstate->hostname, NULL,
-			&hints, dns_cb, pingstate);
+		dnscache_getaddrinfo(DnsBase, pingstate->hostname, NULL,
+			&hints, pingstate->dns_nocache, dns_cb, pingstate);
 	}
 }
 
@@ -1820,6 +3242,18 @@ static int ping_delete(void *state)
 
 	base->table[pingstate->index]= NULL;
 
+	multi_free(pingstate->multi);
+	pingstate->multi= NULL;
+	free(pingstate->stats);
+	pingstate->stats= NULL;
+	if (pingstate->rate)
+	{
+		evtimer_del(&pingstate->rate->send_timer);
+		free(pingstate->rate->slots);
+		free(pingstate->rate);
+		pingstate->rate= NULL;
+	}
+
 	free(pingstate->atlas);
 	pingstate->atlas= NULL;
 	free(pingstate->bundle_id);
@@ -15,6 +15,7 @@ Created:	April 2013 by Philip Homburg for RIPE NCC
 
 #include "eperd.h"
 #include "tcputil.h"
+#include "certcache.h"
 #include "atlas_path.h"
 
 #define SAFE_PREFIX_IN ATLAS_DATA_OUT
@@ -84,6 +85,8 @@ struct state
 	char *response_out;
 	char only_v4;
 	char only_v6;
+	char dns_nocache;		/* Bypass the DNS cache */
+	char cert_ref;			/* Report known chains by fingerprint */
 	char major_version;
 	char minor_version;
 
@@ -108,6 +111,13 @@ struct state
 	char recv_minor;
 	unsigned server_cipher;
 
+	uint8_t *hello;		/* ClientHello template, see build_hello */
+	size_t hello_len;
+
+	/* Chain this instance last reported in full, for cert_ref */
+	char chain_reported;
+	unsigned char chain_fp[CERTCACHE_FP_LEN];
+
 	struct buf inbuf;
 	struct msgbuf msginbuf;
 
@@ -147,6 +157,12 @@ struct hsbuf
 
 #define URANDOM_DEV	"/dev/urandom"
 
+/* Offset of the random in the ClientHello template, after the record
+ * header, the handshake header and the version.
+ */
+#define HELLO_RANDOM	(5+4+2)
+#define HELLO_RANDOM_LEN 32
+
 static struct hgbase *hg_base;
 
 static int eat_server_hello(struct state *state);
@@ -339,29 +355,6 @@ static int buf_read(struct state *state, struct buf *buf)
 	return -1;
 }
 
-static int buf_write(struct buf *buf)
-{
-	int r;
-	size_t len;
-	struct evbuffer *output;
-
-	output= bufferevent_get_output(buf->bev);
-	while (buf->offset < buf->size)
-	{
-		len= buf->size - buf->offset;
-		r= evbuffer_add(output, buf->buf+buf->offset, len);
-		if (r >= 0)
-		{
-			buf->offset += len;
-			continue;
-		}
-		fprintf(stderr, "write to %p failed: %s\n",
-			buf->bev, r == 0 ? "eof" : strerror(errno));
-		return -1;
-	}
-	return 0;
-}
-
 static void buf_cleanup(struct buf *buf)
 {
 	free(buf->buf);
@@ -536,11 +529,10 @@ static void hsbuf_final(struct hsbuf *hsbuf, int type, struct msgbuf *msgbuf)
 	hsbuf->buffer.offset += len;
 }
 
-static void add_random(struct hsbuf *hsbuf)
+static void fill_random(uint8_t *buf)
 {
 	int fd;
 	time_t t;
-	uint8_t buf[32];
 
 	t= time(NULL);
 	buf[0]= t >> 24;
@@ -553,10 +545,9 @@ static void add_random(struct hsbuf *hsbuf)
 	/* Best effort, just ignore errors */
 	if (fd != -1)
 	{
-		read(fd, buf+4, sizeof(buf)-4);
+		read(fd, buf+4, HELLO_RANDOM_LEN-4);
 		close(fd);
 	}
-	hsbuf_add(hsbuf, buf, sizeof(buf));
 }
 
 static void add_sessionid(struct hsbuf *hsbuf)
@@ -715,6 +706,46 @@ static void add_extensions(struct state *state, struct hsbuf *hsbuf)
 	hsbuf_cleanup(&elliptic_curves_buf);
 }
 
+/* Only the random differs between ClientHellos of an instance. Build the
+ * records once, writecb fills in the random before sending.
+ */
+static void build_hello(struct state *state)
+{
+	uint8_t c;
+	uint8_t random[HELLO_RANDOM_LEN];
+	struct buf outbuf;
+	struct msgbuf msgoutbuf;
+	struct hsbuf hsbuf;
+
+	buf_init(&outbuf, NULL);
+	msgbuf_init(&msgoutbuf, NULL, &outbuf);
+	hsbuf_init(&hsbuf);
+
+	/* Major/minor */
+	c= state->major_version;
+	hsbuf_add(&hsbuf, &c, 1);
+
+	c= state->minor_version;
+	hsbuf_add(&hsbuf, &c, 1);
+	memset(random, '\0', sizeof(random));
+	hsbuf_add(&hsbuf, random, sizeof(random));
+	add_sessionid(&hsbuf);
+	add_ciphers(&hsbuf);
+	add_compression(&hsbuf);
+
+	add_extensions(state, &hsbuf);
+
+	hsbuf_final(&hsbuf, HS_CLIENT_HELLO, &msgoutbuf);
+	msgbuf_final(&msgoutbuf, MSG_HANDSHAKE);
+
+	hsbuf_cleanup(&hsbuf);
+	msgbuf_cleanup(&msgoutbuf);
+
+	/* Keep the buffer of outbuf, nothing was consumed from it */
+	state->hello= (uint8_t *)outbuf.buf;
+	state->hello_len= outbuf.size;
+}
+
 static struct hgbase *sslgetcert_base_new(struct event_base *event_base)
 {
 	struct hgbase *base;
@@ -779,7 +810,7 @@ static void timeout_callback(int __attribute((unused)) unused,
 static void *sslgetcert_init(int __attribute((unused)) argc, char *argv[],
 	void (*done)(void *state, int error))
 {
-	int c, i, only_v4, only_v6, major, minor;
+	int c, i, only_v4, only_v6, dns_nocache, cert_ref, major, minor;
 	size_t newsiz;
 	char *hostname, *str_port, *infname, *version_str;
 	char *output_file, *A_arg, *B_arg, *h_arg;
@@ -802,6 +833,8 @@ static void *sslgetcert_init(int __attribute((unused)) argc, char *argv[],
 	response_out= NULL;
 	only_v4= 0;
 	only_v6= 0;
+	dns_nocache= 0;
+	cert_ref= 0;
 
 	if (!hg_base)
 	{
@@ -813,7 +846,7 @@ static void *sslgetcert_init(int __attribute((unused)) argc, char *argv[],
 
 	/* Allow us to be called directly by another program in busybox */
 	optind= 0;
-	while (c= getopt_long(argc, argv, "A:B:h:O:R:V:W:i:p:46",
+	while (c= getopt_long(argc, argv, "A:B:h:O:R:V:W:i:p:46CN",
 		longopts, NULL), c != -1)
 	{
 		switch(c)
@@ -853,6 +886,12 @@ static void *sslgetcert_init(int __attribute((unused)) argc, char *argv[],
 			only_v6= 1;
 			only_v4= 0;
 			break;
+		case 'C':
+			cert_ref= 1;
+			break;
+		case 'N':
+			dns_nocache= 1;
+			break;
 		default:
 			crondlog(LVL8 "bad option '%c'", c);
 			return NULL;
@@ -975,6 +1014,10 @@ static void *sslgetcert_init(int __attribute((unused)) argc, char *argv[],
 
 	state->only_v4= !!only_v4;	/* Gcc bug? */
 	state->only_v6= !!only_v6;
+	state->dns_nocache= dns_nocache;
+	state->cert_ref= cert_ref;
+
+	build_hello(state);
 
 	state->line= NULL;
 	state->linemax= 0;
@@ -1142,6 +1185,11 @@ static void readcb(struct bufferevent *bev UNUSED_PARAM, void *ptr)
 			buf_cleanup(&state->inbuf);
 			if (!state->response_in)
 				tu_cleanup(&state->tu_env);
+			if (state->resp_file)
+			{
+				fclose(state->resp_file);
+				state->resp_file= NULL;
+			}
 			state->busy= 0;
 			if (state->base->done)
 				state->base->done(state, 0);
@@ -1460,12 +1508,13 @@ static int eat_server_hello(struct state *state)
 
 static int eat_certificate(struct state *state)
 {
-	int i, n, r, first, slen, need_nl, type;
+	int i, n, r, first, slen, need_nl, type, known;
 	size_t o, len;
 	uint8_t *p;
 	struct msgbuf *msgbuf;
 	FILE *fh;
 	struct buf tmpbuf;
+	unsigned char chain_fp[CERTCACHE_FP_LEN], fp[CERTCACHE_FP_LEN];
 
 	msgbuf= &state->msginbuf;
 
@@ -1541,8 +1590,21 @@ static int eat_certificate(struct state *state)
 		if (fh == NULL)
 			return -1;
 
+		/* The same chain as this instance reported last time? */
+		known= 0;
+		if (state->cert_ref && 3+n <= len)
+		{
+			certcache_fp(p+3, n, chain_fp);
+			known= state->chain_reported &&
+				memcmp(chain_fp, state->chain_fp,
+				CERTCACHE_FP_LEN) == 0;
+		}
+
 		first= 1;
-		fprintf(fh, ", " DBQ(cert) ":[ ");
+		if (known)
+			fprintf(fh, ", " DBQ(cert_fp) ":[ ");
+		else
+			fprintf(fh, ", " DBQ(cert) ":[ ");
 
 		buf_init(&tmpbuf, NULL);
 		while (o < 3+n)
@@ -1559,6 +1621,18 @@ static int eat_certificate(struct state *state)
 				report(state);
 				return -1;
 			}
+			if (known)
+			{
+				/* Same chain as reported before */
+				certcache_fp(p+o+3, slen, fp);
+				fprintf(fh, "%s\"", !first ? ", " : "");
+				for (i= 0; i<CERTCACHE_FP_LEN; i++)
+					fprintf(fh, "%02x", fp[i]);
+				fputc('"', fh);
+				o += 3+slen;
+				first= 0;
+				continue;
+			}
 			buf_add_b64(&tmpbuf, p+o+3, slen);
 			fprintf(fh, "%s\"-----BEGIN CERTIFICATE-----\\n",
 				!first ? ", " : "");
@@ -1603,6 +1677,11 @@ static int eat_certificate(struct state *state)
 			report(state);
 			return -1;
 		}
+		if (state->cert_ref && !known)
+		{
+			memcpy(state->chain_fp, chain_fp, CERTCACHE_FP_LEN);
+			state->chain_reported= 1;
+		}
 		msgbuf->buffer.offset += 4+len;
 		break;
 	}
@@ -1617,11 +1696,7 @@ static int eat_certificate(struct state *state)
 
 static void writecb(struct bufferevent *bev, void *ptr)
 {
-	char c;
 	struct state *state;
-	struct buf outbuf;
-	struct msgbuf msgoutbuf;
-	struct hsbuf hsbuf;
 
 	state= ENV2STATE(ptr);
 
@@ -1632,33 +1707,17 @@ static void writecb(struct bufferevent *bev, void *ptr)
 		case WRITE_HELLO:
 			gettime_mono(&state->t_connect);
 
-			buf_init(&outbuf, bev);
-			msgbuf_init(&msgoutbuf, NULL, &outbuf);
-			hsbuf_init(&hsbuf);
-
-			/* Major/minor */
-			c= state->major_version;
-			hsbuf_add(&hsbuf, &c, 1);
-
-			c= state->minor_version;
-			hsbuf_add(&hsbuf, &c, 1);
-			add_random(&hsbuf);
-			add_sessionid(&hsbuf);
-			add_ciphers(&hsbuf);
-			add_compression(&hsbuf);
-
-			add_extensions(state, &hsbuf);
+			fill_random(state->hello + HELLO_RANDOM);
 
-			hsbuf_final(&hsbuf, HS_CLIENT_HELLO, &msgoutbuf);
-			msgbuf_final(&msgoutbuf, MSG_HANDSHAKE);
-
-			/* Ignore error */
+			/* Ignore error. Copied, the template gets a new
+			 * random for the next connection.
+			 */
 			if (!state->response_in)
-				(void) buf_write(&outbuf);
-
-			hsbuf_cleanup(&hsbuf);
-			msgbuf_cleanup(&msgoutbuf);
-			buf_cleanup(&outbuf);
+			{
+				(void) evbuffer_add(
+					bufferevent_get_output(bev),
+					state->hello, state->hello_len);
+			}
 
 			/* Done */
 			state->writestate= WRITE_DONE;
@@ -1884,11 +1943,15 @@ static void sslgetcert_start(void *vstate)
 		writecb(NULL, &state->tu_env);
 		while(state->resp_file != NULL)
 			readcb(NULL, &state->tu_env);
-		report(state);
+
+		/* Unless readcb finished the run */
+		if (state->busy)
+			report(state);
 	}
 	else
 	{
-		tu_connect_to_name(&state->tu_env, state->hostname, 0, 0,
+		tu_connect_to_name(&state->tu_env, state->hostname,
+			state->dns_nocache ? TU_F_DNS_NOCACHE : 0,
 			state->portname,
 			&interval, &hints, state->infname, NULL, NULL,
 			timeout_callback,
@@ -1935,6 +1998,8 @@ static int sslgetcert_delete(void *vstate)
 	state->portname= NULL;
 	free(state->infname);
 	state->infname= NULL;
+	free(state->hello);
+	state->hello= NULL;
 
 	free(state);
 
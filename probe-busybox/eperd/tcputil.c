@@ -6,23 +6,88 @@
 
 #include "libbb.h"
 #include "eperd.h"
+#include "dnscache.h"
 #include <assert.h>
+#include <netinet/tcp.h>
 #include <event2/bufferevent.h>
 #include <event2/dns.h>
 #include <event2/event.h>
 
 #include "tcputil.h"
 
+/* Older C libraries */
+#ifndef TCP_FASTOPEN_CONNECT
+#define TCP_FASTOPEN_CONNECT	30
+#endif
+#ifndef TCPI_OPT_SYN_DATA
+#define TCPI_OPT_SYN_DATA	32
+#endif
+
 const char *ssl_version= NULL;
 
 static int ssl_initialized= 0;
 
+#if ENABLE_FEATURE_EVHTTPGET_HTTPS
+/* SSL_CTX objects are shared by all connections with the same
+ * configuration. Contexts that verify the server certificate share one
+ * trust store. It is loaded once and reloaded when the CA bundle changes.
+ */
+#define TLS_CTX_MAX	4
+
+struct tls_ctx_ent
+{
+	char do_http2;		/* ALPN h2 */
+	char verify;		/* Verify server certificate */
+	SSL_CTX *ctx;
+};
+
+static struct tls_ctx_ent tls_ctx_cache[TLS_CTX_MAX];
+static X509_STORE *tls_store;
+static time_t tls_store_mtime;
+
+/* Client session cache for connections with tls_resume set. Sessions are
+ * keyed by host, port, SNI and the context configuration. The key is
+ * also attached to the SSL object, because a TLS 1.3 ticket can arrive
+ * after tu_env has given up the connection.
+ */
+#define TLS_SESS_MAX	16
+
+struct tls_sess_ent
+{
+	char *key;
+	SSL_SESSION *sess;
+};
+
+static struct tls_sess_ent tls_sess_cache[TLS_SESS_MAX];
+static int tls_sess_next;		/* Entry to replace next */
+static int tls_sess_key_index= -1;	/* SSL ex_data index of the key */
+
+static SSL_CTX *get_tls_ctx(struct tu_env *env, int verify);
+static X509_STORE *get_tls_store(void);
+static SSL_SESSION *get_tls_session(const char *key);
+static int new_session_cb(SSL *tls, SSL_SESSION *sess);
+static void free_sess_key(void *parent, void *ptr, CRYPTO_EX_DATA *ad,
+	int idx, long argl, void *argp);
+#endif
+
 static void dns_cb(int result, struct evutil_addrinfo *res, void *ctx);
 static int create_bev(struct tu_env *env);
+static int connect_bev(struct tu_env *env, struct bufferevent *bev,
+	struct sockaddr *addr, socklen_t addrlen);
 static void eventcb(struct bufferevent *bev, short events, void *ptr);
+static void interleave_addrs(struct evutil_addrinfo *res);
+static void race_start(struct tu_env *env);
+static void race_next(struct tu_env *env);
+static void race_timer_cb(int unused, const short event, void *ptr);
+static void race_won(struct tu_env *env, struct tu_attempt *att);
+static void race_failed(struct tu_env *env, struct tu_attempt *att,
+	const char *err);
+static void race_cancel(struct tu_env *env);
+static void race_done(struct tu_env *env, struct tu_attempt *att,
+	enum tu_attempt_state state, const char *err);
 
 void tu_connect_to_name(struct tu_env *env, char *host,
-	bool do_tls, bool do_http2, char *port,
+	unsigned flags, char *port,
 	struct timeval *interval,
 	struct evutil_addrinfo *hints,
 	char *infname,
@@ -52,13 +117,31 @@ void tu_connect_to_name(struct tu_env *env, char *host,
 	env->writecb= writecb;
 	env->dns_res= NULL;
 	env->bev= NULL;
-	env->do_tls = do_tls;
-	env->do_http2 = do_http2;
+	env->do_tls = !!(flags & TU_F_TLS);
+	env->do_http2 = !!(flags & TU_F_HTTP2);
+	env->tls_resume = !!(flags & TU_F_TLS_RESUME);
+	env->tls_resumed = 0;
+	env->host = host;
+	env->port = port;
 	env->server_name = server_name;
 	env->cert_name = cert_name;
+	env->race = !!(flags & TU_F_RACE);
+	/* Not with a race, the connect would complete locally */
+	env->tfo = (flags & TU_F_TFO) && !env->race;
+	env->tfo_cookie = 0;
+	env->race_next = NULL;
+	env->nattempts = 0;
+	env->race_first = 0;
+	if (env->race && !env->attempts)
+	{
+		env->attempts = xzalloc(TU_ATTEMPT_MAX *
+			sizeof(*env->attempts));
+	}
 
 	evtimer_assign(&env->timer, EventBase,
 		timeout_callback, env);
+	evtimer_assign(&env->race_timer, EventBase,
+		race_timer_cb, env);
 
 	/* Check if hostname is numeric or had to be resolved */
 	env->host_is_literal= 0;
@@ -75,7 +158,8 @@ void tu_connect_to_name(struct tu_env *env, char *host,
 	env->dnsip= 1;
 	env->connecting= 0;
 	gettime_mono(&env->start_time);
-	(void) evdns_getaddrinfo(DnsBase, host, port, hints, dns_cb, env);
+	dnscache_getaddrinfo(DnsBase, host, port, hints,
+		!!(flags & TU_F_DNS_NOCACHE), dns_cb, env);
 }
 
 void tu_restart_connect(struct tu_env *env)
@@ -83,6 +167,25 @@ void tu_restart_connect(struct tu_env *env)
 	int r;
 	struct bufferevent *bev;
 
+	if (env->race)
+	{
+		/* Give up on the attempts in progress, race the rest */
+		race_cancel(env);
+		if (env->race_next)
+		{
+			race_start(env);
+			return;
+		}
+		if (env->dns_res)
+		{
+			evutil_freeaddrinfo(env->dns_res);
+			env->dns_res= NULL;
+			env->dns_curr= NULL;
+		}
+		env->reporterr(env, TU_OUT_OF_ADDRS, "");
+		return;
+	}
+
 	/* Connect failed, try next address */
 	if (env->dns_curr)	/* Just to be on the safe side */
 	{
@@ -117,7 +220,7 @@ void tu_restart_connect(struct tu_env *env)
 			return;
 		}
 		bev= env->bev;
-		if (bufferevent_socket_connect(bev,
+		if (connect_bev(env, bev,
 			env->dns_curr->ai_addr,
 			env->dns_curr->ai_addrlen) == 0)
 		{
@@ -185,6 +288,11 @@ void tu_fake_ttr(void *ctx, char *host)
 
 void tu_cleanup(struct tu_env *env)
 {
+	if (env->race)
+		race_cancel(env);
+	free(env->attempts);
+	env->attempts= NULL;
+	env->nattempts= 0;
 	if (env->dns_res)
 	{
 		evutil_freeaddrinfo(env->dns_res);
@@ -255,6 +363,14 @@ static void dns_cb(int result, struct evutil_addrinfo *res, void *ctx)
 
 	env->reportcount(env, count);
 
+	if (env->race)
+	{
+		interleave_addrs(res);
+		env->race_next= res;
+		race_start(env);
+		return;
+	}
+
 	while (env->dns_curr)
 	{
 		evtimer_add(&env->timer, &env->interval);
@@ -285,7 +401,7 @@ static void dns_cb(int result, struct evutil_addrinfo *res, void *ctx)
 		}
 
 		bev= env->bev;
-		if (bufferevent_socket_connect(bev,
+		if (connect_bev(env, bev,
 			env->dns_curr->ai_addr,
 			env->dns_curr->ai_addrlen) == 0)
 		{
@@ -339,18 +455,17 @@ static void dns_cb(int result, struct evutil_addrinfo *res, void *ctx)
 
 static int create_bev(struct tu_env *env)
 {
-	int af, fd, fl;
+	int af, fd, fl, on;
 	struct bufferevent *bev;
 	SSL *tls;
-	X509_VERIFY_PARAM *vpm = NULL;
 
 	af= env->dns_curr->ai_addr->sa_family;
 
-	/* Consistency check. These fields need to be clear */
-	assert(!env->tls_ctx);
 #if ENABLE_FEATURE_EVHTTPGET_HTTPS
 	if(env->do_tls || env->do_http2)
 	{
+		int verify;
+
 		if (!ssl_initialized) {
 			ssl_initialized= 1;
 			RAND_poll();
@@ -363,75 +478,37 @@ static int create_bev(struct tu_env *env)
 			 * What about OpenSSL_version(OPENSSL_VERSION)?
 			 */
 			ssl_version= SSLeay_version(SSLEAY_VERSION);
+
+			tls_sess_key_index= SSL_get_ex_new_index(0, NULL,
+				NULL, NULL, free_sess_key);
 		}
-		/* fancy ssl options yet. just what is default in lib */
-		if ((env->tls_ctx = SSL_CTX_new(SSLv23_client_method())) == NULL)
+		/* Drop the context of a previous connect attempt */
+		if (env->tls_ctx)
 		{
-			env->reporterr(env, TU_SSL_CTX_INIT_ERR,
-				"SSL_CTX_new call failed");
+			SSL_CTX_free(env->tls_ctx);
+			env->tls_ctx= NULL;
+		}
+		verify= (env->do_http2 && env->cert_name != NULL);
+		if ((env->tls_ctx= get_tls_ctx(env, verify)) == NULL)
 			return -1;
+		if ((tls = SSL_new(env->tls_ctx)) == NULL) {
+			env->reporterr(env, TU_SSL_OBJ_INIT_ERR,
+				"SSL_new call failed");
+				return -1;
 		}
-		if (env->do_http2)
+		if (verify)
 		{
-			/* SSL_CTX_set_alpn_protos gets an ALPN list
-			 * in wire format. Each string is prefixed by
-			 * a length byte.
+			/* The context is shared, the name to check is set
+			 * per connection.
 			 */
-			const unsigned char alpn_list[]=
-				{ '\2', 'h', '2' };
-			size_t alpn_len= sizeof(alpn_list);
-			int r;
-
-			r= SSL_CTX_set_alpn_protos(env->tls_ctx,
-				alpn_list, alpn_len);
-			if (r != 0)
-			{
-				env->reporterr(env, TU_SSL_CTX_INIT_ERR,
-				"SSL_CTX_set_alpn_protos call failed");
-                                return -1;
-			}
-			if (env->cert_name)
+			if (!X509_VERIFY_PARAM_set1_host(SSL_get0_param(tls),
+				env->cert_name, 0))
 			{
-				if (!SSL_CTX_set_default_verify_paths
-					(env->tls_ctx))
-				{
-					env->reporterr(env,
-						TU_SSL_CTX_INIT_ERR,
-			"SSL_CTX_set_default_verify_paths call failed");
-                                	return -1;
-				}
-				vpm= X509_VERIFY_PARAM_new();
-				if (!X509_VERIFY_PARAM_set1_host(vpm,
-					env->cert_name, 0))
-				{
-					env->reporterr(env,
-						TU_SSL_CTX_INIT_ERR,
+				env->reporterr(env, TU_SSL_OBJ_INIT_ERR,
 				"X509_VERIFY_PARAM_set1_host call failed");
-					X509_VERIFY_PARAM_free(vpm);
-					vpm= NULL;
-                                	return -1;
-				}
-			}
-		}
-		if (vpm)
-		{
-			if (!SSL_CTX_set1_param(env->tls_ctx, vpm))
-			{
-				env->reporterr(env, TU_SSL_CTX_INIT_ERR,
-				"SSL_CTX_set1_param call failed");
-				X509_VERIFY_PARAM_free(vpm);
-				vpm= NULL;
-                                return -1;
-			}
-			X509_VERIFY_PARAM_free(vpm);
-			vpm= NULL;
-			SSL_CTX_set_verify(env->tls_ctx,
-				SSL_VERIFY_PEER, 0);
-		}
-		if ((tls = SSL_new(env->tls_ctx)) == NULL) {
-			env->reporterr(env, TU_SSL_OBJ_INIT_ERR,
-				"SSL_new call failed");
+				SSL_free(tls);
 				return -1;
+			}
 		}
 		if (env->server_name)
 		{
@@ -443,6 +520,25 @@ static int create_bev(struct tu_env *env)
 				return -1;
 			}
 		}
+		env->tls_resumed= 0;
+		if (env->tls_resume)
+		{
+			char *key;
+			SSL_SESSION *sess;
+
+			key= xasprintf("%s %s %s %s %d", env->host, env->port,
+				env->server_name ? env->server_name : "",
+				verify ? env->cert_name : "", env->do_http2);
+			sess= get_tls_session(key);
+			if (sess)
+			{
+				SSL_set_session(tls, sess);
+				SSL_SESSION_free(sess);
+			}
+
+			/* The SSL object owns the key from here on */
+			SSL_set_ex_data(tls, tls_sess_key_index, key);
+		}
 		bev = bufferevent_openssl_socket_new(EventBase, -1, tls,
 				BUFFEREVENT_SSL_CONNECTING,
 				BEV_OPT_CLOSE_ON_FREE);
@@ -462,7 +558,8 @@ static int create_bev(struct tu_env *env)
 	{
 		crondlog(DIE9 "bufferevent_socket_new failed");
 	}
-	if (env->infname)
+	env->tfo_cookie= 0;
+	if (env->infname || env->tfo)
 	{
 		fd= socket(af, SOCK_STREAM, 0);
 		if (fd == -1)
@@ -472,7 +569,8 @@ static int create_bev(struct tu_env *env)
 			return -1;
 		}
 
-		if (bind_interface(fd, af, env->infname) == -1)
+		if (env->infname &&
+			bind_interface(fd, af, env->infname) == -1)
 		{
 			env->reporterr(env, TU_SOCKET_ERR,
 				"bind_interface failed");
@@ -493,6 +591,14 @@ static int create_bev(struct tu_env *env)
                         return -1;
                 }
 
+		/* Without kernel support this is a normal connect */
+		if (env->tfo)
+		{
+			on= 1;
+			setsockopt(fd, IPPROTO_TCP, TCP_FASTOPEN_CONNECT,
+				&on, sizeof(on));
+		}
+
 		bufferevent_setfd(bev, fd);
 	}
 	bufferevent_setcb(bev, env->readcb, env->writecb, eventcb, env);
@@ -503,14 +609,314 @@ static int create_bev(struct tu_env *env)
 	return 0;
 }
 
+/* With TCP Fast Open, connect returns at once if the kernel has a cookie
+ * for the server. The SYN then carries the first write, the request or
+ * the ClientHello.
+ */
+static int connect_bev(struct tu_env *env, struct bufferevent *bev,
+	struct sockaddr *addr, socklen_t addrlen)
+{
+	if (!env->tfo)
+		return bufferevent_socket_connect(bev, addr, addrlen);
+
+	if (connect(bufferevent_getfd(bev), addr, addrlen) == 0)
+		env->tfo_cookie= 1;
+	else if (errno != EINPROGRESS && errno != EINTR)
+		return -1;
+
+	/* Let libevent wait for the socket to become writable */
+	return bufferevent_socket_connect(bev, NULL, 0);
+}
+
+/* Outcome of TCP Fast Open for the connection on bev: "syn-data" if the
+ * server accepted data in the SYN, "cookie" if it had to be sent again
+ * after the handshake, "none" if there was no cookie yet.
+ */
+const char *tu_tfo_result(struct tu_env *env, struct bufferevent *bev)
+{
+	struct tcp_info info;
+	socklen_t len;
+
+	if (!env->tfo_cookie)
+		return "none";
+	len= sizeof(info);
+	if (bev && getsockopt(bufferevent_getfd(bev), IPPROTO_TCP, TCP_INFO,
+		&info, &len) == 0 && (info.tcpi_options & TCPI_OPT_SYN_DATA))
+	{
+		return "syn-data";
+	}
+	return "cookie";
+}
+
+#if ENABLE_FEATURE_EVHTTPGET_HTTPS
+/* Return a new reference to a shared context for env */
+static SSL_CTX *get_tls_ctx(struct tu_env *env, int verify)
+{
+	int i, r;
+	SSL_CTX *ctx;
+	X509_STORE *store;
+	struct tls_ctx_ent *ent, *free_ent;
+
+	store= NULL;
+	if (verify)
+	{
+		/* This may flush contexts that use an outdated store */
+		store= get_tls_store();
+		if (store == NULL)
+		{
+			env->reporterr(env, TU_SSL_CTX_INIT_ERR,
+			"X509_STORE_set_default_paths call failed");
+			return NULL;
+		}
+	}
+
+	free_ent= NULL;
+	for (i= 0, ent= tls_ctx_cache; i<TLS_CTX_MAX; i++, ent++)
+	{
+		if (ent->ctx == NULL)
+		{
+			if (free_ent == NULL)
+				free_ent= ent;
+			continue;
+		}
+		if (ent->do_http2 == env->do_http2 && ent->verify == verify)
+		{
+			SSL_CTX_up_ref(ent->ctx);
+			return ent->ctx;
+		}
+	}
+
+	/* fancy ssl options yet. just what is default in lib */
+	if ((ctx = SSL_CTX_new(SSLv23_client_method())) == NULL)
+	{
+		env->reporterr(env, TU_SSL_CTX_INIT_ERR,
+			"SSL_CTX_new call failed");
+		return NULL;
+	}
+	if (env->do_http2)
+	{
+		/* SSL_CTX_set_alpn_protos gets an ALPN list
+		 * in wire format. Each string is prefixed by
+		 * a length byte.
+		 */
+		const unsigned char alpn_list[]=
+			{ '\2', 'h', '2' };
+		size_t alpn_len= sizeof(alpn_list);
+
+		r= SSL_CTX_set_alpn_protos(ctx, alpn_list, alpn_len);
+		if (r != 0)
+		{
+			env->reporterr(env, TU_SSL_CTX_INIT_ERR,
+			"SSL_CTX_set_alpn_protos call failed");
+			SSL_CTX_free(ctx);
+			return NULL;
+		}
+	}
+	if (verify)
+	{
+		SSL_CTX_set1_cert_store(ctx, store);
+		SSL_CTX_set_verify(ctx, SSL_VERIFY_PEER, 0);
+	}
+
+	/* Sessions go to our own cache, and only for tls_resume */
+	SSL_CTX_set_session_cache_mode(ctx,
+		SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+	SSL_CTX_sess_set_new_cb(ctx, new_session_cb);
+
+	/* The cache only holds a handful of configurations. If it is
+	 * full, just don't cache.
+	 */
+	if (free_ent)
+	{
+		free_ent->do_http2= env->do_http2;
+		free_ent->verify= verify;
+		free_ent->ctx= ctx;
+		SSL_CTX_up_ref(ctx);
+	}
+	return ctx;
+}
+
+/* Return the trust store for the default verify paths, (re)loading it if
+ * the CA bundle changed since it was loaded.
+ */
+static X509_STORE *get_tls_store(void)
+{
+	int i;
+	time_t mtime;
+	const char *path;
+	X509_STORE *store;
+	struct stat sb;
+
+	mtime= 0;
+	path= getenv(X509_get_default_cert_file_env());
+	if (path == NULL)
+		path= X509_get_default_cert_file();
+	if (stat(path, &sb) == 0 && sb.st_mtime > mtime)
+		mtime= sb.st_mtime;
+	path= getenv(X509_get_default_cert_dir_env());
+	if (path == NULL)
+		path= X509_get_default_cert_dir();
+	if (stat(path, &sb) == 0 && sb.st_mtime > mtime)
+		mtime= sb.st_mtime;
+
+	if (tls_store && mtime == tls_store_mtime)
+		return tls_store;
+
+	store= X509_STORE_new();
+	if (store == NULL)
+		return NULL;
+	if (!X509_STORE_set_default_paths(store))
+	{
+		X509_STORE_free(store);
+		return NULL;
+	}
+
+	if (tls_store)
+	{
+		/* Connections in progress keep their references */
+		X509_STORE_free(tls_store);
+		for (i= 0; i<TLS_CTX_MAX; i++)
+		{
+			if (tls_ctx_cache[i].ctx && tls_ctx_cache[i].verify)
+			{
+				SSL_CTX_free(tls_ctx_cache[i].ctx);
+				tls_ctx_cache[i].ctx= NULL;
+			}
+		}
+	}
+	tls_store= store;
+	tls_store_mtime= mtime;
+	return tls_store;
+}
+
+/* Return a reference to a cached session for key, NULL if there is none.
+ * TLS 1.3 tickets should be used only once, so those leave the cache.
+ */
+static SSL_SESSION *get_tls_session(const char *key)
+{
+	int i;
+	SSL_SESSION *sess;
+	struct tls_sess_ent *ent;
+
+	for (i= 0, ent= tls_sess_cache; i<TLS_SESS_MAX; i++, ent++)
+	{
+		if (ent->key != NULL && strcmp(ent->key, key) == 0)
+			break;
+	}
+	if (i >= TLS_SESS_MAX)
+		return NULL;
+
+	sess= ent->sess;
+	if (time(NULL) >= SSL_SESSION_get_time(sess) +
+		SSL_SESSION_get_timeout(sess) ||
+		!SSL_SESSION_is_resumable(sess))
+	{
+		SSL_SESSION_free(sess);
+		sess= NULL;
+	}
+	else if (SSL_SESSION_get_protocol_version(sess) < TLS1_3_VERSION)
+	{
+		/* Keep it for the next connection */
+		SSL_SESSION_up_ref(sess);
+		return sess;
+	}
+
+	free(ent->key);
+	ent->key= NULL;
+	ent->sess= NULL;
+	return sess;
+}
+
+static int new_session_cb(SSL *tls, SSL_SESSION *sess)
+{
+	int i;
+	const char *key;
+	struct tls_sess_ent *ent;
+
+	key= SSL_get_ex_data(tls, tls_sess_key_index);
+	if (key == NULL)
+		return 0;	/* No tls_resume */
+
+	/* Replace the session for the same key, otherwise the oldest */
+	for (i= 0, ent= tls_sess_cache; i<TLS_SESS_MAX; i++, ent++)
+	{
+		if (ent->key != NULL && strcmp(ent->key, key) == 0)
+			break;
+	}
+	if (i >= TLS_SESS_MAX)
+	{
+		ent= &tls_sess_cache[tls_sess_next];
+		tls_sess_next= (tls_sess_next+1) % TLS_SESS_MAX;
+		free(ent->key);
+		ent->key= strdup(key);
+	}
+	if (ent->sess)
+		SSL_SESSION_free(ent->sess);
+
+	/* Keep a copy. Libevent frees connections without SSL_shutdown and
+	 * OpenSSL then marks their session as not resumable.
+	 */
+	ent->sess= SSL_SESSION_dup(sess);
+	if (ent->sess == NULL)
+	{
+		free(ent->key);
+		ent->key= NULL;
+	}
+
+	return 0;
+}
+
+static void free_sess_key(void *parent UNUSED_PARAM, void *ptr,
+	CRYPTO_EX_DATA *ad UNUSED_PARAM, int idx UNUSED_PARAM,
+	long argl UNUSED_PARAM, void *argp UNUSED_PARAM)
+{
+	free(ptr);
+}
+#endif /* ENABLE_FEATURE_EVHTTPGET_HTTPS */
+
 static void eventcb(struct bufferevent *bev, short events, void *ptr)
 {
+	int i;
 	long err;
 	struct tu_env *env;
+	struct tu_attempt *att;
 	char errbuf[80];
 
 	env= ptr;
 
+	if (env->race && bev != env->bev)
+	{
+		/* One of the attempts of a race */
+		att= NULL;
+		for (i= 0; i<env->nattempts; i++)
+		{
+			if (env->attempts[i].bev == bev)
+			{
+				att= &env->attempts[i];
+				break;
+			}
+		}
+		if (att == NULL)
+			return;
+		if (events & (BEV_EVENT_ERROR|BEV_EVENT_EOF))
+		{
+			err= bufferevent_get_openssl_error(bev);
+			if (err)
+				ERR_error_string_n(err, errbuf, sizeof(errbuf));
+			else
+			{
+				strlcpy(errbuf, (events & BEV_EVENT_ERROR) ?
+					strerror(errno) : "connection closed",
+					sizeof(errbuf));
+			}
+			race_failed(env, att, errbuf);
+			return;
+		}
+		if (!(events & BEV_EVENT_CONNECTED))
+			return;
+		race_won(env, att);
+	}
+
 	if (events & BEV_EVENT_ERROR)
 	{
 		if (env->connecting)
@@ -544,6 +950,12 @@ static void eventcb(struct bufferevent *bev, short events, void *ptr)
 		events &= ~BEV_EVENT_CONNECTED;
 		env->connecting= 0;
 
+		if (env->do_tls || env->do_http2)
+		{
+			env->tls_resumed= SSL_session_reused(
+				bufferevent_openssl_get_ssl(bev));
+		}
+
 		if (env->do_http2)
 		{
 			/* Check if the server accepted the h2 ALPN */
@@ -573,3 +985,228 @@ static void eventcb(struct bufferevent *bev, short events, void *ptr)
 		printf("events = 0x%x\n", events);
 }
 
+/* Reorder the addresses so that the address families alternate, starting
+ * with the family of the first address (RFC 8305, Section 4). The first
+ * address stays first, so res remains the head of the list.
+ */
+static void interleave_addrs(struct evutil_addrinfo *res)
+{
+	int family;
+	struct evutil_addrinfo *ai, *next, *same, *other, **same_tail,
+		**other_tail, **tail;
+
+	family= res->ai_family;
+	same= NULL;
+	same_tail= &same;
+	other= NULL;
+	other_tail= &other;
+	for (ai= res; ai; ai= next)
+	{
+		next= ai->ai_next;
+		ai->ai_next= NULL;
+		if (ai->ai_family == family)
+		{
+			*same_tail= ai;
+			same_tail= &ai->ai_next;
+		}
+		else
+		{
+			*other_tail= ai;
+			other_tail= &ai->ai_next;
+		}
+	}
+
+	tail= &ai;
+	while (same || other)
+	{
+		if (same)
+		{
+			*tail= same;
+			tail= &same->ai_next;
+			same= same->ai_next;
+		}
+		if (other)
+		{
+			*tail= other;
+			tail= &other->ai_next;
+			other= other->ai_next;
+		}
+	}
+	*tail= NULL;
+}
+
+static double race_ms(struct tu_env *env)
+{
+	struct timespec now;
+
+	gettime_mono(&now);
+	return (now.tv_sec-env->race_start.tv_sec)*1e3 +
+		(now.tv_nsec-env->race_start.tv_nsec)/1e6;
+}
+
+/* Start a race with the addresses from race_next on. The caller sees a
+ * single connect: beforeconnect is called once and connected gets the
+ * winner in dns_curr.
+ */
+static void race_start(struct tu_env *env)
+{
+	/* Later races add to the attempts of the earlier ones */
+	if (env->nattempts == 0)
+		gettime_mono(&env->race_start);
+	env->race_first= env->nattempts;
+
+	env->dns_curr= env->race_next;
+	if (atlas_check_addr(env->dns_curr->ai_addr,
+		env->dns_curr->ai_addrlen) == -1)
+	{
+		env->reporterr(env, TU_BAD_ADDR, "");
+		return;
+	}
+	env->beforeconnect(env,
+		env->dns_curr->ai_addr, env->dns_curr->ai_addrlen);
+
+	race_next(env);
+}
+
+/* Whether the current race may start another attempt */
+static int race_room(struct tu_env *env)
+{
+	return env->nattempts-env->race_first < TU_RACE_MAX &&
+		env->nattempts < TU_ATTEMPT_MAX;
+}
+
+/* Start attempts until one is connecting. Report an error if none are
+ * left.
+ */
+static void race_next(struct tu_env *env)
+{
+	int i;
+	struct evutil_addrinfo *ai;
+	struct tu_attempt *att;
+	struct timeval delay;
+
+	att= NULL;
+	while (env->race_next && race_room(env))
+	{
+		ai= env->race_next;
+		env->race_next= ai->ai_next;
+		env->dns_curr= ai;
+
+		if (atlas_check_addr(ai->ai_addr, ai->ai_addrlen) == -1)
+		{
+			race_cancel(env);
+			env->reporterr(env, TU_BAD_ADDR, "");
+			return;
+		}
+
+		if (create_bev(env) == -1)
+		{
+			race_cancel(env);
+			return;
+		}
+		att= &env->attempts[env->nattempts++];
+		att->ai= ai;
+		att->addrlen= ai->ai_addrlen;
+		memcpy(&att->addr, ai->ai_addr, att->addrlen);
+		att->bev= env->bev;
+		env->bev= NULL;
+		att->state= TU_ATTEMPT_CONNECTING;
+		att->start= race_ms(env);
+		att->end= 0;
+		att->err[0]= '\0';
+
+		/* Each attempt gets at least the full interval */
+		evtimer_add(&env->timer, &env->interval);
+
+		if (bufferevent_socket_connect(att->bev, ai->ai_addr,
+			ai->ai_addrlen) == 0)
+		{
+			if (env->race_next && race_room(env))
+			{
+				delay.tv_sec= 0;
+				delay.tv_usec= TU_RACE_DELAY * 1000;
+				evtimer_add(&env->race_timer, &delay);
+			}
+			return;
+		}
+
+		/* Immediate error. The event callback may have dealt with
+		 * it already.
+		 */
+		if (att->state != TU_ATTEMPT_CONNECTING)
+			return;
+		race_done(env, att, TU_ATTEMPT_FAILED, strerror(errno));
+	}
+
+	for (i= env->race_first; i<env->nattempts; i++)
+	{
+		if (env->attempts[i].state == TU_ATTEMPT_CONNECTING)
+			return;
+	}
+
+	/* Every attempt failed */
+	env->reporterr(env, TU_CONNECT_ERR,
+		env->nattempts ? env->attempts[env->nattempts-1].err : "");
+}
+
+static void race_timer_cb(int __attribute((unused)) unused,
+	const short __attribute((unused)) event, void *ptr)
+{
+	race_next(ptr);
+}
+
+static void race_won(struct tu_env *env, struct tu_attempt *att)
+{
+	int i;
+
+	evtimer_del(&env->race_timer);
+	att->state= TU_ATTEMPT_CONNECTED;
+	att->end= race_ms(env);
+	env->bev= att->bev;
+	att->bev= NULL;
+	env->dns_curr= att->ai;
+
+	for (i= 0; i<env->nattempts; i++)
+	{
+		if (env->attempts[i].state == TU_ATTEMPT_CONNECTING)
+		{
+			race_done(env, &env->attempts[i],
+				TU_ATTEMPT_CANCELLED, "");
+		}
+	}
+}
+
+static void race_failed(struct tu_env *env, struct tu_attempt *att,
+	const char *err)
+{
+	race_done(env, att, TU_ATTEMPT_FAILED, err);
+
+	/* Don't wait for the timer, start the next attempt now */
+	evtimer_del(&env->race_timer);
+	race_next(env);
+}
+
+static void race_cancel(struct tu_env *env)
+{
+	int i;
+
+	evtimer_del(&env->race_timer);
+	for (i= 0; i<env->nattempts; i++)
+	{
+		if (env->attempts[i].state == TU_ATTEMPT_CONNECTING)
+		{
+			race_done(env, &env->attempts[i],
+				TU_ATTEMPT_CANCELLED, "");
+		}
+	}
+}
+
+static void race_done(struct tu_env *env, struct tu_attempt *att,
+	enum tu_attempt_state state, const char *err)
+{
+	bufferevent_free(att->bev);
+	att->bev= NULL;
+	att->state= state;
+	att->end= race_ms(env);
+	strlcpy(att->err, err, sizeof(att->err));
+}
@@ -14,6 +14,28 @@ enum tu_err { TU_DNS_ERR, TU_READ_ERR, TU_SOCKET_ERR, TU_CONNECT_ERR,
 	TU_OUT_OF_ADDRS, TU_BAD_ADDR, TU_SSL_CTX_INIT_ERR, TU_SSL_OBJ_INIT_ERR,
 	TU_SSL_INIT_ERR };
 
+/* Connection racing (RFC 8305). Attempts start TU_RACE_DELAY ms apart,
+ * or as soon as the previous one fails. The first to connect wins.
+ */
+#define TU_RACE_DELAY	250	/* Connection Attempt Delay, ms */
+#define TU_RACE_MAX	8	/* Attempts per race */
+#define TU_ATTEMPT_MAX	32	/* Attempts per measurement, over all races */
+
+enum tu_attempt_state { TU_ATTEMPT_CONNECTING, TU_ATTEMPT_CONNECTED,
+	TU_ATTEMPT_FAILED, TU_ATTEMPT_CANCELLED };
+
+struct tu_attempt
+{
+	struct evutil_addrinfo *ai;	/* Until dns_res is freed */
+	struct sockaddr_in6 addr;
+	socklen_t addrlen;
+	struct bufferevent *bev;	/* While connecting */
+	enum tu_attempt_state state;
+	double start;			/* ms since the first race started */
+	double end;
+	char err[80];
+};
+
 struct tu_env
 {
 	char dnsip;
@@ -26,6 +48,19 @@ struct tu_env
 	char *infname;
 	char do_tls;
 	char do_http2;
+	char tls_resume;	/* Use the TLS session cache */
+	char tls_resumed;	/* Handshake resumed a session */
+	char race;		/* Race connections to all addresses */
+	char tfo;		/* TCP Fast Open, not with race */
+	char tfo_cookie;	/* Connect waits for the first write */
+	struct evutil_addrinfo *race_next;	/* Next address to try */
+	struct event race_timer;
+	struct timespec race_start;
+	struct tu_attempt *attempts;	/* TU_ATTEMPT_MAX, only with race */
+	int nattempts;		/* Reset per measurement */
+	int race_first;		/* First attempt of the current race */
+	const char *host;
+	const char *port;
 	const char *server_name;
 	const char *cert_name;
 	SSL_CTX *tls_ctx;
@@ -44,8 +79,16 @@ struct tu_env
 
 extern const char *ssl_version;
 
+/* Flags for tu_connect_to_name */
+#define TU_F_TLS	0x01	/* Connect with TLS */
+#define TU_F_HTTP2	0x02	/* Offer h2 in ALPN */
+#define TU_F_TLS_RESUME	0x04	/* Use the TLS session cache */
+#define TU_F_RACE	0x08	/* Race connections to all addresses */
+#define TU_F_DNS_NOCACHE 0x10	/* Bypass the DNS answer cache */
+#define TU_F_TFO	0x20	/* TCP Fast Open, ignored with TU_F_RACE */
+
 void tu_connect_to_name(struct tu_env *env, char *host,
-	bool do_tls, bool do_http2, char *port,
+	unsigned flags, char *port,
 	struct timeval *interval,
 	struct evutil_addrinfo *hints,
 	char *infname,
@@ -62,4 +105,5 @@ void tu_connect_to_name(struct tu_env *env, char *host,
 	void (*writecb)(struct bufferevent *bev, void *ptr));
 void tu_restart_connect(struct tu_env *env);
 void tu_fake_ttr(void *ctx, char *host);
+const char *tu_tfo_result(struct tu_env *env, struct bufferevent *bev);
 void tu_cleanup(struct tu_env *env);
@@ -17,6 +17,8 @@
 #include <netinet/udp.h>
 
 #include "eperd.h"
+#include "dnscache.h"
+#include "icmperr.h"
 #include "atlas_path.h"
 
 #define SAFE_PREFIX_REL ATLAS_DATA_NEW_REL
@@ -28,7 +30,7 @@
 #define uh_sum check
 #endif
 
-#define TRACEROUTE_OPT_STRING ("!46IUFrTa:b:c:f:g:i:m:p:t:w:z:A:B:O:S:H:D:R:W:")
+#define TRACEROUTE_OPT_STRING ("!46IUFrTPNa:b:c:f:g:i:m:p:t:w:z:A:B:O:S:H:D:R:W:E:")
 
 #define OPT_4	(1 << 0)
 #define OPT_6	(1 << 1)
@@ -37,6 +39,8 @@
 #define OPT_F	(1 << 4)
 #define OPT_r	(1 << 5)
 #define OPT_T	(1 << 6)
+#define OPT_P	(1 << 7)
+#define OPT_N	(1 << 8)
 
 #define IPHDR              20
 #define ICMP6_HDR 	(sizeof(struct icmp6_hdr))
@@ -46,6 +50,24 @@
 #define SRC_BASE_PORT	(20480)
 #define MAX_DATA_SIZE   (4096)
 
+#define PAR_PACE	20000	/* Time between rounds of parallel probes (us) */
+
+/* Instance indexes. The index is the source port offset for UDP and TCP,
+ * so it has to stay below 65536-SRC_BASE_PORT. IPv4 ICMP has only the bits
+ * below the instance id in icmp_id, so those instances take indexes from
+ * a separate low range. IPv6 probes also carry a generation counter in the
+ * upper half of v6info->id.
+ */
+#define TRT_MAX_INDEX	(65536-SRC_BASE_PORT)
+#define TRT_LO_INDEX	(1 << TRT_ICMP4_INSTANCE_ID_SHIFT)
+#define TRT_GEN_SHIFT	16
+#define TRT_INDEX_MASK	0xffff
+#define TRT_ID6(state)	((state)->index | \
+				((uint32_t)(state)->gen << TRT_GEN_SHIFT))
+
+#define STOPSET_HASH	256	/* Hash buckets in the stop set */
+#define STOPSET_MAX	4096	/* Max. entries in the stop set */
+
 #define DBQ(str) "\"" #str "\""
 
 #define ICMPEXT_VERSION_SHIFT 4
@@ -71,6 +93,21 @@
 #define RESP_ADDRINFO		8
 #define RESP_ADDRINFO_SA	9
 
+/* Stop set shared by all traceroutes (Doubletree). An entry records that
+ * 'addr' replied at 'ttl' on the way to 'dst'. IPv4 addresses are stored
+ * IPv4-mapped.
+ */
+struct stopent
+{
+	struct stopent *next;		/* Same hash bucket */
+	struct stopent *ttl_next;	/* Same TTL */
+	struct in6_addr addr;
+	struct in6_addr dst;
+	uint8_t ttl;
+	unsigned gen;			/* Run that last saw it */
+	time_t expires;
+};
+
 struct trtbase
 {
 	struct event_base *event_base;
@@ -80,18 +117,60 @@ struct trtbase
 	struct trtstate **table;
 	int tabsiz;
 
+	/* Free indexes, FIFO to delay reuse. One list below TRT_LO_INDEX and
+	 * one above.
+	 */
+	int *tabnext;
+	uint16_t *tabgen;
+	struct trtfree
+	{
+		int head;
+		int tail;
+	} freelo, freehi;
+
 	/* For standalone traceroute. Called when a traceroute instance is
 	 * done. Just one pointer for all instances. It is up to the caller
 	 * to keep it consistent.
 	 */
 	void (*done)(void *state, int error);
 
+	/* Stop set, hashed on address and TTL and also listed per TTL */
+	struct stopent *stopset[STOPSET_HASH];
+	struct stopent *stopttl[256];
+	unsigned stopcount;
+	unsigned stopgen;
+
 	/* Leave some space for headers. The various traceroute variations
 	 * have to check that it fits.
 	 */
 	u_char packet[MAX_DATA_SIZE+128];
 };
 
+/* Parallel mode. Probes for all hops are sent up front. The first reply
+ * to each probe is kept and the per-hop result is rebuilt from them.
+ */
+struct trtslot
+{
+	struct timespec xmit_time;
+	struct timespec rcvd_time;
+	u_char *packet;
+	size_t len;
+	struct sockaddr_in6 remote;	/* Also holds a struct sockaddr_in */
+	struct in6_addr dstaddr;
+	int rcvdttl;
+	int rcvdtclass;
+};
+
+struct trtpar
+{
+	struct trtslot *slots;		/* One per probe, indexed by seq-1 */
+	unsigned nslots;
+	unsigned round;			/* Rounds of probes sent */
+	uint8_t lasthop;		/* Highest hop that replied */
+	uint8_t dsthop;			/* Lowest hop that ended the trace */
+	unsigned rebuild:1;		/* Rebuilding the result */
+};
+
 struct trtstate
 {
 	/* Parameters */
@@ -107,6 +186,7 @@ struct trtstate
 	char do_v6;
 	char dont_fragment;
 	char delay_name_res;
+	char dns_nocache;		/* Bypass the DNS cache */
 	char trtcount;
 	unsigned short maxpacksize;
 	unsigned short hbhoptsize;
@@ -118,6 +198,9 @@ struct trtstate
 	unsigned char parisbase;
 	unsigned duptimeout;
 	unsigned timeout;
+	unsigned stoplife;		/* Lifetime of stop set entries (s),
+					 * 0 if not using the stop set
+					 */
 	int tos;
 
 	char *response_in;	/* Fuzzing */
@@ -126,6 +209,7 @@ struct trtstate
 	/* Base and index in table */
 	struct trtbase *base;
 	int index;
+	uint16_t gen;			/* Generation of index */
 
 	struct sockaddr_in6 sin6;
 	socklen_t socklen;
@@ -159,6 +243,8 @@ struct trtstate
 					 */
 	unsigned dnsip:1;		/* Busy with dns name resolution */
 	unsigned no_src:1;		/* Did not bind yet */
+	unsigned stopped:1;		/* Reached a hop in the stop set */
+	unsigned stopgen;		/* Identifies this run in the stop set */
 	struct evutil_addrinfo *dns_res;
 	struct evutil_addrinfo *dns_curr;
 
@@ -172,6 +258,8 @@ struct trtstate
 
 	struct event timer;
 
+	struct trtpar *par;		/* Parallel mode, NULL otherwise */
+
 	unsigned long min;
 	unsigned long max;
 	unsigned long sum;
@@ -184,29 +272,16 @@ struct trtstate
 	size_t resmax;
 	char open_result;
 
+	u_char *tmpl;			/* Packet template, see tmpl_save */
+	size_t tmpl_len;		/* Zero if there is no template */
+	uint16_t tmpl_cksum;		/* Checksum of the template */
+	unsigned short tmpl_packsize;	/* curpacksize it was built for */
+
 	FILE *resp_file_out;	/* Fuzzing */
 };
 
 static struct trtbase *trt_base;
 
-struct v4_ph
-{
-	struct in_addr src;
-	struct in_addr dst;
-	uint8_t zero;
-	uint8_t proto;
-	uint16_t len;
-};
-
-struct v6_ph
-{
-	struct in6_addr src;
-	struct in6_addr dst;
-	uint32_t len;
-	uint8_t zero[3];
-	uint8_t nxt;
-};
-
 struct v6info
 {
 	uint16_t fuzz;
@@ -219,6 +294,11 @@ struct v6info
 static int create_socket(struct trtstate *state, int do_tcp);
 static void ready_callback4(int __attribute((unused)) unused,
 	const short __attribute((unused)) event, void *s);
+static void ready_packet4(struct trtstate *state, ssize_t nrecv,
+	struct sockaddr_in *remotep, struct timespec *nowp);
+static void ready_packet6(struct trtstate *state, ssize_t nrecv,
+	struct sockaddr_in6 *remotep, struct timespec *nowp,
+	int rcvdttl, int rcvdtclass, struct in6_addr *dstaddrp);
 static void ready_tcp4(int __attribute((unused)) unused,
 	const short __attribute((unused)) event, void *s);
 static void ready_callback6(int __attribute((unused)) unused,
@@ -226,104 +306,30 @@ static void ready_callback6(int __attribute((unused)) unused,
 static void noreply_callback(int __attribute((unused)) unused,
 	const short __attribute((unused)) event, void *s);
 
-static int in_cksum(unsigned short *buf, int sz)
+/* Probes are copied from a template that is built on the first probe of
+ * a run, and again when the packet size changes. Fields that differ per
+ * probe are zero in the template. Their checksum contribution is added
+ * with inet_cksum_adjust.
+ */
+static int tmpl_ok(struct trtstate *state)
 {
-	int nleft = sz;
-	int sum = 0;
-	unsigned short *w = buf;
-	unsigned short ans = 0;
-
-	while (nleft > 1) {
-		sum += *w++;
-		nleft -= 2;
-	}
-
-	if (nleft == 1) {
-		*(unsigned char *) (&ans) = *(unsigned char *) w;
-		sum += ans;
-	}
-
-	sum = (sum >> 16) + (sum & 0xFFFF);
-	sum += (sum >> 16);
-	ans = ~sum;
-	return ans;
+	return state->tmpl_len != 0 &&
+		state->tmpl_packsize == state->curpacksize;
 }
 
-static int in_cksum_udp(struct v4_ph *v4_ph, struct udphdr *udp, 
-	unsigned short *buf, int sz)
+static void tmpl_save(struct trtstate *state, size_t len, uint16_t cksum)
 {
-	int nleft = sz;
-	int sum = 0;
-	unsigned short *w = buf;
-	unsigned short ans = 0;
-
-	nleft= sizeof(*v4_ph);
-	w= (unsigned short *)v4_ph;
-	while (nleft > 1) {
-		sum += *w++;
-		nleft -= 2;
-	}
-
-	if (udp)
-	{
-		nleft= sizeof(*udp);
-		w= (unsigned short *)udp;
-		while (nleft > 1) {
-			sum += *w++;
-			nleft -= 2;
-		}
-	}
-
-	nleft= sz;
-	w= buf;
-
-	while (nleft > 1) {
-		sum += *w++;
-		nleft -= 2;
-	}
-
-	if (nleft == 1) {
-		*(unsigned char *) (&ans) = *(unsigned char *) w;
-		sum += ans;
-	}
-
-	sum = (sum >> 16) + (sum & 0xFFFF);
-	sum += (sum >> 16);
-	ans = ~sum;
-	return ans;
+	state->tmpl= xrealloc(state->tmpl, len);
+	memcpy(state->tmpl, state->base->packet, len);
+	state->tmpl_len= len;
+	state->tmpl_cksum= cksum;
+	state->tmpl_packsize= state->curpacksize;
 }
 
-static int in_cksum_icmp6(struct v6_ph *v6_ph, unsigned short *buf, int sz)
+static size_t tmpl_load(struct trtstate *state)
 {
-	int nleft = sz;
-	int sum = 0;
-	unsigned short *w = buf;
-	unsigned short ans = 0;
-
-	nleft= sizeof(*v6_ph);
-	w= (unsigned short *)v6_ph;
-	while (nleft > 1) {
-		sum += *w++;
-		nleft -= 2;
-	}
-
-	nleft= sz;
-	w= buf;
-
-	while (nleft > 1) {
-		sum += *w++;
-		nleft -= 2;
-	}
-
-	if (nleft == 1) {
-		*(unsigned char *) (&ans) = *(unsigned char *) w;
-		sum += ans;
-	}
-
-	sum = (sum >> 16) + (sum & 0xFFFF);
-	sum += (sum >> 16);
-	ans = ~sum;
-	return ans;
+	memcpy(state->base->packet, state->tmpl, state->tmpl_len);
+	return state->tmpl_len;
 }
 
 static void add_str(struct trtstate *state, const char *str)
@@ -457,6 +463,238 @@ static void report(struct trtstate *state)
 		state->base->done(state, 0);
 }
 
+static void stopset_key(struct sockaddr *sa, struct in6_addr *addr)
+{
+	if (sa->sa_family == AF_INET6)
+	{
+		*addr= ((struct sockaddr_in6 *)sa)->sin6_addr;
+		return;
+	}
+
+	/* IPv4-mapped */
+	memset(addr, '\0', sizeof(*addr));
+	addr->s6_addr[10]= 0xff;
+	addr->s6_addr[11]= 0xff;
+	memcpy(&addr->s6_addr[12], &((struct sockaddr_in *)sa)->sin_addr, 4);
+}
+
+static unsigned stopset_hash(struct in6_addr *addr, uint8_t ttl)
+{
+	unsigned i, h;
+
+	h= ttl;
+	for (i= 0; i<sizeof(addr->s6_addr); i++)
+		h= h*31 + addr->s6_addr[i];
+	return h % STOPSET_HASH;
+}
+
+static const char *stopset_ntop(struct trtstate *state, struct in6_addr *addr,
+	char *buf, size_t bufsiz)
+{
+	if (state->sin6.sin6_family == AF_INET6)
+		return inet_ntop(AF_INET6, addr, buf, bufsiz);
+	return inet_ntop(AF_INET, &addr->s6_addr[12], buf, bufsiz);
+}
+
+static void stopset_expire(struct trtbase *base, time_t now)
+{
+	int i;
+	struct stopent *ent, **entp;
+
+	for (i= 0; i<256; i++)
+	{
+		for (entp= &base->stopttl[i]; *entp;)
+		{
+			if ((*entp)->expires <= now)
+				*entp= (*entp)->ttl_next;
+			else
+				entp= &(*entp)->ttl_next;
+		}
+	}
+	for (i= 0; i<STOPSET_HASH; i++)
+	{
+		for (entp= &base->stopset[i]; *entp;)
+		{
+			ent= *entp;
+			if (ent->expires <= now)
+			{
+				*entp= ent->next;
+				free(ent);
+				base->stopcount--;
+			}
+			else
+				entp= &ent->next;
+		}
+	}
+}
+
+/* Add the address that replied at the current hop to the stop set. Returns
+ * 1 if an earlier traceroute to the same destination saw it at this hop.
+ * The rest of the path is then assumed to be known.
+ */
+static int stopset_add(struct trtstate *state, struct sockaddr *sa)
+{
+	int known;
+	unsigned h;
+	time_t now;
+	struct trtbase *base;
+	struct stopent *ent;
+	struct in6_addr addr, dst;
+
+	if (!state->stoplife)
+		return 0;
+
+	base= state->base;
+	now= atlas_time();
+
+	stopset_key(sa, &addr);
+	stopset_key((struct sockaddr *)&state->sin6, &dst);
+	h= stopset_hash(&addr, state->hop);
+	for (ent= base->stopset[h]; ent; ent= ent->next)
+	{
+		if (ent->ttl == state->hop &&
+			memcmp(&ent->addr, &addr, sizeof(addr)) == 0 &&
+			memcmp(&ent->dst, &dst, sizeof(dst)) == 0)
+		{
+			break;
+		}
+	}
+	if (ent)
+	{
+		known= (ent->expires > now && ent->gen != state->stopgen);
+		ent->expires= now + state->stoplife;
+		ent->gen= state->stopgen;
+
+		/* All hops are probed already in parallel mode */
+		return known && !state->par;
+	}
+
+	if (base->stopcount >= STOPSET_MAX)
+	{
+		stopset_expire(base, now);
+		if (base->stopcount >= STOPSET_MAX)
+			return 0;
+	}
+
+	ent= xzalloc(sizeof(*ent));
+	ent->addr= addr;
+	ent->dst= dst;
+	ent->ttl= state->hop;
+	ent->gen= state->stopgen;
+	ent->expires= now + state->stoplife;
+	ent->next= base->stopset[h];
+	base->stopset[h]= ent;
+	ent->ttl_next= base->stopttl[ent->ttl];
+	base->stopttl[ent->ttl]= ent;
+	base->stopcount++;
+
+	return 0;
+}
+
+/* Hops where the stop set has just one address, seen on the way to
+ * different destinations, are assumed to be shared by all paths. Report
+ * them from the stop set and start probing after them.
+ */
+static void stopset_skip(struct trtstate *state)
+{
+	int shared;
+	time_t now;
+	struct stopent *ent, *first;
+	struct in6_addr dst;
+	char buf[INET6_ADDRSTRLEN];
+	char line[160];
+
+	now= atlas_time();
+	stopset_key((struct sockaddr *)&state->sin6, &dst);
+
+	while (state->hop < state->maxhops)
+	{
+		first= NULL;
+		shared= 0;
+		for (ent= state->base->stopttl[state->hop]; ent;
+			ent= ent->ttl_next)
+		{
+			if (ent->expires <= now)
+				continue;
+			if (!first)
+			{
+				first= ent;
+				continue;
+			}
+			if (memcmp(&ent->addr, &first->addr,
+				sizeof(ent->addr)) != 0)
+			{
+				break;	/* Load balancing or path change */
+			}
+			if (memcmp(&ent->dst, &first->dst,
+				sizeof(ent->dst)) != 0)
+			{
+				shared= 1;
+			}
+		}
+		if (!first || ent || !shared ||
+			memcmp(&first->addr, &dst, sizeof(dst)) == 0)
+		{
+			break;
+		}
+
+		snprintf(line, sizeof(line), "{ " DBQ(hop) ":%d, "
+			DBQ(result) ": [ { " DBQ(from) ":" DBQ(%s) ", "
+			DBQ(cached) ":true } ] }, ", state->hop,
+			stopset_ntop(state, &first->addr, buf, sizeof(buf)));
+		add_str(state, line);
+
+		state->last_response_hop= state->hop;
+		state->hop++;
+	}
+}
+
+/* Report the rest of the path to the destination from the stop set. A hop
+ * can have more than one entry (load balancing or a path change), all of
+ * them are reported.
+ */
+static void stopset_rest(struct trtstate *state)
+{
+	int hop, n;
+	time_t now;
+	struct stopent *ent;
+	struct in6_addr dst;
+	char buf[INET6_ADDRSTRLEN];
+	char line[160];
+
+	now= atlas_time();
+	stopset_key((struct sockaddr *)&state->sin6, &dst);
+
+	for (hop= state->hop+1; hop <= state->maxhops; hop++)
+	{
+		n= 0;
+		for (ent= state->base->stopttl[hop]; ent; ent= ent->ttl_next)
+		{
+			if (ent->expires <= now ||
+				memcmp(&ent->dst, &dst, sizeof(dst)) != 0)
+			{
+				continue;
+			}
+
+			if (n == 0)
+			{
+				snprintf(line, sizeof(line), ", { " DBQ(hop)
+					":%d, " DBQ(result) ": [ ", hop);
+				add_str(state, line);
+			}
+			snprintf(line, sizeof(line), "%s{ " DBQ(from) ":"
+				DBQ(%s) ", " DBQ(cached) ":true }",
+				n ? ", " : "",
+				stopset_ntop(state, &ent->addr, buf, sizeof(buf)));
+			add_str(state, line);
+			n++;
+		}
+		if (!n)
+			break;
+		add_str(state, " ] }");
+	}
+}
+
 static int set_tos(struct trtstate *state, int sock, int af, int inner)
 {
 	int r;
@@ -499,20 +737,17 @@ static int set_tos(struct trtstate *state, int sock, int af, int inner)
 	return 0;
 }
 
-static void send_pkt(struct trtstate *state)
+static int xmit_pkt(struct trtstate *state)
 {
 	int r, hop, len, on, sock, serrno;
 	uint16_t sum, val;
 	unsigned usum;
 	struct trtbase *base;
-	struct icmp *icmp_hdr;
+	struct icmp *icmp_hdr, *ticmp_hdr;
 	struct icmp6_hdr *icmp6_hdr;
-	struct v6info *v6info;
+	struct v6info *v6info, *tv6info;
 	struct tcphdr *tcphdr;
-	struct v4_ph v4_ph;
-	struct v6_ph v6_ph;
 	struct udphdr udp;
-	struct timeval interval;
 	struct sockaddr_in6 sin6copy;
 	char line[80];
 	char id[]= "http://atlas.ripe.net Atlas says Hi!";
@@ -522,63 +757,8 @@ static void send_pkt(struct trtstate *state)
 		int error;
 	} r_errno;
 
-	state->gotresp= 0;
-
 	base= state->base;
 
-	if (state->sent >= state->trtcount)
-	{
-		add_str(state, " } ] }");
-		if (state->hop >= state->maxhops ||
-			(state->done && !state->not_done))
-		{
-			/* We are done */
-			if (state->resp_file_out)
-			{
-				r= 0;
-				write_response(state->resp_file_out,
-					RESP_SENDTO, sizeof(r), &r);
-			}
-			report(state);
-			return;
-		}
-
-		state->hop++;
-		state->sent= 0;
-		state->done= 0;
-		state->not_done= 0;
-
-		if (state->hop - state->last_response_hop > 
-			state->gaplimit)
-		{
-#if 0
-			printf("gaplimit reached: %d > %d + %d\n",
-				state->hop, state->last_response_hop,
-				state->gaplimit);
-#endif
-			if (state->lastditch)
-			{
-				/* Also done with last-ditch probe. */
-				if (state->resp_file_out)
-				{
-					r= 0;
-					write_response(state->resp_file_out,
-						RESP_SENDTO, sizeof(r), &r);
-				}
-				report(state);
-				return;
-			}
-			state->lastditch= 1;
-			state->hop= 255;
-		}
-
-		snprintf(line, sizeof(line),
-			", { " DBQ(hop) ":%d, " DBQ(result) ": [ ", state->hop);
-		add_str(state, line);
-		state->open_result= 0;
-	}
-	state->seq++;
-
 	gettime_mono(&state->xmit_time);
 
 	if (state->sin6.sin6_family == AF_INET6)
@@ -618,7 +798,7 @@ static void send_pkt(struct trtstate *state)
 			if (set_tos(state, sock, AF_INET6, 1 /*inner*/) == -1)
 			{
 				close(sock);
-				return;
+				return -1;
 			}
 
 			/* Bind to source addr/port */
@@ -641,31 +821,50 @@ static void send_pkt(struct trtstate *state)
 				add_str(state, line);
 				report(state);
 				close(sock);
-				return;
+				return -1;
 			}
 
 			tcphdr= (struct tcphdr *)base->packet;
-			memset(tcphdr, '\0', sizeof(*tcphdr));
+			if (!tmpl_ok(state))
+			{
+				memset(tcphdr, '\0', sizeof(*tcphdr));
 
-			len= sizeof(*tcphdr);
+				len= sizeof(*tcphdr);
 
-			tcphdr->seq= htonl((state->index) << 16 | state->seq);
-			tcphdr->doff= len / 4;
-			tcphdr->syn= 1;
+				tcphdr->doff= len / 4;
+				tcphdr->syn= 1;
 
-			if (len+state->curpacksize > sizeof(base->packet))
-			{
-				crondlog(
+				if (len+state->curpacksize >
+					sizeof(base->packet))
+				{
+					crondlog(
 			DIE9 "base->packet too small, need at least %d",
-					len+state->curpacksize);
-			}
-			if (state->curpacksize > 0)
-			{
-				memset(&base->packet[len], '\0',
-					state->curpacksize);
-				strcpy((char *)&base->packet[len], id);
-				len += state->curpacksize;
+						len+state->curpacksize);
+				}
+				if (state->curpacksize > 0)
+				{
+					memset(&base->packet[len], '\0',
+						state->curpacksize);
+					strcpy((char *)&base->packet[len], id);
+					len += state->curpacksize;
+				}
+
+				tcphdr->source= state->loc_sin6.sin6_port;
+				tcphdr->dest= state->sin6.sin6_port;
+				tcphdr->uh_sum= 0;
+
+				sum= inet_cksum_ph6(&state->loc_sin6.sin6_addr,
+					&state->sin6.sin6_addr, IPPROTO_TCP,
+					len);
+				tmpl_save(state, len, inet_cksum_fold(
+					inet_cksum_add(sum, base->packet, len)));
 			}
+			len= tmpl_load(state);
+
+			tcphdr->seq= htonl((state->index) << 16 | state->seq);
+			tcphdr->check= inet_cksum_adjust(state->tmpl_cksum,
+				&((struct tcphdr *)state->tmpl)->seq,
+				&tcphdr->seq, sizeof(tcphdr->seq));
 
 			{
 				int  offset = 2;
@@ -673,20 +872,6 @@ static void send_pkt(struct trtstate *state)
 					&offset, sizeof(offset));
 			}
 
-			memset(&v6_ph, '\0', sizeof(v6_ph));
-			v6_ph.src= state->loc_sin6.sin6_addr;
-			v6_ph.dst= state->sin6.sin6_addr;
-			v6_ph.len= htonl(len);
-			v6_ph.nxt= IPPROTO_TCP;
-			tcphdr->source= state->loc_sin6.sin6_port;
-			tcphdr->dest= state->sin6.sin6_port;
-			tcphdr->uh_sum= 0;
-
-			sum= in_cksum_icmp6(&v6_ph, 
-				(unsigned short *)base->packet, len);
-			
-			tcphdr->check= sum;
-
 			/* Set hop count */
 			setsockopt(sock, SOL_IPV6, IPV6_UNICAST_HOPS,
 				&hop, sizeof(hop));
@@ -749,7 +934,7 @@ static void send_pkt(struct trtstate *state)
 						strerror(serrno));
 					add_str(state, line);
 					report(state);
-					return;
+					return -1;
 				}
 			}
 		}
@@ -771,52 +956,67 @@ static void send_pkt(struct trtstate *state)
 					 state->destoptsize);
 
 			icmp6_hdr= (struct icmp6_hdr *)base->packet;
-			icmp6_hdr->icmp6_type= ICMP6_ECHO_REQUEST;
-			icmp6_hdr->icmp6_code= 0;
-			icmp6_hdr->icmp6_cksum= 0;
-			icmp6_hdr->icmp6_id= htons(base->my_pid);
-			icmp6_hdr->icmp6_seq= htons(state->seq);
-
 			v6info= (struct v6info *)&icmp6_hdr[1];
-			v6info->fuzz= 0;
-			v6info->pid= htonl(base->my_pid);
-			v6info->id= htonl(state->index);
-			v6info->seq= htonl(state->seq);
-			v6info->tv= state->xmit_time;
+			if (!tmpl_ok(state))
+			{
+				icmp6_hdr->icmp6_type= ICMP6_ECHO_REQUEST;
+				icmp6_hdr->icmp6_code= 0;
+				icmp6_hdr->icmp6_cksum= 0;
+				icmp6_hdr->icmp6_id= htons(base->my_pid);
+				icmp6_hdr->icmp6_seq= 0;
 
-			len= sizeof(*v6info);
+				memset(v6info, '\0', sizeof(*v6info));
+				v6info->pid= htonl(base->my_pid);
+				v6info->id= htonl(TRT_ID6(state));
 
-			if (state->curpacksize < len)
-				state->curpacksize= len;
-			if (ICMP6_HDR+state->curpacksize >
-				sizeof(base->packet))
-			{
-				crondlog(
+				len= sizeof(*v6info);
+
+				if (state->curpacksize < len)
+					state->curpacksize= len;
+				if (ICMP6_HDR+state->curpacksize >
+					sizeof(base->packet))
+				{
+					crondlog(
 			DIE9 "base->packet too small, need at least %d",
-					ICMP6_HDR+state->curpacksize);
-			}
+						ICMP6_HDR+state->curpacksize);
+				}
 
-			if (state->curpacksize > len)
-			{
-				memset(&base->packet[ICMP6_HDR+len], '\0',
-					state->curpacksize-len);
-				strcpy((char *)&base->packet[ICMP6_HDR+len],
-					id);
-				len= state->curpacksize;
+				if (state->curpacksize > len)
+				{
+					memset(&base->packet[ICMP6_HDR+len],
+						'\0', state->curpacksize-len);
+					strcpy((char *)
+						&base->packet[ICMP6_HDR+len],
+						id);
+					len= state->curpacksize;
+				}
+
+				len += ICMP6_HDR;
+
+				sum= inet_cksum_ph6(&state->loc_sin6.sin6_addr,
+					&state->sin6.sin6_addr, IPPROTO_ICMPV6,
+					len);
+				tmpl_save(state, len, inet_cksum_fold(
+					inet_cksum_add(sum, base->packet, len)));
 			}
+			len= tmpl_load(state);
 
-			len += ICMP6_HDR;
+			icmp6_hdr->icmp6_seq= htons(state->seq);
+			v6info->seq= htonl(state->seq);
+			v6info->tv= state->xmit_time;
 
 			if (state->parismod)
 			{
-				memset(&v6_ph, '\0', sizeof(v6_ph));
-				v6_ph.src= state->loc_sin6.sin6_addr;
-				v6_ph.dst= state->sin6.sin6_addr;
-				v6_ph.len= htonl(len);
-				v6_ph.nxt= IPPROTO_ICMPV6;
-
-				sum= in_cksum_icmp6(&v6_ph,
-					(unsigned short *)base->packet, len);
+				tv6info= (struct v6info *)
+					&((struct icmp6_hdr *)state->tmpl)[1];
+				sum= inet_cksum_adjust(state->tmpl_cksum,
+					&((struct icmp6_hdr *)state->tmpl)->
+					icmp6_seq, &icmp6_hdr->icmp6_seq,
+					sizeof(icmp6_hdr->icmp6_seq));
+				sum= inet_cksum_adjust(sum, &tv6info->seq,
+					&v6info->seq, sizeof(v6info->seq));
+				sum= inet_cksum_adjust(sum, &tv6info->tv,
+					&v6info->tv, sizeof(v6info->tv));
 
 				/* Avoid 0 */
 				val= state->paris + 1;
@@ -827,14 +1027,11 @@ static void send_pkt(struct trtstate *state)
 
 				v6info->fuzz= htons(sum);
 
-				sum= in_cksum_icmp6(&v6_ph, 
-					(unsigned short *)base->packet, len);
-
 #if 0
 				printf(
-			"send_pkt: seq %d, paris %d, cksum= htons(0x%x)\n",
+			"send_pkt: seq %d, paris %d, fuzz= htons(0x%x)\n",
 					state->seq, state->paris,
-					ntohs(sum));
+					sum);
 #endif
 			}
 
@@ -889,7 +1086,7 @@ static void send_pkt(struct trtstate *state)
 						strerror(serrno));
 					add_str(state, line);
 					report(state);
-					return;
+					return -1;
 				}
 			}
 		}
@@ -924,7 +1121,7 @@ static void send_pkt(struct trtstate *state)
 			if (set_tos(state, sock, AF_INET6, 1 /*inner*/) == -1)
 			{
 				close(sock);
-				return;
+				return -1;
 			}
 
 			/* Bind to source addr/port */
@@ -947,7 +1144,7 @@ static void send_pkt(struct trtstate *state)
 				add_str(state, line);
 				report(state);
 				close(sock);
-				return;
+				return -1;
 			}
 
 			/* Set port */
@@ -973,9 +1170,29 @@ static void send_pkt(struct trtstate *state)
 					IPV6_MTU_DISCOVER, &on, sizeof(on));
 
 			v6info= (struct v6info *)base->packet;
-			v6info->fuzz= 0;
-			v6info->pid= htonl(base->my_pid);
-			v6info->id= htonl(state->index);
+			if (!tmpl_ok(state))
+			{
+				memset(v6info, '\0', sizeof(*v6info));
+				v6info->pid= htonl(base->my_pid);
+				v6info->id= htonl(TRT_ID6(state));
+
+				len= sizeof(*v6info);
+
+				if (state->curpacksize < len)
+					state->curpacksize= len;
+				if (state->curpacksize > len)
+				{
+					memset(&base->packet[len], '\0',
+						state->curpacksize-len);
+					strcpy((char *)&base->packet[len], id);
+					len= state->curpacksize;
+				}
+
+				/* The kernel does the UDP checksum */
+				tmpl_save(state, len, 0);
+			}
+			len= tmpl_load(state);
+
 			v6info->seq= htonl(state->seq);
 			v6info->tv= state->xmit_time;
 
@@ -987,18 +1204,6 @@ static void send_pkt(struct trtstate *state)
 				ntohl(v6info->seq));
 #endif
 
-			len= sizeof(*v6info);
-
-			if (state->curpacksize < len)
-				state->curpacksize= len;
-			if (state->curpacksize > len)
-			{
-				memset(&base->packet[len], '\0',
-					state->curpacksize-len);
-				strcpy((char *)&base->packet[len], id);
-				len= state->curpacksize;
-			}
-
 			if (state->response_in)
 			{
 				size_t rlen;
@@ -1049,7 +1254,7 @@ static void send_pkt(struct trtstate *state)
 						strerror(serrno));
 					add_str(state, line);
 					report(state);
-					return;
+					return -1;
 				}
 			}
 		}
@@ -1082,7 +1287,7 @@ static void send_pkt(struct trtstate *state)
 			if (set_tos(state, sock, AF_INET, 1 /*inner*/) == -1)
 			{
 				close(sock);
-				return;
+				return -1;
 			}
 
 			/* Bind to source addr/port */
@@ -1109,52 +1314,56 @@ static void send_pkt(struct trtstate *state)
 				add_str(state, line);
 				report(state);
 				close(sock);
-				return;
+				return -1;
 			}
 
 			hop= state->hop;
 
 			tcphdr= (struct tcphdr *)base->packet;
-			memset(tcphdr, '\0', sizeof(*tcphdr));
+			if (!tmpl_ok(state))
+			{
+				memset(tcphdr, '\0', sizeof(*tcphdr));
 
-			len= sizeof(*tcphdr);
+				len= sizeof(*tcphdr);
 
-			tcphdr->seq= htonl((state->index) << 16 | state->seq);
-			tcphdr->doff= len / 4;
-			tcphdr->syn= 1;
+				tcphdr->doff= len / 4;
+				tcphdr->syn= 1;
 
-			if (len+state->curpacksize > sizeof(base->packet))
-			{
-				crondlog(
+				if (len+state->curpacksize >
+					sizeof(base->packet))
+				{
+					crondlog(
 			DIE9 "base->packet too small, need at least %d",
-					len+state->curpacksize);
-			}
-			if (state->curpacksize > 0)
-			{
-				memset(&base->packet[len], '\0',
-					state->curpacksize);
-				strcpy((char *)&base->packet[len], id);
-				len += state->curpacksize;
-			}
-
-			v4_ph.src= ((struct sockaddr_in *)&state->loc_sin6)->
-				sin_addr;
-			v4_ph.dst= ((struct sockaddr_in *)&state->sin6)->
-				sin_addr;
-			v4_ph.zero= 0;
-			v4_ph.proto= IPPROTO_TCP;
-			v4_ph.len= htons(len);
-			tcphdr->source=
-				((struct sockaddr_in *)&state->loc_sin6)->
-				sin_port;
-			tcphdr->dest= ((struct sockaddr_in *)&state->sin6)->
-				sin_port;
-			tcphdr->uh_sum= 0;
-
-			sum= in_cksum_udp(&v4_ph, NULL,
-				(unsigned short *)base->packet, len);
-			
-			tcphdr->check= sum;
+						len+state->curpacksize);
+				}
+				if (state->curpacksize > 0)
+				{
+					memset(&base->packet[len], '\0',
+						state->curpacksize);
+					strcpy((char *)&base->packet[len], id);
+					len += state->curpacksize;
+				}
+
+				tcphdr->source= ((struct sockaddr_in *)
+					&state->loc_sin6)->sin_port;
+				tcphdr->dest= ((struct sockaddr_in *)
+					&state->sin6)->sin_port;
+				tcphdr->uh_sum= 0;
+
+				sum= inet_cksum_ph4(&((struct sockaddr_in *)
+					&state->loc_sin6)->sin_addr,
+					&((struct sockaddr_in *)
+					&state->sin6)->sin_addr,
+					IPPROTO_TCP, len);
+				tmpl_save(state, len, inet_cksum_fold(
+					inet_cksum_add(sum, base->packet, len)));
+			}
+			len= tmpl_load(state);
+
+			tcphdr->seq= htonl((state->index) << 16 | state->seq);
+			tcphdr->check= inet_cksum_adjust(state->tmpl_cksum,
+				&((struct tcphdr *)state->tmpl)->seq,
+				&tcphdr->seq, sizeof(tcphdr->seq));
 
 #if 0
 			if (state->parismod)
@@ -1244,7 +1453,7 @@ static void send_pkt(struct trtstate *state)
 						strerror(serrno));
 					add_str(state, line);
 					report(state);
-					return;
+					return -1;
 				}
 			}
 		}
@@ -1253,53 +1462,70 @@ static void send_pkt(struct trtstate *state)
 			hop= state->hop;
 
 			icmp_hdr= (struct icmp *)base->packet;
-			icmp_hdr->icmp_type= ICMP_ECHO;
-			icmp_hdr->icmp_code= 0;
-			icmp_hdr->icmp_cksum= 0;
-			icmp_hdr->icmp_id= htons(state->index | 
-				(instance_id << TRT_ICMP4_INSTANCE_ID_SHIFT));
-			icmp_hdr->icmp_seq= htons(state->seq);
-			icmp_hdr->icmp_data[0]= '\0';
-			icmp_hdr->icmp_data[1]= '\0';
-
-			len= offsetof(struct icmp, icmp_data[2]);
-
-			/* currpacksize is the amount of data after the
-			 * ICMP header. len is the minimal amount of data
-			 * including the ICMP header. Later len becomes
-			 * the packet size including ICMP header.
-			 */
-			if (ICMP_MINLEN+state->curpacksize < len)
-				state->curpacksize= len-ICMP_MINLEN;
-			if (ICMP_MINLEN+state->curpacksize >
-				sizeof(base->packet))
-			{
-				crondlog(
+			ticmp_hdr= (struct icmp *)state->tmpl;
+			if (!tmpl_ok(state))
+			{
+				icmp_hdr->icmp_type= ICMP_ECHO;
+				icmp_hdr->icmp_code= 0;
+				icmp_hdr->icmp_cksum= 0;
+				icmp_hdr->icmp_id= htons(state->index | 
+					(instance_id <<
+					TRT_ICMP4_INSTANCE_ID_SHIFT));
+				icmp_hdr->icmp_seq= 0;
+				icmp_hdr->icmp_data[0]= '\0';
+				icmp_hdr->icmp_data[1]= '\0';
+
+				len= offsetof(struct icmp, icmp_data[2]);
+
+				/* currpacksize is the amount of data after
+				 * the ICMP header. len is the minimal amount
+				 * of data including the ICMP header. Later
+				 * len becomes the packet size including ICMP
+				 * header.
+				 */
+				if (ICMP_MINLEN+state->curpacksize < len)
+					state->curpacksize= len-ICMP_MINLEN;
+				if (ICMP_MINLEN+state->curpacksize >
+					sizeof(base->packet))
+				{
+					crondlog(
 			DIE9 "base->packet too small, need at least %d",
-					ICMP_MINLEN+state->curpacksize);
-			}
-			if (ICMP_MINLEN+state->curpacksize > len)
-			{
-				memset(&base->packet[len], '\0',
-					ICMP_MINLEN+state->curpacksize-len);
-				strcpy((char *)&base->packet[len], id);
-				len= ICMP_MINLEN+state->curpacksize;
+						ICMP_MINLEN+state->curpacksize);
+				}
+				if (ICMP_MINLEN+state->curpacksize > len)
+				{
+					memset(&base->packet[len], '\0',
+						ICMP_MINLEN+state->curpacksize-
+						len);
+					strcpy((char *)&base->packet[len], id);
+					len= ICMP_MINLEN+state->curpacksize;
+				}
+
+				tmpl_save(state, len, inet_cksum(
+					(uint16_t *)icmp_hdr, len));
+				ticmp_hdr= (struct icmp *)state->tmpl;
 			}
+			len= tmpl_load(state);
+
+			icmp_hdr->icmp_seq= htons(state->seq);
+			sum= inet_cksum_adjust(state->tmpl_cksum,
+				&ticmp_hdr->icmp_seq, &icmp_hdr->icmp_seq,
+				sizeof(icmp_hdr->icmp_seq));
 
 			if (state->parismod)
 			{
-				sum= in_cksum((unsigned short *)icmp_hdr, len);
+				val= ntohs(sum);
+				usum= val + (0xffff - state->paris);
+				val= usum + (usum >> 16);
 
-				sum= ntohs(sum);
-				usum= sum + (0xffff - state->paris);
-				sum= usum + (usum >> 16);
+				icmp_hdr->icmp_data[0]= val >> 8;
+				icmp_hdr->icmp_data[1]= val;
 
-				icmp_hdr->icmp_data[0]= sum >> 8;
-				icmp_hdr->icmp_data[1]= sum;
+				sum= inet_cksum_adjust(sum, ticmp_hdr->icmp_data,
+					icmp_hdr->icmp_data, 2);
 			}
 
-			icmp_hdr->icmp_cksum=
-				in_cksum((unsigned short *)icmp_hdr, len);
+			icmp_hdr->icmp_cksum= sum;
 
 #if 0
 			printf(
@@ -1366,7 +1592,7 @@ static void send_pkt(struct trtstate *state)
 						strerror(serrno));
 					add_str(state, line);
 					report(state);
-					return;
+					return -1;
 				}
 			}
 		}
@@ -1385,7 +1611,7 @@ static void send_pkt(struct trtstate *state)
 			if (set_tos(state, sock, AF_INET, 1 /*inner*/) == -1)
 			{
 				close(sock);
-				return;
+				return -1;
 			}
 
 			/* Bind to source addr/port */
@@ -1412,7 +1638,7 @@ static void send_pkt(struct trtstate *state)
 				add_str(state, line);
 				report(state);
 				close(sock);
-				return;
+				return -1;
 			}
 
 			hop= state->hop;
@@ -1429,37 +1655,44 @@ static void send_pkt(struct trtstate *state)
 					htons(BASE_PORT + state->seq);
 			}
 
-			base->packet[0]= '\0';
-			base->packet[1]= '\0';
-			len= 2;	/* We need to fudge checksum */
-
-			if (state->curpacksize < len)
-				state->curpacksize= len;
-			if (state->curpacksize > len)
-			{
-				memset(&base->packet[len], '\0',
-					state->curpacksize-len);
-				strcpy((char *)&base->packet[len], id);
-				len= state->curpacksize;
-			}
-
-			v4_ph.src= ((struct sockaddr_in *)&state->loc_sin6)->
-				sin_addr;
-			v4_ph.dst= ((struct sockaddr_in *)&state->sin6)->
-				sin_addr;
-			v4_ph.zero= 0;
-			v4_ph.proto= IPPROTO_UDP;
-			v4_ph.len= htons(sizeof(udp)+len);
-			udp.uh_sport=
-				((struct sockaddr_in *)&state->loc_sin6)->
-				sin_port;
-			udp.uh_dport= ((struct sockaddr_in *)&state->sin6)->
-				sin_port;
-			udp.uh_ulen= v4_ph.len;
-			udp.uh_sum= 0;
-
-			sum= in_cksum_udp(&v4_ph, &udp,
-				(unsigned short *)base->packet, len);
+			if (!tmpl_ok(state))
+			{
+				base->packet[0]= '\0';
+				base->packet[1]= '\0';
+				len= 2;	/* We need to fudge checksum */
+
+				if (state->curpacksize < len)
+					state->curpacksize= len;
+				if (state->curpacksize > len)
+				{
+					memset(&base->packet[len], '\0',
+						state->curpacksize-len);
+					strcpy((char *)&base->packet[len], id);
+					len= state->curpacksize;
+				}
+
+				/* Destination port is added per probe */
+				udp.uh_sport= ((struct sockaddr_in *)
+					&state->loc_sin6)->sin_port;
+				udp.uh_dport= 0;
+				udp.uh_ulen= htons(sizeof(udp)+len);
+				udp.uh_sum= 0;
+
+				sum= inet_cksum_ph4(&((struct sockaddr_in *)
+					&state->loc_sin6)->sin_addr,
+					&((struct sockaddr_in *)
+					&state->sin6)->sin_addr,
+					IPPROTO_UDP, sizeof(udp)+len);
+				sum= inet_cksum_add(sum, &udp, sizeof(udp));
+				tmpl_save(state, len, inet_cksum_fold(
+					inet_cksum_add(sum, base->packet, len)));
+			}
+			len= tmpl_load(state);
+
+			udp.uh_dport= 0;
+			sum= inet_cksum_adjust(state->tmpl_cksum, &udp.uh_dport,
+				&((struct sockaddr_in *)&state->sin6)->sin_port,
+				sizeof(udp.uh_dport));
 
 			if (state->parismod)
 			{
@@ -1484,9 +1717,6 @@ static void send_pkt(struct trtstate *state)
 			base->packet[0]= sum >> 8;
 			base->packet[1]= sum;
 
-			sum= in_cksum_udp(&v4_ph, &udp,
-				(unsigned short *)base->packet, len);
-
 			/* Set hop count */
 			setsockopt(sock, IPPROTO_IP, IP_TTL,
 				&hop, sizeof(hop));
@@ -1546,12 +1776,146 @@ static void send_pkt(struct trtstate *state)
 						strerror(serrno));
 					add_str(state, line);
 					report(state);
-					return;
+					return -1;
 				}
 			}
 		}
 	}
 
+	return 0;
+}
+
+/* Send one round of probes, one for each hop. Probe n for a hop gets the
+ * same sequence number it would get when probing hop by hop.
+ */
+static void par_send(struct trtstate *state)
+{
+	unsigned ind;
+	struct trtpar *par;
+	struct timeval interval;
+
+	par= state->par;
+
+	for (state->hop= state->firsthop;; state->hop++)
+	{
+		ind= (state->hop-state->firsthop)*state->trtcount +
+			par->round;
+		state->seq= ind+1;
+		if (xmit_pkt(state) == -1)
+			return;
+		par->slots[ind].xmit_time= state->xmit_time;
+		if (state->hop >= state->maxhops)
+			break;
+	}
+	par->round++;
+
+	if (par->round < state->trtcount)
+	{
+		interval.tv_sec= 0;
+		interval.tv_usec= PAR_PACE;
+	}
+	else
+	{
+		interval.tv_sec= state->timeout/1000000;
+		interval.tv_usec= state->timeout % 1000000;
+	}
+	evtimer_add(&state->timer, &interval);
+}
+
+/* The end of a trace is a zero RESP_SENDTO in the response file. Consume it
+ * when replaying, so the next run in the same process starts clean.
+ */
+static void end_response(struct trtstate *state)
+{
+	int r;
+	size_t len;
+
+	if (state->par)
+		return;
+	if (state->resp_file_out)
+	{
+		r= 0;
+		write_response(state->resp_file_out, RESP_SENDTO,
+			sizeof(r), &r);
+	}
+	if (state->response_in)
+	{
+		len= sizeof(r);
+		read_response(state->socket_icmp, RESP_SENDTO, &len, &r);
+	}
+}
+
+static void send_pkt(struct trtstate *state)
+{
+	struct timeval interval;
+	char line[80];
+
+	if (state->par && !state->par->rebuild)
+	{
+		par_send(state);
+		return;
+	}
+
+	state->gotresp= 0;
+
+	if (state->sent >= state->trtcount)
+	{
+		add_str(state, " } ] }");
+		if (state->hop >= state->maxhops ||
+			(state->done && !state->not_done) || state->stopped)
+		{
+			/* We are done */
+			end_response(state);
+			if (state->stopped)
+				stopset_rest(state);
+			report(state);
+			return;
+		}
+
+		state->hop++;
+		state->sent= 0;
+		state->done= 0;
+		state->not_done= 0;
+
+		/* In parallel mode, later hops may have replied already */
+		if (state->hop - state->last_response_hop > 
+			state->gaplimit &&
+			!(state->par && state->hop <= state->par->lasthop))
+		{
+#if 0
+			printf("gaplimit reached: %d > %d + %d\n",
+				state->hop, state->last_response_hop,
+				state->gaplimit);
+#endif
+			/* No last-ditch probe in parallel mode, it was
+			 * never sent.
+			 */
+			if (state->lastditch || state->par)
+			{
+				/* Also done with last-ditch probe. */
+				end_response(state);
+				report(state);
+				return;
+			}
+			state->lastditch= 1;
+			state->hop= 255;
+		}
+
+		snprintf(line, sizeof(line),
+			", { " DBQ(hop) ":%d, " DBQ(result) ": [ ", state->hop);
+		add_str(state, line);
+		state->open_result= 0;
+	}
+	state->seq++;
+
+	if (state->par)
+	{
+		/* Rebuilding the result, the probe went out already */
+		state->xmit_time= state->par->slots[state->seq-1].xmit_time;
+	}
+	else if (xmit_pkt(state) == -1)
+		return;
+
 	if (state->open_result)
 		add_str(state, " }, ");
 	add_str(state, "{ ");
@@ -1560,6 +1924,9 @@ static void send_pkt(struct trtstate *state)
 	/* Increment packets sent */
 	state->sent++;
 
+	if (state->par)
+		return;
+
 	/* Set timer */
 	interval.tv_sec= state->timeout/1000000;
 	interval.tv_usec= state->timeout % 1000000;
@@ -1614,7 +1981,7 @@ static void do_icmp_multi(struct trtstate *state,
 		printf("do_icmp_multi: not enough for ICMP extension header\n");
 		return;
 	}
-	cksum= in_cksum((unsigned short *)packet, size);
+	cksum= inet_cksum((uint16_t *)packet, size);
 	if (cksum != 0)
 	{
 		/* There is also an option for a zero checksum. */
@@ -1660,10 +2027,246 @@ static void do_icmp_multi(struct trtstate *state,
 			do_mpls(state, packet+o+4, len-4);
 		o += len;
 
-		add_str(state, " }");
+		add_str(state, " }");
+	}
+
+	add_str(state, " ] }");
+}
+
+static void par_reset(struct trtpar *par)
+{
+	unsigned i;
+
+	for (i= 0; i<par->nslots; i++)
+		free(par->slots[i].packet);
+	memset(par->slots, '\0', par->nslots * sizeof(*par->slots));
+	par->round= 0;
+	par->lasthop= 0;
+	par->dsthop= 0;
+	par->rebuild= 0;
+}
+
+/* Feed the replies kept in parallel mode to the hop by hop code, in the
+ * order in which it would have sent the probes.
+ */
+static void par_rebuild(struct trtstate *state)
+{
+	uint16_t seq;
+	struct trtpar *par;
+	struct trtslot *slot;
+
+	par= state->par;
+
+	event_del(&state->timer);
+	par->rebuild= 1;
+
+	state->hop= state->firsthop;
+	state->seq= 0;
+	state->sent= 0;
+
+	send_pkt(state);
+	while (state->busy)
+	{
+		seq= state->seq;
+		slot= &par->slots[seq-1];
+		if (slot->packet)
+		{
+			memcpy(state->base->packet, slot->packet, slot->len);
+			if (state->sin6.sin6_family == AF_INET6)
+			{
+				ready_packet6(state, slot->len, &slot->remote,
+					&slot->rcvd_time, slot->rcvdttl,
+					slot->rcvdtclass, &slot->dstaddr);
+			}
+			else
+			{
+				ready_packet4(state, slot->len,
+					(struct sockaddr_in *)&slot->remote,
+					&slot->rcvd_time);
+			}
+			if (!state->busy || state->seq != seq)
+				continue;	/* Moved on to the next probe */
+
+			/* Nothing to wait for */
+			event_del(&state->timer);
+		}
+
+		if (!state->gotresp)
+		{
+			if (state->open_result)
+				add_str(state, " }, { ");
+			add_str(state, DBQ(x) ":" DBQ(*));
+			state->open_result= 1;
+		}
+		send_pkt(state);
+	}
+}
+
+/* Keep the first reply to probe 'seq'. Rebuild the result as soon as
+ * every probe up to the hop that ended the trace has a reply.
+ */
+static void par_add(struct trtstate *state, unsigned seq, int done,
+	struct trtslot *new)
+{
+	unsigned i, n;
+	uint8_t hop;
+	struct trtpar *par;
+	struct trtslot *slot;
+
+	par= state->par;
+
+	if (seq < 1 || seq > par->nslots)
+		return;
+	slot= &par->slots[seq-1];
+	if (slot->packet)
+		return;		/* Dup or late, only the first one counts */
+
+	new->xmit_time= slot->xmit_time;
+	*slot= *new;
+	slot->packet= xmalloc(new->len);
+	memcpy(slot->packet, state->base->packet, new->len);
+
+	hop= state->firsthop + (seq-1)/state->trtcount;
+	if (hop > par->lasthop)
+		par->lasthop= hop;
+	if (done && (par->dsthop == 0 || hop < par->dsthop))
+		par->dsthop= hop;
+	if (par->dsthop == 0)
+		return;
+
+	n= (par->dsthop-state->firsthop+1)*state->trtcount;
+	for (i= 0; i<n; i++)
+	{
+		if (!par->slots[i].packet)
+			return;
+	}
+	par_rebuild(state);
+}
+
+/* Get the probe a reply is for. Only UDP and ICMP probes are sent in
+ * parallel mode.
+ */
+static void par_store4(struct trtstate *state, ssize_t nrecv,
+	struct sockaddr_in *remote, struct timespec *now)
+{
+	int done;
+	unsigned ind, seq;
+	const struct icmp *icmp;
+	const struct udphdr *eudp;
+	struct icmperr ie;
+	struct trtslot slot;
+
+	if (icmperr_decode4(state->base->packet, nrecv, &ie) == -1)
+		return;
+
+	icmp= (const struct icmp *)ie.icmp;
+	if (ie.type == ICMP_ECHOREPLY)
+	{
+		if (!state->do_icmp || ie.code != 0)
+			return;
+		done= 1;
+	}
+	else if (ie.type == ICMP_TIME_EXCEEDED || ie.type == ICMP_DEST_UNREACH)
+	{
+		done= (ie.type == ICMP_DEST_UNREACH);
+
+		/* ICMP only guarantees 8 bytes of the original packet */
+		if (ie.l4_len < 8)
+			return;
+
+		if (ie.proto == IPPROTO_UDP && state->do_udp)
+		{
+			eudp= (const struct udphdr *)ie.l4;
+			if (ntohs(eudp->uh_sport) - SRC_BASE_PORT !=
+				state->index)
+			{
+				return;
+			}
+			if (state->parismod)
+				seq= ntohs(eudp->uh_sum);
+			else
+				seq= ntohs(eudp->uh_dport)-BASE_PORT;
+			goto found;
+		}
+		if (ie.proto != IPPROTO_ICMP || !state->do_icmp)
+			return;
+		icmp= (const struct icmp *)ie.l4;
+		if (icmp->icmp_type != ICMP_ECHO)
+			return;
+	}
+	else
+		return;
+
+	/* Echo request or reply */
+	ind= ntohs(icmp->icmp_id);
+	if ((ind >> TRT_ICMP4_INSTANCE_ID_SHIFT) != instance_id)
+		return;
+	if ((ind & ~TRT_ICMP4_INSTANCE_ID_MASK) != state->index)
+		return;
+	seq= ntohs(icmp->icmp_seq);
+
+found:
+	memset(&slot, '\0', sizeof(slot));
+	slot.rcvd_time= *now;
+	slot.len= nrecv;
+	memcpy(&slot.remote, remote, sizeof(*remote));
+	par_add(state, seq, done, &slot);
+}
+
+static void par_store6(struct trtstate *state, ssize_t nrecv,
+	struct sockaddr_in6 *remote, struct timespec *now,
+	int rcvdttl, int rcvdtclass, struct in6_addr *dstaddr)
+{
+	int done;
+	const u_char *ptr;
+	const struct v6info *v6info;
+	struct icmperr ie;
+	struct trtslot slot;
+
+	if (icmperr_decode6(state->base->packet, nrecv, &ie) == -1)
+		return;
+
+	if (ie.type == ICMP6_ECHO_REPLY)
+	{
+		if (!state->do_icmp)
+			return;
+		done= 1;
+		ptr= ie.icmp + sizeof(struct icmp6_hdr);
+	}
+	else if (ie.type == ICMP6_DST_UNREACH ||
+		ie.type == ICMP6_PACKET_TOO_BIG ||
+		ie.type == ICMP6_TIME_EXCEEDED)
+	{
+		done= (ie.type == ICMP6_DST_UNREACH);
+		if (ie.l4 == NULL)
+			return;	/* Not the first fragment */
+		if (ie.proto == IPPROTO_UDP && state->do_udp)
+			ptr= ie.l4 + sizeof(struct udphdr);
+		else if (ie.proto == IPPROTO_ICMPV6 && state->do_icmp)
+			ptr= ie.l4 + sizeof(struct icmp6_hdr);
+		else
+			return;
 	}
+	else
+		return;
 
-	add_str(state, " ] }");
+	if (ptr + sizeof(*v6info) > ie.icmp + ie.icmp_len)
+		return;
+	v6info= (const struct v6info *)ptr;
+	if (ntohl(v6info->pid) != state->base->my_pid ||
+		ntohl(v6info->id) != TRT_ID6(state))
+	{
+		return;
+	}
+
+	memset(&slot, '\0', sizeof(slot));
+	slot.rcvd_time= *now;
+	slot.len= nrecv;
+	slot.remote= *remote;
+	slot.dstaddr= *dstaddr;
+	slot.rcvdttl= rcvdttl;
+	slot.rcvdtclass= rcvdtclass;
+	par_add(state, ntohl(v6info->seq), done, &slot);
 }
 
 static void ready_callback4(int __attribute((unused)) unused,
@@ -1671,19 +2274,10 @@ static void ready_callback4(int __attribute((unused)) unused,
 {
 	struct trtbase *base;
 	struct trtstate *state;
-	int hlen, ehlen, ind, nextmtu, late, isDup, icmp_prefixlen, offset;
-	unsigned seq, srcport;
 	ssize_t nrecv;
 	socklen_t slen;
-	struct ip *ip, *eip;
-	struct icmp *icmp, *eicmp;
-	struct tcphdr *etcp;
-	struct udphdr *eudp;
-	double ms;
 	struct timespec now;
-	struct timeval interval;
 	struct sockaddr_in remote;
-	char line[80];
 
 	state= s;
 	base= state->base;
@@ -1780,37 +2374,57 @@ static void ready_callback4(int __attribute((unused)) unused,
 			sizeof(remote), &remote);
 	}
 
-	ip= (struct ip *)base->packet;
-	hlen= ip->ip_hl*4;
+	if (state->par)
+	{
+		par_store4(state, nrecv, &remote, &now);
+		return;
+	}
 
-	if (nrecv < hlen + ICMP_MINLEN || ip->ip_hl < 5)
+	ready_packet4(state, nrecv, &remote, &now);
+}
+
+static void ready_packet4(struct trtstate *state, ssize_t nrecv,
+	struct sockaddr_in *remotep, struct timespec *nowp)
+{
+	struct trtbase *base;
+	int ind, nextmtu, late, isDup;
+	unsigned seq, srcport;
+	struct ip *ip, *eip;
+	struct icmp *icmp, *eicmp;
+	struct tcphdr *etcp;
+	struct udphdr *eudp;
+	struct icmperr ie;
+	double ms;
+	struct timespec now;
+	struct timeval interval;
+	struct sockaddr_in remote;
+	char line[80];
+
+	base= state->base;
+	remote= *remotep;
+	now= *nowp;
+
+	if (icmperr_decode4(base->packet, nrecv, &ie) == -1)
 	{
 		/* Short packet */
 		printf("ready_callback4: too short %d\n", (int)nrecv);
 		return;
 	}
 
-	icmp= (struct icmp *)(base->packet+hlen);
+	ip= (struct ip *)ie.ip;
+	icmp= (struct icmp *)ie.icmp;
 
 	if (icmp->icmp_type == ICMP_TIME_EXCEEDED ||
 		icmp->icmp_type == ICMP_DEST_UNREACH)
 	{
-		eip= &icmp->icmp_ip;
-		ehlen= eip->ip_hl*4;
-
-		/* Make sure the packet we have is big enough */
-		if (nrecv < hlen + ICMP_MINLEN + ehlen || eip->ip_hl < 5)
-		{
-			printf("ready_callback4: too short %d\n", (int)nrecv);
-			return;
-		}
+		eip= (struct ip *)ie.inner;
 
 		if (eip->ip_p == IPPROTO_TCP)
 		{
 			/* Now check if there is also a TCP header in the
 			 * packet
 			 */
-			if (nrecv < hlen + ICMP_MINLEN + ehlen + 8)
+			if (ie.l4_len < 8)
 			{
 				printf("ready_callback4: too short %d\n",
 					(int)nrecv);
@@ -1818,7 +2432,7 @@ static void ready_callback4(int __attribute((unused)) unused,
 			}
 
 			/* ICMP only guarantees 8 bytes! */
-			etcp= (struct tcphdr *)((char *)eip+ehlen);
+			etcp= (struct tcphdr *)ie.l4;
 
 			/* Quick check if the source port is in range */
 			srcport= ntohs(etcp->source);
@@ -1905,7 +2519,14 @@ static void ready_callback4(int __attribute((unused)) unused,
 			}
 
 			if (!late && !isDup)
+			{
 				state->last_response_hop= state->hop;
+				if (stopset_add(state,
+					(struct sockaddr *)&remote))
+				{
+					state->stopped= 1;
+				}
+			}
 
 			ms= (now.tv_sec-state->xmit_time.tv_sec)*1000 +
 				(now.tv_nsec-state->xmit_time.tv_nsec)/1e6;
@@ -2037,14 +2658,14 @@ static void ready_callback4(int __attribute((unused)) unused,
 			/* Now check if there is also a UDP header in the
 			 * packet
 			 */
-			if (nrecv < hlen + ICMP_MINLEN + ehlen + sizeof(*eudp))
+			if (ie.l4_len < sizeof(*eudp))
 			{
 				printf("ready_callback4: too short %d\n",
 					(int)nrecv);
 				return;
 			}
 
-			eudp= (struct udphdr *)((char *)eip+ehlen);
+			eudp= (struct udphdr *)ie.l4;
 
 			/* We store the id in the source port.
 			 */
@@ -2131,7 +2752,14 @@ static void ready_callback4(int __attribute((unused)) unused,
 			}
 
 			if (!late && !isDup)
+			{
 				state->last_response_hop= state->hop;
+				if (stopset_add(state,
+					(struct sockaddr *)&remote))
+				{
+					state->stopped= 1;
+				}
+			}
 
 			ms= (now.tv_sec-state->xmit_time.tv_sec)*1000 +
 				(now.tv_nsec-state->xmit_time.tv_nsec)/1e6;
@@ -2259,15 +2887,14 @@ static void ready_callback4(int __attribute((unused)) unused,
 			/* Now check if there is also an ICMP header in the
 			 * packet
 			 */
-			if (nrecv < hlen + ICMP_MINLEN + ehlen +
-				offsetof(struct icmp, icmp_data[0]))
+			if (ie.l4_len < offsetof(struct icmp, icmp_data[0]))
 			{
 				printf("ready_callback4: too short %d\n",
 					(int)nrecv);
 				return;
 			}
 
-			eicmp= (struct icmp *)((char *)eip+ehlen);
+			eicmp= (struct icmp *)ie.l4;
 
 			if (eicmp->icmp_type != ICMP_ECHO ||
 				eicmp->icmp_code != 0)
@@ -2367,7 +2994,14 @@ static void ready_callback4(int __attribute((unused)) unused,
 			}
 
 			if (!late && !isDup)
+			{
 				state->last_response_hop= state->hop;
+				if (stopset_add(state,
+					(struct sockaddr *)&remote))
+				{
+					state->stopped= 1;
+				}
+			}
 
 			ms= (now.tv_sec-state->xmit_time.tv_sec)*1000 +
 				(now.tv_nsec-state->xmit_time.tv_nsec)/1e6;
@@ -2507,45 +3141,10 @@ static void ready_callback4(int __attribute((unused)) unused,
 		}
 
 		/* RFC-4884, Multi-Part ICMP messages */
-		icmp_prefixlen= (ntohs(icmp->icmp_pmvoid) & 0xff) * 4;
-		if (icmp_prefixlen != 0)
-		{
-			
-#if 0
-			printf("icmp_pmvoid: 0x%x for %s\n", icmp->icmp_pmvoid, state->hostname);
-			printf("icmp_prefixlen: 0x%x for %s\n", icmp_prefixlen, inet_ntoa(remote.sin_addr));
-#endif
-			offset= hlen + ICMP_MINLEN + icmp_prefixlen;
-			if (nrecv > offset)
-			{
-				do_icmp_multi(state, base->packet+offset,
-					nrecv-offset, 0 /*!pre_rfc4884*/);
-			}
-			else
-			{
-#if 0
-				printf(
-			"ready_callback4: too short %d (Multi-Part ICMP)\n",
-					(int)nrecv);
-#endif
-			}
-		}
-		else if (nrecv > hlen + ICMP_MINLEN + 128)
+		if (ie.ext)
 		{
-			/* Try old style extensions */
-			icmp_prefixlen= 128;
-			offset= hlen + ICMP_MINLEN + icmp_prefixlen;
-			if (nrecv > offset)
-			{
-				do_icmp_multi(state, base->packet+offset,
-					nrecv-offset, 1 /*pre_rfc4884*/);
-			}
-			else
-			{
-				printf(
-			"ready_callback4: too short %d (Multi-Part ICMP)\n",
-					(int)nrecv);
-			}
+			do_icmp_multi(state, (u_char *)ie.ext, ie.ext_len,
+				ie.ext_pre4884);
 		}
 
 		state->open_result= 1;
@@ -3261,29 +3860,15 @@ static void ready_callback6(int __attribute((unused)) unused,
 	const short __attribute((unused)) event, void *s)
 {
 	ssize_t nrecv;
-	int ind, rcvdttl, late, isDup, nxt, icmp_prefixlen, offset, rcvdtclass;
-	unsigned nextmtu, seq, optlen, hbhoptsize, dstoptsize;
-	size_t v6info_siz, siz;
+	int rcvdttl, rcvdtclass;
 	struct trtbase *base;
 	struct trtstate *state;
-	struct ip6_hdr *eip;
-	struct ip6_frag *frag;
-	struct ip6_ext *opthdr;
-	struct icmp6_hdr *icmp, *eicmp;
-	struct tcphdr *etcp;
-	struct udphdr *eudp;
-	struct v6info *v6info;
 	struct cmsghdr *cmsgptr;
-	void *ptr;
-	double ms= -42;	/* lint, to spot problems */
 	struct timespec now;
 	struct sockaddr_in6 remote;
 	struct in6_addr dstaddr;
 	struct msghdr msg;
 	struct iovec iov[1];
-	struct timeval interval;
-	char buf[INET6_ADDRSTRLEN];
-	char line[80];
 	char cmsgbuf[256];
 
 	state= s;
@@ -3449,36 +4034,65 @@ static void ready_callback6(int __attribute((unused)) unused,
 			sizeof(rcvdtclass), &rcvdtclass);
 	}
 
-	if (nrecv < sizeof(*icmp))
+	if (state->par)
+	{
+		par_store6(state, nrecv, &remote, &now, rcvdttl, rcvdtclass,
+			&dstaddr);
+		return;
+	}
+
+	ready_packet6(state, nrecv, &remote, &now, rcvdttl, rcvdtclass,
+		&dstaddr);
+}
+
+static void ready_packet6(struct trtstate *state, ssize_t nrecv,
+	struct sockaddr_in6 *remotep, struct timespec *nowp,
+	int rcvdttl, int rcvdtclass, struct in6_addr *dstaddrp)
+{
+	int ind, late, isDup, nxt;
+	uint32_t id;
+	unsigned nextmtu, seq, hbhoptsize, dstoptsize;
+	size_t v6info_siz, siz;
+	struct trtbase *base;
+	struct ip6_hdr *eip;
+	struct icmp6_hdr *icmp, *eicmp;
+	struct icmperr ie;
+	struct tcphdr *etcp;
+	struct udphdr *eudp;
+	struct v6info *v6info;
+	void *ptr;
+	double ms= -42;	/* lint, to spot problems */
+	struct timespec now;
+	struct sockaddr_in6 remote;
+	struct in6_addr dstaddr;
+	struct timeval interval;
+	char buf[INET6_ADDRSTRLEN];
+	char line[80];
+
+	base= state->base;
+	remote= *remotep;
+	now= *nowp;
+	dstaddr= *dstaddrp;
+
+	if (icmperr_decode6(base->packet, nrecv, &ie) == -1)
 	{
 		/* Short packet */
 #if 0
-		fprintf(stderr, "ready_callback6: too short %d (icmp)\n",
+		fprintf(stderr, "ready_callback6: too short %d\n",
 			(int)nrecv);
 #endif
 		return;
 	}
 
-	icmp= (struct icmp6_hdr *)&base->packet;
+	icmp= (struct icmp6_hdr *)ie.icmp;
 
-	hbhoptsize= 0;
-	dstoptsize= 0;
+	hbhoptsize= ie.hbhoptsize;
+	dstoptsize= ie.dstoptsize;
 	if (icmp->icmp6_type == ICMP6_DST_UNREACH ||
 		icmp->icmp6_type == ICMP6_PACKET_TOO_BIG ||
 		icmp->icmp6_type == ICMP6_TIME_EXCEEDED)
 	{
-		eip= (struct ip6_hdr *)&icmp[1];
-
-		/* Make sure the packet we have is big enough */
-		if (nrecv < sizeof(*icmp) + sizeof(*eip))
-		{
-#if 0
-			fprintf(stderr,
-				"ready_callback6: too short %d (icmp_ip)\n",
-				(int)nrecv);
-#endif
-			return;
-		}
+		eip= (struct ip6_hdr *)ie.inner;
 
 		/* Make sure we have TCP, UDP, ICMP, a fragment header or
 		 * an options header */
@@ -3489,99 +4103,18 @@ static void ready_callback6(int __attribute((unused)) unused,
 			eip->ip6_nxt == IPPROTO_UDP ||
 			eip->ip6_nxt == IPPROTO_ICMPV6)
 		{
-			frag= NULL;
-			nxt= eip->ip6_nxt;
-			ptr= &eip[1];
-			if (nxt == IPPROTO_HOPOPTS)
-			{
-				/* Make sure the options header is completely
-				 * there.
-				 */
-				offset= (u_char *)ptr - base->packet;
-				if (offset + sizeof(*opthdr) > nrecv)
-				{
-#if 0
-					fprintf(stderr,
-			"ready_callback6: too short %d (HOPOPTS)\n",
-						(int)nrecv);
-#endif
-					return;
-				}
-				opthdr= (struct ip6_ext *)ptr;
-				hbhoptsize= 8*opthdr->ip6e_len;
-				optlen= hbhoptsize+8;
-				if (offset + optlen > nrecv)
-				{
-					/* Does not contain the full header */
-					return;
-				}
-				nxt= opthdr->ip6e_nxt;
-				ptr= ((char *)opthdr)+optlen;
-			}
-			if (nxt == IPPROTO_FRAGMENT)
-			{
-				/* Make sure the fragment header is completely
-				 * there.
-				 */
-				offset= (u_char *)ptr - base->packet;
-				if (offset + sizeof(*frag) > nrecv)
-				{
-#if 0
-					fprintf(stderr,
-			"ready_callback6: too short %d (FRAGMENT)\n",
-						(int)nrecv);
-#endif
-					return;
-				}
-				frag= (struct ip6_frag *)ptr;
-				if ((ntohs(frag->ip6f_offlg) & ~3) != 0)
-				{
-					/* Not first fragment, just ignore
-					 * it.
-					 */
-					if (state->response_in)
-					{
-						/* Try again for the next
-						 * packet
-						 */
-						ready_callback6(0, 0, state);
-					}
-					return;
-				}
-				nxt= frag->ip6f_nxt;
-				ptr= &frag[1];
-			}
-			if (nxt == IPPROTO_DSTOPTS)
+			if (ie.frag_later)
 			{
-				/* Make sure the options header is completely
-				 * there.
-				 */
-				offset= (u_char *)ptr - base->packet;
-				if (offset + sizeof(*opthdr) > nrecv)
-				{
-#if 0
-					printf(
-			"ready_callback6: too short %d (DSTOPTS)\n",
-						(int)nrecv);
-#endif
-					return;
-				}
-				opthdr= (struct ip6_ext *)ptr;
-				dstoptsize= 8*opthdr->ip6e_len;
-				optlen= dstoptsize+8;
-				if (offset + optlen > nrecv)
+				/* Not first fragment, just ignore it. */
+				if (state->response_in)
 				{
-					/* Does not contain the full header */
-#if 0
-					printf(
-			"ready_callback6: too short %d (full DSTOPTS)\n",
-						(int)nrecv);
-#endif
-					return;
+					/* Try again for the next packet */
+					ready_callback6(0, 0, state);
 				}
-				nxt= opthdr->ip6e_nxt;
-				ptr= ((char *)opthdr)+optlen;
+				return;
 			}
+			nxt= ie.proto;
+			ptr= (void *)ie.l4;
 
 			v6info_siz= sizeof(*v6info);
 			if (nxt == IPPROTO_TCP)
@@ -3597,8 +4130,7 @@ static void ready_callback6(int __attribute((unused)) unused,
 			/* Now check if there is also a header in the
 			 * packet.
 			 */
-			offset= (u_char *)ptr - base->packet;
-			if (offset + siz + v6info_siz > nrecv)
+			if (siz + v6info_siz > ie.l4_len)
 			{
 #if 0
 				printf(
@@ -3654,7 +4186,9 @@ static void ready_callback6(int __attribute((unused)) unused,
 					return;
 				}
 
-				ind= ntohl(v6info->id);
+				id= ntohl(v6info->id);
+				ind= (id >> TRT_GEN_SHIFT) == state->gen ?
+					(int)(id & TRT_INDEX_MASK) : -1;
 			}
 
 			if (ind != state->index)
@@ -3733,7 +4267,14 @@ static void ready_callback6(int __attribute((unused)) unused,
 			}
 
 			if (!late && !isDup)
+			{
 				state->last_response_hop= state->hop;
+				if (stopset_add(state,
+					(struct sockaddr *)&remote))
+				{
+					state->stopped= 1;
+				}
+			}
 
 			if (memcmp(&eip->ip6_src,
 				&state->loc_sin6.sin6_addr,
@@ -3910,43 +4451,10 @@ static void ready_callback6(int __attribute((unused)) unused,
 		}
 
 		/* RFC-4884, Multi-Part ICMP messages */
-		icmp_prefixlen= icmp->icmp6_data8[0] * 8;
-		if (icmp_prefixlen != 0)
-		{
-			
-			printf("icmp6_data8[0]: 0x%x for %s\n", icmp->icmp6_data8[0], state->hostname);
-			printf("icmp_prefixlen: 0x%x for %s\n", icmp_prefixlen, inet_ntop(AF_INET6, &state->sin6.sin6_addr, buf, sizeof(buf)));
-			offset= sizeof(*icmp) + icmp_prefixlen;
-			if (nrecv > offset)
-			{
-				do_icmp_multi(state, base->packet+offset,
-					nrecv-offset, 0 /*!pre_rfc4884*/);
-			}
-			else
-			{
-#if 0
-				printf(
-			"ready_callback6: too short %d (Multi-Part ICMP)\n",
-					(int)nrecv);
-#endif
-			}
-		}
-		else if (nrecv > 128)
+		if (ie.ext)
 		{
-			/* Try old style extensions */
-			icmp_prefixlen= 128;
-			offset= sizeof(*icmp) + icmp_prefixlen;
-			if (nrecv > offset)
-			{
-				do_icmp_multi(state, base->packet+offset,
-					nrecv-offset, 1 /*pre_rfc4884*/);
-			}
-			else
-			{
-				printf(
-			"ready_callback6: too short %d (Multi-Part ICMP)\n",
-					(int)nrecv);
-			}
+			do_icmp_multi(state, (u_char *)ie.ext, ie.ext_len,
+				ie.ext_pre4884);
 		}
 
 		state->open_result= 1;
@@ -3991,7 +4499,9 @@ static void ready_callback6(int __attribute((unused)) unused,
 			return;
 		}
 
-		ind= ntohl(v6info->id);
+		id= ntohl(v6info->id);
+		ind= (id >> TRT_GEN_SHIFT) == state->gen ?
+			(int)(id & TRT_INDEX_MASK) : -1;
 
 		if (ind != state->index)
 			state= NULL;
@@ -4146,6 +4656,80 @@ static void ready_callback6(int __attribute((unused)) unused,
 	}
 }
 
+static void index_put(struct trtbase *base, int ind)
+{
+	struct trtfree *list;
+
+	list= ind < TRT_LO_INDEX ? &base->freelo : &base->freehi;
+	base->tabnext[ind]= -1;
+	if (list->tail == -1)
+		list->head= ind;
+	else
+		base->tabnext[list->tail]= ind;
+	list->tail= ind;
+}
+
+static int index_get(struct trtbase *base, struct trtfree *list)
+{
+	int ind;
+
+	ind= list->head;
+	if (ind == -1)
+		return -1;
+	list->head= base->tabnext[ind];
+	if (list->head == -1)
+		list->tail= -1;
+	return ind;
+}
+
+/* Allocate an index. IPv4 ICMP needs one below TRT_LO_INDEX; the others
+ * take one from the high range, growing the table into it first, and only
+ * use the low range when the table is full. Returns -1 if all indexes are
+ * in use.
+ */
+static int index_alloc(struct trtbase *base, int icmp4)
+{
+	int i, ind, newsiz;
+
+	for (;;)
+	{
+		if (icmp4)
+		{
+			ind= index_get(base, &base->freelo);
+			if (ind != -1)
+				return ind;
+			if (base->tabsiz >= TRT_LO_INDEX)
+				return -1;
+		}
+		else
+		{
+			ind= index_get(base, &base->freehi);
+			if (ind != -1)
+				return ind;
+			if (base->tabsiz >= TRT_MAX_INDEX)
+				return index_get(base, &base->freelo);
+		}
+
+		/* Grow the table and add the new slots to the free lists */
+		newsiz= base->tabsiz ? 2*base->tabsiz : 16;
+		if (newsiz > TRT_MAX_INDEX)
+			newsiz= TRT_MAX_INDEX;
+		base->table= xrealloc(base->table,
+			newsiz*sizeof(*base->table));
+		base->tabnext= xrealloc(base->tabnext,
+			newsiz*sizeof(*base->tabnext));
+		base->tabgen= xrealloc(base->tabgen,
+			newsiz*sizeof(*base->tabgen));
+		for (i= base->tabsiz; i<newsiz; i++)
+		{
+			base->table[i]= NULL;
+			base->tabgen[i]= 0;
+			index_put(base, i);
+		}
+		base->tabsiz= newsiz;
+	}
+}
+
 static struct trtbase *traceroute_base_new(struct event_base
 	*event_base)
 {
@@ -4155,8 +4739,10 @@ static struct trtbase *traceroute_base_new(struct event_base
 
 	base->event_base= event_base;
 
-	base->tabsiz= 10;
-	base->table= xzalloc(base->tabsiz * sizeof(*base->table));
+	base->tabsiz= 0;
+	base->table= NULL;
+	base->freelo.head= base->freelo.tail= -1;
+	base->freehi.head= base->freehi.tail= -1;
 
 	base->my_pid= getpid();
 
@@ -4170,6 +4756,27 @@ static void noreply_callback(int __attribute((unused)) unused,
 
 	state= s;
 
+	if (state->par)
+	{
+		if (state->par->round < state->trtcount)
+		{
+			/* Next round of probes */
+			send_pkt(state);
+			return;
+		}
+
+		if (state->resp_file_out)
+		{
+			/* Use a zero proto to signal a timeout */
+			uint8_t proto= 0;
+
+			write_response(state->resp_file_out, RESP_PROTO,
+				sizeof(proto), &proto);
+		}
+		par_rebuild(state);
+		return;
+	}
+
 	if (!state->gotresp)
 	{
 		if (state->open_result)
@@ -4205,12 +4812,11 @@ static void *traceroute_init(int __attribute((unused)) argc, char *argv[],
 {
 	uint16_t destport;
 	uint32_t opt;
-	int i, do_icmp, do_v6, dont_fragment, delay_name_res, do_tcp, do_udp;
-	int tos;
+	int ind, do_icmp, do_v6, dont_fragment, delay_name_res, do_tcp, do_udp;
+	int tos, parallel;
 	unsigned count, duptimeout, firsthop, gaplimit, maxhops, maxpacksize,
-		hbhoptsize, destoptsize, parismod, parisbase, timeout;
+		hbhoptsize, destoptsize, parismod, parisbase, timeout, stoplife;
 		/* must be int-sized */
-	size_t newsiz;
 	char *str_Atlas;
 	char *str_bundle;
 	const char *hostname;
@@ -4249,19 +4855,21 @@ static void *traceroute_init(int __attribute((unused)) argc, char *argv[],
 	hbhoptsize= 0;
 	destoptsize= 0;
 	tos= 0;
+	stoplife= 0;
 	str_Atlas= NULL;
 	str_bundle= NULL;
 	out_filename= NULL;
 	response_in= NULL;
 	response_out= NULL;
-	opt_complementary = "=1:4--6:i--u:a+:b+:c+:f+:g+:m+:t+:w+:z+:S+:H+:D+";
+	opt_complementary = "=1:4--6:i--u:a+:b+:c+:f+:g+:m+:t+:w+:z+:S+:H+:D+:E+";
 
 	opt = getopt32(argv, TRACEROUTE_OPT_STRING, &parismod, &parisbase,
 		&count,
 		&firsthop, &gaplimit, &interface, &maxhops, &destportstr,
 		&tos, &timeout, &duptimeout,
 		&str_Atlas, &str_bundle, &out_filename, &maxpacksize,
-		&hbhoptsize, &destoptsize, &response_in, &response_out);
+		&hbhoptsize, &destoptsize, &response_in, &response_out,
+		&stoplife);
 	hostname = argv[optind];
 
 	if (opt == 0xffffffff)
@@ -4279,11 +4887,22 @@ static void *traceroute_init(int __attribute((unused)) argc, char *argv[],
 				 */
 	do_tcp= !!(opt & OPT_T);
 	do_udp= !(do_icmp || do_tcp);
+	parallel= !!(opt & OPT_P);
 	if (maxpacksize > MAX_DATA_SIZE)
 	{
 		crondlog(LVL8 "max. packet size too big");
 		return NULL;
 	}
+	if (parallel && do_tcp)
+	{
+		crondlog(LVL8 "parallel mode not supported for TCP");
+		return NULL;
+	}
+	if (parallel && firsthop > maxhops)
+	{
+		crondlog(LVL8 "first hop beyond max. hops");
+		return NULL;
+	}
 
 	if (response_in)
 	{
@@ -4374,6 +4993,16 @@ static void *traceroute_init(int __attribute((unused)) argc, char *argv[],
 		af= -1;
 	}
 
+	/* Recorded probes carry a low index, like the fixed pid below */
+	ind= index_alloc(trt_base, (do_icmp && !do_v6) ||
+		response_in || response_out);
+	if (ind == -1)
+	{
+		crondlog(LVL8 "too many traceroutes");
+		free(lsa);
+		goto err;
+	}
+
 	state= xzalloc(sizeof(*state));
 	state->parismod= parismod;
 	state->parisbase= parisbase;
@@ -4386,6 +5015,7 @@ static void *traceroute_init(int __attribute((unused)) argc, char *argv[],
 	state->destportstr= strdup(destportstr);
 	state->duptimeout= duptimeout*1000;
 	state->timeout= timeout*1000;
+	state->stoplife= stoplife;
 	state->tos= tos;
 	state->atlas= str_Atlas ? strdup(str_Atlas) : NULL;
 	state->bundle_id= str_bundle ? strdup(str_bundle) : NULL;
@@ -4396,6 +5026,7 @@ static void *traceroute_init(int __attribute((unused)) argc, char *argv[],
 	state->do_v6= do_v6;
 	state->dont_fragment= dont_fragment;
 	state->delay_name_res= delay_name_res;
+	state->dns_nocache= !!(opt & OPT_N);
 	state->hbhoptsize= hbhoptsize;
 	state->destoptsize= destoptsize;
 	state->out_filename= validated_out_filename;
@@ -4413,26 +5044,20 @@ static void *traceroute_init(int __attribute((unused)) argc, char *argv[],
 	state->socket_icmp= -1;
 	state->socket_tcp= -1;
 
+	if (parallel)
+	{
+		state->par= xzalloc(sizeof(*state->par));
+		state->par->nslots= (maxhops-firsthop+1)*count;
+		state->par->slots= xzalloc(state->par->nslots *
+			sizeof(*state->par->slots));
+	}
+
 	if (response_in || response_out)
 		trt_base->my_pid= 42;
 
-	for (i= 0; i<trt_base->tabsiz; i++)
-	{
-		if (trt_base->table[i] == NULL)
-			break;
-	}
-	if (i >= trt_base->tabsiz)
-	{
-		newsiz= 2*trt_base->tabsiz;
-		trt_base->table= xrealloc(trt_base->table,
-			newsiz*sizeof(*trt_base->table));
-		for (i= trt_base->tabsiz; i<newsiz; i++)
-			trt_base->table[i]= NULL;
-		i= trt_base->tabsiz;
-		trt_base->tabsiz= newsiz;
-	}
-	state->index= i;
-	trt_base->table[i]= state;
+	state->index= ind;
+	state->gen= trt_base->tabgen[ind]++;
+	trt_base->table[ind]= state;
 	trt_base->done= done;
 
 	memset(&state->loc_sin6, '\0', sizeof(state->loc_sin6));
@@ -4501,6 +5126,7 @@ static void traceroute_start2(void *state)
 	trtstate->not_done= 0;
 	trtstate->lastditch= 0;
 	trtstate->curpacksize= trtstate->maxpacksize;
+	trtstate->tmpl_len= 0;
 
 	if (trtstate->result) free(trtstate->result);
 	trtstate->resmax= 80;
@@ -4511,6 +5137,11 @@ static void traceroute_start2(void *state)
 
 	trtstate->socket_tcp= -1;
 
+	trtstate->stopped= 0;
+	trtstate->stopgen= ++trtstate->base->stopgen;
+	if (trtstate->stoplife && !trtstate->par)
+		stopset_skip(trtstate);
+
 	snprintf(line, sizeof(line), "{ " DBQ(hop) ":%d", trtstate->hop);
 	add_str(trtstate, line);
 
@@ -4555,11 +5186,15 @@ static void traceroute_start2(void *state)
 
 	add_str(trtstate, ", " DBQ(result) ": [ ");
 
+	if (trtstate->par)
+		par_reset(trtstate->par);
+
 	send_pkt(trtstate);
 
 	if (trtstate->response_in)
 	{
-		for (;;)
+		/* Until report() ends this run */
+		while (trtstate->busy)
 		{
 			if (trtstate->sin6.sin6_family == AF_INET6)
 				ready_callback6(0, 0, state);
@@ -4967,8 +5602,9 @@ static void traceroute_start(void *state)
 		memset(&hints, '\0', sizeof(hints));
 		hints.ai_socktype= SOCK_DGRAM;
 		hints.ai_family= trtstate->do_v6 ? AF_INET6 : AF_INET;
-		(void) evdns_getaddrinfo(DnsBase, trtstate->hostname,
-			trtstate->destportstr, &hints, dns_cb, trtstate);
+		dnscache_getaddrinfo(DnsBase, trtstate->hostname,
+			trtstate->destportstr, &hints, trtstate->dns_nocache,
+			dns_cb, trtstate);
 	}
 }
 
@@ -4992,6 +5628,7 @@ static int traceroute_delete(void *state)
 	if (base->table[ind] != trtstate)
 		crondlog(DIE9 "strange, state not in table");
 	base->table[ind]= NULL;
+	index_put(base, ind);
 
 	event_del(&trtstate->timer);
 
@@ -5007,6 +5644,15 @@ static int traceroute_delete(void *state)
 	trtstate->destportstr= NULL;
 	free(trtstate->out_filename);
 	trtstate->out_filename= NULL;
+	free(trtstate->tmpl);
+	trtstate->tmpl= NULL;
+	if (trtstate->par)
+	{
+		par_reset(trtstate->par);
+		free(trtstate->par->slots);
+		free(trtstate->par);
+		trtstate->par= NULL;
+	}
 
 	free(trtstate);
 
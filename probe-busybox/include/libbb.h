@@ -765,6 +765,14 @@ ssize_t recv_from_to(int fd, void *buf, size_t len, int flags,
 		socklen_t sa_size) FAST_FUNC;
 
 uint16_t inet_cksum(uint16_t *addr, int len) FAST_FUNC;
+uint32_t inet_cksum_add(uint32_t sum, const void *buf, int len) FAST_FUNC;
+uint16_t inet_cksum_fold(uint32_t sum) FAST_FUNC;
+uint32_t inet_cksum_ph4(const struct in_addr *src, const struct in_addr *dst,
+		uint8_t proto, uint16_t len) FAST_FUNC;
+uint32_t inet_cksum_ph6(const struct in6_addr *src, const struct in6_addr *dst,
+		uint8_t nxt, uint32_t len) FAST_FUNC;
+uint16_t inet_cksum_adjust(uint16_t cksum, const void *old, const void *new,
+		int len) FAST_FUNC;
 
 char *xstrdup(const char *s) FAST_FUNC RETURNS_MALLOC;
 char *xstrndup(const char *s, int n) FAST_FUNC RETURNS_MALLOC;
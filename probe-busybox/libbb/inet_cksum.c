@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2026 RIPE NCC <atlas@ripe.net>
+ * Licensed under GPLv2 or later, see file LICENSE in this tarball for details.
+ *
+ * Internet checksum (RFC 1071). Partial sums are returned folded to 16 bits
+ * but not complemented, so a few of them can be added before the final
+ * inet_cksum_fold. The main loop adds 32-bit words into a 64-bit accumulator,
+ * which gives the same one's complement sum as adding 16-bit words in
+ * either byte order. SSE2 and NEON versions are used for the bulk of
+ * large buffers.
+ */
+
+#include "libbb.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+static uint32_t fold16(uint64_t sum)
+{
+	sum= (sum >> 32) + (sum & 0xFFFFFFFF);
+	sum= (sum >> 16) + (sum & 0xFFFF);
+	sum= (sum >> 16) + (sum & 0xFFFF);
+	sum= (sum >> 16) + (sum & 0xFFFF);
+	return sum;
+}
+
+#if defined(__SSE2__)
+/* Adds 16-bit words to four 32-bit lanes. Every lane gains at most
+ * 2*0xFFFF per 16 bytes, so lanes cannot overflow for buffers below
+ * 512 KB.
+ */
+static uint64_t sum_vec(const unsigned char **pp, int *lenp)
+{
+	const unsigned char *p= *pp;
+	int len= *lenp;
+	__m128i acc, zero, v;
+	uint32_t lanes[4];
+
+	zero= _mm_setzero_si128();
+	acc= zero;
+	while (len >= 16)
+	{
+		v= _mm_loadu_si128((const __m128i *)p);
+		acc= _mm_add_epi32(acc, _mm_unpacklo_epi16(v, zero));
+		acc= _mm_add_epi32(acc, _mm_unpackhi_epi16(v, zero));
+		p += 16;
+		len -= 16;
+	}
+	_mm_storeu_si128((__m128i *)lanes, acc);
+
+	*pp= p;
+	*lenp= len;
+	return (uint64_t)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+#define HAVE_SUM_VEC 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+static uint64_t sum_vec(const unsigned char **pp, int *lenp)
+{
+	const unsigned char *p= *pp;
+	int len= *lenp;
+	uint32x4_t acc;
+	uint32_t lanes[4];
+
+	acc= vdupq_n_u32(0);
+	while (len >= 16)
+	{
+		acc= vpadalq_u16(acc, vld1q_u16((const uint16_t *)p));
+		p += 16;
+		len -= 16;
+	}
+	vst1q_u32(lanes, acc);
+
+	*pp= p;
+	*lenp= len;
+	return (uint64_t)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+#define HAVE_SUM_VEC 1
+#endif
+
+/* Add the 16-bit words in 'buf' to partial sum 'sum'. Only the last buffer
+ * of a sequence may have an odd length.
+ */
+uint32_t FAST_FUNC inet_cksum_add(uint32_t sum, const void *buf, int len)
+{
+	const unsigned char *p= buf;
+	uint64_t acc= sum;
+	uint32_t w0, w1, w2, w3;
+	uint16_t w;
+
+#ifdef HAVE_SUM_VEC
+	if (len >= 64)
+		acc += sum_vec(&p, &len);
+#endif
+	while (len >= 16)
+	{
+		move_from_unaligned32(w0, p);
+		move_from_unaligned32(w1, p+4);
+		move_from_unaligned32(w2, p+8);
+		move_from_unaligned32(w3, p+12);
+		acc += (uint64_t)w0 + w1 + w2 + w3;
+		p += 16;
+		len -= 16;
+	}
+	while (len >= 4)
+	{
+		move_from_unaligned32(w0, p);
+		acc += w0;
+		p += 4;
+		len -= 4;
+	}
+	if (len >= 2)
+	{
+		move_from_unaligned16(w, p);
+		acc += w;
+		p += 2;
+		len -= 2;
+	}
+	if (len == 1)
+	{
+		w= 0;
+		*(unsigned char *)&w= *p;
+		acc += w;
+	}
+
+	return fold16(acc);
+}
+
+/* Fold a partial sum and return its complement, ready to be stored in
+ * a header.
+ */
+uint16_t FAST_FUNC inet_cksum_fold(uint32_t sum)
+{
+	sum= (sum >> 16) + (sum & 0xFFFF);
+	sum += (sum >> 16);
+	return ~sum;
+}
+
+uint16_t FAST_FUNC inet_cksum(uint16_t *addr, int len)
+{
+	return inet_cksum_fold(inet_cksum_add(0, addr, len));
+}
+
+/* Partial sums of the TCP/UDP pseudo headers. 'len' and 'proto' are in
+ * host byte order.
+ */
+uint32_t FAST_FUNC inet_cksum_ph4(const struct in_addr *src,
+	const struct in_addr *dst, uint8_t proto, uint16_t len)
+{
+	uint32_t sum;
+
+	sum= inet_cksum_add(0, src, sizeof(*src));
+	sum= inet_cksum_add(sum, dst, sizeof(*dst));
+	return fold16((uint64_t)sum + htons(proto) + htons(len));
+}
+
+uint32_t FAST_FUNC inet_cksum_ph6(const struct in6_addr *src,
+	const struct in6_addr *dst, uint8_t nxt, uint32_t len)
+{
+	uint32_t sum;
+
+	sum= inet_cksum_add(0, src, sizeof(*src));
+	sum= inet_cksum_add(sum, dst, sizeof(*dst));
+	return fold16((uint64_t)sum + htons(len >> 16) + htons(len & 0xFFFF) +
+		htons(nxt));
+}
+
+/* Update checksum 'cksum' for 'len' bytes at 'old' changing into the bytes
+ * at 'new' (RFC 1624, eqn. 3). 'len' has to be even.
+ */
+uint16_t FAST_FUNC inet_cksum_adjust(uint16_t cksum, const void *old,
+	const void *new, int len)
+{
+	uint32_t sum;
+
+	/* inet_cksum_fold of the old bytes is their one's complement
+	 * negation.
+	 */
+	sum= (uint16_t)~cksum;
+	sum += inet_cksum_fold(inet_cksum_add(0, old, len));
+	sum= inet_cksum_add(sum, new, len);
+	return inet_cksum_fold(sum);
+}
@@ -0,0 +1,118 @@
+#!/usr/bin/env python3
+#
+# Generates eperd/http2_huffman.h, the HPACK Huffman decoding tables, from
+# huffman_encode[] in eperd/http2.c:
+#
+#	scripts/mk_http2_huffman.py eperd/http2.c > eperd/http2_huffman.h
+#
+# An optional second argument sets the number of bits of the fast table
+# (default 12).
+#
+# Copyright (c) 2026 RIPE NCC <atlas@ripe.net>
+# Licensed under GPLv2 or later, see file LICENSE in this tarball for details.
+
+import re, sys
+
+if len(sys.argv) < 2:
+    sys.exit("usage: mk_http2_huffman.py <http2.c> [<fast bits>]")
+src = open(sys.argv[1]).read()
+FAST = int(sys.argv[2]) if len(sys.argv) > 2 else 12
+codes = {}
+for m in re.finditer(r'/\*\s*(\d+) \*/ \{\s*(0x[0-9a-f]+),\s*(\d+),', src):
+    codes[int(m.group(1))] = (int(m.group(2), 16), int(m.group(3)))
+assert len(codes) == 256
+codes[256] = (0x3fffffff, 30)   # EOS
+
+# The code is canonical: check, then build first code and offset per length
+order = sorted(codes, key=lambda s: (codes[s][1], s))
+code = 0; prev = codes[order[0]][1]
+for s in order:
+    l = codes[s][1]; code <<= l - prev; prev = l
+    assert code == codes[s][0]
+    code += 1
+MAXLEN = 30
+first = [0]*(MAXLEN+1); count = [0]*(MAXLEN+1); base = [0]*(MAXLEN+1)
+for i, s in enumerate(order):
+    l = codes[s][1]
+    if count[l] == 0:
+        first[l] = codes[s][0]; base[l] = i
+    count[l] += 1
+# Lengths without codes: make the range empty but keep 'first' consistent
+code = 0
+for l in range(1, MAXLEN+1):
+    if count[l] == 0:
+        first[l] = code; base[l] = base[l-1] + count[l-1] if l > 1 else 0
+    code = (first[l] + count[l]) << 1
+
+lookup = {}
+for s, (c, l) in codes.items():
+    lookup[(l, c)] = s
+def dec1(bits, avail):
+    for l in range(1, avail+1):
+        s = lookup.get((l, bits >> (avail - l)))
+        if s is not None:
+            return s, l
+    return None, 0
+
+fast = []
+for i in range(1 << FAST):
+    s1, l1 = dec1(i, FAST)
+    if s1 is None or s1 == 256:
+        fast.append((0, 0, 0, 0)); continue
+    rest = FAST - l1
+    s2, l2 = dec1(i & ((1 << rest)-1), rest) if rest else (None, 0)
+    if s2 is None or s2 == 256:
+        fast.append((s1, 0, l1, l1))
+    else:
+        fast.append((s1, s2, l1, l1+l2))
+
+print("""/*
+ * Copyright (c) 2026 RIPE NCC <atlas@ripe.net>
+ * Licensed under GPLv2 or later, see file LICENSE in this tarball for details.
+ * http2_huffman.h
+ */
+
+/* HPACK Huffman decoding tables (RFC 7541, Appendix B). Generated by
+ * scripts/mk_http2_huffman.py from huffman_encode in http2.c.
+ *
+ * huffman_fast is indexed by the next %d bits of input and gives the one
+ * or two symbols with codes that fit. Longer codes are canonical, so they
+ * are decoded by length with huffman_first, huffman_count and huffman_base
+ * into huffman_sorted.
+ */
+
+#define HUFFMAN_FAST_BITS	%d
+#define HUFFMAN_MAX_BITS	%d
+#define HUFFMAN_EOS		256
+
+struct huffman_fast
+{
+	uint8_t sym1;
+	uint8_t sym2;
+	uint8_t bits1;		/* Code of sym1, 0 if longer than the table */
+	uint8_t bits;		/* Codes of sym1 and sym2, bits1 if there is no sym2 */
+};
+""" % (FAST, FAST, MAXLEN))
+print("static const struct huffman_fast huffman_fast[1 << HUFFMAN_FAST_BITS]=\n{")
+for i in range(0, len(fast), 4):
+    print("\t" + " ".join("{ %3d, %3d, %2d, %2d }," % e for e in fast[i:i+4]))
+print("};\n")
+print("/* First code and number of codes of each length */")
+print("static const uint32_t huffman_first[HUFFMAN_MAX_BITS+1]=\n{")
+for l in range(0, MAXLEN+1, 4):
+    print("\t" + " ".join("0x%08x," % first[x] for x in range(l, min(l+4, MAXLEN+1))))
+print("};\n")
+print("static const uint8_t huffman_count[HUFFMAN_MAX_BITS+1]=\n{")
+for l in range(0, MAXLEN+1, 8):
+    print("\t" + " ".join("%2d," % count[x] for x in range(l, min(l+8, MAXLEN+1))))
+print("};\n")
+print("/* Index in huffman_sorted of the first code of each length */")
+print("static const uint16_t huffman_base[HUFFMAN_MAX_BITS+1]=\n{")
+for l in range(0, MAXLEN+1, 8):
+    print("\t" + " ".join("%3d," % base[x] for x in range(l, min(l+8, MAXLEN+1))))
+print("};\n")
+print("/* Symbols ordered by code */")
+print("static const uint16_t huffman_sorted[HUFFMAN_EOS+1]=\n{")
+for i in range(0, len(order), 8):
+    print("\t" + " ".join("%3d," % s for s in order[i:i+8]))
+print("};")
@@ -0,0 +1,287 @@
+/*
+ * Copyright (c) 2026 RIPE NCC <atlas@ripe.net>
+ * Licensed under GPLv2 or later, see file LICENSE in this tarball for details.
+ *
+ * Checks libbb/inet_cksum.c against the checksum routines it replaced in
+ * ping and traceroute. With -b it also times both over a few packet sizes.
+ */
+
+#include "libbb.h"
+#include <time.h>
+
+/* The old code, as it was in traceroute.c. Ping's mkcksum was the same
+ * loop with a long accumulator.
+ */
+struct v4_ph
+{
+	struct in_addr src;
+	struct in_addr dst;
+	uint8_t zero;
+	uint8_t proto;
+	uint16_t len;
+};
+
+struct v6_ph
+{
+	struct in6_addr src;
+	struct in6_addr dst;
+	uint32_t len;
+	uint8_t zero[3];
+	uint8_t nxt;
+};
+
+static int in_cksum(unsigned short *buf, int sz)
+{
+	int nleft = sz;
+	int sum = 0;
+	unsigned short *w = buf;
+	unsigned short ans = 0;
+
+	while (nleft > 1) {
+		sum += *w++;
+		nleft -= 2;
+	}
+
+	if (nleft == 1) {
+		*(unsigned char *) (&ans) = *(unsigned char *) w;
+		sum += ans;
+	}
+
+	sum = (sum >> 16) + (sum & 0xFFFF);
+	sum += (sum >> 16);
+	ans = ~sum;
+	return ans;
+}
+
+static int in_cksum_ph(void *ph, int phlen, unsigned short *buf, int sz)
+{
+	int nleft;
+	int sum = 0;
+	unsigned short *w;
+	unsigned short ans = 0;
+
+	nleft= phlen;
+	w= ph;
+	while (nleft > 1) {
+		sum += *w++;
+		nleft -= 2;
+	}
+
+	nleft= sz;
+	w= buf;
+	while (nleft > 1) {
+		sum += *w++;
+		nleft -= 2;
+	}
+
+	if (nleft == 1) {
+		*(unsigned char *) (&ans) = *(unsigned char *) w;
+		sum += ans;
+	}
+
+	sum = (sum >> 16) + (sum & 0xFFFF);
+	sum += (sum >> 16);
+	ans = ~sum;
+	return ans;
+}
+
+static uint16_t cksum_adjust(uint16_t cksum, const void *old, const void *new,
+	size_t len)
+{
+	uint32_t sum;
+	const uint16_t *o, *n;
+
+	o= old;
+	n= new;
+	sum= (uint16_t)~cksum;
+	for (; len > 1; len -= 2)
+	{
+		sum += (uint16_t)~*o++;
+		sum += *n++;
+	}
+
+	sum = (sum >> 16) + (sum & 0xFFFF);
+	sum += (sum >> 16);
+	return ~sum;
+}
+
+#define MAXLEN	4100
+
+static uint32_t rnd_state= 42;
+
+static uint32_t rnd(void)
+{
+	/* xorshift32, the same sequence on every run */
+	rnd_state ^= rnd_state << 13;
+	rnd_state ^= rnd_state >> 17;
+	rnd_state ^= rnd_state << 5;
+	return rnd_state;
+}
+
+static void fill(unsigned char *p, int len, int ones)
+{
+	int i;
+
+	for (i= 0; i<len; i++)
+		p[i]= ones ? 0xff : rnd();
+}
+
+/* One's complement sums have two zeros */
+static int same_sum(uint16_t a, uint16_t b)
+{
+	return a == b || (a % 0xFFFF) == (b % 0xFFFF);
+}
+
+static int check(void)
+{
+	int i, len, off, split, ones, errors;
+	uint16_t old, new;
+	uint32_t sum;
+	struct v4_ph v4_ph;
+	struct v6_ph v6_ph;
+	static uint16_t bufspace[MAXLEN/2+8];
+	static uint16_t oldspace[32], newspace[32];
+	unsigned char *buf;
+
+	errors= 0;
+
+	for (ones= 0; ones<2; ones++)
+	for (off= 0; off<4; off += 2)
+	for (len= 0; len<=MAXLEN; len++)
+	{
+		buf= (unsigned char *)bufspace + off;
+		fill(buf, len, ones);
+
+		old= in_cksum((unsigned short *)buf, len);
+		new= inet_cksum((uint16_t *)buf, len);
+		if (old != new)
+		{
+			printf("inet_cksum: len %d, offset %d: %04x, want %04x\n",
+				len, off, new, old);
+			errors++;
+		}
+
+		/* Partial sums, split at an even offset */
+		split= (len/2) ? (rnd() % (len/2))*2 : 0;
+		sum= inet_cksum_add(0, buf, split);
+		sum= inet_cksum_add(sum, buf+split, len-split);
+		new= inet_cksum_fold(sum);
+		if (old != new)
+		{
+			printf("inet_cksum_add: len %d, split %d: %04x, want %04x\n",
+				len, split, new, old);
+			errors++;
+		}
+
+		if (len > 1500)
+			continue;
+
+		memset(&v4_ph, '\0', sizeof(v4_ph));
+		fill((unsigned char *)&v4_ph.src, 4, ones);
+		fill((unsigned char *)&v4_ph.dst, 4, ones);
+		v4_ph.proto= IPPROTO_UDP;
+		v4_ph.len= htons(len);
+		old= in_cksum_ph(&v4_ph, sizeof(v4_ph),
+			(unsigned short *)buf, len);
+		new= inet_cksum_fold(inet_cksum_add(inet_cksum_ph4(&v4_ph.src,
+			&v4_ph.dst, IPPROTO_UDP, len), buf, len));
+		if (old != new)
+		{
+			printf("inet_cksum_ph4: len %d: %04x, want %04x\n",
+				len, new, old);
+			errors++;
+		}
+
+		memset(&v6_ph, '\0', sizeof(v6_ph));
+		fill((unsigned char *)&v6_ph.src, 16, ones);
+		fill((unsigned char *)&v6_ph.dst, 16, ones);
+		v6_ph.nxt= IPPROTO_ICMPV6;
+		v6_ph.len= htonl(len);
+		old= in_cksum_ph(&v6_ph, sizeof(v6_ph),
+			(unsigned short *)buf, len);
+		new= inet_cksum_fold(inet_cksum_add(inet_cksum_ph6(&v6_ph.src,
+			&v6_ph.dst, IPPROTO_ICMPV6, len), buf, len));
+		if (old != new)
+		{
+			printf("inet_cksum_ph6: len %d: %04x, want %04x\n",
+				len, new, old);
+			errors++;
+		}
+	}
+
+	for (i= 0; i<100000; i++)
+	{
+		len= (rnd() % 32) * 2;
+		fill((unsigned char *)oldspace, len, 0);
+		fill((unsigned char *)newspace, len, 0);
+		old= rnd();
+		new= inet_cksum_adjust(old, oldspace, newspace, len);
+		old= cksum_adjust(old, oldspace, newspace, len);
+		if (!same_sum(old, new))
+		{
+			printf("inet_cksum_adjust: len %d: %04x, want %04x\n",
+				len, new, old);
+			errors++;
+		}
+	}
+
+	return errors;
+}
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec/1e9;
+}
+
+static void bench(void)
+{
+	static const int sizes[]= { 64, 256, 1500, 4096 };
+	int i, n, rounds;
+	unsigned sink;
+	double t_old, t_new;
+	static uint16_t buf[MAXLEN/2];
+
+	fill((unsigned char *)buf, sizeof(buf), 0);
+	sink= 0;
+	printf("bytes  old GB/s  new GB/s\n");
+	for (i= 0; i<(int)ARRAY_SIZE(sizes); i++)
+	{
+		rounds= (1 << 28) / sizes[i];
+
+		t_old= now();
+		for (n= 0; n<rounds; n++)
+		{
+			buf[0]= n;
+			sink += in_cksum((unsigned short *)buf, sizes[i]);
+		}
+		t_old= now()-t_old;
+
+		t_new= now();
+		for (n= 0; n<rounds; n++)
+		{
+			buf[0]= n;
+			sink += inet_cksum(buf, sizes[i]);
+		}
+		t_new= now()-t_new;
+
+		printf("%5d  %8.1f  %8.1f\n", sizes[i],
+			(double)rounds*sizes[i]/t_old/1e9,
+			(double)rounds*sizes[i]/t_new/1e9);
+	}
+	if (sink == 1)
+		printf("\n");	/* Keep the loops */
+}
+
+int main(int argc, char *argv[])
+{
+	if (check() != 0)
+		return 1;
+	printf("ok\n");
+
+	if (argc > 1 && strcmp(argv[1], "-b") == 0)
+		bench();
+	return 0;
+}
@@ -0,0 +1,413 @@
+/*
+ * Copyright (c) 2026 RIPE NCC <atlas@ripe.net>
+ * Licensed under GPLv2 or later, see file LICENSE in this tarball for details.
+ *
+ * Checks eperd/dnscache.c with scripted answers in place of evdns and a
+ * clock that only moves when told to.
+ */
+
+/* The cache size is static */
+#include "eperd/dnscache.c"
+
+struct globals G;
+
+static int errors;
+
+#define CHECK(name, cond) \
+	do { if (!(cond)) { printf("%s: %s failed\n", name, #cond); \
+		errors++; } } while (0)
+
+void crondlog(const char *fmt, ...)
+{
+	va_list ap;
+
+	va_start(ap, fmt);
+	vfprintf(stderr, fmt, ap);
+	va_end(ap);
+	fprintf(stderr, "\n");
+	exit(1);
+}
+
+void* FAST_FUNC xzalloc(size_t size)
+{
+	void *p;
+
+	p= calloc(1, size);
+	if (!p)
+		crondlog("out of memory");
+	return p;
+}
+
+char* FAST_FUNC xstrdup(const char *s)
+{
+	return strcpy(xzalloc(strlen(s)+1), s);
+}
+
+void* FAST_FUNC xmemdup(const void *s, int n)
+{
+	return memcpy(xzalloc(n), s, n);
+}
+
+static time_t clock_sec;
+
+int gettime_mono(struct timespec *tsp)
+{
+	tsp->tv_sec= clock_sec;
+	tsp->tv_nsec= 0;
+	return 0;
+}
+
+/* Queries sent, in order */
+#define MAXQUERIES	(4*DNSCACHE_MAX)
+
+static struct query
+{
+	char *name;
+	char type;
+	evdns_callback_type cb;
+	void *arg;
+} queries[MAXQUERIES];
+static int nqueries, nanswered, npassed;
+
+static struct evdns_request *query(const char *name, char type,
+	evdns_callback_type cb, void *arg)
+{
+	struct query *q;
+
+	if (nqueries >= MAXQUERIES)
+		crondlog("too many queries");
+	q= &queries[nqueries++];
+	q->name= xstrdup(name);
+	q->type= type;
+	q->cb= cb;
+	q->arg= arg;
+	return (struct evdns_request *)q;
+}
+
+struct evdns_request *evdns_base_resolve_ipv4(struct evdns_base *base,
+	const char *name, int flags, evdns_callback_type cb, void *arg)
+{
+	return query(name, DNS_IPv4_A, cb, arg);
+}
+
+struct evdns_request *evdns_base_resolve_ipv6(struct evdns_base *base,
+	const char *name, int flags, evdns_callback_type cb, void *arg)
+{
+	return query(name, DNS_IPv6_AAAA, cb, arg);
+}
+
+/* The hosts file has hosts.test */
+static char hosts_base;
+static int nhosts, nloads;
+
+struct evdns_base *evdns_base_new(struct event_base *event_base, int flags)
+{
+	return (struct evdns_base *)&hosts_base;
+}
+
+int evdns_base_load_hosts(struct evdns_base *base, const char *hosts_fname)
+{
+	nloads++;
+	return 0;
+}
+
+void evdns_getaddrinfo_cancel(struct evdns_getaddrinfo_request *req)
+{
+}
+
+struct evdns_getaddrinfo_request *evdns_getaddrinfo(struct evdns_base *base,
+	const char *name, const char *port, const struct evutil_addrinfo *hints,
+	evdns_getaddrinfo_cb cb, void *arg)
+{
+	struct sockaddr_in sin;
+
+	if (base != (struct evdns_base *)&hosts_base)
+	{
+		npassed++;
+		cb(EVUTIL_EAI_FAIL, NULL, arg);
+		return NULL;
+	}
+
+	nhosts++;
+	if (strcasecmp(name, "hosts.test") != 0)
+	{
+		/* Queued, to be cancelled */
+		return (struct evdns_getaddrinfo_request *)&hosts_base;
+	}
+	memset(&sin, '\0', sizeof(sin));
+	sin.sin_family= AF_INET;
+	sin.sin_addr.s_addr= htonl(0x7f000002);
+	sin.sin_port= htons(atoi(port));
+	cb(0, evutil_new_addrinfo_((struct sockaddr *)&sin, sizeof(sin),
+		hints), arg);
+	return NULL;
+}
+
+/* Answer the oldest open queries */
+static void answer(int n, int result, int ttl)
+{
+	static const u_char addrs[]=
+	{
+		193, 0, 0, 164, 193, 0, 0, 165,
+		0x20, 0x01, 0x06, 0x7c, 0x02, 0xe8, 0, 3,
+		0, 0, 0, 0, 0xc1, 0x00, 0x00, 0xa4,
+	};
+	struct query *q;
+
+	for (; n > 0; n--)
+	{
+		if (nanswered >= nqueries)
+			crondlog("no query to answer");
+		q= &queries[nanswered++];
+		if (result != DNS_ERR_NONE)
+			q->cb(result, q->type, 0, ttl, NULL, q->arg);
+		else if (q->type == DNS_IPv4_A)
+			q->cb(result, q->type, 2, ttl, (void *)addrs, q->arg);
+		else
+			q->cb(result, q->type, 1, ttl, (void *)(addrs+8), q->arg);
+	}
+}
+
+/* What a lookup got */
+struct got
+{
+	int called;
+	int error;
+	int v4, v6;
+	void (*then)(struct got *got);	/* From within the callback */
+	const char *name;
+};
+
+static void got_cb(int error, struct evutil_addrinfo *res, void *arg)
+{
+	struct got *got;
+	struct evutil_addrinfo *ai;
+
+	got= arg;
+	got->called++;
+	got->error= error;
+	for (ai= res; ai; ai= ai->ai_next)
+	{
+		if (ai->ai_family == AF_INET)
+			got->v4++;
+		else
+			got->v6++;
+	}
+	if (res)
+		evutil_freeaddrinfo(res);
+	if (got->then)
+		got->then(got);
+}
+
+static void lookup(const char *name, int nocache, struct got *got)
+{
+	struct evutil_addrinfo hints;
+
+	memset(&hints, '\0', sizeof(hints));
+	hints.ai_socktype= SOCK_STREAM;
+	got->name= name;
+	dnscache_getaddrinfo(NULL, name, "80", &hints, nocache, got_cb, got);
+}
+
+static void check_hit(void)
+{
+	struct got g1, g2, g3;
+
+	/* Both families are queried once, also for a second lookup while
+	 * the queries are out
+	 */
+	memset(&g1, '\0', sizeof(g1));
+	memset(&g2, '\0', sizeof(g2));
+	lookup("hit.test", 0, &g1);
+	lookup("HIT.test", 0, &g2);
+	CHECK("hit", nqueries-nanswered == 2);
+	answer(2, DNS_ERR_NONE, 60);
+	CHECK("hit", g1.called == 1 && g1.error == 0);
+	CHECK("hit", g1.v4 == 2 && g1.v6 == 1);
+	CHECK("hit", g2.called == 1 && g2.v4 == 2 && g2.v6 == 1);
+
+	/* Then from the cache, before the lookup returns */
+	memset(&g3, '\0', sizeof(g3));
+	lookup("hit.test", 0, &g3);
+	CHECK("hit", nqueries == nanswered);
+	CHECK("hit", g3.called == 1 && g3.v4 == 2 && g3.v6 == 1);
+}
+
+static void check_negative(void)
+{
+	struct got got;
+
+	/* NXDOMAIN is kept for its ttl */
+	memset(&got, '\0', sizeof(got));
+	lookup("nx.test", 0, &got);
+	answer(2, DNS_ERR_NOTEXIST, 30);
+	CHECK("negative", got.called == 1 && got.error == EVUTIL_EAI_NONAME);
+
+	memset(&got, '\0', sizeof(got));
+	lookup("nx.test", 0, &got);
+	CHECK("negative", nqueries == nanswered);
+	CHECK("negative", got.called == 1 && got.error == EVUTIL_EAI_NONAME);
+
+	/* Server failures are not kept */
+	memset(&got, '\0', sizeof(got));
+	lookup("fail.test", 0, &got);
+	answer(2, DNS_ERR_SERVERFAILED, 30);
+	CHECK("negative", got.called == 1 && got.error == EVUTIL_EAI_FAIL);
+	lookup("fail.test", 0, &got);
+	CHECK("negative", nqueries-nanswered == 2);
+	answer(2, DNS_ERR_SERVERFAILED, 30);
+}
+
+static void check_expiry(void)
+{
+	struct got got;
+
+	memset(&got, '\0', sizeof(got));
+	lookup("ttl.test", 0, &got);
+	answer(2, DNS_ERR_NONE, 10);
+
+	clock_sec += 9;
+	lookup("ttl.test", 0, &got);
+	CHECK("expiry", nqueries == nanswered);
+
+	clock_sec += 1;
+	lookup("ttl.test", 0, &got);
+	CHECK("expiry", nqueries-nanswered == 2);
+	answer(2, DNS_ERR_NONE, 10);
+	CHECK("expiry", got.called == 3 && got.v4 == 6);
+
+	/* The negative ttl is capped */
+	clock_sec += DNSCACHE_NEG_MAX_TTL;
+	lookup("nx.test", 0, &got);
+	CHECK("expiry", nqueries-nanswered == 2);
+	answer(2, DNS_ERR_NOTEXIST, 2*DNSCACHE_NEG_MAX_TTL);
+	clock_sec += DNSCACHE_NEG_MAX_TTL;
+	lookup("nx.test", 0, &got);
+	CHECK("expiry", nqueries-nanswered == 2);
+	answer(2, DNS_ERR_NOTEXIST, 30);
+}
+
+static void check_nocache(void)
+{
+	struct got got;
+
+	/* The cached name goes to evdns anyway */
+	memset(&got, '\0', sizeof(got));
+	lookup("hit.test", 1, &got);
+	CHECK("nocache", npassed == 1 && nqueries == nanswered);
+	CHECK("nocache", got.called == 1 && got.error == EVUTIL_EAI_FAIL);
+
+	/* So do literals and single labels */
+	lookup("193.0.0.164", 0, &got);
+	lookup("localhost", 0, &got);
+	CHECK("nocache", npassed == 3 && nqueries == nanswered);
+}
+
+static void check_hosts(void)
+{
+	int n;
+	struct got got;
+
+	/* Answered from the hosts file, without queries or a record */
+	memset(&got, '\0', sizeof(got));
+	n= dc_nrec;
+	lookup("hosts.test", 0, &got);
+	CHECK("hosts", nqueries == nanswered && dc_nrec == n);
+	CHECK("hosts", got.called == 1 && got.error == 0);
+	CHECK("hosts", got.v4 == 1 && got.v6 == 0);
+
+	/* Cached names don't look there */
+	lookup("cached.test", 0, &got);
+	CHECK("hosts", nqueries-nanswered == 2);
+	answer(2, DNS_ERR_NONE, 60);
+	n= nhosts;
+	lookup("cached.test", 0, &got);
+	CHECK("hosts", nqueries == nanswered && nhosts == n);
+	CHECK("hosts", got.called == 3 && got.v6 == 2);
+
+	/* A flush rereads it */
+	n= nloads;
+	dnscache_flush();
+	CHECK("hosts", nloads == n+1);
+}
+
+static void again(struct got *got)
+{
+	/* A second lookup of the name that was just answered */
+	got->then= NULL;
+	lookup(got->name, 0, got);
+}
+
+static void flush(struct got *got)
+{
+	dnscache_flush();
+}
+
+static void check_reentry(void)
+{
+	struct got g1, g2;
+
+	/* The record is answering its waiters while a callback looks up
+	 * the same name. A failure is not kept, so this used to free it
+	 * twice.
+	 */
+	memset(&g1, '\0', sizeof(g1));
+	memset(&g2, '\0', sizeof(g2));
+	g1.then= again;
+	g2.then= again;
+	lookup("again.test", 0, &g1);
+	lookup("again.test", 0, &g2);
+	answer(2, DNS_ERR_SERVERFAILED, 0);
+	CHECK("reentry", g1.called == 1 && g2.called == 1);
+
+	/* They share a new A query and get the AAAA answer just given */
+	CHECK("reentry", nqueries-nanswered == 1);
+	answer(1, DNS_ERR_SERVERFAILED, 0);
+	CHECK("reentry", g1.called == 2 && g2.called == 2);
+
+	/* Or flushes the cache */
+	memset(&g1, '\0', sizeof(g1));
+	memset(&g2, '\0', sizeof(g2));
+	g1.then= flush;
+	lookup("flush.test", 0, &g1);
+	lookup("flush.test", 0, &g2);
+	answer(2, DNS_ERR_NONE, 60);
+	CHECK("reentry", g1.called == 1 && g2.called == 1 && g2.v4 == 2);
+	CHECK("reentry", dc_nrec == 0);
+}
+
+static void check_bound(void)
+{
+	int i;
+	char name[32];
+	static struct got got[DNSCACHE_MAX];
+
+	/* Names that are all still being resolved */
+	for (i= 0; i<DNSCACHE_MAX; i++)
+	{
+		snprintf(name, sizeof(name), "n%d.test", i);
+		lookup(name, 0, &got[i]);
+		CHECK("bound", dc_nrec <= DNSCACHE_MAX);
+	}
+	answer(nqueries-nanswered, DNS_ERR_NONE, 60);
+	for (i= 0; i<DNSCACHE_MAX; i++)
+		CHECK("bound", got[i].called == 1 && got[i].v6 == 1);
+	CHECK("bound", dc_nrec <= DNSCACHE_MAX);
+}
+
+int main(void)
+{
+	EventBase= event_base_new();
+
+	check_hit();
+	check_negative();
+	check_expiry();
+	check_nocache();
+	check_hosts();
+	check_reentry();
+	check_bound();
+	if (errors)
+		return 1;
+	printf("ok\n");
+	return 0;
+}
@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2026 RIPE NCC <atlas@ripe.net>
+ * Licensed under GPLv2 or later, see file LICENSE in this tarball for details.
+ *
+ * Checks eperd/dnsmsg.c on hand made messages: compressed names, pointer
+ * loops, names that don't fit and records that run past the end. With
+ * -b <file>... it times parsing the DNS messages in evtdig response
+ * files.
+ */
+
+#include "libbb.h"
+#include "eperd/dnsmsg.h"
+
+#include <time.h>
+
+#define RESP_PACKET	1	/* As in eperd/evtdig.c */
+
+static int errors;
+
+#define CHECK(name, cond) \
+	do { if (!(cond)) { printf("%s: %s failed\n", name, #cond); \
+		errors++; } } while (0)
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec/1e9;
+}
+
+/* Header with one question and one answer, then 'www.ripe.net IN A' */
+static const u_char msg_a[]=
+{
+	0x30, 0x39, 0x81, 0x80, 0, 1, 0, 1, 0, 0, 0, 0,
+	3, 'w', 'w', 'w', 4, 'r', 'i', 'p', 'e', 3, 'n', 'e', 't', 0,
+	0, 1, 0, 1,
+	/* Answer, the owner points at the question */
+	0xc0, 12, 0, 1, 0, 1, 0, 0, 1, 0x2c, 0, 4, 193, 0, 6, 139
+};
+
+static void check_parse(void)
+{
+	u_char buf[512];
+	char name[DNSMSG_NAMELEN];
+	size_t end;
+	struct dnsmsg msg;
+	struct dnsrr rr;
+
+	CHECK("parse", dnsmsg_init(&msg, msg_a, 11) == -1);
+	CHECK("parse", dnsmsg_init(&msg, msg_a, sizeof(msg_a)) == 0);
+	CHECK("parse", msg.id == 12345 && msg.flags == 0x8180);
+	CHECK("parse", msg.qdcount == 1 && msg.ancount == 1 &&
+		msg.nscount == 0 && msg.arcount == 0);
+
+	CHECK("parse", dnsmsg_question(&msg, &rr) == 0);
+	CHECK("parse", rr.name_off == 12 && rr.type == 1 && rr.class == 1);
+	CHECK("parse", msg.offset == 30);
+	CHECK("parse", dnsmsg_name(&msg, rr.name_off, name, sizeof(name),
+		&end) == 12 && strcmp(name, "www.ripe.net") == 0 && end == 26);
+
+	CHECK("parse", dnsmsg_rr(&msg, &rr) == 0);
+	CHECK("parse", rr.type == 1 && rr.ttl == 300 && rr.rdlen == 4);
+	CHECK("parse", rr.rdata_off == 42 && msg.offset == sizeof(msg_a));
+	CHECK("parse", dnsmsg_name(&msg, rr.name_off, name, sizeof(name),
+		&end) == 12 && strcmp(name, "www.ripe.net") == 0 && end == 32);
+
+	/* The answer cut short, in the fixed part and in the rdata */
+	dnsmsg_init(&msg, msg_a, sizeof(msg_a)-5);
+	dnsmsg_question(&msg, &rr);
+	CHECK("parse", dnsmsg_rr(&msg, &rr) == -1);
+	dnsmsg_init(&msg, msg_a, sizeof(msg_a)-1);
+	dnsmsg_question(&msg, &rr);
+	CHECK("parse", dnsmsg_rr(&msg, &rr) == -1);
+
+	/* The question cut short */
+	dnsmsg_init(&msg, msg_a, 28);
+	CHECK("parse", dnsmsg_question(&msg, &rr) == -1);
+	dnsmsg_init(&msg, msg_a, 20);
+	CHECK("parse", dnsmsg_question(&msg, &rr) == -1);
+
+	/* The root */
+	memcpy(buf, msg_a, 12);
+	buf[12]= 0;
+	dnsmsg_init(&msg, buf, 13);
+	CHECK("parse", dnsmsg_name(&msg, 12, name, sizeof(name), &end) == 0 &&
+		name[0] == '\0' && end == 13);
+}
+
+static void check_names(void)
+{
+	int i;
+	u_char buf[512];
+	char name[DNSMSG_NAMELEN];
+	struct dnsmsg msg;
+
+	memset(buf, '\0', 12);
+
+	/* Labels are copied as they are, quoting is up to the caller */
+	memcpy(buf+12, "\5a\"b\\c\4ripe\0", 12);
+	dnsmsg_init(&msg, buf, 24);
+	CHECK("names", dnsmsg_name(&msg, 12, name, sizeof(name), NULL) == 10 &&
+		strcmp(name, "a\"b\\c.ripe") == 0);
+
+	/* A pointer to itself and a loop of two */
+	buf[12]= 0xc0;
+	buf[13]= 12;
+	dnsmsg_init(&msg, buf, 14);
+	CHECK("names", dnsmsg_name(&msg, 12, name, sizeof(name), NULL) == -1);
+	buf[12]= 1;
+	buf[13]= 'a';
+	buf[14]= 0xc0;
+	buf[15]= 16;
+	buf[16]= 0xc0;
+	buf[17]= 12;
+	dnsmsg_init(&msg, buf, 18);
+	CHECK("names", dnsmsg_name(&msg, 12, name, sizeof(name), NULL) == -1);
+
+	/* A pointer past the end, and the reserved label types */
+	buf[12]= 0xc0;
+	buf[13]= 100;
+	dnsmsg_init(&msg, buf, 14);
+	CHECK("names", dnsmsg_name(&msg, 12, name, sizeof(name), NULL) == -1);
+	buf[12]= 0x40;
+	CHECK("names", dnsmsg_name(&msg, 12, name, sizeof(name), NULL) == -1);
+	buf[12]= 0x80;
+	CHECK("names", dnsmsg_name(&msg, 12, name, sizeof(name), NULL) == -1);
+
+	/* 4 labels of 63 bytes make a name of 255, one more byte doesn't
+	 * fit, and neither does a small buffer
+	 */
+	for (i= 0; i<4; i++)
+	{
+		buf[12+i*64]= 63;
+		memset(buf+12+i*64+1, 'x', 63);
+	}
+	buf[12+4*64]= 0;
+	dnsmsg_init(&msg, buf, 12+4*64+1);
+	CHECK("names", dnsmsg_name(&msg, 12, name, sizeof(name), NULL) == -1);
+	buf[12+3*64]= 62;
+	buf[12+4*64-1]= 0;
+	dnsmsg_init(&msg, buf, 12+4*64);
+	CHECK("names", dnsmsg_name(&msg, 12, name, sizeof(name), NULL) == 254);
+	CHECK("names", dnsmsg_name(&msg, 12, name, 100, NULL) == -1);
+}
+
+/* The DNS messages in a response file. Anything that doesn't have a
+ * question, such as TCP or TLS streams, is skipped.
+ */
+static int load_messages(const char *file, u_char **msgs, size_t *lens,
+	int max)
+{
+	int n, type;
+	size_t size;
+	u_char *data;
+	FILE *f;
+	struct dnsmsg msg;
+	struct dnsrr rr;
+
+	f= fopen(file, "rb");
+	if (!f)
+		return 0;
+	n= 0;
+	while (n < max && fread(&type, sizeof(type), 1, f) == 1 &&
+		fread(&size, sizeof(size), 1, f) == 1)
+	{
+		data= malloc(size+1);
+		if (!data || fread(data, 1, size, f) != size)
+		{
+			free(data);
+			break;
+		}
+		if (type == RESP_PACKET &&
+			dnsmsg_init(&msg, data, size) == 0 &&
+			msg.qdcount == 1 && dnsmsg_question(&msg, &rr) == 0)
+		{
+			msgs[n]= data;
+			lens[n]= size;
+			n++;
+		}
+		else
+			free(data);
+	}
+	fclose(f);
+	return n;
+}
+
+/* Walk all records of a message and decompress their names */
+static int walk(const u_char *buf, size_t len)
+{
+	unsigned i, count;
+	int total;
+	char name[DNSMSG_NAMELEN];
+	struct dnsmsg msg;
+	struct dnsrr rr;
+
+	dnsmsg_init(&msg, buf, len);
+	if (dnsmsg_question(&msg, &rr) == -1)
+		return -1;
+	total= dnsmsg_name(&msg, rr.name_off, name, sizeof(name), NULL);
+	count= msg.ancount + msg.nscount + msg.arcount;
+	for (i= 0; i<count; i++)
+	{
+		if (dnsmsg_rr(&msg, &rr) == -1)
+			break;
+		total += dnsmsg_name(&msg, rr.name_off, name, sizeof(name),
+			NULL);
+	}
+	return total;
+}
+
+#define MAXMSGS	1024
+
+static void bench(char *files[])
+{
+	int i, n, nmsgs, rounds, sink;
+	size_t lens[MAXMSGS];
+	u_char *msgs[MAXMSGS];
+	double t;
+
+	nmsgs= 0;
+	for (i= 0; files[i]; i++)
+	{
+		nmsgs += load_messages(files[i], msgs+nmsgs, lens+nmsgs,
+			MAXMSGS-nmsgs);
+	}
+	if (!nmsgs)
+		return;
+
+	rounds= 10000;
+	sink= 0;
+	t= now();
+	for (n= 0; n<rounds; n++)
+	{
+		for (i= 0; i<nmsgs; i++)
+			sink += walk(msgs[i], lens[i]);
+	}
+	t= now()-t;
+	printf("%d messages, %.0f ns per message (%d)\n", nmsgs,
+		t/(rounds*nmsgs)*1e9, sink);
+	for (i= 0; i<nmsgs; i++)
+		free(msgs[i]);
+}
+
+int main(int argc, char *argv[])
+{
+	check_parse();
+	check_names();
+	if (errors)
+		return 1;
+	printf("ok\n");
+
+	if (argc > 2 && strcmp(argv[1], "-b") == 0)
+		bench(argv+2);
+	return 0;
+}
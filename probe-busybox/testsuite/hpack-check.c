@@ -0,0 +1,475 @@
+/*
+ * Copyright (c) 2026 RIPE NCC <atlas@ripe.net>
+ * Licensed under GPLv2 or later, see file LICENSE in this tarball for details.
+ *
+ * Checks the HPACK decoder in eperd/http2.c against the examples in
+ * RFC 7541 appendix C, and the Huffman decoder against huffman_encode.
+ * With -b it times decoding the header blocks.
+ */
+
+/* The decoder is static */
+#include "eperd/http2.c"
+
+#include <time.h>
+
+void crondlog(const char *fmt, ...)
+{
+	va_list ap;
+
+	va_start(ap, fmt);
+	vfprintf(stderr, fmt, ap);
+	va_end(ap);
+	fprintf(stderr, "\n");
+	exit(1);
+}
+
+struct block
+{
+	const char *name;
+	const char *hex;
+	const char *headers[16];	/* Name, value, ..., NULL */
+	size_t size;			/* Of the dynamic table after */
+	const char *table[16];		/* Newest first */
+};
+
+/* C.3, requests without Huffman coding */
+static struct block c3[]=
+{
+	{ "C.3.1",
+		"828684410f7777772e6578616d706c652e636f6d",
+		{ ":method", "GET", ":scheme", "http", ":path", "/",
+		  ":authority", "www.example.com", NULL },
+		57,
+		{ ":authority", "www.example.com", NULL } },
+	{ "C.3.2",
+		"828684be58086e6f2d6361636865",
+		{ ":method", "GET", ":scheme", "http", ":path", "/",
+		  ":authority", "www.example.com",
+		  "cache-control", "no-cache", NULL },
+		110,
+		{ "cache-control", "no-cache",
+		  ":authority", "www.example.com", NULL } },
+	{ "C.3.3",
+		"828785bf400a637573746f6d2d6b65790c637573746f6d2d76616c7565",
+		{ ":method", "GET", ":scheme", "https", ":path", "/index.html",
+		  ":authority", "www.example.com",
+		  "custom-key", "custom-value", NULL },
+		164,
+		{ "custom-key", "custom-value",
+		  "cache-control", "no-cache",
+		  ":authority", "www.example.com", NULL } },
+	{ NULL }
+};
+
+/* C.4, the same requests with Huffman coding */
+static struct block c4[]=
+{
+	{ "C.4.1",
+		"828684418cf1e3c2e5f23a6ba0ab90f4ff",
+		{ ":method", "GET", ":scheme", "http", ":path", "/",
+		  ":authority", "www.example.com", NULL },
+		57,
+		{ ":authority", "www.example.com", NULL } },
+	{ "C.4.2",
+		"828684be5886a8eb10649cbf",
+		{ ":method", "GET", ":scheme", "http", ":path", "/",
+		  ":authority", "www.example.com",
+		  "cache-control", "no-cache", NULL },
+		110,
+		{ "cache-control", "no-cache",
+		  ":authority", "www.example.com", NULL } },
+	{ "C.4.3",
+		"828785bf408825a849e95ba97d7f8925a849e95bb8e8b4bf",
+		{ ":method", "GET", ":scheme", "https", ":path", "/index.html",
+		  ":authority", "www.example.com",
+		  "custom-key", "custom-value", NULL },
+		164,
+		{ "custom-key", "custom-value",
+		  "cache-control", "no-cache",
+		  ":authority", "www.example.com", NULL } },
+	{ NULL }
+};
+
+/* C.5, responses without Huffman coding and a table of 256 octets. The
+ * first block starts with the size update that the example leaves to
+ * SETTINGS, the others add size updates that evict entries.
+ */
+static struct block c5[]=
+{
+	{ "C.5.1",
+		"3fe101"
+		"4803333032580770726976617465611d4d6f6e2c203231204f6374"
+		"20323031332032303a31333a323120474d546e1768747470733a2f"
+		"2f7777772e6578616d706c652e636f6d",
+		{ ":status", "302", "cache-control", "private",
+		  "date", "Mon, 21 Oct 2013 20:13:21 GMT",
+		  "location", "https://www.example.com", NULL },
+		222,
+		{ "location", "https://www.example.com",
+		  "date", "Mon, 21 Oct 2013 20:13:21 GMT",
+		  "cache-control", "private",
+		  ":status", "302", NULL } },
+	{ "C.5.2",
+		"4803333037c1c0bf",
+		{ ":status", "307", "cache-control", "private",
+		  "date", "Mon, 21 Oct 2013 20:13:21 GMT",
+		  "location", "https://www.example.com", NULL },
+		222,
+		{ ":status", "307",
+		  "location", "https://www.example.com",
+		  "date", "Mon, 21 Oct 2013 20:13:21 GMT",
+		  "cache-control", "private", NULL } },
+	{ "C.5.3",
+		"88c1611d4d6f6e2c203231204f637420323031332032303a31333a"
+		"323220474d54c05a04677a69707738666f6f3d4153444a4b48514b"
+		"425a584f5157454f50495541585157454f49553b206d61782d6167"
+		"653d333630303b2076657273696f6e3d31",
+		{ ":status", "200", "cache-control", "private",
+		  "date", "Mon, 21 Oct 2013 20:13:22 GMT",
+		  "location", "https://www.example.com",
+		  "content-encoding", "gzip",
+		  "set-cookie",
+		  "foo=ASDJKHQKBZXOQWEOPIUAXQWEOIU; max-age=3600; version=1",
+		  NULL },
+		215,
+		{ "set-cookie",
+		  "foo=ASDJKHQKBZXOQWEOPIUAXQWEOIU; max-age=3600; version=1",
+		  "content-encoding", "gzip",
+		  "date", "Mon, 21 Oct 2013 20:13:22 GMT", NULL } },
+	{ "shrink to 100",
+		"3f45" "be",
+		{ "set-cookie",
+		  "foo=ASDJKHQKBZXOQWEOPIUAXQWEOIU; max-age=3600; version=1",
+		  NULL },
+		98,
+		{ "set-cookie",
+		  "foo=ASDJKHQKBZXOQWEOPIUAXQWEOIU; max-age=3600; version=1",
+		  NULL } },
+	{ "shrink to 0, grow to 4096",
+		"20" "3fe11f" "4003666f6f03626172",
+		{ "foo", "bar", NULL },
+		38,
+		{ "foo", "bar", NULL } },
+	{ NULL }
+};
+
+/* Blocks that have to fail */
+static struct block bad[]=
+{
+	{ "size update above 4096", "3fe21f" },
+	{ "size update after a field", "8220" },
+	{ "index past the table", "c0" },
+	{ "index 0", "80" },
+	{ NULL }
+};
+
+static int errors;
+
+static size_t unhex(const char *hex, uint8_t *buf)
+{
+	size_t n;
+	unsigned v;
+
+	for (n= 0; hex[0] && hex[1]; hex += 2, n++)
+	{
+		sscanf(hex, "%2x", &v);
+		buf[n]= v;
+	}
+	return n;
+}
+
+/* Decodes a block, the decoder reports the fields on stderr */
+static int decode(struct http2_env *env, const char *hex, char **textp)
+{
+	int r;
+	size_t o, len, textlen, dlen;
+	FILE *saved;
+	uint8_t buf[512];
+
+	len= unhex(hex, buf);
+
+	saved= stderr;
+	stderr= open_memstream(textp, &textlen);
+	env->http2_dyn_update_ok= true;
+	r= 0;
+	for (o= 0; o<len; o += dlen)
+	{
+		dlen= Xdecode_header2(env, NULL, buf+o, len-o, 1);
+		if (dlen == 0)
+		{
+			r= -1;
+			break;
+		}
+	}
+	fclose(stderr);
+	stderr= saved;
+	return r;
+}
+
+static void check_block(struct http2_env *env, struct block *b)
+{
+	int i, n;
+	size_t klen, vlen;
+	char *text;
+	const char *kp, *vp;
+	char want[2048];
+
+	if (decode(env, b->hex, &text) == -1)
+	{
+		printf("%s: decode failed\n", b->name);
+		errors++;
+		free(text);
+		return;
+	}
+
+	n= 0;
+	for (i= 0; b->headers[i]; i += 2)
+	{
+		n += snprintf(want+n, sizeof(want)-n, "'%s': '%s'\n",
+			b->headers[i], b->headers[i+1]);
+		if (strcmp(b->headers[i], ":status") == 0)
+		{
+			n += snprintf(want+n, sizeof(want)-n, "HTTP/2 %s\n",
+				b->headers[i+1]);
+		}
+	}
+	if (strcmp(text, want) != 0)
+	{
+		printf("%s: got\n%swant\n%s", b->name, text, want);
+		errors++;
+	}
+	free(text);
+
+	if (env->http2_dyn_size != b->size)
+	{
+		printf("%s: table size %zu, want %zu\n", b->name,
+			env->http2_dyn_size, b->size);
+		errors++;
+	}
+	for (i= 0; b->table[i]; i += 2)
+	{
+		if (i/2 >= env->http2_dyn_count)
+		{
+			printf("%s: entry %d missing\n", b->name, i/2+1);
+			errors++;
+			return;
+		}
+		Xget_dyn(env, HPACK_STATIC_NR+1+i/2, &kp, &klen, &vp, &vlen);
+		if (klen != strlen(b->table[i]) ||
+			memcmp(kp, b->table[i], klen) != 0 ||
+			vlen != strlen(b->table[i+1]) ||
+			memcmp(vp, b->table[i+1], vlen) != 0)
+		{
+			printf("%s: entry %d is '%.*s: %.*s'\n", b->name,
+				i/2+1, (int)klen, kp, (int)vlen, vp);
+			errors++;
+		}
+	}
+	if (i/2 != env->http2_dyn_count)
+	{
+		printf("%s: %u entries, want %d\n", b->name,
+			env->http2_dyn_count, i/2);
+		errors++;
+	}
+}
+
+static void check_blocks(struct block *blocks)
+{
+	struct http2_env *env;
+
+	env= http2_init();
+	for (; blocks->name; blocks++)
+		check_block(env, blocks);
+	http2_free(env);
+}
+
+static void check_bad(void)
+{
+	char *text;
+	struct block *b;
+	struct http2_env *env;
+
+	for (b= bad; b->name; b++)
+	{
+		env= http2_init();
+		if (decode(env, b->hex, &text) != -1)
+		{
+			printf("%s: not rejected\n", b->name);
+			errors++;
+		}
+		free(text);
+		http2_free(env);
+	}
+}
+
+static uint32_t rnd_state= 42;
+
+static uint32_t rnd(void)
+{
+	/* xorshift32, the same sequence on every run */
+	rnd_state ^= rnd_state << 13;
+	rnd_state ^= rnd_state >> 17;
+	rnd_state ^= rnd_state << 5;
+	return rnd_state;
+}
+
+/* Pads with ones, as RFC 7541 requires */
+static size_t encode(const uint8_t *str, size_t len, uint8_t *out)
+{
+	int bits;
+	size_t i, o;
+	uint64_t acc;
+	struct huffman_encode *ent;
+
+	acc= 0;
+	bits= 0;
+	o= 0;
+	for (i= 0; i<len; i++)
+	{
+		ent= &huffman_encode[str[i]];
+		acc= (acc << ent->bits) | ent->encoding;
+		bits += ent->bits;
+		for (; bits >= 8; bits -= 8)
+			out[o++]= acc >> (bits-8);
+	}
+	if (bits)
+		out[o++]= (acc << (8-bits)) | ((1 << (8-bits))-1);
+	return o;
+}
+
+static void check_huffman(void)
+{
+	int i, n;
+	size_t len, enclen, declen;
+	FILE *saved;
+	uint8_t str[256], enc[1024];
+	char dec[256];
+	struct http2_env *env;
+
+	env= http2_init();
+
+	/* Every symbol on its own, then random strings that mix the fast
+	 * table and long codes.
+	 */
+	for (n= 0; n<256+10000; n++)
+	{
+		if (n < 256)
+		{
+			str[0]= n;
+			len= 1;
+		}
+		else
+		{
+			len= rnd() % sizeof(str);
+			for (i= 0; i<len; i++)
+			{
+				str[i]= (rnd() % 4) ? "abcdefghijklmnop"
+					"qrstuvwxyz0123456789-./:= "[rnd() % 42] :
+					rnd();
+			}
+		}
+		enclen= encode(str, len, enc);
+		declen= Xdecode_huffman2(env, enc, enclen, dec, sizeof(dec));
+		if (declen != len || memcmp(dec, str, len) != 0)
+		{
+			printf("huffman: string %d of %zu octets: got %zu\n",
+				n, len, declen);
+			errors++;
+		}
+	}
+
+	/* Padding that is too long or not all ones, and EOS in the string */
+	saved= stderr;
+	stderr= fopen("/dev/null", "w");
+	str[0]= 'a';
+	enclen= encode(str, 1, enc);
+	enc[enclen++]= 0xff;
+	if (Xdecode_huffman2(env, enc, enclen, dec, sizeof(dec)) != 0)
+	{
+		printf("huffman: 8 bits of padding not rejected\n");
+		errors++;
+	}
+	enclen= encode(str, 1, enc);
+	enc[0] &= ~1;
+	if (Xdecode_huffman2(env, enc, enclen, dec, sizeof(dec)) != 0)
+	{
+		printf("huffman: padding with a zero not rejected\n");
+		errors++;
+	}
+	memset(enc, 0xff, 4);
+	if (Xdecode_huffman2(env, enc, 4, dec, sizeof(dec)) != 0)
+	{
+		printf("huffman: EOS not rejected\n");
+		errors++;
+	}
+	fclose(stderr);
+	stderr= saved;
+
+	http2_free(env);
+}
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec/1e9;
+}
+
+/* Decode the C.5 responses over and over, the fields go to /dev/null */
+static void bench(void)
+{
+	int i, n, rounds;
+	size_t o, len[3], dlen, total;
+	double t;
+	FILE *saved;
+	uint8_t buf[3][512];
+	struct http2_env *env;
+
+	for (i= 0; i<3; i++)
+		len[i]= unhex(c5[i].hex, buf[i]);
+
+	saved= stderr;
+	stderr= fopen("/dev/null", "w");
+	env= http2_init();
+	rounds= 200000;
+	total= 0;
+	t= now();
+	for (n= 0; n<rounds; n++)
+	{
+		for (i= 0; i<3; i++)
+		{
+			env->http2_dyn_update_ok= true;
+			for (o= 0; o<len[i]; o += dlen)
+			{
+				dlen= Xdecode_header2(env, NULL, buf[i]+o,
+					len[i]-o, 0);
+				if (dlen == 0)
+					exit(1);
+			}
+			total += len[i];
+		}
+	}
+	t= now()-t;
+	fclose(stderr);
+	stderr= saved;
+	http2_free(env);
+	printf("%.1f ns per block, %.1f MB/s\n", t/(rounds*3)*1e9,
+		total/t/1e6);
+}
+
+int main(int argc, char *argv[])
+{
+	check_blocks(c3);
+	check_blocks(c4);
+	check_blocks(c5);
+	check_huffman();
+	check_bad();
+	if (errors)
+		return 1;
+	printf("ok\n");
+
+	if (argc > 1 && strcmp(argv[1], "-b") == 0)
+		bench();
+	return 0;
+}
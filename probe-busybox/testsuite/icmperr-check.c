@@ -0,0 +1,276 @@
+/*
+ * Copyright (c) 2026 RIPE NCC <atlas@ripe.net>
+ * Licensed under GPLv2 or later, see file LICENSE in this tarball for details.
+ *
+ * Checks eperd/icmperr.c on packets with a known layout. With -b <file>...
+ * it times the decoder over the ICMP packets in evtraceroute response
+ * files.
+ */
+
+#include "libbb.h"
+#include <time.h>
+#include <netinet/ip.h>
+#include <netinet/ip_icmp.h>
+#include <netinet/ip6.h>
+#include <netinet/icmp6.h>
+
+#include "eperd/icmperr.h"
+
+#define RESP_PACKET	1	/* As in traceroute.c */
+
+static int errors;
+
+#define CHECK(name, cond) \
+	do { if (!(cond)) { printf("%s: %s failed\n", name, #cond); \
+		errors++; } } while (0)
+
+static size_t ip4(u_char *p, int hl, int proto, size_t len)
+{
+	memset(p, '\0', hl*4);
+	p[0]= 0x40 | hl;
+	p[2]= len >> 8;
+	p[3]= len;
+	p[8]= 64;
+	p[9]= proto;
+	return hl*4;
+}
+
+static size_t ip6(u_char *p, int nxt)
+{
+	memset(p, '\0', sizeof(struct ip6_hdr));
+	p[0]= 0x60;
+	p[6]= nxt;
+	p[7]= 64;
+	return sizeof(struct ip6_hdr);
+}
+
+/* Extension header of 8*(1+len8) bytes */
+static size_t ext6(u_char *p, int nxt, int len8)
+{
+	memset(p, '\0', 8*(1+len8));
+	p[0]= nxt;
+	p[1]= len8;
+	return 8*(1+len8);
+}
+
+static void check4(void)
+{
+	u_char p[512];
+	size_t o, inner;
+	struct icmperr ie;
+
+	/* Time exceeded quoting UDP */
+	o= ip4(p, 5, IPPROTO_ICMP, 0);
+	memset(p+o, '\0', 8);
+	p[o]= ICMP_TIME_EXCEEDED;
+	inner= o+8;
+	o= inner + ip4(p+inner, 5, IPPROTO_UDP, 0);
+	o += 8;
+	CHECK("v4 udp", icmperr_decode4(p, o, &ie) == 0);
+	CHECK("v4 udp", ie.type == ICMP_TIME_EXCEEDED && ie.code == 0);
+	CHECK("v4 udp", ie.icmp == p+20 && ie.icmp_len == o-20);
+	CHECK("v4 udp", ie.inner == p+inner);
+	CHECK("v4 udp", ie.proto == IPPROTO_UDP);
+	CHECK("v4 udp", ie.l4 == p+inner+20 && ie.l4_len == 8);
+	CHECK("v4 udp", ie.ext == NULL);
+
+	/* Quoted header with options */
+	o= inner + ip4(p+inner, 6, IPPROTO_ICMP, 0);
+	o += 8;
+	CHECK("v4 options", icmperr_decode4(p, o, &ie) == 0);
+	CHECK("v4 options", ie.l4 == p+inner+24 && ie.l4_len == 8);
+
+	/* Header cut short */
+	CHECK("v4 short", icmperr_decode4(p, inner+19, &ie) == -1);
+	CHECK("v4 short", icmperr_decode4(p, 20+7, &ie) == -1);
+
+	/* RFC 4884 length of 32 words, then a 12 byte extension */
+	o= inner + ip4(p+inner, 5, IPPROTO_UDP, 0);
+	memset(p+o, '\0', 128+12-20);
+	p[20+5]= 32;
+	o= inner+128+12;
+	CHECK("v4 rfc4884", icmperr_decode4(p, o, &ie) == 0);
+	CHECK("v4 rfc4884", ie.ext == p+inner+128 && ie.ext_len == 12);
+	CHECK("v4 rfc4884", !ie.ext_pre4884);
+
+	/* The same without the length is an older router */
+	p[20+5]= 0;
+	CHECK("v4 pre4884", icmperr_decode4(p, o, &ie) == 0);
+	CHECK("v4 pre4884", ie.ext == p+inner+128 && ie.ext_len == 12);
+	CHECK("v4 pre4884", ie.ext_pre4884);
+
+	/* Echo reply has no quoted packet */
+	p[20]= ICMP_ECHOREPLY;
+	CHECK("v4 echo", icmperr_decode4(p, 20+8+32, &ie) == 0);
+	CHECK("v4 echo", ie.type == ICMP_ECHOREPLY && ie.inner == NULL);
+}
+
+static void check6(void)
+{
+	u_char p[512];
+	size_t o, inner, l4;
+	struct icmperr ie;
+
+	/* Time exceeded quoting UDP after hop-by-hop and destination
+	 * options
+	 */
+	memset(p, '\0', 8);
+	p[0]= ICMP6_TIME_EXCEEDED;
+	inner= 8;
+	o= inner + ip6(p+inner, IPPROTO_HOPOPTS);
+	o += ext6(p+o, IPPROTO_DSTOPTS, 0);
+	o += ext6(p+o, IPPROTO_UDP, 2);
+	l4= o;
+	o += 8;
+	CHECK("v6 options", icmperr_decode6(p, o, &ie) == 0);
+	CHECK("v6 options", ie.type == ICMP6_TIME_EXCEEDED);
+	CHECK("v6 options", ie.inner == p+inner);
+	CHECK("v6 options", ie.hbhoptsize == 0 && ie.dstoptsize == 16);
+	CHECK("v6 options", ie.proto == IPPROTO_UDP);
+	CHECK("v6 options", ie.l4 == p+l4 && ie.l4_len == 8);
+	CHECK("v6 options", !ie.frag_later && ie.ext == NULL);
+
+	/* Options cut short */
+	CHECK("v6 short", icmperr_decode6(p, l4-1, &ie) == -1);
+	CHECK("v6 short", icmperr_decode6(p, inner+39, &ie) == -1);
+
+	/* A non-first fragment has no transport header */
+	o= inner + ip6(p+inner, IPPROTO_FRAGMENT);
+	memset(p+o, '\0', 8);
+	p[o]= IPPROTO_DSTOPTS;
+	p[o+3]= 8 << 3;		/* Offset 64 */
+	o += 8;
+	o += 16;
+	CHECK("v6 fragment", icmperr_decode6(p, o, &ie) == 0);
+	CHECK("v6 fragment", ie.frag_later && ie.l4 == NULL);
+	CHECK("v6 fragment", ie.proto == IPPROTO_DSTOPTS);
+
+	/* RFC 4884 length of 16 words, then a 12 byte extension */
+	o= inner + ip6(p+inner, IPPROTO_UDP);
+	memset(p+o, '\0', 128+12-40);
+	p[4]= 16;
+	o= inner+128+12;
+	CHECK("v6 rfc4884", icmperr_decode6(p, o, &ie) == 0);
+	CHECK("v6 rfc4884", ie.ext == p+inner+128 && ie.ext_len == 12);
+	CHECK("v6 rfc4884", !ie.ext_pre4884);
+
+	/* Packet too big has the MTU where the length would be */
+	p[0]= ICMP6_PACKET_TOO_BIG;
+	p[4]= 0x01;
+	p[5]= 0x00;
+	p[6]= 0x05;
+	p[7]= 0x00;
+	CHECK("v6 too big", icmperr_decode6(p, inner+40+8, &ie) == 0);
+	CHECK("v6 too big", ie.ext == NULL);
+
+	/* Echo reply has no quoted packet */
+	memset(p, '\0', 8);
+	p[0]= ICMP6_ECHO_REPLY;
+	CHECK("v6 echo", icmperr_decode6(p, 8+32, &ie) == 0);
+	CHECK("v6 echo", ie.type == ICMP6_ECHO_REPLY && ie.inner == NULL);
+}
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec/1e9;
+}
+
+/* Time the decoder over the ICMP packets in response files. IPv4 packets
+ * start with the IP header, IPv6 ones with the ICMPv6 header.
+ */
+static void bench(char *files[])
+{
+	enum { MAXPKTS= 4096 };
+	int i, n, npkts, type, rounds;
+	size_t size, total;
+	unsigned sink;
+	double t;
+	FILE *f;
+	u_char *data;
+	struct icmperr ie;
+	static u_char *pkts[MAXPKTS];
+	static size_t lens[MAXPKTS];
+	static int v4[MAXPKTS];
+
+	npkts= 0;
+	for (; *files; files++)
+	{
+		f= fopen(*files, "r");
+		if (!f)
+		{
+			perror(*files);
+			exit(1);
+		}
+		while (fread(&type, sizeof(type), 1, f) == 1 &&
+			fread(&size, sizeof(size), 1, f) == 1)
+		{
+			data= malloc(size ? size : 1);
+			if (!data || fread(data, 1, size, f) != size)
+				break;
+			if (type != RESP_PACKET || npkts >= MAXPKTS)
+			{
+				free(data);
+				continue;
+			}
+			if (size >= 20 && (data[0] >> 4) == 4 &&
+				data[9] == IPPROTO_ICMP)
+			{
+				v4[npkts]= 1;
+			}
+			else if (size >= 8 && ((data[0] >= ICMP6_DST_UNREACH &&
+				data[0] <= ICMP6_PARAM_PROB) ||
+				data[0] == ICMP6_ECHO_REPLY))
+			{
+				v4[npkts]= 0;
+			}
+			else
+			{
+				free(data);
+				continue;
+			}
+			pkts[npkts]= data;
+			lens[npkts]= size;
+			npkts++;
+		}
+		fclose(f);
+	}
+	if (!npkts)
+		return;
+
+	rounds= 20000;
+	sink= 0;
+	total= 0;
+	t= now();
+	for (n= 0; n<rounds; n++)
+	{
+		for (i= 0; i<npkts; i++)
+		{
+			if (v4[i])
+				icmperr_decode4(pkts[i], lens[i], &ie);
+			else
+				icmperr_decode6(pkts[i], lens[i], &ie);
+			sink += ie.proto;
+		}
+		total += npkts;
+	}
+	t= now()-t;
+	printf("%d packets, %.1f ns per packet\n", npkts, t/total*1e9);
+	if (sink == 1)
+		printf("\n");	/* Keep the loop */
+}
+
+int main(int argc, char *argv[])
+{
+	check4();
+	check6();
+	if (errors)
+		return 1;
+	printf("ok\n");
+
+	if (argc > 2 && strcmp(argv[1], "-b") == 0)
+		bench(argv+2);
+	return 0;
+}
@@ -0,0 +1,412 @@
+/*
+ * Copyright (c) 2026 RIPE NCC <atlas@ripe.net>
+ * Licensed under GPLv2 or later, see file LICENSE in this tarball for details.
+ *
+ * Checks the ClientHello template of eperd/sslgetcert.c, parses the
+ * server flight of an evsslgetcert response file with eat_server_hello
+ * and eat_certificate, and checks the bound of eperd/certcache.c. With
+ * -b <file>... it times writing the hello and parsing the flights.
+ */
+
+/* The parser is static */
+#include "eperd/sslgetcert.c"
+
+#include <time.h>
+
+#define OUTFILE	"sslgetcert-check.out"
+
+struct globals G;
+
+/* errno in the included code. Set at run time, as in appletlib.c, the
+ * compiler would still see the null pointer.
+ */
+static int check_errno;
+int *const bb_errno= &check_errno;
+
+static int errors;
+static struct bufferevent *nodata;	/* Where more input would come from */
+
+#define CHECK(name, cond) \
+	do { if (!(cond)) { printf("%s: %s failed\n", name, #cond); \
+		errors++; } } while (0)
+
+void crondlog(const char *fmt, ...)
+{
+	va_list ap;
+
+	va_start(ap, fmt);
+	vfprintf(stderr, fmt, ap);
+	va_end(ap);
+	fprintf(stderr, "\n");
+	exit(1);
+}
+
+void* FAST_FUNC xzalloc(size_t size)
+{
+	void *p;
+
+	p= calloc(1, size);
+	if (!p)
+		crondlog("out of memory");
+	return p;
+}
+
+void* FAST_FUNC xrealloc(void *ptr, size_t size)
+{
+	ptr= realloc(ptr, size);
+	if (!ptr)
+		crondlog("out of memory");
+	return ptr;
+}
+
+int gettime_mono(struct timespec *tsp)
+{
+	return clock_gettime(CLOCK_MONOTONIC, tsp);
+}
+
+time_t atlas_time(void)
+{
+	return 0;
+}
+
+int get_timesync(void)
+{
+	return 0;
+}
+
+char *atlas_get_version_json_str(void)
+{
+	return "";
+}
+
+int validate_atlas_id(const char *atlas_id)
+{
+	return 1;
+}
+
+char *rebased_validated_filename(const char *base, const char *path,
+	const char *prefix)
+{
+	return NULL;
+}
+
+/* Only reached through the applet */
+void read_response_file(FILE *file, int type, size_t *sizep, void *data)
+{
+	crondlog("read_response_file called");
+}
+
+void write_response(FILE *file, int type, size_t size, void *data)
+{
+	crondlog("write_response called");
+}
+
+void tu_connect_to_name(struct tu_env *env, char *host,
+	unsigned flags, char *port,
+	struct timeval *interval,
+	struct evutil_addrinfo *hints,
+	char *infname,
+	const char *server_name,
+	const char *cert_name,
+	void (*timeout_callback)(int unused, const short event, void *s),
+	void (*reporterr)(struct tu_env *env, enum tu_err cause,
+		const char *err),
+	void (*reportcount)(struct tu_env *env, int count),
+	void (*beforeconnect)(struct tu_env *env,
+		struct sockaddr *addr, socklen_t addrlen),
+	void (*connected)(struct tu_env *env, struct bufferevent *bev),
+	void (*readcb)(struct bufferevent *bev, void *ptr),
+	void (*writecb)(struct bufferevent *bev, void *ptr))
+{
+	crondlog("tu_connect_to_name called");
+}
+
+void tu_restart_connect(struct tu_env *env)
+{
+	crondlog("tu_restart_connect called");
+}
+
+void tu_fake_ttr(void *ctx, char *host)
+{
+}
+
+void tu_cleanup(struct tu_env *env)
+{
+}
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec/1e9;
+}
+
+/* The packets of a response file, one after the other */
+static u_char *load_flight(const char *file, size_t *lenp)
+{
+	int type;
+	size_t size, len;
+	u_char *data;
+	FILE *f;
+
+	f= fopen(file, "rb");
+	if (!f)
+		crondlog("unable to open %s", file);
+	data= NULL;
+	len= 0;
+	while (fread(&type, sizeof(type), 1, f) == 1 &&
+		fread(&size, sizeof(size), 1, f) == 1)
+	{
+		data= xrealloc(data, len+size+1);
+		if (fread(data+len, 1, size, f) != size)
+			break;
+		if (type == RESP_PACKET)
+			len += size;
+	}
+	fclose(f);
+	*lenp= len;
+	return data;
+}
+
+static void init_state(struct state *state)
+{
+	memset(state, '\0', sizeof(*state));
+	state->major_version= 3;
+	state->minor_version= 3;
+	state->hostname= "atlas.ripe.net";
+	state->portname= "443";
+	state->sni= "atlas.ripe.net";
+	state->tu_env.host_is_literal= 1;
+	state->output_file= OUTFILE;
+}
+
+static int parse(struct state *state, const u_char *flight, size_t len)
+{
+	int r;
+
+	buf_init(&state->inbuf, nodata);
+	buf_add(&state->inbuf, flight, len);
+	msgbuf_init(&state->msginbuf, &state->inbuf, NULL);
+	r= eat_server_hello(state);
+	if (r == 0)
+		r= eat_certificate(state);
+	msgbuf_cleanup(&state->msginbuf);
+	buf_cleanup(&state->inbuf);
+	return r;
+}
+
+static void check_hello(void)
+{
+	size_t len;
+	u_char *p, first[HELLO_RANDOM_LEN];
+	struct state state;
+	struct bufferevent *bev1, *bev2;
+	struct evbuffer *out1, *out2;
+
+	init_state(&state);
+	build_hello(&state);
+	p= state.hello;
+	len= state.hello_len;
+
+	/* One handshake record with one ClientHello */
+	CHECK("hello", len > HELLO_RANDOM+HELLO_RANDOM_LEN);
+	CHECK("hello", p[0] == MSG_HANDSHAKE && p[1] == 3 && p[2] == 0);
+	CHECK("hello", ((p[3] << 8) | p[4]) == len-5);
+	CHECK("hello", p[5] == HS_CLIENT_HELLO);
+	CHECK("hello", ((p[6] << 16) | (p[7] << 8) | p[8]) == len-9);
+	CHECK("hello", p[9] == 3 && p[10] == 3);
+	CHECK("hello", memmem(p, len, state.sni, strlen(state.sni)) != NULL);
+
+	/* Each connection gets its own random. A hello that is still
+	 * queued keeps the random it was sent with.
+	 */
+	bev1= bufferevent_socket_new(EventBase, -1, 0);
+	bev2= bufferevent_socket_new(EventBase, -1, 0);
+	out1= bufferevent_get_output(bev1);
+	out2= bufferevent_get_output(bev2);
+
+	state.writestate= WRITE_HELLO;
+	writecb(bev1, &state.tu_env);
+	CHECK("hello", evbuffer_get_length(out1) == len);
+	memcpy(first, evbuffer_pullup(out1, -1)+HELLO_RANDOM, sizeof(first));
+
+	state.writestate= WRITE_HELLO;
+	writecb(bev2, &state.tu_env);
+	CHECK("hello", evbuffer_get_length(out2) == len);
+	CHECK("hello", memcmp(evbuffer_pullup(out1, -1)+HELLO_RANDOM,
+		first, sizeof(first)) == 0);
+	CHECK("hello", memcmp(evbuffer_pullup(out2, -1)+HELLO_RANDOM,
+		first, sizeof(first)) != 0);
+	CHECK("hello", memcmp(evbuffer_pullup(out1, -1)+HELLO_RANDOM+
+		HELLO_RANDOM_LEN, evbuffer_pullup(out2, -1)+HELLO_RANDOM+
+		HELLO_RANDOM_LEN, len-HELLO_RANDOM-HELLO_RANDOM_LEN) == 0);
+
+	bufferevent_free(bev1);
+	bufferevent_free(bev2);
+	free(state.hello);
+}
+
+/* Report a chain in full, then by fingerprint with cert_ref. Another
+ * instance reports it in full again.
+ */
+static void check_parse(const char *file)
+{
+	int n;
+	size_t len, linemax;
+	u_char *flight;
+	char *line;
+	FILE *f;
+	struct state state, other;
+
+	flight= load_flight(file, &len);
+	unlink(OUTFILE);
+
+	init_state(&state);
+	state.cert_ref= 1;
+	CHECK("parse", parse(&state, flight, len) == 0);
+	CHECK("parse", state.recv_major == 3 && state.server_cipher != 0);
+	CHECK("parse", state.chain_reported);
+	CHECK("parse", parse(&state, flight, len) == 0);
+	init_state(&other);
+	other.cert_ref= 1;
+	CHECK("parse", parse(&other, flight, len) == 0);
+
+	/* Half a flight waits for more */
+	init_state(&state);
+	CHECK("parse", parse(&state, flight, len/2) == -1 && errno == EAGAIN);
+
+	f= fopen(OUTFILE, "r");
+	line= NULL;
+	linemax= 0;
+	for (n= 0; f && getline(&line, &linemax, f) != -1; n++)
+	{
+		if (n == 1)
+		{
+			CHECK("parse", strstr(line, DBQ(cert_fp) ":[ \"") !=
+				NULL);
+		}
+		else
+		{
+			CHECK("parse", strstr(line,
+				DBQ(cert) ":[ \"-----BEGIN CERTIFICATE") != NULL);
+		}
+	}
+	free(line);
+	CHECK("parse", n == 3);
+	if (f)
+		fclose(f);
+	unlink(OUTFILE);
+	free(flight);
+}
+
+static void check_certcache(void)
+{
+	int i;
+	unsigned char fp[CERTCACHE_FP_LEN];
+	struct certcache cc;
+	struct certcache_ent *ent;
+
+	memset(&cc, '\0', sizeof(cc));
+	for (i= 0; i<CERTCACHE_MAX+10; i++)
+	{
+		certcache_fp(&i, sizeof(i), fp);
+		ent= certcache_lookup(&cc, fp, 1);
+		ent->tag= i % 2;
+		CHECK("certcache", cc.count <= CERTCACHE_MAX);
+	}
+	CHECK("certcache", cc.count == CERTCACHE_MAX);
+	CHECK("certcache", certcache_lookup(&cc, fp, 0) == ent);
+
+	certcache_expire(&cc, 1);
+	CHECK("certcache", cc.count > 0 && cc.count < CERTCACHE_MAX);
+	CHECK("certcache", certcache_lookup(&cc, fp, 0) == ent);
+	certcache_clear(&cc);
+	CHECK("certcache", cc.count == 0);
+	CHECK("certcache", certcache_lookup(&cc, fp, 0) == NULL);
+}
+
+static void bench(char *files[])
+{
+	int i, n, nfiles, rounds;
+	size_t lens[16];
+	u_char *flights[16];
+	double t;
+	struct state state;
+	struct bufferevent *bev;
+	struct evbuffer *out;
+
+	init_state(&state);
+	build_hello(&state);
+	bev= bufferevent_socket_new(EventBase, -1, 0);
+	out= bufferevent_get_output(bev);
+
+	rounds= 100000;
+	t= now();
+	for (n= 0; n<rounds; n++)
+	{
+		state.writestate= WRITE_HELLO;
+		writecb(bev, &state.tu_env);
+		evbuffer_drain(out, evbuffer_get_length(out));
+	}
+	t= now()-t;
+	printf("hello: %.0f ns\n", t/rounds*1e9);
+	bufferevent_free(bev);
+	free(state.hello);
+
+	/* Files without a chain, for example with an alert, are skipped */
+	nfiles= 0;
+	for (i= 0; files[i] && nfiles < 16; i++)
+	{
+		flights[nfiles]= load_flight(files[i], &lens[nfiles]);
+		init_state(&state);
+		if (parse(&state, flights[nfiles], lens[nfiles]) == 0)
+			nfiles++;
+		else
+			free(flights[nfiles]);
+	}
+	if (!nfiles)
+		return;
+
+	/* Output goes to the file, truncated each round */
+	rounds= 20000;
+	t= now();
+	for (n= 0; n<rounds; n++)
+	{
+		for (i= 0; i<nfiles; i++)
+		{
+			init_state(&state);
+			parse(&state, flights[i], lens[i]);
+		}
+		if (n % 1000 == 999)
+			(void) truncate(OUTFILE, 0);
+	}
+	t= now()-t;
+	printf("%d flights, %.0f ns per flight\n", nfiles,
+		t/(rounds*nfiles)*1e9);
+	unlink(OUTFILE);
+	for (i= 0; i<nfiles; i++)
+		free(flights[i]);
+}
+
+int main(int argc, char *argv[])
+{
+	EventBase= event_base_new();
+	nodata= bufferevent_socket_new(EventBase, -1, 0);
+
+	if (argc < 2)
+	{
+		fprintf(stderr, "usage: sslgetcert-check [-b] <file>...\n");
+		return 1;
+	}
+	check_hello();
+	check_parse(argv[argc-1]);
+	check_certcache();
+	if (errors)
+		return 1;
+	printf("ok\n");
+
+	if (argc > 2 && strcmp(argv[1], "-b") == 0)
+		bench(argv+2);
+	return 0;
+}
@@ -64,6 +64,25 @@ optional()
 	done
 }
 
+# Build a check program from <name>.c in the testsuite directory and the
+# sources (relative to $bindir) it checks, with the flags of the busybox build.
+# Usage: build_check <name> <source>...
+
+build_check()
+{
+	local name="$1"
+	shift
+	local srcs=
+
+	for i in "$@"; do
+		srcs="$srcs $bindir/$i"
+	done
+	${HOSTCC:-gcc} -O2 -std=gnu99 -I"$bindir/include" -I"$bindir" \
+		-I"$bindir/libbb" -I"$bindir/libevent-2.1.11-stable/include" \
+		-include "$bindir/include/autoconf.h" -D_GNU_SOURCE \
+		-o "$name" "$name.c" $srcs
+}
+
 # The testing function
 
 testing()
@@ -0,0 +1,502 @@
+/*
+ * Copyright (c) 2026 RIPE NCC <atlas@ripe.net>
+ * Licensed under GPLv2 or later, see file LICENSE in this tarball for details.
+ *
+ * Checks the UDP socket pool of eperd/evtdig.c on loopback: which queries
+ * share a socket, retiring and sweeping sockets, and match_reply, which
+ * has to reject replies with another ID or question. With -b it times
+ * attaching and matching.
+ */
+
+/* As in the applet build, the replay code has an assert that doesn't
+ * compile
+ */
+#define NDEBUG 1
+
+/* The pool is static */
+#include "eperd/evtdig.c"
+
+#include <poll.h>
+
+struct globals G;
+
+/* errno in the included code, see sslgetcert-check.c */
+static int check_errno;
+int *const bb_errno= &check_errno;
+
+const char *ssl_version;
+
+static int errors;
+static time_t clock_sec;
+
+#define CHECK(name, cond) \
+	do { if (!(cond)) { printf("%s: %s failed\n", name, #cond); \
+		errors++; } } while (0)
+
+void crondlog(const char *fmt, ...)
+{
+	va_list ap;
+
+	/* Debug output from the pool */
+	if (strncmp(fmt, LVL7, strlen(LVL7)) == 0)
+		return;
+
+	va_start(ap, fmt);
+	vfprintf(stderr, fmt, ap);
+	va_end(ap);
+	fprintf(stderr, "\n");
+	exit(1);
+}
+
+void* FAST_FUNC xzalloc(size_t size)
+{
+	void *p;
+
+	p= calloc(1, size);
+	if (!p)
+		crondlog("out of memory");
+	return p;
+}
+
+time_t atlas_time(void)
+{
+	return clock_sec;
+}
+
+int gettime_mono(struct timespec *tsp)
+{
+	tsp->tv_sec= clock_sec;
+	tsp->tv_nsec= 0;
+	return 0;
+}
+
+/* No interface to bind to, the name only has to be part of the key */
+int bind_interface(int socket, int af, char *name)
+{
+	return 0;
+}
+
+/* Not reached from the pool */
+int atlas_check_addr(const struct sockaddr *sa, socklen_t len)
+{
+	crondlog("atlas_check_addr called");
+	return -1;
+}
+
+char *atlas_name_macro(char *str)
+{
+	crondlog("atlas_name_macro called");
+	return NULL;
+}
+
+char *atlas_get_version_json_str(void)
+{
+	return "";
+}
+
+int get_timesync(void)
+{
+	return 0;
+}
+
+int get_probe_id(void)
+{
+	return 0;
+}
+
+int validate_atlas_id(const char *atlas_id)
+{
+	return 1;
+}
+
+char *rebased_validated_filename(const char *base, const char *path,
+	const char *prefix)
+{
+	return NULL;
+}
+
+void get_local_resolvers(char *nslist[MAXNS], int *resolv_max, char *infname)
+{
+	crondlog("get_local_resolvers called");
+}
+
+void peek_response(int fd, int *typep)
+{
+	crondlog("peek_response called");
+}
+
+void peek_response_file(FILE *file, int *typep)
+{
+	crondlog("peek_response_file called");
+}
+
+void read_response(int fd, int type, size_t *sizep, void *data)
+{
+	crondlog("read_response called");
+}
+
+void read_response_file(FILE *file, int type, size_t *sizep, void *data)
+{
+	crondlog("read_response_file called");
+}
+
+void write_response(FILE *file, int type, size_t size, void *data)
+{
+	crondlog("write_response called");
+}
+
+struct evdns_base *evdns_base_new(struct event_base *event_base,
+	int initialize_nameservers)
+{
+	crondlog("evdns_base_new called");
+	return NULL;
+}
+
+struct evdns_getaddrinfo_request *evdns_getaddrinfo(
+	struct evdns_base *dns_base, const char *nodename,
+	const char *servname, const struct evutil_addrinfo *hints_in,
+	evdns_getaddrinfo_cb cb, void *arg)
+{
+	crondlog("evdns_getaddrinfo called");
+	return NULL;
+}
+
+void tu_connect_to_name(struct tu_env *env, char *host,
+	unsigned flags, char *port,
+	struct timeval *interval,
+	struct evutil_addrinfo *hints,
+	char *infname,
+	const char *server_name,
+	const char *cert_name,
+	void (*timeout_callback)(int unused, const short event, void *s),
+	void (*reporterr)(struct tu_env *env, enum tu_err cause,
+		const char *err),
+	void (*reportcount)(struct tu_env *env, int count),
+	void (*beforeconnect)(struct tu_env *env,
+		struct sockaddr *addr, socklen_t addrlen),
+	void (*connected)(struct tu_env *env, struct bufferevent *bev),
+	void (*readcb)(struct bufferevent *bev, void *ptr),
+	void (*writecb)(struct bufferevent *bev, void *ptr))
+{
+	crondlog("tu_connect_to_name called");
+}
+
+void tu_cleanup(struct tu_env *env)
+{
+}
+
+const char *tu_tfo_result(struct tu_env *env, struct bufferevent *bev)
+{
+	return NULL;
+}
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec/1e9;
+}
+
+static struct tdig_base *new_base(void)
+{
+	struct tdig_base *base;
+
+	base= xzalloc(sizeof(*base));
+	base->event_base= EventBase;
+	evtimer_assign(&base->udp_pool_timer, base->event_base,
+		udp_pool_sweep, base);
+	return base;
+}
+
+/* A server socket on loopback */
+static int new_server(struct sockaddr_in *sin)
+{
+	int fd;
+	socklen_t len;
+
+	fd= socket(AF_INET, SOCK_DGRAM, 0);
+	memset(sin, '\0', sizeof(*sin));
+	sin->sin_family= AF_INET;
+	sin->sin_addr.s_addr= htonl(INADDR_LOOPBACK);
+	len= sizeof(*sin);
+	if (fd == -1 || bind(fd, (struct sockaddr *)sin, len) == -1 ||
+		getsockname(fd, (struct sockaddr *)sin, &len) == -1)
+	{
+		crondlog("unable to create server socket: %s", strerror(errno));
+	}
+	return fd;
+}
+
+/* A query header followed by the question for 'name' */
+static int mk_query(u_char *packet, unsigned id, char *name, unsigned type)
+{
+	int len;
+	struct DNS_HEADER *dns;
+
+	memset(packet, '\0', sizeof(struct DNS_HEADER));
+	dns= (struct DNS_HEADER *)packet;
+	dns->id= htons(id);
+	dns->q_count= htons(1);
+	len= sizeof(struct DNS_HEADER);
+	len += ChangetoDnsNameFormat(packet+len, NS_MAXCDNAME, name);
+	packet[len++]= type >> 8;
+	packet[len++]= type;
+	packet[len++]= 0;
+	packet[len++]= C_IN;
+	return len;
+}
+
+static struct query_state *new_query(struct tdig_base *base,
+	struct sockaddr_in *server, unsigned id, char *name, unsigned type)
+{
+	int len;
+	u_char packet[MAX_DNS_BUF_SIZE];
+	struct query_state *qry;
+
+	qry= xzalloc(sizeof(*qry));
+	qry->base= base;
+	qry->res= xzalloc(sizeof(*qry->res));
+	qry->res->ai_family= AF_INET;
+	qry->res->ai_addr= xzalloc(sizeof(*server));
+	memcpy(qry->res->ai_addr, server, sizeof(*server));
+	qry->res->ai_addrlen= sizeof(*server);
+	qry->qryid= id;
+	len= mk_query(packet, id, name, type);
+	save_question(qry, packet, len);
+	return qry;
+}
+
+static void free_query(struct query_state *qry)
+{
+	if (qry->usock)
+		udp_pool_detach(qry);
+	free(qry->res->ai_addr);
+	free(qry->res);
+	free(qry);
+}
+
+static void check_match(void)
+{
+	int len;
+	u_char packet[MAX_DNS_BUF_SIZE];
+	struct sockaddr_in server;
+	struct tdig_base *base;
+	struct query_state *qry;
+	struct DNS_HEADER *dns;
+
+	base= new_base();
+	memset(&server, '\0', sizeof(server));
+	qry= new_query(base, &server, 4242, "www.ripe.net.", T_A);
+	CHECK("match", qry->qsect_len == 14+4);
+
+	len= mk_query(packet, 4242, "www.ripe.net.", T_A);
+	CHECK("match", match_reply(qry, packet, len));
+
+	/* Servers may change the case of the name */
+	len= mk_query(packet, 4242, "WwW.RiPe.NeT.", T_A);
+	CHECK("match", match_reply(qry, packet, len));
+
+	/* Another ID, name, type or class */
+	len= mk_query(packet, 4243, "www.ripe.net.", T_A);
+	CHECK("match", !match_reply(qry, packet, len));
+	len= mk_query(packet, 4242, "www.ripe.org.", T_A);
+	CHECK("match", !match_reply(qry, packet, len));
+	len= mk_query(packet, 4242, "ww.ripe.net.", T_A);
+	CHECK("match", !match_reply(qry, packet, len));
+	len= mk_query(packet, 4242, "www.ripe.net.", T_AAAA);
+	CHECK("match", !match_reply(qry, packet, len));
+	len= mk_query(packet, 4242, "www.ripe.net.", T_A);
+	packet[len-1]= C_CHAOS;
+	CHECK("match", !match_reply(qry, packet, len));
+
+	/* A question cut short */
+	len= mk_query(packet, 4242, "www.ripe.net.", T_A);
+	CHECK("match", !match_reply(qry, packet, len-1));
+
+	/* No question, for example FORMERR. Only the ID has to match */
+	dns= (struct DNS_HEADER *)packet;
+	dns->q_count= 0;
+	CHECK("match", match_reply(qry, packet, sizeof(*dns)));
+	dns->id= htons(4243);
+	CHECK("match", !match_reply(qry, packet, sizeof(*dns)));
+
+	free_query(qry);
+	free(base);
+}
+
+static void check_attach(void)
+{
+	int i, fd1, fd2;
+	struct sockaddr_in server1, server2;
+	struct tdig_base *base;
+	struct query_state *qa, *qb, *qc, *qd, *qe, *qs[UDP_POOL_MAXUSE];
+	struct udp_sock *usock;
+
+	base= new_base();
+	fd1= new_server(&server1);
+	fd2= new_server(&server2);
+
+	/* Queries for one server share a socket */
+	qa= new_query(base, &server1, 1, "www.ripe.net.", T_A);
+	qb= new_query(base, &server1, 2, "www.ripe.net.", T_AAAA);
+	CHECK("attach", udp_pool_attach(qa) == 0);
+	CHECK("attach", udp_pool_attach(qb) == 0);
+	CHECK("attach", qa->usock && qa->usock == qb->usock);
+	CHECK("attach", qa->usock->waiting == qb && qb->usock_next == qa);
+	CHECK("attach", base->udp_pool_count == 1);
+	usock= qa->usock;
+
+	/* Another port, TTL option or interface gets its own socket */
+	qc= new_query(base, &server2, 3, "www.ripe.net.", T_A);
+	qd= new_query(base, &server1, 4, "www.ripe.net.", T_A);
+	qd->opt_do_ttl= 1;
+	qe= new_query(base, &server1, 5, "www.ripe.net.", T_A);
+	qe->infname= "lo";
+	CHECK("attach", udp_pool_attach(qc) == 0);
+	CHECK("attach", udp_pool_attach(qd) == 0);
+	CHECK("attach", udp_pool_attach(qe) == 0);
+	CHECK("attach", qc->usock != usock && qd->usock != usock &&
+		qe->usock != usock && qd->usock != qe->usock);
+	CHECK("attach", base->udp_pool_count == 4);
+	free_query(qc);
+	free_query(qd);
+	free_query(qe);
+
+	/* The socket is connected, a packet from another address is dropped
+	 * by the kernel. From the server, only the right ID and question
+	 * select a query.
+	 */
+	{
+		int len;
+		u_char packet[MAX_DNS_BUF_SIZE];
+		struct pollfd pfd;
+		counter_t martian;
+
+		len= mk_query(packet, 2, "www.ripe.net.", T_A);
+		sendto(fd2, packet, len, 0, (struct sockaddr *)&usock->loc_sin6,
+			usock->loc_socklen);
+		sendto(fd1, packet, len, 0, (struct sockaddr *)&usock->loc_sin6,
+			usock->loc_socklen);
+		pfd.fd= usock->fd;
+		pfd.events= POLLIN;
+		CHECK("attach", poll(&pfd, 1, 1000) == 1);
+		martian= base->martian;
+		udp_pool_callback(usock->fd, EV_READ, usock);
+		CHECK("attach", base->martian == martian+1);
+		CHECK("attach", recv(usock->fd, packet, sizeof(packet),
+			MSG_DONTWAIT) == -1);
+
+		len= mk_query(packet, 2, "www.ripe.net.", T_AAAA);
+		for (qc= usock->waiting; qc; qc= qc->usock_next)
+		{
+			if (match_reply(qc, packet, len))
+				break;
+		}
+		CHECK("attach", qc == qb);
+	}
+
+	/* Idle sockets are closed by the sweep, a socket in use stays */
+	free_query(qa);
+	clock_sec += UDP_POOL_IDLE;
+	udp_pool_sweep(0, 0, base);
+	CHECK("attach", base->udp_pool_count == 1);
+	free_query(qb);
+	clock_sec += UDP_POOL_IDLE;
+	udp_pool_sweep(0, 0, base);
+	CHECK("attach", base->udp_pool_count == 0);
+
+	/* A socket is retired after UDP_POOL_MAXUSE queries and closed when
+	 * the last of them is done
+	 */
+	for (i= 0; i<UDP_POOL_MAXUSE; i++)
+	{
+		qs[i]= new_query(base, &server1, i, "www.ripe.net.", T_A);
+		CHECK("attach", udp_pool_attach(qs[i]) == 0);
+		CHECK("attach", qs[i]->usock == qs[0]->usock);
+	}
+	CHECK("attach", qs[0]->usock->retired && base->udp_pool_count == 0);
+	qa= new_query(base, &server1, i, "www.ripe.net.", T_A);
+	CHECK("attach", udp_pool_attach(qa) == 0);
+	CHECK("attach", qa->usock != qs[0]->usock);
+	CHECK("attach", base->udp_pool_count == 1);
+	for (i= 0; i<UDP_POOL_MAXUSE; i++)
+		free_query(qs[i]);
+	free_query(qa);
+	clock_sec += UDP_POOL_IDLE;
+	udp_pool_sweep(0, 0, base);
+	CHECK("attach", base->udp_pool_count == 0);
+
+	close(fd1);
+	close(fd2);
+	free(base);
+}
+
+static void bench(void)
+{
+	int i, n, len, fd, rounds;
+	u_char packet[MAX_DNS_BUF_SIZE];
+	double t;
+	struct sockaddr_in server;
+	struct tdig_base *base;
+	struct query_state *qs[64], *qry;
+
+	base= new_base();
+	fd= new_server(&server);
+	for (i= 0; i<64; i++)
+		qs[i]= new_query(base, &server, i, "www.ripe.net.", T_A);
+
+	/* Attach and detach 64 queries, the socket stays in the pool */
+	rounds= 10000;
+	CHECK("bench", udp_pool_attach(qs[0]) == 0);
+	t= now();
+	for (n= 0; n<rounds; n++)
+	{
+		for (i= 1; i<64; i++)
+		{
+			udp_pool_attach(qs[i]);
+			qs[i]->usock->uses= 0;
+		}
+		for (i= 1; i<64; i++)
+			udp_pool_detach(qs[i]);
+	}
+	t= now()-t;
+	printf("attach+detach: %.0f ns\n", t/(rounds*63)*1e9);
+
+	/* Find the query for a reply among 64 waiting ones */
+	for (i= 1; i<64; i++)
+		udp_pool_attach(qs[i]);
+	len= mk_query(packet, 0, "www.ripe.net.", T_A);
+	rounds= 100000;
+	t= now();
+	for (n= 0; n<rounds; n++)
+	{
+		for (qry= qs[0]->usock->waiting; qry; qry= qry->usock_next)
+		{
+			if (match_reply(qry, packet, len))
+				break;
+		}
+		CHECK("bench", qry == qs[0]);
+	}
+	t= now()-t;
+	printf("match among 64: %.0f ns\n", t/rounds*1e9);
+
+	for (i= 0; i<64; i++)
+		free_query(qs[i]);
+	close(fd);
+}
+
+int main(int argc, char *argv[])
+{
+	EventBase= event_base_new();
+
+	check_match();
+	check_attach();
+	if (errors)
+		return 1;
+	printf("ok\n");
+
+	if (argc > 1 && strcmp(argv[1], "-b") == 0)
+		bench();
+	return 0;
+}